@@ -0,0 +1,79 @@
+"""Property commands for Unreal Engine.
+
+This module contains commands for reading and writing reflected properties
+of actors and their components by dotted property path.
+"""
+
+import sys
+import os
+import json
+from mcp.server.fastmcp import Context
+
+# Import send_command from the parent module
+sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+from unreal_mcp_bridge import send_command
+
+def register_all(mcp):
+    """Register all property commands with the MCP server."""
+    
+    @mcp.tool()
+    def get_properties(ctx: Context, paths: list, names: list = None, filter: dict = None,
+                       max_response_bytes: int = None) -> str:
+        """Read property values from many actors by property path.
+        
+        A path is a dotted chain of property names, e.g. "bHidden", "Tags[0]",
+        "StaticMeshComponent.Mobility" or "LightComponent.Intensity". Paths continue into struct members
+        ("RootComponent.RelativeLocation.X") and through object references. A first segment that is not
+        a property of the actor is looked up as a component name. Fixed-size array properties need an [index].
+        
+        Args:
+            paths: Property paths to read from every actor
+            names: Actor names to read from
+            filter: Actor filter with the same fields as get_scene_info's filter; with names, it narrows them
+            max_response_bytes: Byte budget for the response; a larger result is cut and carries a cursor for
+                                continue_response (default: UNREAL_MCP_MAX_RESPONSE_BYTES)
+        """
+        try:
+            params = {"paths": paths}
+            if names:
+                params["names"] = names
+            if filter:
+                params["filter"] = filter
+            response = send_command("get_properties", params, max_response_bytes=max_response_bytes)
+            if response["status"] == "success":
+                return json.dumps(response["result"], indent=2)
+            else:
+                return f"Error: {response['message']}"
+        except Exception as e:
+            return f"Error getting properties: {str(e)}"
+
+    @mcp.tool()
+    def set_properties(ctx: Context, values: dict, names: list = None, filter: dict = None,
+                       transact: bool = True, notify: bool = True) -> str:
+        """Write property values on many actors in one undoable batch.
+        
+        Args:
+            values: Map of property path to value, with paths as in get_properties. Numbers, booleans,
+                    arrays and objects are converted by type; a string for a non-string property is parsed
+                    as Unreal property text, e.g. "Movable" for an enum or "(X=1,Y=2,Z=3)" for a vector.
+                    Only properties editable in the details panel can be set, and only on the actor and
+                    its components, not on assets they reference such as a component's mesh
+            names: Actor names to modify
+            filter: Actor filter with the same fields as get_scene_info's filter; with names, it narrows them
+            transact: Record one undo entry for the whole batch
+            notify: Send editor change notifications so objects react to the new values; pass False
+                    for faster bulk writes of plain values
+        """
+        try:
+            params = {"values": values, "transact": transact, "notify": notify}
+            if names:
+                params["names"] = names
+            if filter:
+                params["filter"] = filter
+            response = send_command("set_properties", params)
+            if response["status"] == "success":
+                return json.dumps(response["result"], indent=2)
+            else:
+                return f"Error: {response['message']}"
+        except Exception as e:
+            return f"Error setting properties: {str(e)}"
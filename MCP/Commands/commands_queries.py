@@ -0,0 +1,171 @@
+"""Spatial query commands for Unreal Engine.
+
+This module contains commands that query the editor world's collision scene,
+such as batched line traces, shape sweeps and overlaps.
+"""
+
+import sys
+import os
+import json
+from mcp.server.fastmcp import Context
+
+# Import send_command from the parent module
+sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+from unreal_mcp_bridge import send_command
+
+def register_all(mcp):
+    """Register all query commands with the MCP server."""
+    
+    @mcp.tool()
+    def trace_batch(ctx: Context, starts: list = None, ends: list = None, shape: dict = None, overlap_centers: list = None,
+                    overlap_shape: dict = None, channel: str = "visibility", trace_complex: bool = False,
+                    ignore: list = None, max_response_bytes: int = None) -> str:
+        """Run many collision queries against the editor world in one call.
+        
+        Traces and overlaps run in parallel. Results come back as base64 little-endian columns described
+        in 'columns' (decode with numpy.frombuffer(base64.b64decode(v), dtype).reshape(-1, stride)).
+        For traces: hit_actors (index into 'actors', 'no_hit' for a miss), positions, normals and distances
+        (-1 for a miss); sweeps also return impact_points. For overlaps: the actors overlapping query i are
+        overlap_actors[overlap_offsets[i]:overlap_offsets[i + 1]].
+        
+        Args:
+            starts: Trace start points, flat [x, y, z, ...] list
+            ends: Trace end points, same layout as starts
+            shape: Optional shape to sweep instead of a line trace:
+                   {"type": "sphere", "radius": r}, {"type": "capsule", "radius": r, "half_height": h}
+                   or {"type": "box", "half_extent": [x, y, z]}, each with an optional "rotation": [pitch, yaw, roll]
+            overlap_centers: Centers of overlap queries, same layout as starts
+            overlap_shape: Shape used for every overlap query (required with overlap_centers)
+            channel: Collision channel: visibility, camera, world_static, world_dynamic, pawn,
+                     physics_body, vehicle or destructible
+            trace_complex: Trace against complex (per-triangle) collision
+            ignore: Actor names to ignore, e.g. the objects being snapped
+            max_response_bytes: Byte budget for the response; a larger result is cut and carries a cursor for
+                                continue_response (default: UNREAL_MCP_MAX_RESPONSE_BYTES)
+        """
+        try:
+            params = {"channel": channel, "trace_complex": trace_complex}
+            if starts is not None:
+                params["starts"] = starts
+                params["ends"] = ends
+            if shape:
+                params["shape"] = shape
+            if overlap_centers is not None:
+                params["overlap_centers"] = overlap_centers
+            if overlap_shape:
+                params["overlap_shape"] = overlap_shape
+            if ignore:
+                params["ignore"] = ignore
+            response = send_command("trace_batch", params, max_response_bytes=max_response_bytes)
+            if response["status"] == "success":
+                return json.dumps(response["result"], indent=2)
+            else:
+                return f"Error: {response['message']}"
+        except Exception as e:
+            return f"Error running trace batch: {str(e)}"
+
+    @mcp.tool()
+    def get_scene_stats(ctx: Context, filter: dict = None, max_classes: int = 50) -> str:
+        """Get aggregate statistics about the scene in one small response.
+        
+        Returns actor counts per class (most frequent first), mesh components, instances, LOD0 triangle
+        total, unique mesh and material counts, light counts by mobility and by type, and actor count
+        and bounds per level. Cheap enough to call on every planning step instead of dumping the scene.
+        
+        Args:
+            filter: Optional actor filter with the same fields as get_scene_info's filter
+            max_classes: Number of classes listed; the remaining actors are summed in other_class_actors
+        """
+        try:
+            params = {"max_classes": max_classes}
+            if filter:
+                params["filter"] = filter
+            response = send_command("get_scene_stats", params)
+            if response["status"] == "success":
+                return json.dumps(response["result"], indent=2)
+            else:
+                return f"Error: {response['message']}"
+        except Exception as e:
+            return f"Error getting scene stats: {str(e)}"
+
+    @mcp.tool()
+    def query_frustum(ctx: Context, location: list, rotation: list = None, direction: list = None,
+                      look_at: list = None, fov: float = 90.0, aspect_ratio: float = 1.7778, near: float = 10.0,
+                      far: float = 1000000.0, occlusion: bool = False, occluder_min_coverage: float = 0.05,
+                      filter: dict = None, max_results: int = 200, max_response_bytes: int = None) -> str:
+        """List what a camera at a location would see, largest on screen first.
+        
+        Runs on the CPU: actor bounds are culled against the view frustum, and with occlusion enabled the
+        largest on-screen meshes are rasterized into a small depth buffer to drop actors hidden behind them.
+        Coverage is the approximate share of the screen covered by the actor's projected bounds (0 to 1).
+        
+        Args:
+            location: Camera position [x, y, z]
+            rotation: Camera rotation [pitch, yaw, roll]
+            direction: View direction [x, y, z], instead of rotation
+            look_at: Point to look at [x, y, z], instead of rotation
+            fov: Horizontal field of view in degrees
+            aspect_ratio: Width over height
+            near: Near clip distance
+            far: Far clip distance
+            occlusion: Remove actors hidden behind large meshes (coarse, conservative)
+            occluder_min_coverage: Minimum screen coverage of an actor used as an occluder
+            filter: Optional actor filter with the same fields as get_scene_info's filter, applied to the results
+            max_results: Maximum number of actors returned
+            max_response_bytes: Byte budget for the response; a larger result is cut and carries a cursor for
+                                continue_response (default: UNREAL_MCP_MAX_RESPONSE_BYTES)
+        """
+        try:
+            params = {"location": location, "fov": fov, "aspect_ratio": aspect_ratio, "near": near, "far": far,
+                      "occlusion": occlusion, "occluder_min_coverage": occluder_min_coverage,
+                      "max_results": max_results}
+            if rotation:
+                params["rotation"] = rotation
+            if direction:
+                params["direction"] = direction
+            if look_at:
+                params["look_at"] = look_at
+            if filter:
+                params["filter"] = filter
+            response = send_command("query_frustum", params, max_response_bytes=max_response_bytes)
+            if response["status"] == "success":
+                return json.dumps(response["result"], indent=2)
+            else:
+                return f"Error: {response['message']}"
+        except Exception as e:
+            return f"Error querying frustum: {str(e)}"
+
+    @mcp.tool()
+    def build_occupancy_grid(ctx: Context, region_min: list, region_max: list, resolution: float = 50.0,
+                             channel: str = "world_static", format: str = "rle", include_grid: bool = True,
+                             include_heightmap: bool = True, max_response_bytes: int = None) -> str:
+        """Voxelize the collision geometry of a region into an occupancy grid and a height map for path planning.
+        
+        The grid is (nx, ny, nz) voxels from the region's minimum corner, read as an [ny][nx][nz] array.
+        With format "rle", "grid" is base64 uint32 run lengths alternating empty/occupied, starting with empty.
+        With format "bits", each column is packed into ceil(nz / 8) bytes, little-endian bit order.
+        "heightmap" is base64 float32 [ny][nx] holding the top of the highest occupied voxel, NaN if empty.
+        Results are cached by the content hashes of the actors in the region, so repeated calls are cheap.
+        
+        Args:
+            region_min: Minimum corner [x, y, z]
+            region_max: Maximum corner [x, y, z]
+            resolution: Voxel edge length in world units
+            channel: Collision channel the geometry must block (world_static, world_dynamic, pawn, visibility, ...)
+            format: "rle" or "bits"
+            include_grid: Return the 3D grid
+            include_heightmap: Return the 2.5D height map
+            max_response_bytes: Byte budget for the response; a larger result is cut and carries a cursor for
+                                continue_response (default: UNREAL_MCP_MAX_RESPONSE_BYTES)
+        """
+        try:
+            params = {"region": {"min": region_min, "max": region_max}, "resolution": resolution,
+                      "channel": channel, "format": format, "include_grid": include_grid,
+                      "include_heightmap": include_heightmap}
+            response = send_command("build_occupancy_grid", params, max_response_bytes=max_response_bytes)
+            if response["status"] == "success":
+                return json.dumps(response["result"], indent=2)
+            else:
+                return f"Error: {response['message']}"
+        except Exception as e:
+            return f"Error building occupancy grid: {str(e)}"
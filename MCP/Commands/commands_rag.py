@@ -7,9 +7,14 @@ This module provides tools to query knowledge bases created from project source
 
 import sys
 import os
+import json
 import logging
 from mcp.server.fastmcp import Context
 
+# Import send_command from the parent module
+sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+from unreal_mcp_bridge import send_command
+
 # --- RAG Core Imports ---
 # These libraries are required for the RAG functionality.
 # We'll wrap the main logic in a try...except block to handle missing dependencies.
@@ -159,4 +164,37 @@ def register_all(mcp):
 
         except Exception as e:
             logging.error(f"Error during RAG query: {str(e)}", exc_info=True)
-            return f"An error occurred while querying the knowledge base: {str(e)}"
\ No newline at end of file
+            return f"An error occurred while querying the knowledge base: {str(e)}"
+
+    @mcp.tool()
+    def semantic_search(ctx: Context, query: str, index: str = "assets", k: int = 10, filter: dict = None,
+                        max_response_bytes: int = None) -> str:
+        """
+        Find assets or actors by meaning in a vector index held by the editor.
+        The query is embedded with the same model as the knowledge base and matched against embeddings
+        stored with upsert_embeddings, which must have been made with that model too.
+
+        Args:
+            query: Natural language description, e.g. "old wooden furniture".
+            index: The vector index to search. Defaults to 'assets'.
+            k: Number of hits. Defaults to 10.
+            filter: Optional metadata conditions, e.g. {"kind": "asset", "path": "/Game/Props*"}.
+            max_response_bytes: Byte budget for the response; a larger result is cut and carries a cursor for
+                                continue_response (default: UNREAL_MCP_MAX_RESPONSE_BYTES)
+
+        Returns:
+            The hits with their ids, similarity scores and metadata, as JSON.
+        """
+        try:
+            vector = get_embedding_model().embed_query(query)
+            params = {"index": index, "vector": [float(v) for v in vector], "k": k}
+            if filter:
+                params["filter"] = filter
+            response = send_command("query_embeddings", params, max_response_bytes=max_response_bytes)
+            if response["status"] == "success":
+                return json.dumps(response["result"], indent=2)
+            else:
+                return f"Error: {response['message']}"
+        except Exception as e:
+            logging.error(f"Error during semantic search: {str(e)}", exc_info=True)
+            return f"An error occurred during semantic search: {str(e)}"
@@ -6,6 +6,7 @@ including getting scene information, creating, modifying, and deleting objects.
 
 import sys
 import os
+import json
 from mcp.server.fastmcp import Context
 
 # Import send_command from the parent module
@@ -16,10 +17,30 @@ def register_all(mcp):
     """Register all scene-related commands with the MCP server."""
     
     @mcp.tool()
-    def get_scene_info(ctx: Context) -> str:
-        """Get detailed information about the current Unreal scene."""
+    def get_scene_info(ctx: Context, format: str = None, quantize: bool = False, include_bounds: bool = True,
+                       filter: dict = None, max_response_bytes: int = None) -> str:
+        """Get detailed information about the current Unreal scene.
+        
+        Args:
+            format: Optional 'columnar' to get one ids array plus base64 packed little-endian columns
+                    (location, rotation quaternion xyzw, scale, bounds min/max) described in 'columns'
+            quantize: In columnar mode, pack columns as 16-bit integers with per-component ranges
+            include_bounds: In columnar mode, include the bounds column
+            filter: Optional actor filter; every given field must match:
+                    classes (class names, subclasses match too), name and label (wildcards with * and ?),
+                    folder (outliner folder, subfolders included), region ({"min": [x, y, z], "max": [x, y, z]})
+            max_response_bytes: Byte budget for the response; a larger result is cut and carries a cursor for
+                                continue_response (default: UNREAL_MCP_MAX_RESPONSE_BYTES)
+        """
         try:
-            response = send_command("get_scene_info")
+            params = {}
+            if format:
+                params["format"] = format
+                params["quantize"] = quantize
+                params["include_bounds"] = include_bounds
+            if filter:
+                params["filter"] = filter
+            response = send_command("get_scene_info", params, max_response_bytes=max_response_bytes)
             if response["status"] == "success":
                 return json.dumps(response["result"], indent=2)
             else:
@@ -28,14 +49,52 @@ def register_all(mcp):
             return f"Error getting scene info: {str(e)}"
 
     @mcp.tool()
-    def get_asset_info(ctx: Context, type: str = None) -> str:
-        """Get detailed information about the current Unreal project assets.
+    def get_asset_info(ctx: Context, type: str = None, classes: list = None, include_subclasses: bool = True,
+                       paths: list = None, recursive: bool = True, sort: str = None, descending: bool = False,
+                       page_size: int = None, page_cursor: str = None, deep: list = None,
+                       max_response_bytes: int = None) -> str:
+        """Get detailed information about the current Unreal project assets, one page at a time.
+        
+        Info comes from asset registry tags (e.g. triangle counts, approximate size, parent class) without
+        loading the assets. Fields in deep load the assets, in batches and for a limited number of assets.
+        The first call runs the query and keeps its sorted result; pass the returned next_page_cursor to get
+        the following pages of that same result (the query arguments are then ignored).
         
         Args:
-            type: The type of asset to get information about ( 'StaticMesh', 'Blueprint', 'Material'.)
+            type: Optional asset class short name or path; 'Material' also matches material instances
+            classes: Optional asset class paths or short names, e.g. ['/Script/Engine.StaticMesh', 'SoundWave']
+            include_subclasses: Also match classes derived from the given ones, including blueprint classes
+            paths: Optional package path roots, e.g. ['/Game/Props', '/Game/Characters']
+            recursive: Also match assets in folders below the given paths
+            sort: Optional order: 'name', 'path', 'size' (package size on disk) or 'modified' (file time)
+            descending: Reverse the order
+            page_size: Assets per page (default 200, max 2000)
+            page_cursor: next_page_cursor from the previous page
+            deep: Optional fields that need the asset loaded: 'bounds', 'material_slots', 'metadata'
+            max_response_bytes: Byte budget for the response; a larger result is cut and carries a cursor for
+                                continue_response (default: UNREAL_MCP_MAX_RESPONSE_BYTES)
         """
         try:
-            response = send_command("get_asset_info", {"type": type})
+            params = {}
+            if page_cursor:
+                params["page_cursor"] = page_cursor
+            else:
+                if type:
+                    params["type"] = type
+                if classes:
+                    params["classes"] = classes
+                params["include_subclasses"] = include_subclasses
+                if paths:
+                    params["paths"] = paths
+                params["recursive"] = recursive
+                if sort:
+                    params["sort"] = sort
+                params["descending"] = descending
+            if page_size:
+                params["page_size"] = page_size
+            if deep:
+                params["deep"] = deep
+            response = send_command("get_asset_info", params, max_response_bytes=max_response_bytes)
             if response["status"] == "success":
                 return json.dumps(response["result"], indent=2)
             else:
@@ -43,6 +102,111 @@ def register_all(mcp):
         except Exception as e:
             return f"Error getting scene info: {str(e)}"
 
+    @mcp.tool()
+    def search_assets(ctx: Context, query: str, max_results: int = None, min_match: float = None,
+                      classes: list = None, paths: list = None, max_response_bytes: int = None) -> str:
+        """Find project assets by a vague name, ranked by fuzzy match.
+        
+        Matches words and fragments against asset names first, then package paths, class names and
+        asset registry tags, tolerating typos (e.g. 'wodden chiar' finds SM_WoodenChair).
+        
+        Args:
+            query: Free text, e.g. 'wooden chair' or 'SM_Rock_03'
+            max_results: Optional number of best hits to return (default 20, max 500)
+            min_match: Optional share of the query an asset must match, 0-1 (default 0.34); lower is more tolerant
+            classes: Optional asset class paths or short names to restrict to, subclasses included
+            paths: Optional package path roots to restrict to, e.g. ['/Game/Props']
+            max_response_bytes: Byte budget for the response; a larger result is cut and carries a cursor for
+                                continue_response (default: UNREAL_MCP_MAX_RESPONSE_BYTES)
+        """
+        try:
+            params = {"query": query}
+            if max_results:
+                params["max_results"] = max_results
+            if min_match is not None:
+                params["min_match"] = min_match
+            if classes:
+                params["classes"] = classes
+            if paths:
+                params["paths"] = paths
+            response = send_command("search_assets", params, max_response_bytes=max_response_bytes)
+            if response["status"] == "success":
+                return json.dumps(response["result"], indent=2)
+            else:
+                return f"Error: {response['message']}"
+        except Exception as e:
+            return f"Error searching assets: {str(e)}"
+
+    def _dependency_params(assets, depth, categories, include_editor_only, include_script_packages, max_results):
+        params = {"assets": assets, "depth": depth, "include_editor_only": include_editor_only,
+                  "include_script_packages": include_script_packages}
+        if categories:
+            params["categories"] = categories
+        if max_results:
+            params["max_results"] = max_results
+        return params
+
+    @mcp.tool()
+    def get_asset_dependencies(ctx: Context, assets: list, depth: int = 1, categories: list = None,
+                               include_editor_only: bool = True, include_script_packages: bool = False,
+                               max_results: int = None, max_response_bytes: int = None) -> str:
+        """List the packages the given assets depend on, from the asset registry.
+
+        Each result gives its depth, the package it was reached through ('via') and the kinds of that
+        reference; packages marked 'missing' are referenced but do not exist.
+
+        Args:
+            assets: Package names or object paths, e.g. ['/Game/Props/SM_Chair']
+            depth: References followed from the assets; 0 for the full transitive closure
+            categories: Reference kinds to follow: 'hard', 'soft', 'manage' (default hard and soft); 'manage'
+                        links the package of a primary asset to the packages it manages
+            include_editor_only: Also follow references only used in the editor
+            include_script_packages: Also list /Script native packages
+            max_results: Optional number of packages to list, nearest first (default 1000)
+            max_response_bytes: Byte budget for the response; a larger result is cut and carries a cursor for
+                                continue_response (default: UNREAL_MCP_MAX_RESPONSE_BYTES)
+        """
+        try:
+            params = _dependency_params(assets, depth, categories, include_editor_only, include_script_packages, max_results)
+            response = send_command("get_asset_dependencies", params, max_response_bytes=max_response_bytes)
+            if response["status"] == "success":
+                return json.dumps(response["result"], indent=2)
+            else:
+                return f"Error: {response['message']}"
+        except Exception as e:
+            return f"Error getting asset dependencies: {str(e)}"
+
+    @mcp.tool()
+    def get_asset_referencers(ctx: Context, assets: list, depth: int = 1, categories: list = None,
+                              include_editor_only: bool = True, include_script_packages: bool = False,
+                              max_results: int = None, max_response_bytes: int = None) -> str:
+        """List the packages that reference the given assets, to check what a delete or move would break.
+
+        An empty result with depth 0 means no package reaches the assets through the followed categories;
+        the default hard and soft references leave out asset manager management, so pass 'manage' too
+        before deleting a package a primary asset may manage.
+
+        Args:
+            assets: Package names or object paths, e.g. ['/Game/Props/SM_Chair']
+            depth: References followed back from the assets; 0 for the full transitive closure
+            categories: Reference kinds to follow: 'hard', 'soft', 'manage' (default hard and soft); 'manage'
+                        links the package of a primary asset to the packages it manages
+            include_editor_only: Also follow references only used in the editor
+            include_script_packages: Also list /Script native packages
+            max_results: Optional number of packages to list, nearest first (default 1000)
+            max_response_bytes: Byte budget for the response; a larger result is cut and carries a cursor for
+                                continue_response (default: UNREAL_MCP_MAX_RESPONSE_BYTES)
+        """
+        try:
+            params = _dependency_params(assets, depth, categories, include_editor_only, include_script_packages, max_results)
+            response = send_command("get_asset_referencers", params, max_response_bytes=max_response_bytes)
+            if response["status"] == "success":
+                return json.dumps(response["result"], indent=2)
+            else:
+                return f"Error: {response['message']}"
+        except Exception as e:
+            return f"Error getting asset referencers: {str(e)}"
+
     @mcp.tool()
     def create_object(ctx: Context, type: str, name: str = None, location: list = None,label: str = None) -> str:
         """Create a new object in the Unreal scene.
@@ -109,4 +273,372 @@ def register_all(mcp):
             else:
                 return f"Error: {response['message']}"
         except Exception as e:
-            return f"Error deleting object: {str(e)}" 
\ No newline at end of file
+            return f"Error deleting object: {str(e)}"
+
+    @mcp.tool()
+    def get_scene_changes(ctx: Context, since_version: int, max_changes: int = None, coalesce: bool = True,
+                          max_response_bytes: int = None) -> str:
+        """Get the actors added, removed, moved or edited since a known scene version.
+        
+        Use the 'scene_version' from get_scene_info (or 'returned_version' from a previous call)
+        to refresh a cached view of the scene without downloading every actor again.
+        If 'resync_required' is true, call get_scene_info again.
+        
+        Args:
+            since_version: The last scene version the caller has seen
+            max_changes: Optional cap on the number of journal entries to read
+            coalesce: Whether to merge multiple changes to the same actor into one entry
+            max_response_bytes: Byte budget for the response; a larger result is cut and carries a cursor for
+                                continue_response (default: UNREAL_MCP_MAX_RESPONSE_BYTES)
+        """
+        try:
+            params = {"since_version": since_version, "coalesce": coalesce}
+            if max_changes:
+                params["max_changes"] = max_changes
+            response = send_command("get_scene_changes", params, max_response_bytes=max_response_bytes)
+            if response["status"] == "success":
+                return json.dumps(response["result"], indent=2)
+            else:
+                return f"Error: {response['message']}"
+        except Exception as e:
+            return f"Error getting scene changes: {str(e)}"
+
+    @mcp.tool()
+    def modify_objects(ctx: Context, names: list, locations: list = None, rotations: list = None, scales: list = None) -> str:
+        """Move, rotate and scale many objects at once in a single undo transaction.
+        
+        Args:
+            names: The names of the objects to modify
+            locations: Optional list of [x, y, z], one per name
+            rotations: Optional list of [pitch, yaw, roll], one per name
+            scales: Optional list of [x, y, z], one per name
+        """
+        try:
+            params = {"names": names}
+            if locations:
+                params["locations"] = [value for item in locations for value in item]
+            if rotations:
+                params["rotations"] = [value for item in rotations for value in item]
+            if scales:
+                params["scales"] = [value for item in scales for value in item]
+            response = send_command("modify_objects", params)
+            if response["status"] == "success":
+                return json.dumps(response["result"], indent=2)
+            else:
+                return f"Error: {response['message']}"
+        except Exception as e:
+            return f"Error modifying objects: {str(e)}"
+
+    @mcp.tool()
+    def create_objects(ctx: Context, meshes: list, locations: list, mesh_indices: list = None, rotations: list = None,
+                       scales: list = None, labels: list = None, mode: str = "actors", label: str = None) -> str:
+        """Create many static mesh objects in one call.
+        
+        Args:
+            meshes: Unique mesh paths, e.g. ['/Engine/BasicShapes/Cube.Cube']
+            locations: List of [x, y, z], one per object
+            mesh_indices: Index into 'meshes' for each object (optional when only one mesh is given)
+            rotations: Optional list of [pitch, yaw, roll], one per object
+            scales: Optional list of [x, y, z], one per object
+            labels: Optional outliner labels, one per object ('actors' mode only)
+            mode: 'actors' to spawn one actor per object, or 'instanced' to add all objects as instances
+                  of one instanced mesh component per unique mesh (use this for thousands of objects)
+            label: Outliner label of the instance container actor ('instanced' mode only)
+        """
+        try:
+            params = {
+                "meshes": meshes,
+                "locations": [value for item in locations for value in item],
+                "mode": mode,
+            }
+            if mesh_indices:
+                params["mesh_indices"] = mesh_indices
+            if rotations:
+                params["rotations"] = [value for item in rotations for value in item]
+            if scales:
+                params["scales"] = [value for item in scales for value in item]
+            if labels:
+                params["labels"] = labels
+            if label:
+                params["label"] = label
+            response = send_command("create_objects", params)
+            if response["status"] == "success":
+                return json.dumps(response["result"], indent=2)
+            else:
+                return f"Error: {response['message']}"
+        except Exception as e:
+            return f"Error creating objects: {str(e)}"
+
+    @mcp.tool()
+    def scatter(ctx: Context, meshes: list, box: dict = None, polygon: list = None, z_range: list = None,
+                density: float = None, count: int = None, min_spacing: float = 0.0, seed: int = 0,
+                weights: list = None, yaw_range: list = None, pitch_range: list = None, roll_range: list = None,
+                scale_range: list = None, conform_to_ground: bool = False, align_to_normal: bool = False,
+                label: str = None) -> str:
+        """Scatter mesh instances over a region with Poisson-disk spacing.
+        
+        The result is one actor holding an instanced mesh component per mesh. The same seed always
+        gives the same layout.
+        
+        Args:
+            meshes: Mesh paths to choose from, e.g. ['/Game/Foliage/SM_Rock.SM_Rock']
+            box: Region as {"min": [x, y, z], "max": [x, y, z]}
+            polygon: Region outline as [[x, y], ...], used when no box is given
+            z_range: [min_z, max_z] for a polygon region; without it instances are placed at z = 0, or with
+                     conform_to_ground the ground is searched at any height
+            density: Instances per square meter
+            count: Exact number of instances wanted, instead of density
+            min_spacing: Minimum distance between instances in centimeters
+            seed: Random seed
+            weights: Relative chance of each mesh
+            yaw_range: [min, max] yaw in degrees, default [0, 360]
+            pitch_range: [min, max] pitch in degrees, default [0, 0]
+            roll_range: [min, max] roll in degrees, default [0, 0]
+            scale_range: [min, max] uniform scale, default [1, 1]
+            conform_to_ground: Trace down from the top of the region and place instances on what is hit;
+                               points that hit nothing are dropped
+            align_to_normal: Tilt instances to the surface normal when conforming to ground
+            label: Outliner label of the scatter actor
+        """
+        try:
+            params = {
+                "meshes": meshes,
+                "min_spacing": min_spacing,
+                "seed": seed,
+                "conform_to_ground": conform_to_ground,
+                "align_to_normal": align_to_normal,
+            }
+            optional = {
+                "box": box, "polygon": polygon, "z_range": z_range, "density": density, "count": count,
+                "weights": weights, "yaw_range": yaw_range, "pitch_range": pitch_range,
+                "roll_range": roll_range, "scale_range": scale_range, "label": label,
+            }
+            params.update({key: value for key, value in optional.items() if value is not None})
+            response = send_command("scatter", params)
+            if response["status"] == "success":
+                return json.dumps(response["result"], indent=2)
+            else:
+                return f"Error: {response['message']}"
+        except Exception as e:
+            return f"Error scattering objects: {str(e)}"
+
+    @mcp.tool()
+    def delete_objects(ctx: Context, names: list = None, filter: dict = None, dry_run: bool = False,
+                       transact: bool = True, collect_garbage: bool = True) -> str:
+        """Delete many objects in one call.
+        
+        Args:
+            names: Actor names to delete
+            filter: Actor filter with the same fields as get_scene_info's filter; with names, it narrows them
+            dry_run: Only return the names that would be deleted
+            transact: Record one undo entry for the whole batch; pass False to free memory for huge deletes
+            collect_garbage: Run one garbage collection after the batch
+        """
+        try:
+            params = {"dry_run": dry_run, "transact": transact, "collect_garbage": collect_garbage}
+            if names:
+                params["names"] = names
+            if filter:
+                params["filter"] = filter
+            response = send_command("delete_objects", params)
+            if response["status"] == "success":
+                return json.dumps(response["result"], indent=2)
+            else:
+                return f"Error: {response['message']}"
+        except Exception as e:
+            return f"Error deleting objects: {str(e)}"
+
+    @mcp.tool()
+    def get_scene_hashes(ctx: Context, cells: bool = False, level: str = None, region: dict = None,
+                         names: list = None, filter: dict = None, max_response_bytes: int = None) -> str:
+        """Get content hashes of the scene to check whether a cached copy is still valid.
+        
+        Hashes form a tree: root -> level -> spatial cell -> actor. Each actor hash covers its class,
+        transform, label, folder, tags, visibility and components. Compare the root first, then only
+        descend into levels and cells whose hash changed.
+        
+        Args:
+            cells: Include per-cell hashes for each level
+            level: Only return this level
+            region: Only return cells overlapping {"min": [x, y, z], "max": [x, y, z]} (implies cells)
+            names: Return the hashes of these actors
+            filter: Return the hashes of every actor matching this filter (same fields as get_scene_info)
+            max_response_bytes: Byte budget for the response; a larger result is cut and carries a cursor for
+                                continue_response (default: UNREAL_MCP_MAX_RESPONSE_BYTES)
+        """
+        try:
+            params = {"cells": cells}
+            optional = {"level": level, "region": region, "names": names, "filter": filter}
+            params.update({key: value for key, value in optional.items() if value is not None})
+            response = send_command("get_scene_hashes", params, max_response_bytes=max_response_bytes)
+            if response["status"] == "success":
+                return json.dumps(response["result"], indent=2)
+            else:
+                return f"Error: {response['message']}"
+        except Exception as e:
+            return f"Error getting scene hashes: {str(e)}"
+
+    @mcp.tool()
+    def export_scene_snapshot(ctx: Context, path: str = None, filter: dict = None, include_components: bool = True,
+                              wait: bool = False) -> str:
+        """Export the scene to a compact binary snapshot file (.mcpsnap) for offline analysis.
+        
+        The file is little-endian with 64-byte aligned fixed-stride sections (string table, actor
+        records, transforms, bounds, components) described by a section table after the header, so it
+        can be memory-mapped (e.g. numpy.memmap) and read without parsing. See MCPSceneExport.h.
+        
+        Args:
+            path: Output file; relative paths go under the project's Saved/MCPSnapshots directory
+            filter: Only export actors matching this filter (same fields as get_scene_info)
+            include_components: Include the component table
+            wait: Wait for the file to be written; otherwise it appears at 'path' once complete
+        """
+        try:
+            params = {"include_components": include_components, "wait": wait}
+            if path:
+                params["path"] = path
+            if filter:
+                params["filter"] = filter
+            response = send_command("export_scene_snapshot", params)
+            if response["status"] == "success":
+                return json.dumps(response["result"], indent=2)
+            else:
+                return f"Error: {response['message']}"
+        except Exception as e:
+            return f"Error exporting scene snapshot: {str(e)}"
+
+    @mcp.tool()
+    def summarize_scene(ctx: Context, max_bytes: int = 16384, cluster: str = "r", filter: dict = None,
+                        max_classes: int = 3, max_representatives: int = 3) -> str:
+        """Summarize the scene as a hierarchy of spatial clusters that fits a byte budget.
+        
+        Start here instead of get_scene_info on large scenes. Each cluster lists its actor count, bounds,
+        most common classes and largest actors. Clusters have a "parent" id; the biggest clusters are split
+        first until the budget is used. Call again with cluster set to an "expandable" cluster's id to zoom in.
+        Ids stay valid while the scene and filter are unchanged.
+        
+        Args:
+            max_bytes: Approximate size budget of the returned clusters
+            cluster: Cluster id to summarize, "r" for the whole scene
+            filter: Only summarize actors matching this filter (same fields as get_scene_info)
+            max_classes: Classes listed per cluster
+            max_representatives: Representative actors listed per cluster
+        """
+        try:
+            params = {"max_bytes": max_bytes, "cluster": cluster, "max_classes": max_classes,
+                      "max_representatives": max_representatives}
+            if filter:
+                params["filter"] = filter
+            response = send_command("summarize_scene", params)
+            if response["status"] == "success":
+                return json.dumps(response["result"], indent=2)
+            else:
+                return f"Error: {response['message']}"
+        except Exception as e:
+            return f"Error summarizing scene: {str(e)}"
+
+    @mcp.tool()
+    def checkpoint_scene(ctx: Context, filter: dict = None, label: str = None, list_only: bool = False,
+                         delete: str = None) -> str:
+        """Capture the serialized state of the scene into a compressed in-memory checkpoint.
+        
+        Use with restore_scene to try many layouts quickly: checkpoint, edit, restore, edit again.
+        Checkpoints live in editor memory only and the oldest are dropped once 32 exist.
+        Every call returns the list of kept checkpoints.
+        
+        Args:
+            filter: Only capture actors matching this filter (same fields as get_scene_info); restores
+                    then only touch these actors
+            label: Optional name to keep with the checkpoint
+            list_only: Only list the kept checkpoints, capture nothing
+            delete: Id of a checkpoint to drop instead of capturing
+        """
+        try:
+            params = {"list": list_only}
+            if filter:
+                params["filter"] = filter
+            if label:
+                params["label"] = label
+            if delete:
+                params["delete"] = delete
+            response = send_command("checkpoint_scene", params)
+            if response["status"] == "success":
+                return json.dumps(response["result"], indent=2)
+            else:
+                return f"Error: {response['message']}"
+        except Exception as e:
+            return f"Error checkpointing scene: {str(e)}"
+
+    @mcp.tool()
+    def restore_scene(ctx: Context, id: str, dry_run: bool = False, full_compare: bool = False) -> str:
+        """Restore the actors of a checkpoint, applying only what changed since it was taken.
+        
+        Changed actors get their properties, components and transform back, deleted actors are respawned
+        under their old names and actors added since the checkpoint are destroyed. Restores bypass the undo
+        buffer, so they cannot be undone with Ctrl+Z but any number of them costs no undo memory.
+        
+        Args:
+            id: Checkpoint id from checkpoint_scene
+            dry_run: Only report which actors would be restored, respawned or destroyed
+            full_compare: Compare every actor, for edits made by scripts that bypass editor notifications
+        """
+        try:
+            response = send_command("restore_scene", {"id": id, "dry_run": dry_run, "full_compare": full_compare})
+            if response["status"] == "success":
+                return json.dumps(response["result"], indent=2)
+            else:
+                return f"Error: {response['message']}"
+        except Exception as e:
+            return f"Error restoring scene: {str(e)}"
+
+    @mcp.tool()
+    def diff_scene(ctx: Context, from_id: str, to_id: str = "live", properties: bool = True,
+                   full_compare: bool = False, max_changes: int = 1000, max_response_bytes: int = None) -> str:
+        """Show what changed between two checkpoints, or between a checkpoint and the live scene.
+        
+        Unchanged actors are skipped by their hashes, so a diff of a large level with a few edits is fast.
+        Changed actors list only what differs: "location", "rotation" and "scale" as [before, after] pairs,
+        "label", "folder", changed "properties", and component changes. Removed and added actors are
+        listed with their class and location.
+        
+        Args:
+            from_id: Checkpoint id of the earlier state (from checkpoint_scene)
+            to_id: Checkpoint id of the later state, or "live" for the current scene
+            properties: Name the properties that changed on changed actors and components
+            full_compare: Compare every live actor, for edits made by scripts that bypass editor notifications
+            max_changes: Actors described per list; counts always cover every change
+            max_response_bytes: Byte budget for the response; a larger result is cut and carries a cursor for
+                                continue_response (default: UNREAL_MCP_MAX_RESPONSE_BYTES)
+        """
+        try:
+            params = {"from": from_id, "to": to_id, "properties": properties, "full_compare": full_compare,
+                      "max_changes": max_changes}
+            response = send_command("diff_scene", params, max_response_bytes=max_response_bytes)
+            if response["status"] == "success":
+                return json.dumps(response["result"], indent=2)
+            else:
+                return f"Error: {response['message']}"
+        except Exception as e:
+            return f"Error diffing scene: {str(e)}"
+
+    @mcp.tool()
+    def continue_response(ctx: Context, cursor: str, max_response_bytes: int = None) -> str:
+        """Fetch the next part of a response that was cut to its byte budget.
+        
+        A cut response has "_continuation": {"cursor": ...}. Each part holds the next result fields, or the
+        next elements of a cut array, characters of a cut string or members of a cut object; append them
+        to the earlier parts by field name, merging objects member by member. Cursors are single-use, only
+        the most recent ones are kept, and they expire when the editor drops the idle connection.
+        
+        Args:
+            cursor: The cursor from the previous part
+            max_response_bytes: Byte budget for this part (default: the original budget)
+        """
+        try:
+            response = send_command("continue_response", cursor=cursor, max_response_bytes=max_response_bytes or 0)
+            if response["status"] == "success":
+                return json.dumps(response["result"], indent=2)
+            else:
+                return f"Error: {response['message']}"
+        except Exception as e:
+            return f"Error continuing response: {str(e)}"
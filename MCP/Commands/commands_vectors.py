@@ -0,0 +1,116 @@
+"""Vector index commands for Unreal Engine.
+
+This module contains commands for storing embeddings of assets and actors in
+named vector indexes inside the editor and retrieving the most similar entries.
+"""
+
+import sys
+import os
+import json
+import base64
+import struct
+from mcp.server.fastmcp import Context
+
+# Import send_command from the parent module
+sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+from unreal_mcp_bridge import send_command
+
+def encode_floats(values) -> str:
+    """Pack a flat sequence of floats as base64 little-endian float32, the plugin's packed column format."""
+    values = [float(v) for v in values]
+    return base64.b64encode(struct.pack(f"<{len(values)}f", *values)).decode("ascii")
+
+def register_all(mcp):
+    """Register all vector index commands with the MCP server."""
+
+    @mcp.tool()
+    def upsert_embeddings(ctx: Context, index: str, ids: list, vectors: list, metadata: list = None,
+                          kind: str = None, save: bool = False) -> str:
+        """Insert or replace embeddings in a named vector index held by the editor.
+
+        The index is created on first use and keeps the length of its first vector; it is stored as
+        Saved/MCPVectors/<index>.mcpvec when saved and when the server stops. Upserting an existing id
+        replaces its vector and metadata.
+
+        Args:
+            index: Index name (letters, digits, '_' or '-')
+            ids: Entry ids, e.g. asset object paths or actor names
+            vectors: One embedding (list of floats) per id
+            metadata: Optional list of {key: value} objects, one per id, for query filters
+            kind: 'asset' to add kind/class/path metadata from the asset catalog, 'actor' to add
+                  kind/class/level/folder/label metadata from the editor world
+            save: Write the index file after the upsert
+        """
+        try:
+            flat = [value for vector in vectors for value in vector]
+            params = {"index": index, "ids": ids, "vectors": encode_floats(flat), "save": save}
+            if metadata:
+                params["metadata"] = metadata
+            if kind:
+                params["kind"] = kind
+            response = send_command("upsert_embeddings", params)
+            if response["status"] == "success":
+                return json.dumps(response["result"], indent=2)
+            else:
+                return f"Error: {response['message']}"
+        except Exception as e:
+            return f"Error upserting embeddings: {str(e)}"
+
+    @mcp.tool()
+    def query_embeddings(ctx: Context, index: str, vector: list, k: int = 10, ef: int = 64,
+                         filter: dict = None, include_metadata: bool = True,
+                         max_response_bytes: int = None) -> str:
+        """Find the entries of a vector index most similar to an embedding (cosine similarity).
+
+        Args:
+            index: Index name
+            vector: Query embedding, same length as the indexed vectors
+            k: Number of hits
+            ef: Candidates kept while searching; raise it for better recall at some cost in speed
+            filter: Optional metadata conditions, every key must match, e.g.
+                    {"kind": "asset", "class": ["/Script/Engine.StaticMesh"], "path": "/Game/Props*"};
+                    a list accepts any of its values and a trailing '*' matches by prefix
+            include_metadata: Return each hit's metadata
+            max_response_bytes: Byte budget for the response; a larger result is cut and carries a cursor for
+                                continue_response (default: UNREAL_MCP_MAX_RESPONSE_BYTES)
+        """
+        try:
+            params = {"index": index, "vector": encode_floats(vector), "k": k, "ef": ef,
+                      "include_metadata": include_metadata}
+            if filter:
+                params["filter"] = filter
+            response = send_command("query_embeddings", params, max_response_bytes=max_response_bytes)
+            if response["status"] == "success":
+                return json.dumps(response["result"], indent=2)
+            else:
+                return f"Error: {response['message']}"
+        except Exception as e:
+            return f"Error querying embeddings: {str(e)}"
+
+    @mcp.tool()
+    def vector_index(ctx: Context, action: str = "list", index: str = None, ids: list = None,
+                     delete_file: bool = False) -> str:
+        """Manage vector indexes.
+
+        Args:
+            action: 'list' all indexes, 'stats' or 'load' to open one and report its size,
+                    'save' to write it, 'compact' to rebuild it without deleted and replaced entries,
+                    which otherwise keep their memory and file space, 'drop' to unload it,
+                    'delete' to remove the entries in ids
+            index: Index name, required for every action but list
+            ids: Entry ids for 'delete'
+            delete_file: With 'drop', also delete the index file
+        """
+        try:
+            params = {"action": action, "delete_file": delete_file}
+            if index:
+                params["index"] = index
+            if ids:
+                params["ids"] = ids
+            response = send_command("vector_index", params)
+            if response["status"] == "success":
+                return json.dumps(response["result"], indent=2)
+            else:
+                return f"Error: {response['message']}"
+        except Exception as e:
+            return f"Error managing vector index: {str(e)}"
@@ -0,0 +1,94 @@
+"""World Partition commands for Unreal Engine.
+
+This module contains commands for searching World Partition maps without
+loading them, and for loading and unloading regions in the editor.
+"""
+
+import sys
+import os
+import json
+from mcp.server.fastmcp import Context
+
+# Import send_command from the parent module
+sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+from unreal_mcp_bridge import send_command
+
+def register_all(mcp):
+    """Register all World Partition commands with the MCP server."""
+    
+    @mcp.tool()
+    def query_actor_descs(ctx: Context, filter: dict = None, intersects: dict = None, data_layers: list = None,
+                          unloaded_only: bool = False, max_results: int = 20000,
+                          max_response_bytes: int = None) -> str:
+        """Search every actor of a World Partition map, loaded or not.
+        
+        Reads the actor descriptors World Partition keeps for each actor (name, label, class, bounds,
+        folder, data layers), so open-world maps can be searched without loading them. Each result says
+        whether the actor is currently loaded; use load_region to load the ones you need.
+        
+        Args:
+            filter: Optional actor filter with the same fields as get_scene_info's filter;
+                    'region' is tested against the center of each actor's bounds, and 'classes' matches
+                    native classes with their parents, and Blueprint classes (e.g. "BP_Tree_C") by name
+            intersects: Only actors whose bounds intersect {"min": [x, y, z], "max": [x, y, z]}
+            data_layers: Only actors in at least one of these data layer instances
+            unloaded_only: Only actors that are not loaded
+            max_results: Maximum number of actors returned; total_count still counts all matches
+            max_response_bytes: Byte budget for the response; a larger result is cut and carries a cursor for
+                                continue_response (default: UNREAL_MCP_MAX_RESPONSE_BYTES)
+        """
+        try:
+            params = {"unloaded_only": unloaded_only, "max_results": max_results}
+            if filter:
+                params["filter"] = filter
+            if intersects:
+                params["intersects"] = intersects
+            if data_layers:
+                params["data_layers"] = data_layers
+            response = send_command("query_actor_descs", params, max_response_bytes=max_response_bytes)
+            if response["status"] == "success":
+                return json.dumps(response["result"], indent=2)
+            else:
+                return f"Error: {response['message']}"
+        except Exception as e:
+            return f"Error querying actor descriptors: {str(e)}"
+
+    @mcp.tool()
+    def load_region(ctx: Context, region: dict, wait: bool = False) -> str:
+        """Load the actors of a World Partition region in the editor.
+        
+        By default the load starts on the next editor tick and this returns immediately with the region
+        id and status 'loading'; query_actor_descs and load/unload responses list region status.
+        
+        Args:
+            region: Box to load as {"min": [x, y, z], "max": [x, y, z]}
+            wait: Load before returning
+        """
+        try:
+            response = send_command("load_region", {"region": region, "wait": wait})
+            if response["status"] == "success":
+                return json.dumps(response["result"], indent=2)
+            else:
+                return f"Error: {response['message']}"
+        except Exception as e:
+            return f"Error loading region: {str(e)}"
+
+    @mcp.tool()
+    def unload_region(ctx: Context, id: str = None, all: bool = False) -> str:
+        """Unload a region loaded with load_region.
+        
+        Args:
+            id: Region id returned by load_region
+            all: Unload every region loaded with load_region
+        """
+        try:
+            params = {"all": all}
+            if id:
+                params["id"] = id
+            response = send_command("unload_region", params)
+            if response["status"] == "success":
+                return json.dumps(response["result"], indent=2)
+            else:
+                return f"Error: {response['message']}"
+        except Exception as e:
+            return f"Error unloading region: {str(e)}"
@@ -26,6 +26,11 @@ import importlib
 DEFAULT_PORT = 13377
 DEFAULT_BUFFER_SIZE = 65536
 DEFAULT_TIMEOUT = 10  # 10 second timeout
+# Byte budget applied to every response unless a call passes its own; 0 means unlimited
+DEFAULT_MAX_RESPONSE_BYTES = int(os.environ.get("UNREAL_MCP_MAX_RESPONSE_BYTES", "0"))
+# Continuation cursors only work on the connection that received them, so those connections stay open
+MAX_CONTINUATION_CONNECTIONS = 16
+_continuation_sockets = {}
 
 try:
     # Try to read the port from the C++ constants
@@ -88,58 +93,80 @@ mcp = FastMCP(
     # errors::: ,description="Unreal Engine integration through the Model Context Protocol"
 )
 
-def send_command(command_type, params=None, timeout=DEFAULT_TIMEOUT):
+def send_command(command_type, params=None, timeout=DEFAULT_TIMEOUT, max_response_bytes=None, cursor=None):
     """Send a command to the C++ MCP server and return the response.
     
     Args:
         command_type: The type of command to send
         params: Optional parameters for the command
         timeout: Timeout in seconds (default: DEFAULT_TIMEOUT)
+        max_response_bytes: Byte budget for the response (default: DEFAULT_MAX_RESPONSE_BYTES)
+        cursor: Continuation cursor of a truncated response; the server sends its next part instead of running a command
     
     Returns:
-        The JSON response from the server
+        The JSON response from the server. A truncated response has its continuation
+        copied into result["_continuation"] so tools pass the cursor on to the caller;
+        its connection is kept open for the continue_response call that uses the cursor.
     """
+    if max_response_bytes is None:
+        max_response_bytes = DEFAULT_MAX_RESPONSE_BYTES
+    keep_open = False
+    s = _continuation_sockets.pop(cursor, None) if cursor else None
     try:
-        with socket.socket(socket.AF_INET, socket.SOCK_STREAM) as s:
+        if s is None:
+            s = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
             s.settimeout(timeout)  # Set a timeout
             s.connect(("localhost", DEFAULT_PORT))  # Connect to Unreal C++ server
-            command = {
-                "type": command_type,
-                "params": params or {}
-            }
-            s.sendall(json.dumps(command).encode('utf-8'))
-            
-            # Read response with a buffer
-            chunks = []
-            response_data = b''
-            
-            # Wait for data with timeout
-            while True:
+        else:
+            s.settimeout(timeout)
+        command = {
+            "type": command_type,
+            "params": params or {}
+        }
+        if max_response_bytes:
+            command["max_response_bytes"] = max_response_bytes
+        if cursor:
+            command["cursor"] = cursor
+        s.sendall(json.dumps(command).encode('utf-8'))
+        
+        # Read response with a buffer
+        chunks = []
+        response_data = b''
+        
+        # Wait for data with timeout
+        while True:
+            try:
+                chunk = s.recv(DEFAULT_BUFFER_SIZE)
+                if not chunk:  # Connection closed
+                    break
+                chunks.append(chunk)
+                
+                # Try to parse what we have so far
+                response_data = b''.join(chunks)
                 try:
-                    chunk = s.recv(DEFAULT_BUFFER_SIZE)
-                    if not chunk:  # Connection closed
-                        break
-                    chunks.append(chunk)
-                    
-                    # Try to parse what we have so far
-                    response_data = b''.join(chunks)
-                    try:
-                        # If we can parse it as JSON, we have a complete response
-                        json.loads(response_data.decode('utf-8'))
-                        break
-                    except json.JSONDecodeError:
-                        # Incomplete JSON, continue receiving
-                        continue
-                except socket.timeout:
-                    # If we have some data but timed out, try to use what we have
-                    if response_data:
-                        break
-                    raise
+                    # If we can parse it as JSON, we have a complete response
+                    json.loads(response_data.decode('utf-8'))
+                    break
+                except json.JSONDecodeError:
+                    # Incomplete JSON, continue receiving
+                    continue
+            except socket.timeout:
+                # If we have some data but timed out, try to use what we have
+                if response_data:
+                    break
+                raise
+        
+        if not response_data:
+            raise Exception("No data received from server")
             
-            if not response_data:
-                raise Exception("No data received from server")
-                
-            return json.loads(response_data.decode('utf-8'))
+        response = json.loads(response_data.decode('utf-8'))
+        if response.get("truncated") and isinstance(response.get("result"), dict):
+            response["result"]["_continuation"] = response.get("continuation")
+            next_cursor = (response.get("continuation") or {}).get("cursor")
+            if next_cursor:
+                _keep_continuation_socket(next_cursor, s)
+                keep_open = True
+        return response
     except ConnectionRefusedError:
         print(f"Error: Could not connect to Unreal MCP server on localhost:{DEFAULT_PORT}.", file=sys.stderr)
         print("Make sure your Unreal Engine with MCP plugin is running.", file=sys.stderr)
@@ -150,6 +177,16 @@ def send_command(command_type, params=None, timeout=DEFAULT_TIMEOUT):
     except Exception as e:
         print(f"Error communicating with Unreal MCP server: {str(e)}", file=sys.stderr)
         raise Exception(f"Failed to communicate with Unreal MCP server: {str(e)}")
+    finally:
+        if s is not None and not keep_open:
+            s.close()
+
+def _keep_continuation_socket(cursor, s):
+    """Hold a connection for a cursor, closing the oldest held ones past the limit."""
+    _continuation_sockets[cursor] = s
+    while len(_continuation_sockets) > MAX_CONTINUATION_CONNECTIONS:
+        oldest = next(iter(_continuation_sockets))
+        _continuation_sockets.pop(oldest).close()
 
 # All commands have been moved to separate modules in the Commands directory
 
@@ -0,0 +1,607 @@
+#include "MCPAssetCatalog.h"
+
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Algo/Reverse.h"
+#include "Algo/StableSort.h"
+#include "Async/Async.h"
+#include "Async/ParallelFor.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "Misc/PackageName.h"
+#include "MCPConstants.h"
+#include "MCPFileLogger.h"
+
+namespace
+{
+    IAssetRegistry& GetAssetRegistry()
+    {
+        return FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+    }
+
+    /** @return True if Folder is Root or, when recursive, lies below it */
+    bool IsInFolder(const FString& Folder, const FString& Root, bool bRecursive)
+    {
+        if (Folder == Root)
+        {
+            return true;
+        }
+        if (!bRecursive)
+        {
+            return false;
+        }
+        if (Root == TEXT("/"))
+        {
+            return true;
+        }
+        return Folder.Len() > Root.Len() && Folder.StartsWith(Root) && Folder[Root.Len()] == TEXT('/');
+    }
+}
+
+//
+// FMCPAssetCatalog::FTables
+//
+int32 FMCPAssetCatalog::FTables::Add(const FAssetData& AssetData)
+{
+    const FSoftObjectPath ObjectPath = AssetData.GetSoftObjectPath();
+    if (ByObjectPath.Contains(ObjectPath))
+    {
+        Remove(ObjectPath);
+    }
+
+    int32 Index = INDEX_NONE;
+    if (FreeSlots.Num() > 0)
+    {
+        Index = FreeSlots.Pop(EAllowShrinking::No);
+        Assets[Index] = AssetData;
+        PackageSizes[Index] = -1;
+        ModifiedTicks[Index] = -1;
+    }
+    else
+    {
+        Index = Assets.Add(AssetData);
+        PackageSizes.Add(-1);
+        ModifiedTicks.Add(-1);
+    }
+
+    ByObjectPath.Add(ObjectPath, Index);
+    ByClass.FindOrAdd(AssetData.AssetClassPath).Add(Index);
+    ByFolder.FindOrAdd(AssetData.PackagePath).Add(Index);
+    return Index;
+}
+
+int32 FMCPAssetCatalog::FTables::Remove(const FSoftObjectPath& ObjectPath)
+{
+    int32 Index = INDEX_NONE;
+    if (!ByObjectPath.RemoveAndCopyValue(ObjectPath, Index))
+    {
+        return INDEX_NONE;
+    }
+
+    const FAssetData& AssetData = Assets[Index];
+    if (TSet<int32>* ClassSlots = ByClass.Find(AssetData.AssetClassPath))
+    {
+        ClassSlots->Remove(Index);
+        if (ClassSlots->Num() == 0)
+        {
+            ByClass.Remove(AssetData.AssetClassPath);
+        }
+    }
+    if (TSet<int32>* FolderSlots = ByFolder.Find(AssetData.PackagePath))
+    {
+        FolderSlots->Remove(Index);
+        if (FolderSlots->Num() == 0)
+        {
+            ByFolder.Remove(AssetData.PackagePath);
+        }
+    }
+
+    Assets[Index] = FAssetData();
+    FreeSlots.Add(Index);
+    return Index;
+}
+
+//
+// FMCPAssetCatalog
+//
+FMCPAssetCatalog& FMCPAssetCatalog::Get()
+{
+    static FMCPAssetCatalog Instance;
+    return Instance;
+}
+
+void FMCPAssetCatalog::Initialize()
+{
+    if (bInitialized)
+    {
+        return;
+    }
+
+    IAssetRegistry& AssetRegistry = GetAssetRegistry();
+    AssetAddedHandle = AssetRegistry.OnAssetAdded().AddRaw(this, &FMCPAssetCatalog::HandleAssetAdded);
+    AssetRemovedHandle = AssetRegistry.OnAssetRemoved().AddRaw(this, &FMCPAssetCatalog::HandleAssetRemoved);
+    AssetRenamedHandle = AssetRegistry.OnAssetRenamed().AddRaw(this, &FMCPAssetCatalog::HandleAssetRenamed);
+    AssetUpdatedHandle = AssetRegistry.OnAssetUpdated().AddRaw(this, &FMCPAssetCatalog::HandleAssetUpdated);
+    bInitialized = true;
+
+    // Building during the initial scan would only copy a partial registry and then replay every discovery
+    if (AssetRegistry.IsLoadingAssets())
+    {
+        FilesLoadedHandle = AssetRegistry.OnFilesLoaded().AddRaw(this, &FMCPAssetCatalog::HandleFilesLoaded);
+        MCP_LOG_INFO("Asset catalog waiting for the asset registry scan");
+    }
+    else
+    {
+        StartBuild();
+    }
+}
+
+void FMCPAssetCatalog::Shutdown()
+{
+    if (!bInitialized)
+    {
+        return;
+    }
+
+    if (FModuleManager::Get().IsModuleLoaded("AssetRegistry"))
+    {
+        IAssetRegistry& AssetRegistry = GetAssetRegistry();
+        AssetRegistry.OnFilesLoaded().Remove(FilesLoadedHandle);
+        AssetRegistry.OnAssetAdded().Remove(AssetAddedHandle);
+        AssetRegistry.OnAssetRemoved().Remove(AssetRemovedHandle);
+        AssetRegistry.OnAssetRenamed().Remove(AssetRenamedHandle);
+        AssetRegistry.OnAssetUpdated().Remove(AssetUpdatedHandle);
+    }
+
+    if (BuildTickerHandle.IsValid())
+    {
+        FTSTicker::GetCoreTicker().RemoveTicker(BuildTickerHandle);
+        BuildTickerHandle.Reset();
+    }
+
+    // The worker owns nothing of ours, but its result must not outlive the catalog unobserved
+    if (bBuilding)
+    {
+        BuildFuture.Wait();
+        BuildFuture.Reset();
+        bBuilding = false;
+    }
+
+    Tables.Reset();
+    PendingEvents.Empty();
+    ResultSets.Empty();
+    bInitialized = false;
+    MCP_LOG_INFO("Asset catalog shut down");
+}
+
+bool FMCPAssetCatalog::IsScanning() const
+{
+    return GetAssetRegistry().IsLoadingAssets();
+}
+
+void FMCPAssetCatalog::EnsureReady()
+{
+    check(IsInGameThread());
+
+    if (Tables.IsValid())
+    {
+        return;
+    }
+
+    // A query during the initial scan gets what has been discovered so far; later discoveries arrive as events
+    if (!bBuilding)
+    {
+        StartBuild();
+    }
+    BuildFuture.Wait();
+    FinishBuild();
+}
+
+int32 FMCPAssetCatalog::Num() const
+{
+    return Tables.IsValid() ? Tables->ByObjectPath.Num() : 0;
+}
+
+int32 FMCPAssetCatalog::GetSlotCount() const
+{
+    return Tables.IsValid() ? Tables->Assets.Num() : 0;
+}
+
+const FAssetData* FMCPAssetCatalog::GetAsset(int32 Index) const
+{
+    if (!Tables.IsValid() || !Tables->Assets.IsValidIndex(Index) || !Tables->Assets[Index].IsValid())
+    {
+        return nullptr;
+    }
+    return &Tables->Assets[Index];
+}
+
+int32 FMCPAssetCatalog::Find(const FSoftObjectPath& ObjectPath) const
+{
+    const int32* Index = Tables.IsValid() ? Tables->ByObjectPath.Find(ObjectPath) : nullptr;
+    return Index ? *Index : INDEX_NONE;
+}
+
+void FMCPAssetCatalog::Query(const FMCPAssetQuery& Query, TArray<int32>& OutIndices) const
+{
+    OutIndices.Reset();
+    if (!Tables.IsValid())
+    {
+        return;
+    }
+
+    TSet<FTopLevelAssetPath> Classes(Query.ClassPaths);
+    if (Query.bIncludeSubclasses && Classes.Num() > 0)
+    {
+        GetAssetRegistry().GetDerivedClassNames(Query.ClassPaths, TSet<FTopLevelAssetPath>(), Classes);
+    }
+
+    TArray<FString> Roots;
+    for (const FName& PackagePath : Query.PackagePaths)
+    {
+        FString Root = PackagePath.ToString();
+        if (Root.Len() > 1 && Root.EndsWith(TEXT("/")))
+        {
+            Root.LeftChopInline(1);
+        }
+        Roots.Add(MoveTemp(Root));
+    }
+
+    // Folders are far fewer than assets, so path roots are resolved against the folder index
+    TArray<const TSet<int32>*> FolderSets;
+    TSet<FName> Folders;
+    int32 FolderSlotCount = 0;
+    if (Roots.Num() > 0)
+    {
+        for (const TPair<FName, TSet<int32>>& Folder : Tables->ByFolder)
+        {
+            const FString FolderPath = Folder.Key.ToString();
+            for (const FString& Root : Roots)
+            {
+                if (IsInFolder(FolderPath, Root, Query.bRecursivePaths))
+                {
+                    FolderSets.Add(&Folder.Value);
+                    Folders.Add(Folder.Key);
+                    FolderSlotCount += Folder.Value.Num();
+                    break;
+                }
+            }
+        }
+    }
+
+    TArray<const TSet<int32>*> ClassSets;
+    int32 ClassSlotCount = 0;
+    for (const FTopLevelAssetPath& Class : Classes)
+    {
+        if (const TSet<int32>* Slots = Tables->ByClass.Find(Class))
+        {
+            ClassSets.Add(Slots);
+            ClassSlotCount += Slots->Num();
+        }
+    }
+
+    if (Classes.Num() == 0 && Roots.Num() == 0)
+    {
+        OutIndices.Reserve(Tables->ByObjectPath.Num());
+        for (const TPair<FSoftObjectPath, int32>& Entry : Tables->ByObjectPath)
+        {
+            OutIndices.Add(Entry.Value);
+        }
+    }
+    else if (Roots.Num() == 0 || (Classes.Num() > 0 && ClassSlotCount <= FolderSlotCount))
+    {
+        // Walk the smaller index and test the other predicate per asset
+        OutIndices.Reserve(ClassSlotCount);
+        for (const TSet<int32>* Slots : ClassSets)
+        {
+            for (const int32 Index : *Slots)
+            {
+                if (Roots.Num() == 0 || Folders.Contains(Tables->Assets[Index].PackagePath))
+                {
+                    OutIndices.Add(Index);
+                }
+            }
+        }
+    }
+    else
+    {
+        OutIndices.Reserve(FolderSlotCount);
+        for (const TSet<int32>* Slots : FolderSets)
+        {
+            for (const int32 Index : *Slots)
+            {
+                if (Classes.Num() == 0 || Classes.Contains(Tables->Assets[Index].AssetClassPath))
+                {
+                    OutIndices.Add(Index);
+                }
+            }
+        }
+    }
+
+    OutIndices.Sort();
+}
+
+void FMCPAssetCatalog::Sort(TArray<int32>& Indices, EMCPAssetSort SortBy, bool bDescending)
+{
+    if (!Tables.IsValid() || SortBy == EMCPAssetSort::None)
+    {
+        if (bDescending)
+        {
+            Algo::Reverse(Indices);
+        }
+        return;
+    }
+
+    const TArray<FAssetData>& Assets = Tables->Assets;
+    if (SortBy == EMCPAssetSort::Size)
+    {
+        IAssetRegistry& AssetRegistry = GetAssetRegistry();
+        for (const int32 Index : Indices)
+        {
+            int64& Size = Tables->PackageSizes[Index];
+            if (Size < 0)
+            {
+                const TOptional<FAssetPackageData> PackageData = AssetRegistry.GetAssetPackageDataCopy(Assets[Index].PackageName);
+                Size = PackageData.IsSet() ? FMath::Max<int64>(PackageData->DiskSize, 0) : 0;
+            }
+        }
+    }
+    else if (SortBy == EMCPAssetSort::Modified)
+    {
+        TArray<int32> Unread;
+        for (const int32 Index : Indices)
+        {
+            if (Tables->ModifiedTicks[Index] < 0)
+            {
+                Unread.Add(Index);
+            }
+        }
+
+        // One file stat per package; only the first sort of a large result pays for them, in parallel
+        TArray<int64>& ModifiedTicks = Tables->ModifiedTicks;
+        ParallelFor(Unread.Num(), [&Unread, &Assets, &ModifiedTicks](int32 UnreadIndex)
+        {
+            const int32 Index = Unread[UnreadIndex];
+            const FAssetData& AssetData = Assets[Index];
+            const FString& Extension = AssetData.AssetClassPath == UWorld::StaticClass()->GetClassPathName()
+                ? FPackageName::GetMapPackageExtension() : FPackageName::GetAssetPackageExtension();
+            FString Filename;
+            int64 Ticks = 0;
+            if (FPackageName::TryConvertLongPackageNameToFilename(AssetData.PackageName.ToString(), Filename, Extension))
+            {
+                Ticks = FMath::Max<int64>(IFileManager::Get().GetTimeStamp(*Filename).GetTicks(), 0);
+            }
+            ModifiedTicks[Index] = Ticks;
+        });
+    }
+
+    const FTables& Sorted = *Tables;
+    auto NameLess = [&Assets](int32 A, int32 B)
+    {
+        const int32 Order = Assets[A].AssetName.Compare(Assets[B].AssetName);
+        return Order != 0 ? Order < 0 : Assets[A].PackageName.Compare(Assets[B].PackageName) < 0;
+    };
+    auto PathLess = [&Assets](int32 A, int32 B)
+    {
+        const int32 Order = Assets[A].PackageName.Compare(Assets[B].PackageName);
+        return Order != 0 ? Order < 0 : Assets[A].AssetName.Compare(Assets[B].AssetName) < 0;
+    };
+
+    // Stable sorts over slot-ordered input keep equal keys in a fixed order, so repeated queries page identically
+    switch (SortBy)
+    {
+    case EMCPAssetSort::Name:
+        Algo::StableSort(Indices, NameLess);
+        break;
+    case EMCPAssetSort::Path:
+        Algo::StableSort(Indices, PathLess);
+        break;
+    case EMCPAssetSort::Size:
+        Algo::StableSort(Indices, [&Sorted, &PathLess](int32 A, int32 B)
+        {
+            const int64 SizeA = Sorted.PackageSizes[A];
+            const int64 SizeB = Sorted.PackageSizes[B];
+            return SizeA != SizeB ? SizeA < SizeB : PathLess(A, B);
+        });
+        break;
+    case EMCPAssetSort::Modified:
+        Algo::StableSort(Indices, [&Sorted, &PathLess](int32 A, int32 B)
+        {
+            const int64 TicksA = Sorted.ModifiedTicks[A];
+            const int64 TicksB = Sorted.ModifiedTicks[B];
+            return TicksA != TicksB ? TicksA < TicksB : PathLess(A, B);
+        });
+        break;
+    default:
+        break;
+    }
+
+    if (bDescending)
+    {
+        Algo::Reverse(Indices);
+    }
+}
+
+int64 FMCPAssetCatalog::GetPackageSize(int32 Index) const
+{
+    return Tables.IsValid() && Tables->PackageSizes.IsValidIndex(Index) ? Tables->PackageSizes[Index] : -1;
+}
+
+FDateTime FMCPAssetCatalog::GetModifiedTime(int32 Index) const
+{
+    if (!Tables.IsValid() || !Tables->ModifiedTicks.IsValidIndex(Index) || Tables->ModifiedTicks[Index] < 0)
+    {
+        return FDateTime::MinValue();
+    }
+    return FDateTime(Tables->ModifiedTicks[Index]);
+}
+
+const FMCPAssetResultSet& FMCPAssetCatalog::StoreResultSet(const TArray<int32>& Indices, EMCPAssetSort SortBy)
+{
+    if (ResultSets.Num() >= MCPConstants::MAX_ASSET_RESULT_SETS)
+    {
+        ResultSets.RemoveAt(0);
+    }
+
+    // Object paths rather than slots: a slot freed and reused between pages would otherwise show another asset
+    FMCPAssetResultSet& ResultSet = ResultSets.AddDefaulted_GetRef();
+    ResultSet.Id = FString::Printf(TEXT("q%d"), NextResultSetNumber++);
+    ResultSet.SortBy = SortBy;
+    ResultSet.Version = Version;
+    ResultSet.Assets.Reserve(Indices.Num());
+    for (const int32 Index : Indices)
+    {
+        ResultSet.Assets.Add(Tables->Assets[Index].GetSoftObjectPath());
+    }
+    return ResultSet;
+}
+
+const FMCPAssetResultSet* FMCPAssetCatalog::FindResultSet(const FString& Id) const
+{
+    return ResultSets.FindByPredicate([&Id](const FMCPAssetResultSet& ResultSet) { return ResultSet.Id == Id; });
+}
+
+void FMCPAssetCatalog::StartBuild()
+{
+    if (bBuilding)
+    {
+        return;
+    }
+
+    // Copying the registry is quick and must happen here; hashing it into the indexes is not and runs on a worker
+    TArray<FAssetData> Snapshot;
+    GetAssetRegistry().GetAllAssets(Snapshot, true);
+    MCP_LOG_INFO("Building asset catalog from %d assets", Snapshot.Num());
+
+    bBuilding = true;
+    BuildStartTime = FPlatformTime::Seconds();
+    PendingEvents.Reset();
+    BuildFuture = Async(EAsyncExecution::ThreadPool, [Snapshot = MoveTemp(Snapshot)]()
+    {
+        TUniquePtr<FTables> Built = MakeUnique<FTables>();
+        Built->Assets.Reserve(Snapshot.Num());
+        Built->PackageSizes.Reserve(Snapshot.Num());
+        Built->ModifiedTicks.Reserve(Snapshot.Num());
+        Built->ByObjectPath.Reserve(Snapshot.Num());
+        for (const FAssetData& AssetData : Snapshot)
+        {
+            Built->Add(AssetData);
+        }
+        return Built;
+    });
+
+    BuildTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FMCPAssetCatalog::TickBuild));
+}
+
+void FMCPAssetCatalog::FinishBuild()
+{
+    if (!bBuilding)
+    {
+        return;
+    }
+
+    Tables = BuildFuture.Get();
+    BuildFuture.Reset();
+    bBuilding = false;
+    if (BuildTickerHandle.IsValid())
+    {
+        FTSTicker::GetCoreTicker().RemoveTicker(BuildTickerHandle);
+        BuildTickerHandle.Reset();
+    }
+
+    // Events are idempotent against the snapshot: adds replace, removes of unknown assets do nothing
+    // Listeners hear about the result through the rebuild notification only
+    for (const FPendingEvent& Event : PendingEvents)
+    {
+        ApplyEvent(Event, false);
+    }
+    MCP_LOG_INFO("Asset catalog ready with %d assets after %.1f ms (%d events replayed)",
+        Tables->ByObjectPath.Num(), (FPlatformTime::Seconds() - BuildStartTime) * 1000.0, PendingEvents.Num());
+    PendingEvents.Empty();
+    Version++;
+    RebuiltEvent.Broadcast();
+}
+
+bool FMCPAssetCatalog::TickBuild(float DeltaTime)
+{
+    if (!BuildFuture.IsReady())
+    {
+        return true;
+    }
+
+    // Returning false removes this ticker, so FinishBuild must not remove it a second time
+    BuildTickerHandle.Reset();
+    FinishBuild();
+    return false;
+}
+
+void FMCPAssetCatalog::ApplyEvent(const FPendingEvent& Event, bool bBroadcast)
+{
+    // Replacements are split into a removal and an addition so listeners see every slot change
+    const FSoftObjectPath& RemovedPath = Event.Type == EEventType::Renamed ? Event.OldObjectPath : Event.AssetData.GetSoftObjectPath();
+    const int32 RemovedIndex = Tables->Remove(RemovedPath);
+    if (RemovedIndex != INDEX_NONE && bBroadcast)
+    {
+        AssetRemovedEvent.Broadcast(RemovedIndex);
+    }
+
+    if (Event.Type != EEventType::Removed)
+    {
+        // A rename onto an existing path replaces that asset
+        const int32 ReplacedIndex = Tables->Remove(Event.AssetData.GetSoftObjectPath());
+        if (ReplacedIndex != INDEX_NONE && bBroadcast)
+        {
+            AssetRemovedEvent.Broadcast(ReplacedIndex);
+        }
+        const int32 AddedIndex = Tables->Add(Event.AssetData);
+        if (bBroadcast)
+        {
+            AssetAddedEvent.Broadcast(AddedIndex);
+        }
+    }
+    Version++;
+}
+
+void FMCPAssetCatalog::OnEvent(FPendingEvent&& Event)
+{
+    if (Tables.IsValid())
+    {
+        ApplyEvent(Event, true);
+    }
+    else if (bBuilding)
+    {
+        PendingEvents.Add(MoveTemp(Event));
+    }
+
+    // Before a build starts there is nothing to update; the build's snapshot will include the change
+}
+
+void FMCPAssetCatalog::HandleFilesLoaded()
+{
+    GetAssetRegistry().OnFilesLoaded().Remove(FilesLoadedHandle);
+    FilesLoadedHandle.Reset();
+    if (!Tables.IsValid())
+    {
+        StartBuild();
+    }
+}
+
+void FMCPAssetCatalog::HandleAssetAdded(const FAssetData& AssetData)
+{
+    OnEvent(FPendingEvent{ EEventType::Added, AssetData, FSoftObjectPath() });
+}
+
+void FMCPAssetCatalog::HandleAssetRemoved(const FAssetData& AssetData)
+{
+    OnEvent(FPendingEvent{ EEventType::Removed, AssetData, FSoftObjectPath() });
+}
+
+void FMCPAssetCatalog::HandleAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath)
+{
+    OnEvent(FPendingEvent{ EEventType::Renamed, AssetData, FSoftObjectPath(OldObjectPath) });
+}
+
+void FMCPAssetCatalog::HandleAssetUpdated(const FAssetData& AssetData)
+{
+    OnEvent(FPendingEvent{ EEventType::Updated, AssetData, FSoftObjectPath() });
+}
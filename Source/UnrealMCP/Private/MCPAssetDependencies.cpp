@@ -0,0 +1,471 @@
+#include "MCPAssetDependencies.h"
+
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Async/ParallelFor.h"
+#include "MCPAssetCatalog.h"
+#include "MCPFileLogger.h"
+
+namespace
+{
+    IAssetRegistry& GetAssetRegistry()
+    {
+        return FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+    }
+}
+
+//
+// FMCPAssetDependencyGraph
+//
+FMCPAssetDependencyGraph& FMCPAssetDependencyGraph::Get()
+{
+    static FMCPAssetDependencyGraph Instance;
+    return Instance;
+}
+
+void FMCPAssetDependencyGraph::Initialize()
+{
+    if (bInitialized)
+    {
+        return;
+    }
+
+    FMCPAssetCatalog& Catalog = FMCPAssetCatalog::Get();
+    AssetAddedHandle = Catalog.OnAssetAdded().AddRaw(this, &FMCPAssetDependencyGraph::HandleAssetAdded);
+    AssetRemovedHandle = Catalog.OnAssetRemoved().AddRaw(this, &FMCPAssetDependencyGraph::HandleAssetRemoved);
+    RebuiltHandle = Catalog.OnRebuilt().AddRaw(this, &FMCPAssetDependencyGraph::HandleCatalogRebuilt);
+    bInitialized = true;
+}
+
+void FMCPAssetDependencyGraph::Shutdown()
+{
+    if (!bInitialized)
+    {
+        return;
+    }
+
+    FMCPAssetCatalog& Catalog = FMCPAssetCatalog::Get();
+    Catalog.OnAssetAdded().Remove(AssetAddedHandle);
+    Catalog.OnAssetRemoved().Remove(AssetRemovedHandle);
+    Catalog.OnRebuilt().Remove(RebuiltHandle);
+
+    Reset();
+    bInitialized = false;
+}
+
+void FMCPAssetDependencyGraph::Reset()
+{
+    Packages.Empty();
+    NodeByPackage.Empty();
+    AssetCounts.Empty();
+    RowNodeCount = 0;
+    ForwardOffsets.Empty();
+    ForwardTargets.Empty();
+    ForwardFlags.Empty();
+    ReverseOffsets.Empty();
+    ReverseSources.Empty();
+    ReverseFlags.Empty();
+    ForwardOverrides.Empty();
+    ReverseAdditions.Empty();
+    Overridden.Empty();
+    SlotPackages.Empty();
+    PendingPackages.Empty();
+    VisitMarks.Empty();
+    VisitEpoch = 0;
+    bBuilt = false;
+}
+
+bool FMCPAssetDependencyGraph::EnsureCurrent()
+{
+    check(IsInGameThread());
+
+    if (!bBuilt)
+    {
+        FMCPAssetCatalog::Get().EnsureReady();
+        Build();
+        return true;
+    }
+    if (PendingPackages.Num() == 0)
+    {
+        return false;
+    }
+
+    TArray<int32> Changed;
+    Changed.Reserve(PendingPackages.Num());
+    for (const FName PackageName : PendingPackages)
+    {
+        Changed.Add(FindOrAddNode(PackageName));
+    }
+    PendingPackages.Reset();
+
+    TArray<TArray<FEdge>> Edges;
+    ReadEdges(Changed, Edges);
+    for (int32 Index = 0; Index < Changed.Num(); ++Index)
+    {
+        SetOverride(Changed[Index], MoveTemp(Edges[Index]));
+    }
+
+    // Every reverse row read skips overridden sources, so a large overlay is folded back into the rows
+    if (ForwardOverrides.Num() <= FMath::Max(MCPConstants::DEPENDENCY_OVERLAY_MIN_REBUILD, Packages.Num() / 16))
+    {
+        return false;
+    }
+
+    const double StartTime = FPlatformTime::Seconds();
+    TArray<TArray<FEdge>> AllEdges;
+    AllEdges.SetNum(Packages.Num());
+    for (int32 Node = 0; Node < Packages.Num(); ++Node)
+    {
+        ForEachEdge(Node, false, [&AllEdges, Node](int32 Target, uint8 Flags)
+        {
+            AllEdges[Node].Add(FEdge{ Target, Flags });
+        });
+    }
+    const int32 OverlayCount = ForwardOverrides.Num();
+    BuildRows(AllEdges);
+    MCP_LOG_INFO("Folded %d changed packages into the dependency graph in %.1f ms", OverlayCount, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+    return true;
+}
+
+int32 FMCPAssetDependencyGraph::FindPackage(FName PackageName) const
+{
+    const int32* Node = NodeByPackage.Find(PackageName);
+    return Node ? *Node : INDEX_NONE;
+}
+
+int32 FMCPAssetDependencyGraph::GetEdgeCount() const
+{
+    int32 Count = ForwardTargets.Num();
+    for (const TPair<int32, TArray<FEdge>>& Override : ForwardOverrides)
+    {
+        if (Override.Key < RowNodeCount)
+        {
+            Count -= ForwardOffsets[Override.Key + 1] - ForwardOffsets[Override.Key];
+        }
+        Count += Override.Value.Num();
+    }
+    return Count;
+}
+
+template <typename FunctionType>
+void FMCPAssetDependencyGraph::ForEachEdge(int32 Node, bool bReverse, FunctionType&& Function) const
+{
+    if (!bReverse)
+    {
+        if (Overridden[Node])
+        {
+            for (const FEdge& Edge : ForwardOverrides.FindChecked(Node))
+            {
+                Function(Edge.Node, Edge.Flags);
+            }
+        }
+        else if (Node < RowNodeCount)
+        {
+            for (int32 Edge = ForwardOffsets[Node]; Edge < ForwardOffsets[Node + 1]; ++Edge)
+            {
+                Function(ForwardTargets[Edge], ForwardFlags[Edge]);
+            }
+        }
+        return;
+    }
+
+    if (Node < RowNodeCount)
+    {
+        for (int32 Edge = ReverseOffsets[Node]; Edge < ReverseOffsets[Node + 1]; ++Edge)
+        {
+            const int32 Source = ReverseSources[Edge];
+            if (!Overridden[Source])
+            {
+                Function(Source, ReverseFlags[Edge]);
+            }
+        }
+    }
+    if (const TArray<FEdge>* Additions = ReverseAdditions.Find(Node))
+    {
+        for (const FEdge& Edge : *Additions)
+        {
+            Function(Edge.Node, Edge.Flags);
+        }
+    }
+}
+
+int32 FMCPAssetDependencyGraph::Traverse(const FMCPDependencyQuery& Query, TArray<FMCPDependencyHit>& OutHits)
+{
+    OutHits.Reset();
+    EnsureCurrent();
+
+    if (++VisitEpoch == 0)
+    {
+        FMemory::Memzero(VisitMarks.GetData(), VisitMarks.Num() * sizeof(uint32));
+        VisitEpoch = 1;
+    }
+
+    // The hits double as the breadth-first queue: roots first, then each depth in turn
+    for (const int32 Root : Query.Roots)
+    {
+        if (VisitMarks[Root] != VisitEpoch)
+        {
+            VisitMarks[Root] = VisitEpoch;
+            OutHits.Add(FMCPDependencyHit{ Root, 0, INDEX_NONE, 0 });
+        }
+    }
+    const int32 RootCount = OutHits.Num();
+
+    const uint8 ExcludedFlags = Query.bIncludeEditorOnly ? 0 : EMCPDependencyFlags::EditorOnly;
+    int32 MaxDepthReached = 0;
+    for (int32 Head = 0; Head < OutHits.Num(); ++Head)
+    {
+        const int32 Node = OutHits[Head].Node;
+        const int32 Depth = OutHits[Head].Depth + 1;
+        if (Query.MaxDepth > 0 && Depth > Query.MaxDepth)
+        {
+            break;
+        }
+
+        ForEachEdge(Node, Query.bReverse, [this, &Query, &OutHits, &MaxDepthReached, ExcludedFlags, Node, Depth](int32 Other, uint8 Flags)
+        {
+            if ((Flags & Query.Kinds) == 0 || (Flags & ExcludedFlags) != 0 || VisitMarks[Other] == VisitEpoch)
+            {
+                return;
+            }
+            VisitMarks[Other] = VisitEpoch;
+            OutHits.Add(FMCPDependencyHit{ Other, Depth, Node, Flags });
+            MaxDepthReached = Depth;
+        });
+    }
+
+    OutHits.RemoveAt(0, RootCount, EAllowShrinking::No);
+    return MaxDepthReached;
+}
+
+void FMCPAssetDependencyGraph::ReadDependencies(const IAssetRegistry& AssetRegistry, FName PackageName, TArray<TPair<FName, uint8>>& OutDependencies)
+{
+    using namespace UE::AssetRegistry;
+
+    // The registry guards its state with a reader lock, so packages are read from many threads at once
+    TArray<FAssetDependency> Dependencies;
+    AssetRegistry.GetDependencies(FAssetIdentifier(PackageName), Dependencies, EDependencyCategory::Package);
+
+    // Management is recorded from primary asset ids, not packages, so read it from the ids of the package's
+    // primary assets; ids come from the registry tags, since the asset manager is not safe off the game thread
+    TArray<FAssetData> Assets;
+    AssetRegistry.GetAssetsByPackageName(PackageName, Assets, true);
+    for (const FAssetData& Asset : Assets)
+    {
+        const FPrimaryAssetId PrimaryAssetId = Asset.GetPrimaryAssetId();
+        if (PrimaryAssetId.IsValid())
+        {
+            AssetRegistry.GetDependencies(FAssetIdentifier(PrimaryAssetId), Dependencies, EDependencyCategory::Manage);
+        }
+    }
+
+    OutDependencies.Reset(Dependencies.Num());
+    for (const FAssetDependency& Dependency : Dependencies)
+    {
+        if (!Dependency.AssetId.IsPackage() || Dependency.AssetId.PackageName == PackageName)
+        {
+            continue;
+        }
+
+        uint8 Flags = 0;
+        if (Dependency.Category == EDependencyCategory::Manage)
+        {
+            Flags = EMCPDependencyFlags::Manage;
+        }
+        else
+        {
+            Flags = EnumHasAnyFlags(Dependency.Properties, EDependencyProperty::Hard) ? EMCPDependencyFlags::Hard : EMCPDependencyFlags::Soft;
+            if (!EnumHasAnyFlags(Dependency.Properties, EDependencyProperty::Game))
+            {
+                Flags |= EMCPDependencyFlags::EditorOnly;
+            }
+        }
+        OutDependencies.Emplace(Dependency.AssetId.PackageName, Flags);
+    }
+}
+
+int32 FMCPAssetDependencyGraph::FindOrAddNode(FName PackageName)
+{
+    if (const int32* Existing = NodeByPackage.Find(PackageName))
+    {
+        return *Existing;
+    }
+
+    const int32 Node = Packages.Add(PackageName);
+    NodeByPackage.Add(PackageName, Node);
+    AssetCounts.Add(0);
+    Overridden.Add(false);
+    VisitMarks.Add(0);
+    return Node;
+}
+
+void FMCPAssetDependencyGraph::ReadEdges(const TArray<int32>& Nodes, TArray<TArray<FEdge>>& OutEdges)
+{
+    const IAssetRegistry& AssetRegistry = GetAssetRegistry();
+    TArray<TArray<TPair<FName, uint8>>> Dependencies;
+    Dependencies.SetNum(Nodes.Num());
+    ParallelFor(Nodes.Num(), [this, &AssetRegistry, &Nodes, &Dependencies](int32 Index)
+    {
+        ReadDependencies(AssetRegistry, Packages[Nodes[Index]], Dependencies[Index]);
+    });
+
+    // Targets become nodes here, one thread at a time
+    OutEdges.SetNum(Nodes.Num());
+    for (int32 Index = 0; Index < Nodes.Num(); ++Index)
+    {
+        TArray<FEdge>& Edges = OutEdges[Index];
+        Edges.Reset(Dependencies[Index].Num());
+        for (const TPair<FName, uint8>& Dependency : Dependencies[Index])
+        {
+            Edges.Add(FEdge{ FindOrAddNode(Dependency.Key), Dependency.Value });
+        }
+    }
+}
+
+void FMCPAssetDependencyGraph::BuildRows(TArray<TArray<FEdge>>& Edges)
+{
+    const int32 NodeCount = Packages.Num();
+    Edges.SetNum(NodeCount);
+
+    ForwardOffsets.SetNumUninitialized(NodeCount + 1);
+    TArray<int32> ReverseCounts;
+    ReverseCounts.SetNumZeroed(NodeCount + 1);
+    int32 EdgeCount = 0;
+    for (int32 Node = 0; Node < NodeCount; ++Node)
+    {
+        ForwardOffsets[Node] = EdgeCount;
+        EdgeCount += Edges[Node].Num();
+        for (const FEdge& Edge : Edges[Node])
+        {
+            ReverseCounts[Edge.Node + 1]++;
+        }
+    }
+    ForwardOffsets[NodeCount] = EdgeCount;
+
+    ForwardTargets.SetNumUninitialized(EdgeCount);
+    ForwardFlags.SetNumUninitialized(EdgeCount);
+    for (int32 Node = 0; Node < NodeCount; ++Node)
+    {
+        int32 Edge = ForwardOffsets[Node];
+        for (const FEdge& Source : Edges[Node])
+        {
+            ForwardTargets[Edge] = Source.Node;
+            ForwardFlags[Edge] = Source.Flags;
+            Edge++;
+        }
+    }
+
+    // Counting sort by target; sources stay in ascending order within each reverse row
+    ReverseOffsets.SetNumUninitialized(NodeCount + 1);
+    ReverseOffsets[0] = 0;
+    for (int32 Node = 0; Node < NodeCount; ++Node)
+    {
+        ReverseOffsets[Node + 1] = ReverseOffsets[Node] + ReverseCounts[Node + 1];
+    }
+    TArray<int32> Cursors(ReverseOffsets.GetData(), NodeCount);
+    ReverseSources.SetNumUninitialized(EdgeCount);
+    ReverseFlags.SetNumUninitialized(EdgeCount);
+    for (int32 Node = 0; Node < NodeCount; ++Node)
+    {
+        for (int32 Edge = ForwardOffsets[Node]; Edge < ForwardOffsets[Node + 1]; ++Edge)
+        {
+            const int32 Slot = Cursors[ForwardTargets[Edge]]++;
+            ReverseSources[Slot] = Node;
+            ReverseFlags[Slot] = ForwardFlags[Edge];
+        }
+    }
+
+    RowNodeCount = NodeCount;
+    ForwardOverrides.Reset();
+    ReverseAdditions.Reset();
+    Overridden.Init(false, NodeCount);
+}
+
+void FMCPAssetDependencyGraph::SetOverride(int32 Node, TArray<FEdge>&& Edges)
+{
+    if (const TArray<FEdge>* Previous = ForwardOverrides.Find(Node))
+    {
+        for (const FEdge& Edge : *Previous)
+        {
+            ReverseAdditions.FindChecked(Edge.Node).RemoveAllSwap([Node](const FEdge& Addition) { return Addition.Node == Node; });
+        }
+    }
+    for (const FEdge& Edge : Edges)
+    {
+        ReverseAdditions.FindOrAdd(Edge.Node).Add(FEdge{ Node, Edge.Flags });
+    }
+    Overridden[Node] = true;
+    ForwardOverrides.Add(Node, MoveTemp(Edges));
+}
+
+void FMCPAssetDependencyGraph::Build()
+{
+    FMCPAssetCatalog& Catalog = FMCPAssetCatalog::Get();
+    if (!Catalog.IsReady())
+    {
+        return;
+    }
+
+    const double StartTime = FPlatformTime::Seconds();
+    Reset();
+
+    SlotPackages.SetNum(Catalog.GetSlotCount());
+    for (int32 Index = 0; Index < SlotPackages.Num(); ++Index)
+    {
+        if (const FAssetData* AssetData = Catalog.GetAsset(Index))
+        {
+            SlotPackages[Index] = AssetData->PackageName;
+            AssetCounts[FindOrAddNode(AssetData->PackageName)]++;
+        }
+    }
+
+    TArray<int32> Sources;
+    Sources.SetNumUninitialized(Packages.Num());
+    for (int32 Node = 0; Node < Sources.Num(); ++Node)
+    {
+        Sources[Node] = Node;
+    }
+    TArray<TArray<FEdge>> Edges;
+    ReadEdges(Sources, Edges);
+    BuildRows(Edges);
+    bBuilt = true;
+
+    MCP_LOG_INFO("Built dependency graph of %d packages (%d with assets) and %d edges in %.1f ms",
+        Packages.Num(), Sources.Num(), ForwardTargets.Num(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+}
+
+void FMCPAssetDependencyGraph::HandleAssetAdded(int32 Index)
+{
+    const FAssetData* AssetData = FMCPAssetCatalog::Get().GetAsset(Index);
+    if (!bBuilt || !AssetData)
+    {
+        return;
+    }
+
+    if (Index >= SlotPackages.Num())
+    {
+        SlotPackages.SetNum(Index + 1);
+    }
+    SlotPackages[Index] = AssetData->PackageName;
+    AssetCounts[FindOrAddNode(AssetData->PackageName)]++;
+    PendingPackages.Add(AssetData->PackageName);
+}
+
+void FMCPAssetDependencyGraph::HandleAssetRemoved(int32 Index)
+{
+    if (!bBuilt || !SlotPackages.IsValidIndex(Index) || SlotPackages[Index].IsNone())
+    {
+        return;
+    }
+
+    const FName PackageName = SlotPackages[Index];
+    SlotPackages[Index] = NAME_None;
+    AssetCounts[NodeByPackage.FindChecked(PackageName)]--;
+    PendingPackages.Add(PackageName);
+}
+
+void FMCPAssetDependencyGraph::HandleCatalogRebuilt()
+{
+    // Slot indices are all new; the graph is rebuilt on the next query
+    Reset();
+}
@@ -0,0 +1,385 @@
+#include "MCPAssetSearch.h"
+
+#include "Algo/BinarySearch.h"
+#include "Algo/Sort.h"
+#include "Algo/Unique.h"
+#include "Async/ParallelFor.h"
+#include "MCPAssetCatalog.h"
+#include "MCPFileLogger.h"
+
+namespace
+{
+    // Weight of a query trigram found only in the path or only in tags and class, relative to one in the name
+    constexpr float PATH_MATCH_WEIGHT = 0.6f;
+    constexpr float TAG_MATCH_WEIGHT = 0.4f;
+
+    // Share of the score taken by name similarity; the rest is weighted coverage of the query
+    constexpr float NAME_SCORE_SHARE = 0.6f;
+
+    uint64 MakeTrigram(TCHAR A, TCHAR B, TCHAR C)
+    {
+        return (static_cast<uint64>(A) << 42) | (static_cast<uint64>(B) << 21) | static_cast<uint64>(C);
+    }
+
+    void AddWordTrigrams(const FString& Word, TArray<uint64>& OutTrigrams)
+    {
+        // " word " yields " wo", "wor", "ord", "rd ": word starts and ends weigh as much as their middles
+        const TCHAR Space = TEXT(' ');
+        const int32 Length = Word.Len();
+        for (int32 Start = -1; Start < Length - 1; ++Start)
+        {
+            const TCHAR A = Start < 0 ? Space : Word[Start];
+            const TCHAR B = Word[Start + 1];
+            const TCHAR C = Start + 2 < Length ? Word[Start + 2] : Space;
+            OutTrigrams.Add(MakeTrigram(A, B, C));
+        }
+    }
+}
+
+//
+// FMCPAssetSearchIndex
+//
+FMCPAssetSearchIndex& FMCPAssetSearchIndex::Get()
+{
+    static FMCPAssetSearchIndex Instance;
+    return Instance;
+}
+
+void FMCPAssetSearchIndex::Initialize()
+{
+    if (bInitialized)
+    {
+        return;
+    }
+
+    FMCPAssetCatalog& Catalog = FMCPAssetCatalog::Get();
+    AssetAddedHandle = Catalog.OnAssetAdded().AddRaw(this, &FMCPAssetSearchIndex::HandleAssetAdded);
+    AssetRemovedHandle = Catalog.OnAssetRemoved().AddRaw(this, &FMCPAssetSearchIndex::HandleAssetRemoved);
+    RebuiltHandle = Catalog.OnRebuilt().AddRaw(this, &FMCPAssetSearchIndex::HandleCatalogRebuilt);
+    bInitialized = true;
+
+    // Otherwise the catalog's rebuild notification starts the build
+    if (Catalog.IsReady())
+    {
+        Build();
+    }
+}
+
+void FMCPAssetSearchIndex::Shutdown()
+{
+    if (!bInitialized)
+    {
+        return;
+    }
+
+    FMCPAssetCatalog& Catalog = FMCPAssetCatalog::Get();
+    Catalog.OnAssetAdded().Remove(AssetAddedHandle);
+    Catalog.OnAssetRemoved().Remove(AssetRemovedHandle);
+    Catalog.OnRebuilt().Remove(RebuiltHandle);
+
+    Postings.Empty();
+    Slots.Empty();
+    Accumulators.Empty();
+    Touched.Empty();
+    bBuilt = false;
+    bInitialized = false;
+}
+
+void FMCPAssetSearchIndex::EnsureBuilt()
+{
+    check(IsInGameThread());
+
+    if (bBuilt)
+    {
+        return;
+    }
+
+    // Finishing a running catalog build notifies us and builds the index on the way
+    FMCPAssetCatalog::Get().EnsureReady();
+    if (!bBuilt)
+    {
+        Build();
+    }
+}
+
+int32 FMCPAssetSearchIndex::Search(const FString& Query, const FMCPAssetSearchOptions& Options, TArray<FMCPAssetSearchHit>& OutHits)
+{
+    OutHits.Reset();
+    EnsureBuilt();
+
+    TArray<uint64> QueryTrigrams;
+    ExtractTrigrams(Query.Left(MCPConstants::MAX_ASSET_SEARCH_QUERY_CHARS), QueryTrigrams);
+    const int32 QueryCount = QueryTrigrams.Num();
+    if (QueryCount == 0 || Options.MaxResults <= 0)
+    {
+        return 0;
+    }
+
+    // Count, per asset, the query trigrams it contains by walking only their posting lists
+    const TBitArray<>* AllowedSlots = Options.AllowedSlots;
+    for (const uint64 Trigram : QueryTrigrams)
+    {
+        const TArray<uint32>* Posting = Postings.Find(Trigram);
+        if (!Posting)
+        {
+            continue;
+        }
+
+        for (const uint32 Entry : *Posting)
+        {
+            const int32 Index = static_cast<int32>(Entry >> 3);
+            if (AllowedSlots && (Index >= AllowedSlots->Num() || !(*AllowedSlots)[Index]))
+            {
+                continue;
+            }
+
+            const uint8 Fields = static_cast<uint8>(Entry & 7);
+            FAccumulator& Accumulator = Accumulators[Index];
+            if (Accumulator.Hits == 0)
+            {
+                Touched.Add(Index);
+            }
+            Accumulator.Hits++;
+            Accumulator.Fields |= Fields;
+            if (Fields & EMCPAssetSearchField::Name)
+            {
+                Accumulator.NameHits++;
+                Accumulator.Weight += 1.0f;
+            }
+            else
+            {
+                Accumulator.Weight += (Fields & EMCPAssetSearchField::Path) ? PATH_MATCH_WEIGHT : TAG_MATCH_WEIGHT;
+            }
+        }
+    }
+
+    // Keep the best MaxResults in a heap whose top is the worst kept hit
+    const int32 MinHits = FMath::Max(1, FMath::CeilToInt(FMath::Clamp(Options.MinMatch, 0.0f, 1.0f) * QueryCount));
+    const auto WorseHit = [](const FMCPAssetSearchHit& A, const FMCPAssetSearchHit& B) { return A.Score < B.Score; };
+    int32 MatchCount = 0;
+    for (const int32 Index : Touched)
+    {
+        FAccumulator& Accumulator = Accumulators[Index];
+        if (Accumulator.Hits >= MinHits)
+        {
+            MatchCount++;
+
+            // Dice similarity of the name prefers "SM_Chair" over "SM_Chair_Broken_Legs" for "chair"
+            const float NameSimilarity = 2.0f * Accumulator.NameHits / static_cast<float>(QueryCount + Slots[Index].NameTrigramCount);
+            const float Coverage = Accumulator.Weight / QueryCount;
+
+            FMCPAssetSearchHit Hit;
+            Hit.Index = Index;
+            Hit.Score = NAME_SCORE_SHARE * NameSimilarity + (1.0f - NAME_SCORE_SHARE) * Coverage;
+            Hit.MatchedFields = Accumulator.Fields;
+
+            if (OutHits.Num() < Options.MaxResults)
+            {
+                OutHits.HeapPush(Hit, WorseHit);
+            }
+            else if (Hit.Score > OutHits.HeapTop().Score)
+            {
+                OutHits.HeapPopDiscard(WorseHit, EAllowShrinking::No);
+                OutHits.HeapPush(Hit, WorseHit);
+            }
+        }
+        Accumulator = FAccumulator();
+    }
+    Touched.Reset();
+
+    OutHits.Sort([](const FMCPAssetSearchHit& A, const FMCPAssetSearchHit& B)
+    {
+        return A.Score != B.Score ? A.Score > B.Score : A.Index < B.Index;
+    });
+    return MatchCount;
+}
+
+void FMCPAssetSearchIndex::ExtractTrigrams(const FString& Text, TArray<uint64>& OutTrigrams)
+{
+    OutTrigrams.Reset();
+
+    // Words break at separators, lower-to-upper case changes, letter-digit changes and before the last
+    // capital of an acronym, so "SM_WoodenChair03" and "HDRIBackdrop" split like a person would type them
+    FString Word;
+    const int32 Length = Text.Len();
+    for (int32 Position = 0; Position < Length; ++Position)
+    {
+        const TCHAR Char = Text[Position];
+        if (!FChar::IsAlnum(Char))
+        {
+            if (Word.Len() > 0)
+            {
+                AddWordTrigrams(Word, OutTrigrams);
+                Word.Reset();
+            }
+            continue;
+        }
+
+        if (Word.Len() > 0)
+        {
+            const TCHAR Previous = Text[Position - 1];
+            const bool bCaseChange = FChar::IsLower(Previous) && FChar::IsUpper(Char);
+            const bool bDigitChange = FChar::IsDigit(Previous) != FChar::IsDigit(Char);
+            const bool bAcronymEnd = FChar::IsUpper(Previous) && FChar::IsUpper(Char) && Position + 1 < Length && FChar::IsLower(Text[Position + 1]);
+            if (bCaseChange || bDigitChange || bAcronymEnd)
+            {
+                AddWordTrigrams(Word, OutTrigrams);
+                Word.Reset();
+            }
+        }
+        Word.AppendChar(FChar::ToLower(Char));
+    }
+    if (Word.Len() > 0)
+    {
+        AddWordTrigrams(Word, OutTrigrams);
+    }
+
+    Algo::Sort(OutTrigrams);
+    OutTrigrams.SetNum(Algo::Unique(OutTrigrams), EAllowShrinking::No);
+}
+
+void FMCPAssetSearchIndex::ExtractSlot(int32 Index, FSlot& OutSlot)
+{
+    OutSlot = FSlot();
+    const FAssetData* AssetData = FMCPAssetCatalog::Get().GetAsset(Index);
+    if (!AssetData)
+    {
+        return;
+    }
+
+    TMap<uint64, uint8> FieldsByTrigram;
+    TArray<uint64> Trigrams;
+    auto AddText = [&FieldsByTrigram, &Trigrams](const FString& Text, uint8 Field)
+    {
+        ExtractTrigrams(Text, Trigrams);
+        for (const uint64 Trigram : Trigrams)
+        {
+            FieldsByTrigram.FindOrAdd(Trigram) |= Field;
+        }
+    };
+
+    AddText(AssetData->AssetName.ToString(), EMCPAssetSearchField::Name);
+    OutSlot.NameTrigramCount = Trigrams.Num();
+    AddText(AssetData->PackagePath.ToString(), EMCPAssetSearchField::Path);
+    AddText(AssetData->AssetClassPath.GetAssetName().ToString(), EMCPAssetSearchField::Tags);
+
+    // Counts and sizes would only add noise; long values such as blueprint search data are not words
+    for (const auto& TagPair : AssetData->TagsAndValues)
+    {
+        const FString Value = TagPair.Value.AsString();
+        if (Value.Len() <= MCPConstants::MAX_SEARCH_TAG_VALUE_CHARS && !Value.IsNumeric())
+        {
+            AddText(Value, EMCPAssetSearchField::Tags);
+        }
+    }
+
+    OutSlot.Trigrams.Reserve(FieldsByTrigram.Num());
+    for (const TPair<uint64, uint8>& Entry : FieldsByTrigram)
+    {
+        OutSlot.Trigrams.Add(Entry);
+    }
+}
+
+void FMCPAssetSearchIndex::AddToPostings(int32 Index)
+{
+    if (Index >= Slots.Num())
+    {
+        Slots.SetNum(Index + 1);
+        Accumulators.SetNum(Index + 1);
+    }
+
+    // Postings stay sorted by slot; a reused slot lands in the middle, an appended one at the end
+    FSlot& Slot = Slots[Index];
+    ExtractSlot(Index, Slot);
+    for (const TPair<uint64, uint8>& Trigram : Slot.Trigrams)
+    {
+        const uint32 Entry = (static_cast<uint32>(Index) << 3) | Trigram.Value;
+        TArray<uint32>& Posting = Postings.FindOrAdd(Trigram.Key);
+        Posting.Insert(Entry, Algo::LowerBound(Posting, Entry));
+    }
+}
+
+void FMCPAssetSearchIndex::RemoveFromPostings(int32 Index)
+{
+    if (!Slots.IsValidIndex(Index))
+    {
+        return;
+    }
+
+    FSlot& Slot = Slots[Index];
+    for (const TPair<uint64, uint8>& Trigram : Slot.Trigrams)
+    {
+        if (TArray<uint32>* Posting = Postings.Find(Trigram.Key))
+        {
+            const uint32 Entry = (static_cast<uint32>(Index) << 3) | Trigram.Value;
+            const int32 Position = Algo::LowerBound(*Posting, Entry);
+            if (Posting->IsValidIndex(Position) && (*Posting)[Position] == Entry)
+            {
+                Posting->RemoveAt(Position, 1, EAllowShrinking::No);
+            }
+            if (Posting->Num() == 0)
+            {
+                Postings.Remove(Trigram.Key);
+            }
+        }
+    }
+    Slot = FSlot();
+}
+
+void FMCPAssetSearchIndex::Build()
+{
+    FMCPAssetCatalog& Catalog = FMCPAssetCatalog::Get();
+    if (!Catalog.IsReady())
+    {
+        return;
+    }
+
+    const double StartTime = FPlatformTime::Seconds();
+    Postings.Reset();
+    Slots.Reset();
+    Slots.SetNum(Catalog.GetSlotCount());
+    Accumulators.Reset();
+    Accumulators.SetNum(Slots.Num());
+    Touched.Reset();
+
+    // Splitting text is the expensive part and reads only the catalog, so it runs in parallel; merging does not
+    ParallelFor(Slots.Num(), [this](int32 Index)
+    {
+        ExtractSlot(Index, Slots[Index]);
+    });
+
+    // Appending in slot order leaves every posting list sorted
+    for (int32 Index = 0; Index < Slots.Num(); ++Index)
+    {
+        for (const TPair<uint64, uint8>& Trigram : Slots[Index].Trigrams)
+        {
+            Postings.FindOrAdd(Trigram.Key).Add((static_cast<uint32>(Index) << 3) | Trigram.Value);
+        }
+    }
+    bBuilt = true;
+
+    MCP_LOG_INFO("Asset search index built over %d assets with %d trigrams in %.1f ms",
+        Catalog.Num(), Postings.Num(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+}
+
+void FMCPAssetSearchIndex::HandleAssetAdded(int32 Index)
+{
+    if (bBuilt)
+    {
+        AddToPostings(Index);
+    }
+}
+
+void FMCPAssetSearchIndex::HandleAssetRemoved(int32 Index)
+{
+    if (bBuilt)
+    {
+        RemoveFromPostings(Index);
+    }
+}
+
+void FMCPAssetSearchIndex::HandleCatalogRebuilt()
+{
+    bBuilt = false;
+    Build();
+}
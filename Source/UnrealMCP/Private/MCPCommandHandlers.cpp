@@ -10,6 +10,13 @@
 #include "Misc/Paths.h"
 #include "Misc/Guid.h"
 #include "MCPConstants.h"
+#include "MCPSceneJournal.h"
+#include "MCPPackedData.h"
+#include "MCPSceneSnapshot.h"
+#include "MCPAssetSearch.h"
+#include "MCPAssetDependencies.h"
+#include "Algo/Sort.h"
+#include "Misc/PackageName.h"
 #include "AssetRegistry/AssetRegistryModule.h"
 #include "Kismet/GameplayStatics.h"
 #include "Kismet/KismetSystemLibrary.h"
@@ -17,6 +24,8 @@
 #include "Engine/BlueprintGeneratedClass.h"
 #include "Materials/MaterialInstanceConstant.h"
 #include "EditorAssetLibrary.h"   // 用于获取元数据标签
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
 
 
 //
@@ -27,186 +36,849 @@ TSharedPtr<FJsonObject> FMCPGetSceneInfoHandler::Execute(const TSharedPtr<FJsonO
     MCP_LOG_INFO("Handling get_scene_info command");
 
     UWorld *World = GEditor->GetEditorWorldContext().World();
-    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+
+    FMCPActorFilter Filter;
+    FString FilterError;
+    const TSharedPtr<FJsonObject>* FilterObject = nullptr;
+    if (Params->TryGetObjectField(FStringView(TEXT("filter")), FilterObject) && FilterObject && !Filter.Parse(*FilterObject, FilterError))
+    {
+        MCP_LOG_WARNING("Invalid filter in get_scene_info command: %s", *FilterError);
+        return CreateErrorResponse(FilterError);
+    }
+
+    FString Format;
+    if (Params->TryGetStringField(FStringView(TEXT("format")), Format) && Format == TEXT("columnar"))
+    {
+        return ExecuteColumnar(World, Params, Filter);
+    }
+
+    // The game thread only copies actor records; building the JSON happens on worker threads
+    FMCPSnapshotOptions Options;
+    Options.MaxRecords = MCPConstants::MAX_ACTORS_IN_SCENE_INFO;
+    Options.bIncludeBounds = false;
+    Options.Filter = &Filter;
+
+    TArray<FMCPActorRecord> Records;
+    const int32 TotalActorCount = FMCPSceneSnapshot::Capture(World, Options, Records);
+    const int32 ActorCount = Records.Num();
+    const bool bLimitReached = ActorCount < TotalActorCount;
+
+    if (bLimitReached)
+    {
+        MCP_LOG_WARNING("Actor limit reached (%d). Only returning %d of %d actors.",
+                        MCPConstants::MAX_ACTORS_IN_SCENE_INFO, ActorCount, TotalActorCount);
+    }
+
     TArray<TSharedPtr<FJsonValue>> ActorsArray;
+    ActorsArray.SetNum(ActorCount);
+    FMCPSceneSnapshot::ParallelForChunks(ActorCount, [&Records, &ActorsArray](int32 Start, int32 End)
+    {
+        for (int32 Index = Start; Index < End; ++Index)
+        {
+            const FMCPActorRecord& Record = Records[Index];
+            TSharedPtr<FJsonObject> ActorInfo = MakeShared<FJsonObject>();
+            ActorInfo->SetStringField("name", Record.Name.ToString());
+            ActorInfo->SetStringField("type", Record.Class->GetName());
+
+            // Add the actor label (user-facing friendly name)
+            ActorInfo->SetStringField("label", Record.Label);
+
+            // Add location
+            const FVector Location = Record.Transform.GetLocation();
+            TArray<TSharedPtr<FJsonValue>> LocationArray;
+            LocationArray.Add(MakeShared<FJsonValueNumber>(Location.X));
+            LocationArray.Add(MakeShared<FJsonValueNumber>(Location.Y));
+            LocationArray.Add(MakeShared<FJsonValueNumber>(Location.Z));
+            ActorInfo->SetArrayField("location", LocationArray);
+
+            ActorsArray[Index] = MakeShared<FJsonValueObject>(ActorInfo);
+        }
+    });
 
-    int32 ActorCount = 0;
-    int32 TotalActorCount = 0;
-    bool bLimitReached = false;
+    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+    Result->SetStringField("level", World->GetName());
+    // Clients pass this to get_scene_changes to receive only what changed after this dump
+    Result->SetNumberField("scene_version", static_cast<double>(FMCPSceneJournal::Get().GetCurrentVersion()));
+    Result->SetNumberField("actor_count", TotalActorCount);
+    Result->SetNumberField("returned_actor_count", ActorCount);
+    Result->SetBoolField("limit_reached", bLimitReached);
+    Result->SetArrayField("actors", ActorsArray);
+
+    MCP_LOG_INFO("Sending get_scene_info response with %d/%d actors", ActorCount, TotalActorCount);
+
+    return CreateSuccessResponse(Result);
+}
 
-    // First count the total number of actors
-    for (TActorIterator<AActor> CountIt(World); CountIt; ++CountIt)
+TArray<FString> FMCPGetSceneInfoHandler::GetFieldPriorities() const
+{
+    return { TEXT("columns"), TEXT("class_table"), TEXT("ids"), TEXT("classes"), TEXT("location"), TEXT("rotation"),
+        TEXT("scale"), TEXT("actors"), TEXT("bounds"), TEXT("labels") };
+}
+
+TSharedPtr<FJsonObject> FMCPGetSceneInfoHandler::ExecuteColumnar(UWorld* World, const TSharedPtr<FJsonObject>& Params, const FMCPActorFilter& Filter)
+{
+    bool bQuantize = false;
+    Params->TryGetBoolField(FStringView(TEXT("quantize")), bQuantize);
+
+    FMCPSnapshotOptions Options;
+    Options.MaxRecords = MCPConstants::MAX_ACTORS_IN_COLUMNAR_SCENE_INFO;
+    Options.Filter = &Filter;
+    Params->TryGetBoolField(FStringView(TEXT("include_bounds")), Options.bIncludeBounds);
+    Params->TryGetBoolField(FStringView(TEXT("include_labels")), Options.bIncludeLabels);
+    const bool bIncludeBounds = Options.bIncludeBounds;
+    const bool bIncludeLabels = Options.bIncludeLabels;
+
+    TArray<FMCPActorRecord> Records;
+    const int32 TotalActorCount = FMCPSceneSnapshot::Capture(World, Options, Records);
+    const int32 ActorCount = Records.Num();
+    const bool bLimitReached = ActorCount < TotalActorCount;
+
+    if (bLimitReached)
     {
-        TotalActorCount++;
+        MCP_LOG_WARNING("Columnar actor limit reached (%d). Only returning %d of %d actors.",
+                        MCPConstants::MAX_ACTORS_IN_COLUMNAR_SCENE_INFO, ActorCount, TotalActorCount);
     }
 
-    // Then collect actor info up to the limit
-    for (TActorIterator<AActor> It(World); It; ++It)
+    // Classes are sent once in a table and referenced by index; the table is tiny so build it up front
+    TArray<TSharedPtr<FJsonValue>> ClassTableArray;
+    TMap<const UClass*, uint32> ClassIndices;
+    TArray<uint32> Classes;
+    Classes.SetNumUninitialized(ActorCount);
+    for (int32 Index = 0; Index < ActorCount; ++Index)
     {
-        AActor *Actor = *It;
-        TSharedPtr<FJsonObject> ActorInfo = MakeShared<FJsonObject>();
-        ActorInfo->SetStringField("name", Actor->GetName());
-        ActorInfo->SetStringField("type", Actor->GetClass()->GetName());
+        const UClass* Class = Records[Index].Class;
+        const uint32* ClassIndex = ClassIndices.Find(Class);
+        if (!ClassIndex)
+        {
+            ClassIndex = &ClassIndices.Add(Class, ClassTableArray.Num());
+            ClassTableArray.Add(MakeShared<FJsonValueString>(Class->GetName()));
+        }
+        Classes[Index] = *ClassIndex;
+    }
 
-        // Add the actor label (user-facing friendly name)
-        ActorInfo->SetStringField("label", Actor->GetActorLabel());
+    TArray<TSharedPtr<FJsonValue>> IdsArray;
+    TArray<TSharedPtr<FJsonValue>> LabelsArray;
+    TArray<float> Locations;
+    TArray<float> Rotations;
+    TArray<float> Scales;
+    TArray<float> Bounds;
+    IdsArray.SetNum(ActorCount);
+    LabelsArray.SetNum(bIncludeLabels ? ActorCount : 0);
+    Locations.SetNumUninitialized(ActorCount * 3);
+    Rotations.SetNumUninitialized(ActorCount * 4);
+    Scales.SetNumUninitialized(ActorCount * 3);
+    Bounds.SetNumUninitialized(bIncludeBounds ? ActorCount * 6 : 0);
+
+    // Every column is written by index, so chunks land in record order without a merge step
+    FMCPSceneSnapshot::ParallelForChunks(ActorCount, [&](int32 Start, int32 End)
+    {
+        for (int32 Index = Start; Index < End; ++Index)
+        {
+            const FMCPActorRecord& Record = Records[Index];
+            IdsArray[Index] = MakeShared<FJsonValueString>(Record.Name.ToString());
+            if (bIncludeLabels)
+            {
+                LabelsArray[Index] = MakeShared<FJsonValueString>(Record.Label);
+            }
+
+            const FVector Location = Record.Transform.GetLocation();
+            float* LocationOut = &Locations[Index * 3];
+            LocationOut[0] = Location.X;
+            LocationOut[1] = Location.Y;
+            LocationOut[2] = Location.Z;
+
+            // Canonicalize to w >= 0 so the same rotation always packs to the same bits
+            FQuat Rotation = Record.Transform.GetRotation();
+            if (Rotation.W < 0.0)
+            {
+                Rotation = FQuat(-Rotation.X, -Rotation.Y, -Rotation.Z, -Rotation.W);
+            }
+            float* RotationOut = &Rotations[Index * 4];
+            RotationOut[0] = Rotation.X;
+            RotationOut[1] = Rotation.Y;
+            RotationOut[2] = Rotation.Z;
+            RotationOut[3] = Rotation.W;
+
+            const FVector Scale = Record.Transform.GetScale3D();
+            float* ScaleOut = &Scales[Index * 3];
+            ScaleOut[0] = Scale.X;
+            ScaleOut[1] = Scale.Y;
+            ScaleOut[2] = Scale.Z;
+
+            if (bIncludeBounds)
+            {
+                float* BoundsOut = &Bounds[Index * 6];
+                BoundsOut[0] = Record.Bounds.Min.X;
+                BoundsOut[1] = Record.Bounds.Min.Y;
+                BoundsOut[2] = Record.Bounds.Min.Z;
+                BoundsOut[3] = Record.Bounds.Max.X;
+                BoundsOut[4] = Record.Bounds.Max.Y;
+                BoundsOut[5] = Record.Bounds.Max.Z;
+            }
+        }
+    });
 
-        // Add location
-        FVector Location = Actor->GetActorLocation();
-        TArray<TSharedPtr<FJsonValue>> LocationArray;
-        LocationArray.Add(MakeShared<FJsonValueNumber>(Location.X));
-        LocationArray.Add(MakeShared<FJsonValueNumber>(Location.Y));
-        LocationArray.Add(MakeShared<FJsonValueNumber>(Location.Z));
-        ActorInfo->SetArrayField("location", LocationArray);
+    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+    TSharedPtr<FJsonObject> Columns = MakeShared<FJsonObject>();
 
-        ActorsArray.Add(MakeShared<FJsonValueObject>(ActorInfo));
-        ActorCount++;
-        if (ActorCount >= MCPConstants::MAX_ACTORS_IN_SCENE_INFO)
+    // Describes each packed column so clients can decode it with numpy.frombuffer(...).reshape(-1, stride)
+    auto AddColumn = [&Result, &Columns](const FString& Name, const FString& Encoded, const FString& DType, int32 Stride)
+    {
+        Result->SetStringField(Name, Encoded);
+        TSharedPtr<FJsonObject> Column = MakeShared<FJsonObject>();
+        Column->SetStringField("dtype", DType);
+        Column->SetNumberField("stride", Stride);
+        Columns->SetObjectField(Name, Column);
+    };
+
+    // Quantized ranges are reported per component so clients can dequantize with min + q / 65535 * (max - min)
+    auto AddUnormColumn = [&Result, &AddColumn](const FString& Name, const TArray<float>& Values, int32 Stride)
+    {
+        TArray<float> Min;
+        TArray<float> Max;
+        TArray<uint16> Quantized;
+        FMCPPackedData::QuantizeUnorm16(Values, Stride, Min, Max, Quantized);
+        AddColumn(Name, FMCPPackedData::EncodeUInt16s(Quantized), TEXT("<u2"), Stride);
+        Result->SetArrayField(Name + TEXT("_min"), FMCPPackedData::MakeNumberArray(Min));
+        Result->SetArrayField(Name + TEXT("_max"), FMCPPackedData::MakeNumberArray(Max));
+    };
+
+    AddColumn(TEXT("classes"), FMCPPackedData::EncodeUInt32s(Classes), TEXT("<u4"), 1);
+    if (bQuantize)
+    {
+        TArray<int16> QuantizedRotations;
+        FMCPPackedData::QuantizeSnorm16(Rotations, QuantizedRotations);
+
+        AddUnormColumn(TEXT("location"), Locations, 3);
+        AddColumn(TEXT("rotation"), FMCPPackedData::EncodeInt16s(QuantizedRotations), TEXT("<i2"), 4);
+        AddUnormColumn(TEXT("scale"), Scales, 3);
+        if (bIncludeBounds)
+        {
+            AddUnormColumn(TEXT("bounds"), Bounds, 6);
+        }
+    }
+    else
+    {
+        AddColumn(TEXT("location"), FMCPPackedData::EncodeFloats(Locations), TEXT("<f4"), 3);
+        AddColumn(TEXT("rotation"), FMCPPackedData::EncodeFloats(Rotations), TEXT("<f4"), 4);
+        AddColumn(TEXT("scale"), FMCPPackedData::EncodeFloats(Scales), TEXT("<f4"), 3);
+        if (bIncludeBounds)
         {
-            bLimitReached = true;
-            MCP_LOG_WARNING("Actor limit reached (%d). Only returning %d of %d actors.",
-                            MCPConstants::MAX_ACTORS_IN_SCENE_INFO, ActorCount, TotalActorCount);
-            break; // Limit for performance
+            AddColumn(TEXT("bounds"), FMCPPackedData::EncodeFloats(Bounds), TEXT("<f4"), 6);
         }
     }
 
     Result->SetStringField("level", World->GetName());
+    Result->SetNumberField("scene_version", static_cast<double>(FMCPSceneJournal::Get().GetCurrentVersion()));
+    Result->SetStringField("format", TEXT("columnar"));
+    Result->SetBoolField("quantized", bQuantize);
     Result->SetNumberField("actor_count", TotalActorCount);
     Result->SetNumberField("returned_actor_count", ActorCount);
     Result->SetBoolField("limit_reached", bLimitReached);
-    Result->SetArrayField("actors", ActorsArray);
+    Result->SetArrayField("ids", IdsArray);
+    if (bIncludeLabels)
+    {
+        Result->SetArrayField("labels", LabelsArray);
+    }
+    Result->SetArrayField("class_table", ClassTableArray);
+    Result->SetObjectField("columns", Columns);
 
-    MCP_LOG_INFO("Sending get_scene_info response with %d/%d actors", ActorCount, TotalActorCount);
+    MCP_LOG_INFO("Sending columnar get_scene_info response with %d/%d actors", ActorCount, TotalActorCount);
 
     return CreateSuccessResponse(Result);
 }
 
 TSharedPtr<FJsonObject> FMCPGetAsasetInfoHandler::Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket)
 {
-    const static TMap<FString, FTopLevelAssetPath> SupportedTypes = {
-                         {TEXT("StaticMesh"), FTopLevelAssetPath(TEXT("/Script/Engine"), TEXT("StaticMesh"))},
-                         {TEXT("Blueprint"), FTopLevelAssetPath(TEXT("/Script/Engine"), TEXT("Blueprint"))},
-                         {TEXT("Material"), FTopLevelAssetPath(TEXT("/Script/Engine"), TEXT("Material"))},
-                     };
-                     
     MCP_LOG_INFO("Handling get_asset_info command");
     TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
     TArray<TSharedPtr<FJsonValue>> ObjectsArray;
     int32 AssetCount = 0;
     int32 TotalAssetCount = 0;
-    bool bLimitReached = false;
+    
+    // Fields that need the asset loaded; everything else comes from the registry
+    TSet<FString> DeepFields;
+    const TArray<TSharedPtr<FJsonValue>>* DeepArray = nullptr;
+    if (Params->TryGetArrayField(FStringView(TEXT("deep")), DeepArray) && DeepArray)
+    {
+        for (const TSharedPtr<FJsonValue>& DeepValue : *DeepArray)
+        {
+            const FString Field = DeepValue->AsString();
+            if (Field != TEXT("bounds") && Field != TEXT("material_slots") && Field != TEXT("metadata"))
+            {
+                MCP_LOG_WARNING("Unknown deep field '%s' in get_asset_info command", *Field);
+                return CreateErrorResponse(FString::Printf(TEXT("Unknown deep field '%s'; expected bounds, material_slots or metadata"), *Field));
+            }
+            DeepFields.Add(Field);
+        }
+    }
 
-    FString Type;
-    if (!Params->TryGetStringField(FStringView(TEXT("type")), Type))
+    int32 PageSize = MCPConstants::DEFAULT_ASSET_PAGE_SIZE;
+    Params->TryGetNumberField(FStringView(TEXT("page_size")), PageSize);
+    PageSize = FMath::Clamp(PageSize, 1, MCPConstants::MAX_ACTORS_IN_ASSET_INFO);
+
+    // Served from the asset catalog, which is built in the background and follows registry events
+    FMCPAssetCatalog& Catalog = FMCPAssetCatalog::Get();
+    Catalog.EnsureReady();
+
+    // The first page runs the query and stores its sorted result; later pages only slice that result
+    const FMCPAssetResultSet* ResultSet = nullptr;
+    int32 Offset = 0;
+    FString PageCursor;
+    if (Params->TryGetStringField(FStringView(TEXT("page_cursor")), PageCursor))
     {
-        MCP_LOG_WARNING("Missing 'type' field in create_object command");
-        return CreateErrorResponse("Missing 'type' field");
+        FString ResultSetId;
+        FString OffsetString;
+        if (!PageCursor.Split(TEXT(":"), &ResultSetId, &OffsetString) || !OffsetString.IsNumeric())
+        {
+            return CreateErrorResponse(FString::Printf(TEXT("Malformed page cursor '%s'"), *PageCursor));
+        }
+        ResultSet = Catalog.FindResultSet(ResultSetId);
+        if (!ResultSet)
+        {
+            MCP_LOG_WARNING("Unknown or expired page cursor %s in get_asset_info command", *PageCursor);
+            return CreateErrorResponse(FString::Printf(TEXT("Unknown or expired page cursor '%s'; run the query again"), *PageCursor));
+        }
+        Offset = FCString::Atoi(*OffsetString);
     }
+    else
+    {
+        FMCPAssetQuery Query;
+        EMCPAssetSort SortBy = EMCPAssetSort::None;
+        bool bDescending = false;
+        FString Error;
+        if (!ParseQuery(Params, Query, SortBy, bDescending, Error))
+        {
+            MCP_LOG_WARNING("Invalid get_asset_info query: %s", *Error);
+            return CreateErrorResponse(Error);
+        }
+
+        TArray<int32> AssetIndices;
+        Catalog.Query(Query, AssetIndices);
+        Catalog.Sort(AssetIndices, SortBy, bDescending);
+        ResultSet = &Catalog.StoreResultSet(AssetIndices, SortBy);
+    }
+
+    TotalAssetCount = ResultSet->Assets.Num();
+    Offset = FMath::Clamp(Offset, 0, TotalAssetCount);
+    const int32 End = FMath::Min(Offset + PageSize, TotalAssetCount);
+    int32 RemovedCount = 0;
+
+    // Assets whose deep fields were requested; they are loaded after the listing, in batches
+    TArray<FAssetData> DeepAssets;
+    TArray<TSharedPtr<FJsonObject>> DeepAssetInfos;
     
-    // 1. 获取 AssetRegistry 模块
-    FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry");
-    IAssetRegistry& AssetRegistry = AssetRegistryModule.Get();
-
-    // 2. 确保资产数据已加载（编辑器环境下）
-#if WITH_EDITOR
-    AssetRegistry.SearchAllAssets(true);
-#endif
-    // 创建筛选器
-    FARFilter Filter;
-    FString PathFilter = TEXT("/Script/Engine");
-    // 路径筛选
-    Filter.PackagePaths.Add(FName(*PathFilter));
-    Filter.bRecursivePaths = true;
-
-    if ( Type == "StaticMesh")
-    {
-        // 获取 UStaticMesh 类的路径名并添加到过滤器
-        Filter.ClassPaths.Add(UStaticMesh::StaticClass()->GetClassPathName());
-    }else if ( Type == "Blueprint")
-    {
-        // 获取 UBlueprint 类的路径名并添加到过滤器
-        Filter.ClassPaths.Add(UBlueprint::StaticClass()->GetClassPathName());
-    }else if ( Type == "Material")
-    {
-        // 为了找到所有类型的材质, 我们同时筛选 UMaterial 和 UMaterialInstanceConstant
-        Filter.ClassPaths.Add(UMaterial::StaticClass()->GetClassPathName());
-        Filter.ClassPaths.Add(UMaterialInstanceConstant::StaticClass()->GetClassPathName());
-    }
-    // 3. 获取所有资产数据
-    TArray<FAssetData> AssetDataList;
-    AssetRegistry.GetAssets(Filter, AssetDataList);
-
-    TotalAssetCount = AssetDataList.Num();
-    
-    for (const FAssetData& AssetData : AssetDataList)
+    for (int32 Position = Offset; Position < End; ++Position)
     {
-        UObject* Asset = AssetData.GetAsset();
-        if (!Asset)
+        const int32 AssetIndex = Catalog.Find(ResultSet->Assets[Position]);
+        if (AssetIndex == INDEX_NONE)
         {
+            // Removed since the query ran
+            RemovedCount++;
             continue;
         }
+        const FAssetData& AssetData = *Catalog.GetAsset(AssetIndex);
 
-        // 4. 为每个资产创建 JSON 对象
+        // 为每个资产创建 JSON 对象
         TSharedPtr<FJsonObject> AssetInfo = MakeShareable(new FJsonObject);
         
-        // 5. 添加基本资产信息
+        // 添加基本资产信息
         AssetInfo->SetStringField("AssetName", AssetData.AssetName.ToString());
         AssetInfo->SetStringField("ObjectPath", AssetData.GetObjectPathString());
         AssetInfo->SetStringField("AssetClass", AssetData.AssetClassPath.ToString());
+        AssetInfo->SetBoolField("loaded", AssetData.IsAssetLoaded());
+        if (ResultSet->SortBy == EMCPAssetSort::Size)
+        {
+            AssetInfo->SetNumberField("package_size", Catalog.GetPackageSize(AssetIndex));
+        }
+        else if (ResultSet->SortBy == EMCPAssetSort::Modified)
+        {
+            AssetInfo->SetStringField("modified", Catalog.GetModifiedTime(AssetIndex).ToIso8601());
+        }
 
-        // b. 资产标签 (非常重要！)
-        TArray<TSharedPtr<FJsonValue>> TagsArray;
-        TMap<FName, FString> Tags = UEditorAssetLibrary::GetMetadataTagValues(Asset);
-        for (const auto& TagPair : Tags)
-        {
-            TagsArray.Add(MakeShared<FJsonValueString>(TagPair.Key.ToString()));
-        }
-        AssetInfo->SetArrayField("tags", TagsArray);
-
-        // c. 根据不同资产类型，添加特定信息
-        if (UStaticMesh* StaticMesh = Cast<UStaticMesh>(Asset))
-        {
-            // 物理尺寸 (边界框)
-            FBox BoundingBox = StaticMesh->GetBoundingBox();
-            TSharedPtr<FJsonObject> BoundingBoxJson = MakeShared<FJsonObject>();
-            BoundingBoxJson->SetStringField("min", BoundingBox.Min.ToString());
-            BoundingBoxJson->SetStringField("max", BoundingBox.Max.ToString());
-            BoundingBoxJson->SetStringField("size", BoundingBox.GetSize().ToString());
-            AssetInfo->SetObjectField("dimensions", BoundingBoxJson);
-            
-            // 材质插槽信息
-            TArray<TSharedPtr<FJsonValue>> MaterialSlotsArray;
-            for (const FStaticMaterial& MaterialSlot : StaticMesh->GetStaticMaterials())
+        // Registry tags are written when the asset is saved, so they are read without loading it:
+        // triangle and vertex counts, approximate size and material count of meshes, parent class of blueprints
+        TSharedPtr<FJsonObject> TagsJson = MakeShared<FJsonObject>();
+        for (const auto& TagPair : AssetData.TagsAndValues)
+        {
+            FString Value = TagPair.Value.AsString();
+            if (Value.Len() <= MCPConstants::MAX_ASSET_TAG_VALUE_CHARS)
             {
-                TSharedPtr<FJsonObject> SlotJson = MakeShared<FJsonObject>();
-                SlotJson->SetStringField("slot_name", MaterialSlot.MaterialSlotName.ToString());
-                if (MaterialSlot.MaterialInterface)
-                {
-                    SlotJson->SetStringField("default_material", MaterialSlot.MaterialInterface->GetPathName());
-                }
-                MaterialSlotsArray.Add(MakeShared<FJsonValueObject>(SlotJson));
+                TagsJson->SetStringField(TagPair.Key.ToString(), MoveTemp(Value));
             }
-            AssetInfo->SetArrayField("material_slots", MaterialSlotsArray);
+        }
+        AssetInfo->SetObjectField("tags", TagsJson);
+
+        if (DeepFields.Num() > 0 && DeepAssets.Num() < MCPConstants::MAX_ASSETS_WITH_DEEP_INFO)
+        {
+            DeepAssets.Add(AssetData);
+            DeepAssetInfos.Add(AssetInfo);
         }
         
-        // 6. 添加资产到数组
+        // 添加资产到数组
         ObjectsArray.Add(MakeShareable(new FJsonValueObject(AssetInfo)));
         AssetCount++;
-        if (AssetCount >= MCPConstants::MAX_ACTORS_IN_ASSET_INFO)
-        {
-            bLimitReached = true;
-            MCP_LOG_WARNING("Actor limit reached (%d). Only returning %d of %d actors.",
-                            MCPConstants::MAX_ACTORS_IN_SCENE_INFO, AssetCount, TotalAssetCount);
-            break; // Limit for performance
-        }
     }
 
+    if (DeepAssets.Num() > 0)
+    {
+        AddDeepInfo(DeepAssets, DeepAssetInfos, DeepFields);
+    }
 
+    const bool bMorePages = End < TotalAssetCount;
     Result->SetNumberField("returned_asset_count", AssetCount);
-    Result->SetBoolField("limit_reached", bLimitReached);
+    Result->SetNumberField("total_asset_count", TotalAssetCount);
+    Result->SetNumberField("offset", Offset);
+    Result->SetBoolField("limit_reached", bMorePages);
+    if (bMorePages)
+    {
+        Result->SetStringField("next_page_cursor", FString::Printf(TEXT("%s:%d"), *ResultSet->Id, End));
+    }
+    if (RemovedCount > 0)
+    {
+        Result->SetNumberField("removed_since_query", RemovedCount);
+    }
+    // Assets added or changed after the query are not in its result; a new query picks them up
+    Result->SetBoolField("stale", ResultSet->Version != Catalog.GetVersion());
+    if (DeepFields.Num() > 0)
+    {
+        Result->SetNumberField("deep_info_count", DeepAssets.Num());
+    }
     Result->SetArrayField("assets", ObjectsArray);
 
-    MCP_LOG_INFO("Sending get_scene_info response with %d assets", AssetCount);
+    MCP_LOG_INFO("Sending get_asset_info response with %d assets (%d loaded for deep fields)", AssetCount, DeepAssets.Num());
+    return CreateSuccessResponse(Result);
+}
+
+bool FMCPGetAsasetInfoHandler::ParseQuery(const TSharedPtr<FJsonObject>& Params, FMCPAssetQuery& OutQuery, EMCPAssetSort& OutSortBy, bool& bOutDescending, FString& OutError)
+{
+    // Classes by path (/Script/Engine.StaticMesh) or short name (StaticMesh)
+    auto AddClass = [&OutQuery, &OutError](const FString& ClassName)
+    {
+        const FTopLevelAssetPath ClassPath = ClassName.StartsWith(TEXT("/"))
+            ? FTopLevelAssetPath(ClassName)
+            : UClass::TryConvertShortTypeNameToPathName<UClass>(ClassName, ELogVerbosity::NoLogging);
+        if (!ClassPath.IsValid())
+        {
+            OutError = FString::Printf(TEXT("Unknown asset class '%s'"), *ClassName);
+            return false;
+        }
+        OutQuery.ClassPaths.AddUnique(ClassPath);
+        return true;
+    };
+
+    FString Type;
+    if (Params->TryGetStringField(FStringView(TEXT("type")), Type) && !Type.IsEmpty())
+    {
+        if (Type == TEXT("Material"))
+        {
+            // 为了找到所有类型的材质, 我们同时筛选 UMaterial 和 UMaterialInstanceConstant
+            OutQuery.ClassPaths.Add(UMaterial::StaticClass()->GetClassPathName());
+            OutQuery.ClassPaths.Add(UMaterialInstanceConstant::StaticClass()->GetClassPathName());
+        }
+        else if (!AddClass(Type))
+        {
+            return false;
+        }
+    }
+
+    const TArray<TSharedPtr<FJsonValue>>* ClassesArray = nullptr;
+    if (Params->TryGetArrayField(FStringView(TEXT("classes")), ClassesArray) && ClassesArray)
+    {
+        for (const TSharedPtr<FJsonValue>& ClassValue : *ClassesArray)
+        {
+            if (!AddClass(ClassValue->AsString()))
+            {
+                return false;
+            }
+        }
+    }
+
+    OutQuery.bIncludeSubclasses = true;
+    Params->TryGetBoolField(FStringView(TEXT("include_subclasses")), OutQuery.bIncludeSubclasses);
+
+    const TArray<TSharedPtr<FJsonValue>>* PathsArray = nullptr;
+    if (Params->TryGetArrayField(FStringView(TEXT("paths")), PathsArray) && PathsArray)
+    {
+        for (const TSharedPtr<FJsonValue>& PathValue : *PathsArray)
+        {
+            const FString Path = PathValue->AsString();
+            if (!Path.StartsWith(TEXT("/")))
+            {
+                OutError = FString::Printf(TEXT("Package path '%s' must start with '/', e.g. /Game/Props"), *Path);
+                return false;
+            }
+            OutQuery.PackagePaths.Add(FName(*Path));
+        }
+    }
+    OutQuery.bRecursivePaths = true;
+    Params->TryGetBoolField(FStringView(TEXT("recursive")), OutQuery.bRecursivePaths);
+
+    OutSortBy = EMCPAssetSort::None;
+    FString Sort;
+    if (Params->TryGetStringField(FStringView(TEXT("sort")), Sort))
+    {
+        if (Sort == TEXT("name"))
+        {
+            OutSortBy = EMCPAssetSort::Name;
+        }
+        else if (Sort == TEXT("path"))
+        {
+            OutSortBy = EMCPAssetSort::Path;
+        }
+        else if (Sort == TEXT("size"))
+        {
+            OutSortBy = EMCPAssetSort::Size;
+        }
+        else if (Sort == TEXT("modified"))
+        {
+            OutSortBy = EMCPAssetSort::Modified;
+        }
+        else
+        {
+            OutError = FString::Printf(TEXT("Unknown sort '%s'; expected name, path, size or modified"), *Sort);
+            return false;
+        }
+    }
+    bOutDescending = false;
+    Params->TryGetBoolField(FStringView(TEXT("descending")), bOutDescending);
+    return true;
+}
+
+void FMCPGetAsasetInfoHandler::AddDeepInfo(const TArray<FAssetData>& Assets, const TArray<TSharedPtr<FJsonObject>>& AssetInfos, const TSet<FString>& DeepFields)
+{
+    FStreamableManager& StreamableManager = UAssetManager::GetStreamableManager();
+
+    for (int32 Start = 0; Start < Assets.Num(); Start += MCPConstants::ASSET_INFO_LOAD_BATCH)
+    {
+        const int32 End = FMath::Min(Start + MCPConstants::ASSET_INFO_LOAD_BATCH, Assets.Num());
+
+        // One request per batch streams the packages in parallel, and the batch blocks until they are all in;
+        // releasing the handle afterwards lets GC reclaim them
+        TArray<FSoftObjectPath> PathsToLoad;
+        for (int32 Index = Start; Index < End; ++Index)
+        {
+            if (!Assets[Index].IsAssetLoaded())
+            {
+                PathsToLoad.Add(Assets[Index].GetSoftObjectPath());
+            }
+        }
+
+        TSharedPtr<FStreamableHandle> Handle;
+        if (PathsToLoad.Num() > 0)
+        {
+            Handle = StreamableManager.RequestAsyncLoad(PathsToLoad, FStreamableDelegate(), FStreamableManager::AsyncLoadHighPriority);
+            if (Handle.IsValid())
+            {
+                Handle->WaitUntilComplete();
+            }
+        }
+
+        for (int32 Index = Start; Index < End; ++Index)
+        {
+            const TSharedPtr<FJsonObject>& AssetInfo = AssetInfos[Index];
+            UObject* Asset = Assets[Index].GetSoftObjectPath().ResolveObject();
+            if (!Asset)
+            {
+                AssetInfo->SetStringField("load_error", TEXT("Failed to load asset"));
+                continue;
+            }
+
+            // b. 资产元数据标签
+            if (DeepFields.Contains(TEXT("metadata")))
+            {
+                TSharedPtr<FJsonObject> MetadataJson = MakeShared<FJsonObject>();
+                for (const TPair<FName, FString>& TagPair : UEditorAssetLibrary::GetMetadataTagValues(Asset))
+                {
+                    MetadataJson->SetStringField(TagPair.Key.ToString(), TagPair.Value);
+                }
+                AssetInfo->SetObjectField("metadata", MetadataJson);
+            }
+
+            // c. 根据不同资产类型，添加特定信息
+            if (UStaticMesh* StaticMesh = Cast<UStaticMesh>(Asset))
+            {
+                if (DeepFields.Contains(TEXT("bounds")))
+                {
+                    // 物理尺寸 (边界框)
+                    FBox BoundingBox = StaticMesh->GetBoundingBox();
+                    TSharedPtr<FJsonObject> BoundingBoxJson = MakeShared<FJsonObject>();
+                    BoundingBoxJson->SetStringField("min", BoundingBox.Min.ToString());
+                    BoundingBoxJson->SetStringField("max", BoundingBox.Max.ToString());
+                    BoundingBoxJson->SetStringField("size", BoundingBox.GetSize().ToString());
+                    AssetInfo->SetObjectField("dimensions", BoundingBoxJson);
+                }
+
+                if (DeepFields.Contains(TEXT("material_slots")))
+                {
+                    // 材质插槽信息
+                    TArray<TSharedPtr<FJsonValue>> MaterialSlotsArray;
+                    for (const FStaticMaterial& MaterialSlot : StaticMesh->GetStaticMaterials())
+                    {
+                        TSharedPtr<FJsonObject> SlotJson = MakeShared<FJsonObject>();
+                        SlotJson->SetStringField("slot_name", MaterialSlot.MaterialSlotName.ToString());
+                        if (MaterialSlot.MaterialInterface)
+                        {
+                            SlotJson->SetStringField("default_material", MaterialSlot.MaterialInterface->GetPathName());
+                        }
+                        MaterialSlotsArray.Add(MakeShared<FJsonValueObject>(SlotJson));
+                    }
+                    AssetInfo->SetArrayField("material_slots", MaterialSlotsArray);
+                }
+            }
+        }
+
+        if (Handle.IsValid())
+        {
+            Handle->ReleaseHandle();
+        }
+    }
+}
+
+//
+// FMCPSearchAssetsHandler
+//
+TSharedPtr<FJsonObject> FMCPSearchAssetsHandler::Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket)
+{
+    MCP_LOG_INFO("Handling search_assets command");
+
+    FString QueryText;
+    if (!Params->TryGetStringField(FStringView(TEXT("query")), QueryText) || QueryText.TrimStartAndEnd().IsEmpty())
+    {
+        MCP_LOG_WARNING("Missing 'query' field in search_assets command");
+        return CreateErrorResponse(TEXT("Missing 'query' field"));
+    }
+
+    FMCPAssetSearchOptions Options;
+    Params->TryGetNumberField(FStringView(TEXT("max_results")), Options.MaxResults);
+    Options.MaxResults = FMath::Clamp(Options.MaxResults, 1, MCPConstants::MAX_ASSET_SEARCH_RESULTS);
+    double MinMatch = Options.MinMatch;
+    if (Params->TryGetNumberField(FStringView(TEXT("min_match")), MinMatch))
+    {
+        Options.MinMatch = FMath::Clamp(static_cast<float>(MinMatch), 0.0f, 1.0f);
+    }
+
+    // The same class and path predicates as get_asset_info narrow the search through the catalog's indexes
+    FMCPAssetQuery Query;
+    EMCPAssetSort SortBy = EMCPAssetSort::None;
+    bool bDescending = false;
+    FString Error;
+    if (!FMCPGetAsasetInfoHandler::ParseQuery(Params, Query, SortBy, bDescending, Error))
+    {
+        MCP_LOG_WARNING("Invalid search_assets filter: %s", *Error);
+        return CreateErrorResponse(Error);
+    }
+
+    FMCPAssetCatalog& Catalog = FMCPAssetCatalog::Get();
+    FMCPAssetSearchIndex& SearchIndex = FMCPAssetSearchIndex::Get();
+    SearchIndex.EnsureBuilt();
+
+    TBitArray<> AllowedSlots;
+    if (Query.ClassPaths.Num() > 0 || Query.PackagePaths.Num() > 0)
+    {
+        TArray<int32> Indices;
+        Catalog.Query(Query, Indices);
+        AllowedSlots.Init(false, Catalog.GetSlotCount());
+        for (const int32 Index : Indices)
+        {
+            AllowedSlots[Index] = true;
+        }
+        Options.AllowedSlots = &AllowedSlots;
+    }
+
+    const double StartTime = FPlatformTime::Seconds();
+    TArray<FMCPAssetSearchHit> Hits;
+    const int32 MatchCount = SearchIndex.Search(QueryText, Options, Hits);
+    const double SearchMicroseconds = (FPlatformTime::Seconds() - StartTime) * 1000000.0;
+
+    TArray<TSharedPtr<FJsonValue>> AssetsArray;
+    AssetsArray.Reserve(Hits.Num());
+    for (const FMCPAssetSearchHit& Hit : Hits)
+    {
+        const FAssetData& AssetData = *Catalog.GetAsset(Hit.Index);
+        TSharedPtr<FJsonObject> AssetInfo = MakeShared<FJsonObject>();
+        AssetInfo->SetStringField("AssetName", AssetData.AssetName.ToString());
+        AssetInfo->SetStringField("ObjectPath", AssetData.GetObjectPathString());
+        AssetInfo->SetStringField("AssetClass", AssetData.AssetClassPath.ToString());
+        AssetInfo->SetNumberField("score", FMath::RoundToDouble(Hit.Score * 1000.0) / 1000.0);
+
+        TArray<TSharedPtr<FJsonValue>> MatchedArray;
+        if (Hit.MatchedFields & EMCPAssetSearchField::Name)
+        {
+            MatchedArray.Add(MakeShared<FJsonValueString>(TEXT("name")));
+        }
+        if (Hit.MatchedFields & EMCPAssetSearchField::Path)
+        {
+            MatchedArray.Add(MakeShared<FJsonValueString>(TEXT("path")));
+        }
+        if (Hit.MatchedFields & EMCPAssetSearchField::Tags)
+        {
+            MatchedArray.Add(MakeShared<FJsonValueString>(TEXT("tags")));
+        }
+        AssetInfo->SetArrayField("matched", MatchedArray);
+        AssetsArray.Add(MakeShared<FJsonValueObject>(AssetInfo));
+    }
+
+    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+    Result->SetNumberField("returned_asset_count", Hits.Num());
+    Result->SetNumberField("match_count", MatchCount);
+    Result->SetNumberField("search_microseconds", FMath::RoundToDouble(SearchMicroseconds));
+    Result->SetArrayField("assets", AssetsArray);
+
+    MCP_LOG_INFO("search_assets '%s' matched %d assets in %.0f us", *QueryText, MatchCount, SearchMicroseconds);
+    return CreateSuccessResponse(Result);
+}
+
+//
+// FMCPGetAssetDependenciesHandler
+//
+TSharedPtr<FJsonObject> FMCPGetAssetDependenciesHandler::Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket)
+{
+    MCP_LOG_INFO("Handling %s command", *GetCommandName());
+
+    TArray<FString> AssetNames;
+    if (!Params->TryGetStringArrayField(FStringView(TEXT("assets")), AssetNames) || AssetNames.Num() == 0)
+    {
+        MCP_LOG_WARNING("Missing 'assets' field in %s command", *GetCommandName());
+        return CreateErrorResponse(TEXT("Missing 'assets' field: package names or object paths"));
+    }
+
+    FMCPDependencyQuery Query;
+    Query.bReverse = bReverse;
+    Params->TryGetNumberField(FStringView(TEXT("depth")), Query.MaxDepth);
+    Query.MaxDepth = FMath::Max(Query.MaxDepth, 0);
+    Params->TryGetBoolField(FStringView(TEXT("include_editor_only")), Query.bIncludeEditorOnly);
+
+    const TArray<TSharedPtr<FJsonValue>>* CategoriesArray = nullptr;
+    if (Params->TryGetArrayField(FStringView(TEXT("categories")), CategoriesArray) && CategoriesArray)
+    {
+        Query.Kinds = 0;
+        for (const TSharedPtr<FJsonValue>& CategoryValue : *CategoriesArray)
+        {
+            const FString Category = CategoryValue->AsString();
+            if (Category == TEXT("hard"))
+            {
+                Query.Kinds |= EMCPDependencyFlags::Hard;
+            }
+            else if (Category == TEXT("soft"))
+            {
+                Query.Kinds |= EMCPDependencyFlags::Soft;
+            }
+            else if (Category == TEXT("manage"))
+            {
+                Query.Kinds |= EMCPDependencyFlags::Manage;
+            }
+            else
+            {
+                return CreateErrorResponse(FString::Printf(TEXT("Unknown category '%s'; expected hard, soft or manage"), *Category));
+            }
+        }
+    }
+
+    bool bIncludeScriptPackages = false;
+    Params->TryGetBoolField(FStringView(TEXT("include_script_packages")), bIncludeScriptPackages);
+    int32 MaxResults = MCPConstants::DEFAULT_DEPENDENCY_RESULTS;
+    Params->TryGetNumberField(FStringView(TEXT("max_results")), MaxResults);
+    MaxResults = FMath::Clamp(MaxResults, 1, MCPConstants::MAX_DEPENDENCY_RESULTS);
+
+    FMCPAssetDependencyGraph& Graph = FMCPAssetDependencyGraph::Get();
+    const double UpdateStartTime = FPlatformTime::Seconds();
+    const bool bGraphRebuilt = Graph.EnsureCurrent();
+    const double UpdateMilliseconds = (FPlatformTime::Seconds() - UpdateStartTime) * 1000.0;
+
+    // Object paths name their package; anything else is taken as a package name
+    TArray<TSharedPtr<FJsonValue>> UnknownArray;
+    for (const FString& AssetName : AssetNames)
+    {
+        const FString PackageName = FPackageName::IsValidObjectPath(AssetName) ? FPackageName::ObjectPathToPackageName(AssetName) : AssetName;
+        const int32 Node = Graph.FindPackage(FName(*PackageName, FNAME_Find));
+        if (Node == INDEX_NONE)
+        {
+            UnknownArray.Add(MakeShared<FJsonValueString>(AssetName));
+        }
+        else
+        {
+            Query.Roots.Add(Node);
+        }
+    }
+
+    const double StartTime = FPlatformTime::Seconds();
+    TArray<FMCPDependencyHit> Hits;
+    const int32 MaxDepthReached = Graph.Traverse(Query, Hits);
+    const double QueryMicroseconds = (FPlatformTime::Seconds() - StartTime) * 1000000.0;
+
+    if (!bIncludeScriptPackages)
+    {
+        Hits.RemoveAll([&Graph](const FMCPDependencyHit& Hit) { return FPackageName::IsScriptPackage(Graph.GetPackage(Hit.Node).ToString()); });
+    }
+    const int32 TotalCount = Hits.Num();
+    const int32 ReturnedCount = FMath::Min(TotalCount, MaxResults);
+
+    // Breadth-first order keeps the nearest packages when the list is cut; within a depth they are listed by name
+    TArrayView<FMCPDependencyHit> Returned(Hits.GetData(), ReturnedCount);
+    Algo::Sort(Returned, [&Graph](const FMCPDependencyHit& A, const FMCPDependencyHit& B)
+    {
+        return A.Depth != B.Depth ? A.Depth < B.Depth : Graph.GetPackage(A.Node).LexicalLess(Graph.GetPackage(B.Node));
+    });
+
+    TArray<TSharedPtr<FJsonValue>> PackagesArray;
+    PackagesArray.Reserve(ReturnedCount);
+    for (const FMCPDependencyHit& Hit : Returned)
+    {
+        const FString PackageName = Graph.GetPackage(Hit.Node).ToString();
+        TSharedPtr<FJsonObject> PackageInfo = MakeShared<FJsonObject>();
+        PackageInfo->SetStringField("package", PackageName);
+        PackageInfo->SetNumberField("depth", Hit.Depth);
+        PackageInfo->SetStringField("via", Graph.GetPackage(Hit.Via).ToString());
+
+        TArray<TSharedPtr<FJsonValue>> KindsArray;
+        if (Hit.Flags & EMCPDependencyFlags::Hard)
+        {
+            KindsArray.Add(MakeShared<FJsonValueString>(TEXT("hard")));
+        }
+        if (Hit.Flags & EMCPDependencyFlags::Soft)
+        {
+            KindsArray.Add(MakeShared<FJsonValueString>(TEXT("soft")));
+        }
+        if (Hit.Flags & EMCPDependencyFlags::Manage)
+        {
+            KindsArray.Add(MakeShared<FJsonValueString>(TEXT("manage")));
+        }
+        if (Hit.Flags & EMCPDependencyFlags::EditorOnly)
+        {
+            KindsArray.Add(MakeShared<FJsonValueString>(TEXT("editor_only")));
+        }
+        PackageInfo->SetArrayField("kinds", KindsArray);
+
+        // A referenced content package without assets in the catalog is a broken reference
+        if (Graph.GetAssetCount(Hit.Node) == 0 && !FPackageName::IsScriptPackage(PackageName))
+        {
+            PackageInfo->SetBoolField("missing", true);
+        }
+        PackagesArray.Add(MakeShared<FJsonValueObject>(PackageInfo));
+    }
+
+    TSharedPtr<FJsonObject> GraphInfo = MakeShared<FJsonObject>();
+    GraphInfo->SetNumberField("package_count", Graph.GetNodeCount());
+    GraphInfo->SetNumberField("edge_count", Graph.GetEdgeCount());
+    GraphInfo->SetNumberField("changed_package_count", Graph.GetOverlayCount());
+    GraphInfo->SetBoolField("rebuilt", bGraphRebuilt);
+    GraphInfo->SetNumberField("update_ms", FMath::RoundToDouble(UpdateMilliseconds * 10.0) / 10.0);
+
+    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+    Result->SetArrayField("packages", PackagesArray);
+    Result->SetNumberField("total_count", TotalCount);
+    Result->SetNumberField("returned_count", ReturnedCount);
+    Result->SetBoolField("truncated", ReturnedCount < TotalCount);
+    Result->SetNumberField("max_depth_reached", MaxDepthReached);
+    Result->SetNumberField("query_microseconds", FMath::RoundToDouble(QueryMicroseconds));
+    Result->SetObjectField("graph", GraphInfo);
+    if (UnknownArray.Num() > 0)
+    {
+        Result->SetArrayField("unknown", UnknownArray);
+    }
+
+    MCP_LOG_INFO("%s reached %d packages from %d roots in %.0f us", *GetCommandName(), TotalCount, Query.Roots.Num(), QueryMicroseconds);
     return CreateSuccessResponse(Result);
 }
 
@@ -590,6 +1262,9 @@ TSharedPtr<FJsonObject> FMCPModifyObjectHandler::Execute(const TSharedPtr<FJsonO
 
     if (bModified)
     {
+        // SetActor* does not broadcast the editor move delegates, so record the change ourselves
+        FMCPSceneJournal::Get().RecordChange(EMCPSceneChangeType::Transform, Actor);
+
         // Create a result object with the actor name
         TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
         Result->SetStringField("name", Actor->GetName());
@@ -0,0 +1,348 @@
+#include "MCPCommandHandlers_Properties.h"
+
+#include "Editor.h"
+#include "GameFramework/Actor.h"
+#include "Components/ActorComponent.h"
+#include "JsonObjectConverter.h"
+#include "ScopedTransaction.h"
+#include "UObject/UnrealType.h"
+#include "MCPFileLogger.h"
+#include "MCPConstants.h"
+#include "MCPPropertyPath.h"
+#include "MCPSceneJournal.h"
+#include "MCPCommandHandlers_Scene.h"
+
+#define LOCTEXT_NAMESPACE "MCPPropertyCommands"
+
+namespace
+{
+    bool TryGetPaths(const TSharedPtr<FJsonObject>& Params, TArray<FString>& OutPaths)
+    {
+        const TArray<TSharedPtr<FJsonValue>>* PathsPtr = nullptr;
+        if (!Params->TryGetArrayField(FStringView(TEXT("paths")), PathsPtr) || !PathsPtr || PathsPtr->Num() == 0)
+        {
+            return false;
+        }
+        for (const TSharedPtr<FJsonValue>& Value : *PathsPtr)
+        {
+            OutPaths.Add(Value->AsString());
+        }
+        return true;
+    }
+}
+
+//
+// FMCPGetPropertiesHandler
+//
+TSharedPtr<FJsonObject> FMCPGetPropertiesHandler::Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket)
+{
+    MCP_LOG_INFO("Handling get_properties command");
+
+    UWorld* World = GEditor->GetEditorWorldContext().World();
+
+    TArray<FString> Paths;
+    if (!TryGetPaths(Params, Paths))
+    {
+        MCP_LOG_WARNING("Missing 'paths' field in get_properties command");
+        return CreateErrorResponse("Missing 'paths' field");
+    }
+
+    TArray<AActor*> Actors;
+    TArray<TSharedPtr<FJsonValue>> MissingArray;
+    FString TargetError;
+    if (!FMCPSceneUtils::CollectTargetActors(World, Params, Actors, MissingArray, TargetError))
+    {
+        MCP_LOG_WARNING("Invalid targets in get_properties command: %s", *TargetError);
+        return CreateErrorResponse(TargetError);
+    }
+
+    const bool bLimitReached = Actors.Num() > MCPConstants::MAX_ACTORS_PER_PROPERTY_BATCH;
+    if (bLimitReached)
+    {
+        Actors.SetNum(MCPConstants::MAX_ACTORS_PER_PROPERTY_BATCH);
+    }
+
+    // Paths resolve through the per-class cache, so only the first actor of each class pays for name lookups
+    FMCPPropertyPathCache& PathCache = FMCPPropertyPathCache::Get();
+    TSharedPtr<FJsonObject> TypesObject = MakeShared<FJsonObject>();
+    TArray<TSharedPtr<FJsonValue>> ActorsArray;
+    ActorsArray.Reserve(Actors.Num());
+
+    for (AActor* Actor : Actors)
+    {
+        TSharedPtr<FJsonObject> ActorInfo = MakeShared<FJsonObject>();
+        TSharedPtr<FJsonObject> ValuesObject = MakeShared<FJsonObject>();
+        TSharedPtr<FJsonObject> ErrorsObject = MakeShared<FJsonObject>();
+
+        for (const FString& Path : Paths)
+        {
+            FMCPResolvedProperty Resolved;
+            FString Error;
+            if (!PathCache.Resolve(Actor, Path, Resolved, Error))
+            {
+                ErrorsObject->SetStringField(Path, Error);
+                continue;
+            }
+
+            ValuesObject->SetField(Path, ValueToJson(Resolved));
+            if (!TypesObject->HasField(Path))
+            {
+                TypesObject->SetStringField(Path, Resolved.LeafProperty->GetCPPType());
+            }
+        }
+
+        ActorInfo->SetStringField("name", Actor->GetName());
+        ActorInfo->SetObjectField("values", ValuesObject);
+        if (ErrorsObject->Values.Num() > 0)
+        {
+            ActorInfo->SetObjectField("errors", ErrorsObject);
+        }
+        ActorsArray.Add(MakeShared<FJsonValueObject>(ActorInfo));
+    }
+
+    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+    Result->SetArrayField("actors", ActorsArray);
+    Result->SetObjectField("types", TypesObject);
+    Result->SetArrayField("missing", MissingArray);
+    Result->SetBoolField("limit_reached", bLimitReached);
+
+    MCP_LOG_INFO("Read %d properties from %d actors", Paths.Num(), Actors.Num());
+    return CreateSuccessResponse(Result);
+}
+
+TSharedPtr<FJsonValue> FMCPGetPropertiesHandler::ValueToJson(const FMCPResolvedProperty& Resolved)
+{
+    // Elements of fixed-size arrays are exported as text; the JSON converter always reads the whole array
+    if (Resolved.LeafProperty->ArrayDim > 1)
+    {
+        FString Text;
+        Resolved.LeafProperty->ExportTextItem_Direct(Text, Resolved.ValuePtr, nullptr, Resolved.Owner, PPF_None);
+        return MakeShared<FJsonValueString>(Text);
+    }
+
+    TSharedPtr<FJsonValue> Value = FJsonObjectConverter::UPropertyToJsonValue(Resolved.LeafProperty, Resolved.ValuePtr);
+    return Value.IsValid() ? Value : MakeShared<FJsonValueNull>();
+}
+
+//
+// FMCPSetPropertiesHandler
+//
+TSharedPtr<FJsonObject> FMCPSetPropertiesHandler::Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket)
+{
+    MCP_LOG_INFO("Handling set_properties command");
+
+    UWorld* World = GEditor->GetEditorWorldContext().World();
+
+    const TSharedPtr<FJsonObject>* ValuesObject = nullptr;
+    if (!Params->TryGetObjectField(FStringView(TEXT("values")), ValuesObject) || !ValuesObject || (*ValuesObject)->Values.Num() == 0)
+    {
+        MCP_LOG_WARNING("Missing 'values' field in set_properties command");
+        return CreateErrorResponse("Missing 'values' field");
+    }
+
+    TArray<AActor*> Actors;
+    TArray<TSharedPtr<FJsonValue>> MissingArray;
+    FString TargetError;
+    if (!FMCPSceneUtils::CollectTargetActors(World, Params, Actors, MissingArray, TargetError))
+    {
+        MCP_LOG_WARNING("Invalid targets in set_properties command: %s", *TargetError);
+        return CreateErrorResponse(TargetError);
+    }
+    if (Actors.Num() > MCPConstants::MAX_ACTORS_PER_PROPERTY_BATCH)
+    {
+        return CreateErrorResponse(FString::Printf(TEXT("set_properties targets %d actors. The limit is %d"),
+            Actors.Num(), MCPConstants::MAX_ACTORS_PER_PROPERTY_BATCH));
+    }
+
+    bool bTransact = true;
+    Params->TryGetBoolField(FStringView(TEXT("transact")), bTransact);
+
+    // Edit notifications let objects react (e.g. re-register components); without them only the value and render state change
+    bool bNotify = true;
+    Params->TryGetBoolField(FStringView(TEXT("notify")), bNotify);
+
+    FMCPPropertyPathCache& PathCache = FMCPPropertyPathCache::Get();
+    TArray<TSharedPtr<FJsonValue>> ErrorsArray;
+    int32 ErrorCount = 0;
+    int32 SetCount = 0;
+    int32 ModifiedCount = 0;
+
+    auto AddError = [&ErrorsArray, &ErrorCount](const AActor* Actor, const FString& Path, const FString& Error)
+    {
+        if (ErrorCount++ < MCPConstants::MAX_PROPERTY_ERRORS_REPORTED)
+        {
+            TSharedPtr<FJsonObject> ErrorInfo = MakeShared<FJsonObject>();
+            ErrorInfo->SetStringField("name", Actor->GetName());
+            ErrorInfo->SetStringField("path", Path);
+            ErrorInfo->SetStringField("error", Error);
+            ErrorsArray.Add(MakeShared<FJsonValueObject>(ErrorInfo));
+        }
+    };
+
+    {
+        // One undo entry for the whole batch
+        TUniquePtr<FScopedTransaction> Transaction;
+        if (bTransact)
+        {
+            Transaction = MakeUnique<FScopedTransaction>(LOCTEXT("SetProperties", "MCP Set Properties"));
+        }
+
+        for (AActor* Actor : Actors)
+        {
+            bool bActorChanged = false;
+            for (const TPair<FString, TSharedPtr<FJsonValue>>& Entry : (*ValuesObject)->Values)
+            {
+                FMCPResolvedProperty Resolved;
+                FString Error;
+                if (!PathCache.Resolve(Actor, Entry.Key, Resolved, Error))
+                {
+                    AddError(Actor, Entry.Key, Error);
+                    continue;
+                }
+
+                if (!Resolved.MemberProperty->HasAnyPropertyFlags(CPF_Edit)
+                    || Resolved.MemberProperty->HasAnyPropertyFlags(CPF_EditConst) || Resolved.LeafProperty->HasAnyPropertyFlags(CPF_EditConst))
+                {
+                    AddError(Actor, Entry.Key, TEXT("Property is not editable"));
+                    continue;
+                }
+
+                // A path through an object reference can end on a mesh, material or other asset shared by every user of it
+                if (Resolved.Owner != Actor && !Resolved.Owner->IsIn(Actor))
+                {
+                    AddError(Actor, Entry.Key, FString::Printf(TEXT("Path leads out of the actor into %s; only the actor and its components can be set"),
+                        *Resolved.Owner->GetPathName()));
+                    continue;
+                }
+
+                if (bNotify)
+                {
+                    Resolved.Owner->PreEditChange(Resolved.MemberProperty);
+                }
+                else if (bTransact)
+                {
+                    Resolved.Owner->Modify();
+                }
+
+                const bool bWritten = WriteValue(Resolved, Entry.Value, Error);
+
+                // PreEditChange is always paired with PostEditChange so components are re-registered
+                if (bNotify)
+                {
+                    FPropertyChangedEvent ChangedEvent(Resolved.LeafProperty, EPropertyChangeType::ValueSet);
+                    ChangedEvent.SetActiveMemberProperty(Resolved.MemberProperty);
+                    Resolved.Owner->PostEditChangeProperty(ChangedEvent);
+                }
+
+                if (!bWritten)
+                {
+                    AddError(Actor, Entry.Key, Error);
+                    continue;
+                }
+
+                if (!bNotify)
+                {
+                    if (UActorComponent* Component = Cast<UActorComponent>(Resolved.Owner))
+                    {
+                        Component->MarkRenderStateDirty();
+                    }
+                    // Without PostEditChange the journal does not hear about the edit
+                    FMCPSceneJournal::Get().RecordChange(EMCPSceneChangeType::Property, Actor, Resolved.MemberProperty->GetFName());
+                }
+
+                SetCount++;
+                bActorChanged = true;
+            }
+
+            if (bActorChanged)
+            {
+                ModifiedCount++;
+            }
+        }
+    }
+
+    if (ModifiedCount > 0)
+    {
+        GEditor->RedrawLevelEditingViewports();
+    }
+
+    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+    Result->SetNumberField("modified_count", ModifiedCount);
+    Result->SetNumberField("set_count", SetCount);
+    Result->SetNumberField("error_count", ErrorCount);
+    Result->SetArrayField("errors", ErrorsArray);
+    Result->SetArrayField("missing", MissingArray);
+
+    MCP_LOG_INFO("Set %d values on %d actors (%d errors)", SetCount, ModifiedCount, ErrorCount);
+    return CreateSuccessResponse(Result);
+}
+
+bool FMCPSetPropertiesHandler::WriteValue(const FMCPResolvedProperty& Resolved, const TSharedPtr<FJsonValue>& Value, FString& OutError)
+{
+    FProperty* Property = Resolved.LeafProperty;
+
+    // String-like properties take the JSON string as is
+    if (FStrProperty* StrProperty = CastField<FStrProperty>(Property))
+    {
+        StrProperty->SetPropertyValue(Resolved.ValuePtr, Value->AsString());
+        return true;
+    }
+    if (FNameProperty* NameProperty = CastField<FNameProperty>(Property))
+    {
+        NameProperty->SetPropertyValue(Resolved.ValuePtr, FName(*Value->AsString()));
+        return true;
+    }
+    if (FTextProperty* TextProperty = CastField<FTextProperty>(Property))
+    {
+        TextProperty->SetPropertyValue(Resolved.ValuePtr, FText::FromString(Value->AsString()));
+        return true;
+    }
+
+    // Strings and fixed-size array elements go through the property's text import
+    FString Text;
+    bool bImportText = false;
+    if (Value->Type == EJson::String)
+    {
+        Text = Value->AsString();
+        bImportText = true;
+    }
+    else if (Property->ArrayDim > 1)
+    {
+        if (Value->Type == EJson::Number)
+        {
+            Text = FString::SanitizeFloat(Value->AsNumber());
+        }
+        else if (Value->Type == EJson::Boolean)
+        {
+            Text = Value->AsBool() ? TEXT("True") : TEXT("False");
+        }
+        else
+        {
+            OutError = TEXT("Elements of fixed-size arrays take a number, boolean or text value");
+            return false;
+        }
+        bImportText = true;
+    }
+
+    if (bImportText)
+    {
+        if (!Property->ImportText_Direct(*Text, Resolved.ValuePtr, Resolved.Owner, PPF_None))
+        {
+            OutError = FString::Printf(TEXT("Could not parse '%s' as %s"), *Text, *Property->GetCPPType());
+            return false;
+        }
+        return true;
+    }
+
+    FText FailReason;
+    if (!FJsonObjectConverter::JsonValueToUProperty(Value, Property, Resolved.ValuePtr, 0, 0, false, &FailReason))
+    {
+        OutError = FailReason.IsEmpty()
+            ? FString::Printf(TEXT("Value does not match %s"), *Property->GetCPPType())
+            : FailReason.ToString();
+        return false;
+    }
+    return true;
+}
+
+#undef LOCTEXT_NAMESPACE
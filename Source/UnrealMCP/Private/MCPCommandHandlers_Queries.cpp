@@ -0,0 +1,869 @@
+#include "MCPCommandHandlers_Queries.h"
+
+#include "Editor.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "Async/ParallelFor.h"
+#include "CollisionQueryParams.h"
+#include "Components/StaticMeshComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "WorldCollision.h"
+#include "MCPFileLogger.h"
+#include "MCPConstants.h"
+#include "MCPPackedData.h"
+#include "MCPCommandHandlers_Scene.h"
+#include "MCPSceneJournal.h"
+#include "MCPSceneSnapshot.h"
+#include "MCPSceneStats.h"
+#include "MCPFrustumQuery.h"
+#include "MCPOccupancyGrid.h"
+#include "MCPSceneHashes.h"
+
+namespace
+{
+    /** Actor index written for queries that hit nothing */
+    constexpr uint32 NO_HIT = 0xFFFFFFFFu;
+}
+
+//
+// FMCPTraceBatchHandler
+//
+TSharedPtr<FJsonObject> FMCPTraceBatchHandler::Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket)
+{
+    MCP_LOG_INFO("Handling trace_batch command");
+
+    UWorld* World = GEditor->GetEditorWorldContext().World();
+
+    TArray<float> Starts;
+    TArray<float> Ends;
+    const bool bHasStarts = FMCPPackedData::TryGetFloatColumn(Params, TEXT("starts"), Starts);
+    const bool bHasEnds = FMCPPackedData::TryGetFloatColumn(Params, TEXT("ends"), Ends);
+    if (bHasStarts != bHasEnds || Starts.Num() % 3 != 0 || Starts.Num() != Ends.Num())
+    {
+        MCP_LOG_WARNING("Mismatched 'starts' and 'ends' in trace_batch command");
+        return CreateErrorResponse("'starts' and 'ends' must both be given with 3 values for each trace");
+    }
+
+    TArray<float> OverlapCenters;
+    const bool bHasOverlaps = FMCPPackedData::TryGetFloatColumn(Params, TEXT("overlap_centers"), OverlapCenters);
+    if (OverlapCenters.Num() % 3 != 0)
+    {
+        return CreateErrorResponse("'overlap_centers' must have 3 values for each overlap");
+    }
+    if (!bHasStarts && !bHasOverlaps)
+    {
+        MCP_LOG_WARNING("Missing 'starts'/'ends' or 'overlap_centers' field in trace_batch command");
+        return CreateErrorResponse("Missing 'starts'/'ends' or 'overlap_centers' field");
+    }
+
+    const int32 NumTraces = Starts.Num() / 3;
+    const int32 NumOverlaps = OverlapCenters.Num() / 3;
+    if (NumTraces + NumOverlaps > MCPConstants::MAX_QUERIES_PER_TRACE_BATCH)
+    {
+        return CreateErrorResponse(FString::Printf(TEXT("Too many queries (%d). The limit is %d"),
+            NumTraces + NumOverlaps, MCPConstants::MAX_QUERIES_PER_TRACE_BATCH));
+    }
+
+    FString ChannelName = TEXT("visibility");
+    Params->TryGetStringField(FStringView(TEXT("channel")), ChannelName);
+    ECollisionChannel Channel = ECC_Visibility;
+    if (!ParseChannel(ChannelName, Channel))
+    {
+        return CreateErrorResponse(FString::Printf(TEXT("Unknown collision channel '%s'"), *ChannelName));
+    }
+
+    // Traces without a shape are line traces; with one, every trace sweeps that shape
+    bool bSweep = false;
+    FCollisionShape SweepShape;
+    FQuat SweepRotation = FQuat::Identity;
+    const TSharedPtr<FJsonObject>* ShapeObject = nullptr;
+    if (Params->TryGetObjectField(FStringView(TEXT("shape")), ShapeObject) && ShapeObject)
+    {
+        FString ShapeError;
+        if (!ParseShape(*ShapeObject, SweepShape, SweepRotation, ShapeError))
+        {
+            return CreateErrorResponse(FString::Printf(TEXT("Invalid 'shape': %s"), *ShapeError));
+        }
+        bSweep = true;
+    }
+
+    FCollisionShape OverlapShape;
+    FQuat OverlapRotation = FQuat::Identity;
+    if (bHasOverlaps)
+    {
+        const TSharedPtr<FJsonObject>* OverlapShapeObject = nullptr;
+        if (!Params->TryGetObjectField(FStringView(TEXT("overlap_shape")), OverlapShapeObject) || !OverlapShapeObject)
+        {
+            return CreateErrorResponse("'overlap_shape' is required with 'overlap_centers'");
+        }
+        FString ShapeError;
+        if (!ParseShape(*OverlapShapeObject, OverlapShape, OverlapRotation, ShapeError))
+        {
+            return CreateErrorResponse(FString::Printf(TEXT("Invalid 'overlap_shape': %s"), *ShapeError));
+        }
+    }
+
+    bool bTraceComplex = false;
+    Params->TryGetBoolField(FStringView(TEXT("trace_complex")), bTraceComplex);
+
+    FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(MCPTraceBatch), bTraceComplex);
+    TArray<TSharedPtr<FJsonValue>> MissingArray;
+    TArray<FName> IgnoreNames;
+    if (FMCPSceneUtils::TryGetNameArray(Params, TEXT("ignore"), IgnoreNames))
+    {
+        for (const FName& Name : IgnoreNames)
+        {
+            if (AActor* Actor = FMCPSceneUtils::FindActorByName(World, Name))
+            {
+                QueryParams.AddIgnoredActor(Actor);
+            }
+            else
+            {
+                MissingArray.Add(MakeShared<FJsonValueString>(Name.ToString()));
+            }
+        }
+    }
+
+    const double StartTime = FPlatformTime::Seconds();
+
+    TArray<AActor*> TraceActors;
+    TArray<float> Positions;
+    TArray<float> ImpactPoints;
+    TArray<float> Normals;
+    TArray<float> Distances;
+    TraceActors.SetNumZeroed(NumTraces);
+    Positions.SetNumUninitialized(NumTraces * 3);
+    ImpactPoints.SetNumUninitialized(bSweep ? NumTraces * 3 : 0);
+    Normals.SetNumZeroed(NumTraces * 3);
+    Distances.SetNumUninitialized(NumTraces);
+
+    // Scene queries only read the physics scene, so independent queries are split across worker threads.
+    // Every query writes its own slots, so no results need merging.
+    ParallelFor(NumTraces, [&](int32 Index)
+    {
+        const FVector Start(Starts[Index * 3], Starts[Index * 3 + 1], Starts[Index * 3 + 2]);
+        const FVector End(Ends[Index * 3], Ends[Index * 3 + 1], Ends[Index * 3 + 2]);
+
+        FHitResult Hit;
+        const bool bHit = bSweep
+            ? World->SweepSingleByChannel(Hit, Start, End, SweepRotation, Channel, SweepShape, QueryParams)
+            : World->LineTraceSingleByChannel(Hit, Start, End, Channel, QueryParams);
+
+        // Misses report the end point, a zero normal and a distance of -1
+        const FVector Position = bHit ? FVector(Hit.Location) : End;
+        float* PositionOut = &Positions[Index * 3];
+        PositionOut[0] = Position.X;
+        PositionOut[1] = Position.Y;
+        PositionOut[2] = Position.Z;
+        if (bSweep)
+        {
+            const FVector ImpactPoint = bHit ? FVector(Hit.ImpactPoint) : End;
+            float* ImpactOut = &ImpactPoints[Index * 3];
+            ImpactOut[0] = ImpactPoint.X;
+            ImpactOut[1] = ImpactPoint.Y;
+            ImpactOut[2] = ImpactPoint.Z;
+        }
+        Distances[Index] = bHit ? Hit.Distance : -1.0f;
+
+        if (bHit)
+        {
+            float* NormalOut = &Normals[Index * 3];
+            NormalOut[0] = Hit.ImpactNormal.X;
+            NormalOut[1] = Hit.ImpactNormal.Y;
+            NormalOut[2] = Hit.ImpactNormal.Z;
+            TraceActors[Index] = Hit.GetActor();
+        }
+    });
+
+    TArray<TArray<AActor*>> OverlapActors;
+    OverlapActors.SetNum(NumOverlaps);
+    ParallelFor(NumOverlaps, [&](int32 Index)
+    {
+        const FVector Center(OverlapCenters[Index * 3], OverlapCenters[Index * 3 + 1], OverlapCenters[Index * 3 + 2]);
+
+        TArray<FOverlapResult> Overlaps;
+        World->OverlapMultiByChannel(Overlaps, Center, OverlapRotation, Channel, OverlapShape, QueryParams);
+
+        // Several components of one actor may overlap; each actor is reported once
+        TArray<AActor*>& Actors = OverlapActors[Index];
+        for (const FOverlapResult& Overlap : Overlaps)
+        {
+            AActor* Actor = Overlap.GetActor();
+            if (Actor && Actors.Num() < MCPConstants::MAX_ACTORS_PER_OVERLAP)
+            {
+                Actors.AddUnique(Actor);
+            }
+        }
+    });
+
+    const double QueryTime = FPlatformTime::Seconds();
+
+    // Hit actors are listed once in a table; packed columns refer to them by index
+    TMap<AActor*, uint32> ActorIndices;
+    TArray<TSharedPtr<FJsonValue>> ActorsArray;
+    auto GetActorIndex = [&ActorIndices, &ActorsArray](AActor* Actor)
+    {
+        if (const uint32* Existing = ActorIndices.Find(Actor))
+        {
+            return *Existing;
+        }
+        const uint32 NewIndex = static_cast<uint32>(ActorsArray.Num());
+        ActorIndices.Add(Actor, NewIndex);
+        ActorsArray.Add(MakeShared<FJsonValueString>(Actor->GetName()));
+        return NewIndex;
+    };
+
+    TArray<uint32> HitActors;
+    HitActors.SetNumUninitialized(NumTraces);
+    int32 HitCount = 0;
+    for (int32 Index = 0; Index < NumTraces; ++Index)
+    {
+        HitActors[Index] = NO_HIT;
+        if (Distances[Index] >= 0.0f)
+        {
+            HitCount++;
+            if (TraceActors[Index])
+            {
+                HitActors[Index] = GetActorIndex(TraceActors[Index]);
+            }
+        }
+    }
+
+    TArray<uint32> OverlapOffsets;
+    TArray<uint32> OverlapActorIndices;
+    OverlapOffsets.SetNumUninitialized(NumOverlaps > 0 ? NumOverlaps + 1 : 0);
+    for (int32 Index = 0; Index < NumOverlaps; ++Index)
+    {
+        OverlapOffsets[Index] = static_cast<uint32>(OverlapActorIndices.Num());
+        for (AActor* Actor : OverlapActors[Index])
+        {
+            OverlapActorIndices.Add(GetActorIndex(Actor));
+        }
+    }
+    if (NumOverlaps > 0)
+    {
+        OverlapOffsets[NumOverlaps] = static_cast<uint32>(OverlapActorIndices.Num());
+    }
+
+    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+    TSharedPtr<FJsonObject> Columns = MakeShared<FJsonObject>();
+
+    // Describes each packed column so clients can decode it with numpy.frombuffer(...).reshape(-1, stride)
+    auto AddColumn = [&Result, &Columns](const FString& Name, const FString& Encoded, const FString& DType, int32 Stride)
+    {
+        Result->SetStringField(Name, Encoded);
+        TSharedPtr<FJsonObject> Column = MakeShared<FJsonObject>();
+        Column->SetStringField("dtype", DType);
+        Column->SetNumberField("stride", Stride);
+        Columns->SetObjectField(Name, Column);
+    };
+
+    if (NumTraces > 0)
+    {
+        AddColumn(TEXT("hit_actors"), FMCPPackedData::EncodeUInt32s(HitActors), TEXT("<u4"), 1);
+        AddColumn(TEXT("positions"), FMCPPackedData::EncodeFloats(Positions), TEXT("<f4"), 3);
+        if (bSweep)
+        {
+            AddColumn(TEXT("impact_points"), FMCPPackedData::EncodeFloats(ImpactPoints), TEXT("<f4"), 3);
+        }
+        AddColumn(TEXT("normals"), FMCPPackedData::EncodeFloats(Normals), TEXT("<f4"), 3);
+        AddColumn(TEXT("distances"), FMCPPackedData::EncodeFloats(Distances), TEXT("<f4"), 1);
+    }
+    if (NumOverlaps > 0)
+    {
+        AddColumn(TEXT("overlap_offsets"), FMCPPackedData::EncodeUInt32s(OverlapOffsets), TEXT("<u4"), 1);
+        AddColumn(TEXT("overlap_actors"), FMCPPackedData::EncodeUInt32s(OverlapActorIndices), TEXT("<u4"), 1);
+    }
+
+    const double EndTime = FPlatformTime::Seconds();
+
+    Result->SetObjectField("columns", Columns);
+    Result->SetArrayField("actors", ActorsArray);
+    Result->SetNumberField("no_hit", static_cast<double>(NO_HIT));
+    Result->SetNumberField("trace_count", NumTraces);
+    Result->SetNumberField("hit_count", HitCount);
+    Result->SetNumberField("overlap_count", NumOverlaps);
+    Result->SetStringField("trace_type", bSweep ? TEXT("sweep") : TEXT("line"));
+    Result->SetArrayField("missing", MissingArray);
+    Result->SetNumberField("query_ms", (QueryTime - StartTime) * 1000.0);
+    Result->SetNumberField("total_ms", (EndTime - StartTime) * 1000.0);
+
+    MCP_LOG_INFO("Ran %d traces (%d hits) and %d overlaps in %.1f ms", NumTraces, HitCount, NumOverlaps, (EndTime - StartTime) * 1000.0);
+    return CreateSuccessResponse(Result);
+}
+
+TArray<FString> FMCPTraceBatchHandler::GetFieldPriorities() const
+{
+    return { TEXT("columns"), TEXT("actors"), TEXT("hit_actors"), TEXT("distances"), TEXT("positions"), TEXT("impact_points"),
+        TEXT("normals"), TEXT("overlap_offsets"), TEXT("overlap_actors") };
+}
+
+bool FMCPTraceBatchHandler::ParseShape(const TSharedPtr<FJsonObject>& ShapeObject, FCollisionShape& OutShape, FQuat& OutRotation, FString& OutError)
+{
+    FString Type;
+    if (!ShapeObject->TryGetStringField(FStringView(TEXT("type")), Type))
+    {
+        OutError = TEXT("missing 'type'");
+        return false;
+    }
+
+    double Radius = 0.0;
+    double HalfHeight = 0.0;
+    ShapeObject->TryGetNumberField(FStringView(TEXT("radius")), Radius);
+    ShapeObject->TryGetNumberField(FStringView(TEXT("half_height")), HalfHeight);
+
+    if (Type == TEXT("sphere"))
+    {
+        if (Radius <= 0.0)
+        {
+            OutError = TEXT("a sphere needs a positive 'radius'");
+            return false;
+        }
+        OutShape = FCollisionShape::MakeSphere(Radius);
+    }
+    else if (Type == TEXT("capsule"))
+    {
+        if (Radius <= 0.0 || HalfHeight < Radius)
+        {
+            OutError = TEXT("a capsule needs a positive 'radius' and a 'half_height' of at least the radius");
+            return false;
+        }
+        OutShape = FCollisionShape::MakeCapsule(Radius, HalfHeight);
+    }
+    else if (Type == TEXT("box"))
+    {
+        TArray<float> HalfExtent;
+        if (!FMCPPackedData::TryGetFloatColumn(ShapeObject, TEXT("half_extent"), HalfExtent) || HalfExtent.Num() != 3
+            || HalfExtent[0] <= 0.0f || HalfExtent[1] <= 0.0f || HalfExtent[2] <= 0.0f)
+        {
+            OutError = TEXT("a box needs a positive 'half_extent' [x, y, z]");
+            return false;
+        }
+        OutShape = FCollisionShape::MakeBox(FVector3f(HalfExtent[0], HalfExtent[1], HalfExtent[2]));
+    }
+    else
+    {
+        OutError = FString::Printf(TEXT("unknown type '%s'; use sphere, box or capsule"), *Type);
+        return false;
+    }
+
+    OutRotation = FQuat::Identity;
+    TArray<float> Rotation;
+    if (FMCPPackedData::TryGetFloatColumn(ShapeObject, TEXT("rotation"), Rotation))
+    {
+        if (Rotation.Num() != 3)
+        {
+            OutError = TEXT("'rotation' must be [pitch, yaw, roll]");
+            return false;
+        }
+        OutRotation = FRotator(Rotation[0], Rotation[1], Rotation[2]).Quaternion();
+    }
+    return true;
+}
+
+bool FMCPTraceBatchHandler::ParseChannel(const FString& Name, ECollisionChannel& OutChannel)
+{
+    static const TMap<FString, ECollisionChannel> Channels = {
+        { TEXT("visibility"), ECC_Visibility },
+        { TEXT("camera"), ECC_Camera },
+        { TEXT("world_static"), ECC_WorldStatic },
+        { TEXT("world_dynamic"), ECC_WorldDynamic },
+        { TEXT("pawn"), ECC_Pawn },
+        { TEXT("physics_body"), ECC_PhysicsBody },
+        { TEXT("vehicle"), ECC_Vehicle },
+        { TEXT("destructible"), ECC_Destructible }
+    };
+
+    if (const ECollisionChannel* Channel = Channels.Find(Name.ToLower()))
+    {
+        OutChannel = *Channel;
+        return true;
+    }
+    return false;
+}
+
+//
+// FMCPGetSceneStatsHandler
+//
+TSharedPtr<FJsonObject> FMCPGetSceneStatsHandler::Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket)
+{
+    MCP_LOG_INFO("Handling get_scene_stats command");
+
+    UWorld* World = GEditor->GetEditorWorldContext().World();
+
+    FMCPActorFilter Filter;
+    const TSharedPtr<FJsonObject>* FilterObject = nullptr;
+    if (Params->TryGetObjectField(FStringView(TEXT("filter")), FilterObject) && FilterObject)
+    {
+        FString FilterError;
+        if (!Filter.Parse(*FilterObject, FilterError))
+        {
+            MCP_LOG_WARNING("Invalid filter in get_scene_stats command: %s", *FilterError);
+            return CreateErrorResponse(FilterError);
+        }
+    }
+
+    int32 MaxClasses = MCPConstants::MAX_CLASSES_IN_SCENE_STATS;
+    Params->TryGetNumberField(FStringView(TEXT("max_classes")), MaxClasses);
+
+    const double StartTime = FPlatformTime::Seconds();
+
+    FMCPSceneStatsCapture Capture;
+    FMCPSceneStatsCollector::Capture(World, Filter.IsEmpty() ? nullptr : &Filter, Capture);
+    const double CaptureTime = FPlatformTime::Seconds();
+
+    FMCPSceneStats Stats;
+    FMCPSceneStatsCollector::Reduce(Capture, Stats);
+    const double ReduceTime = FPlatformTime::Seconds();
+
+    // Most frequent classes first; the tail is folded into one count to keep the response small
+    TArray<TPair<const UClass*, int32>> Classes = Stats.ClassCounts.Array();
+    Classes.Sort([](const TPair<const UClass*, int32>& A, const TPair<const UClass*, int32>& B)
+    {
+        return A.Value > B.Value;
+    });
+
+    TSharedPtr<FJsonObject> ClassesObject = MakeShared<FJsonObject>();
+    int32 OtherClassActors = 0;
+    for (int32 Index = 0; Index < Classes.Num(); ++Index)
+    {
+        if (Index < MaxClasses)
+        {
+            ClassesObject->SetNumberField(Classes[Index].Key->GetName(), Classes[Index].Value);
+        }
+        else
+        {
+            OtherClassActors += Classes[Index].Value;
+        }
+    }
+
+    TSharedPtr<FJsonObject> MeshesObject = MakeShared<FJsonObject>();
+    MeshesObject->SetNumberField("components", Stats.MeshComponentCount);
+    MeshesObject->SetNumberField("instances", static_cast<double>(Stats.InstanceCount));
+    MeshesObject->SetNumberField("triangles", static_cast<double>(Stats.TriangleCount));
+    MeshesObject->SetNumberField("unique_meshes", Stats.Meshes.Num());
+    MeshesObject->SetNumberField("unique_materials", Stats.Materials.Num());
+
+    static const TCHAR* LightKindNames[] = { TEXT("none"), TEXT("directional"), TEXT("point"), TEXT("spot"), TEXT("rect"), TEXT("sky") };
+    static const TCHAR* MobilityNames[] = { TEXT("static"), TEXT("stationary"), TEXT("movable") };
+    static_assert(UE_ARRAY_COUNT(LightKindNames) == static_cast<int32>(EMCPLightKind::Count), "Light kind names out of date");
+
+    int32 LightTotal = 0;
+    int32 LightsByMobility[3] = {};
+    TSharedPtr<FJsonObject> LightsByKindObject = MakeShared<FJsonObject>();
+    for (int32 Kind = 1; Kind < static_cast<int32>(EMCPLightKind::Count); ++Kind)
+    {
+        int32 KindTotal = 0;
+        TSharedPtr<FJsonObject> KindObject = MakeShared<FJsonObject>();
+        for (int32 Mobility = 0; Mobility < 3; ++Mobility)
+        {
+            const int32 Count = Stats.LightCounts[Kind][Mobility];
+            KindObject->SetNumberField(MobilityNames[Mobility], Count);
+            LightsByMobility[Mobility] += Count;
+            KindTotal += Count;
+        }
+        if (KindTotal > 0)
+        {
+            LightsByKindObject->SetObjectField(LightKindNames[Kind], KindObject);
+        }
+        LightTotal += KindTotal;
+    }
+
+    TSharedPtr<FJsonObject> LightsByMobilityObject = MakeShared<FJsonObject>();
+    for (int32 Mobility = 0; Mobility < 3; ++Mobility)
+    {
+        LightsByMobilityObject->SetNumberField(MobilityNames[Mobility], LightsByMobility[Mobility]);
+    }
+
+    TSharedPtr<FJsonObject> LightsObject = MakeShared<FJsonObject>();
+    LightsObject->SetNumberField("count", LightTotal);
+    LightsObject->SetObjectField("by_mobility", LightsByMobilityObject);
+    LightsObject->SetObjectField("by_type", LightsByKindObject);
+
+    TArray<TSharedPtr<FJsonValue>> LevelsArray;
+    for (int32 Level = 0; Level < Capture.Levels.Num(); ++Level)
+    {
+        TSharedPtr<FJsonObject> LevelInfo = MakeShared<FJsonObject>();
+        LevelInfo->SetStringField("name", Capture.Levels[Level].ToString());
+        LevelInfo->SetNumberField("actor_count", Stats.LevelActorCounts[Level]);
+        if (Stats.LevelBounds[Level].IsValid)
+        {
+            LevelInfo->SetArrayField("bounds_min", FMCPSceneUtils::MakeVectorArray(Stats.LevelBounds[Level].Min));
+            LevelInfo->SetArrayField("bounds_max", FMCPSceneUtils::MakeVectorArray(Stats.LevelBounds[Level].Max));
+        }
+        LevelsArray.Add(MakeShared<FJsonValueObject>(LevelInfo));
+    }
+
+    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+    Result->SetNumberField("scene_version", static_cast<double>(FMCPSceneJournal::Get().GetCurrentVersion()));
+    Result->SetNumberField("actor_count", Stats.ActorCount);
+    Result->SetNumberField("class_count", Classes.Num());
+    Result->SetObjectField("classes", ClassesObject);
+    Result->SetNumberField("other_class_actors", OtherClassActors);
+    Result->SetObjectField("meshes", MeshesObject);
+    Result->SetObjectField("lights", LightsObject);
+    Result->SetArrayField("levels", LevelsArray);
+    Result->SetNumberField("capture_ms", (CaptureTime - StartTime) * 1000.0);
+    Result->SetNumberField("reduce_ms", (ReduceTime - CaptureTime) * 1000.0);
+
+    MCP_LOG_INFO("Computed stats for %d actors in %.1f ms", Stats.ActorCount, (ReduceTime - StartTime) * 1000.0);
+    return CreateSuccessResponse(Result);
+}
+
+//
+// FMCPQueryFrustumHandler
+//
+TSharedPtr<FJsonObject> FMCPQueryFrustumHandler::Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket)
+{
+    MCP_LOG_INFO("Handling query_frustum command");
+
+    UWorld* World = GEditor->GetEditorWorldContext().World();
+
+    FMCPCameraView View;
+    TArray<float> Values;
+    if (!FMCPPackedData::TryGetFloatColumn(Params, TEXT("location"), Values) || Values.Num() != 3)
+    {
+        MCP_LOG_WARNING("Missing 'location' field in query_frustum command");
+        return CreateErrorResponse("Missing 'location' field as [x, y, z]");
+    }
+    View.Location = FVector(Values[0], Values[1], Values[2]);
+
+    // The view direction comes from a rotation, a direction vector or a target point
+    if (FMCPPackedData::TryGetFloatColumn(Params, TEXT("rotation"), Values) && Values.Num() == 3)
+    {
+        View.Rotation = FRotator(Values[0], Values[1], Values[2]);
+    }
+    else if (FMCPPackedData::TryGetFloatColumn(Params, TEXT("direction"), Values) && Values.Num() == 3)
+    {
+        View.Rotation = FVector(Values[0], Values[1], Values[2]).Rotation();
+    }
+    else if (FMCPPackedData::TryGetFloatColumn(Params, TEXT("look_at"), Values) && Values.Num() == 3)
+    {
+        View.Rotation = (FVector(Values[0], Values[1], Values[2]) - View.Location).Rotation();
+    }
+    else
+    {
+        return CreateErrorResponse("Missing 'rotation', 'direction' or 'look_at' field as [x, y, z]");
+    }
+
+    Params->TryGetNumberField(FStringView(TEXT("fov")), View.FieldOfView);
+    Params->TryGetNumberField(FStringView(TEXT("aspect_ratio")), View.AspectRatio);
+    Params->TryGetNumberField(FStringView(TEXT("near")), View.NearPlane);
+    Params->TryGetNumberField(FStringView(TEXT("far")), View.FarPlane);
+    View.Finalize();
+
+    FMCPActorFilter Filter;
+    const TSharedPtr<FJsonObject>* FilterObject = nullptr;
+    if (Params->TryGetObjectField(FStringView(TEXT("filter")), FilterObject) && FilterObject)
+    {
+        FString FilterError;
+        if (!Filter.Parse(*FilterObject, FilterError))
+        {
+            MCP_LOG_WARNING("Invalid filter in query_frustum command: %s", *FilterError);
+            return CreateErrorResponse(FilterError);
+        }
+    }
+
+    bool bOcclusion = false;
+    Params->TryGetBoolField(FStringView(TEXT("occlusion")), bOcclusion);
+    double OccluderMinCoverage = 0.05;
+    Params->TryGetNumberField(FStringView(TEXT("occluder_min_coverage")), OccluderMinCoverage);
+
+    int32 MaxResults = 200;
+    Params->TryGetNumberField(FStringView(TEXT("max_results")), MaxResults);
+    MaxResults = FMath::Clamp(MaxResults, 0, MCPConstants::MAX_ACTORS_IN_FRUSTUM_QUERY);
+
+    const double StartTime = FPlatformTime::Seconds();
+
+    FMCPBoundsCache& BoundsCache = FMCPBoundsCache::Get();
+    BoundsCache.Update(World);
+    const double CacheTime = FPlatformTime::Seconds();
+
+    FPlane Planes[6];
+    View.GetPlanes(Planes);
+    TArray<int32> InFrustum;
+    BoundsCache.Cull(Planes, UE_ARRAY_COUNT(Planes), InFrustum);
+    const double CullTime = FPlatformTime::Seconds();
+
+    struct FVisibleActor
+    {
+        AActor* Actor = nullptr;
+        FBox Box;
+        double Coverage = 0.0;
+        double Depth = 0.0;
+    };
+
+    // Coverage is the share of the screen covered by the box's projected rectangle
+    TArray<FVisibleActor> Visible;
+    Visible.Reserve(InFrustum.Num());
+    for (int32 Index : InFrustum)
+    {
+        AActor* Actor = BoundsCache.Actors[Index].Get();
+        if (!Actor)
+        {
+            continue;
+        }
+
+        const FVector Center(BoundsCache.CenterX[Index], BoundsCache.CenterY[Index], BoundsCache.CenterZ[Index]);
+        const FVector Extent(BoundsCache.ExtentX[Index], BoundsCache.ExtentY[Index], BoundsCache.ExtentZ[Index]);
+        const FBox Box(Center - Extent, Center + Extent);
+
+        FVector2D ScreenMin;
+        FVector2D ScreenMax;
+        double Depth = 0.0;
+        if (!View.ProjectBox(Box, ScreenMin, ScreenMax, Depth))
+        {
+            continue;
+        }
+
+        FVisibleActor& Entry = Visible.AddDefaulted_GetRef();
+        Entry.Actor = Actor;
+        Entry.Box = Box;
+        Entry.Coverage = (ScreenMax.X - ScreenMin.X) * (ScreenMax.Y - ScreenMin.Y) * 0.25;
+        Entry.Depth = Depth;
+    }
+
+    Visible.Sort([](const FVisibleActor& A, const FVisibleActor& B)
+    {
+        return A.Coverage > B.Coverage;
+    });
+
+    // Occluders are taken from every visible actor, not just the filtered ones, since anything solid can hide a match
+    int32 OccluderCount = 0;
+    int32 OccluderTriangles = 0;
+    int32 OccludedCount = 0;
+    if (bOcclusion && Visible.Num() > 0)
+    {
+        FMCPOcclusionBuffer OcclusionBuffer(View, MCPConstants::OCCLUSION_BUFFER_WIDTH);
+        TInlineComponentArray<UStaticMeshComponent*> MeshComponents;
+        for (const FVisibleActor& Entry : Visible)
+        {
+            if (OccluderCount >= MCPConstants::MAX_OCCLUDERS || Entry.Coverage < OccluderMinCoverage)
+            {
+                break;
+            }
+
+            int32 ActorTriangles = 0;
+            MeshComponents.Reset();
+            Entry.Actor->GetComponents(MeshComponents);
+            for (const UStaticMeshComponent* MeshComponent : MeshComponents)
+            {
+                // Instanced components would need every instance rasterized; they are left out
+                if (MeshComponent->IsVisibleInEditor() && !MeshComponent->IsA<UInstancedStaticMeshComponent>())
+                {
+                    ActorTriangles += OcclusionBuffer.RasterizeStaticMesh(MeshComponent, MCPConstants::MAX_OCCLUDER_TRIANGLES);
+                }
+            }
+            if (ActorTriangles > 0)
+            {
+                OccluderCount++;
+                OccluderTriangles += ActorTriangles;
+            }
+        }
+
+        if (OccluderCount > 0)
+        {
+            OcclusionBuffer.BuildHierarchy();
+            OccludedCount = Visible.RemoveAll([&OcclusionBuffer](const FVisibleActor& Entry)
+            {
+                return OcclusionBuffer.IsOccluded(Entry.Box);
+            });
+        }
+    }
+    const double OcclusionTime = FPlatformTime::Seconds();
+
+    TArray<TSharedPtr<FJsonValue>> ActorsArray;
+    int32 MatchCount = 0;
+    for (const FVisibleActor& Entry : Visible)
+    {
+        if (!Filter.IsEmpty() && !Filter.Matches(Entry.Actor))
+        {
+            continue;
+        }
+
+        MatchCount++;
+        if (ActorsArray.Num() < MaxResults)
+        {
+            TSharedPtr<FJsonObject> ActorInfo = MakeShared<FJsonObject>();
+            ActorInfo->SetStringField("name", Entry.Actor->GetName());
+            ActorInfo->SetStringField("class", Entry.Actor->GetClass()->GetName());
+            ActorInfo->SetNumberField("coverage", Entry.Coverage);
+            ActorInfo->SetNumberField("distance", Entry.Depth);
+            ActorsArray.Add(MakeShared<FJsonValueObject>(ActorInfo));
+        }
+    }
+
+    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+    Result->SetArrayField("actors", ActorsArray);
+    Result->SetNumberField("visible_count", MatchCount);
+    Result->SetBoolField("limit_reached", MatchCount > ActorsArray.Num());
+    Result->SetNumberField("tested_count", BoundsCache.Num());
+    Result->SetNumberField("in_frustum_count", InFrustum.Num());
+    if (bOcclusion)
+    {
+        Result->SetNumberField("occluded_count", OccludedCount);
+        Result->SetNumberField("occluder_count", OccluderCount);
+        Result->SetNumberField("occluder_triangles", OccluderTriangles);
+    }
+    Result->SetNumberField("scene_version", static_cast<double>(FMCPSceneJournal::Get().GetCurrentVersion()));
+    Result->SetNumberField("cache_ms", (CacheTime - StartTime) * 1000.0);
+    Result->SetNumberField("cull_ms", (CullTime - CacheTime) * 1000.0);
+    Result->SetNumberField("occlusion_ms", (OcclusionTime - CullTime) * 1000.0);
+
+    MCP_LOG_INFO("Frustum query: %d of %d actors visible", MatchCount, BoundsCache.Num());
+    return CreateSuccessResponse(Result);
+}
+
+//
+// FMCPBuildOccupancyGridHandler
+//
+TSharedPtr<FJsonObject> FMCPBuildOccupancyGridHandler::Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket)
+{
+    MCP_LOG_INFO("Handling build_occupancy_grid command");
+
+    UWorld* World = GEditor->GetEditorWorldContext().World();
+
+    FMCPOccupancySettings Settings;
+    const TSharedPtr<FJsonObject>* RegionObject = nullptr;
+    TArray<float> Min;
+    TArray<float> Max;
+    if (!Params->TryGetObjectField(FStringView(TEXT("region")), RegionObject) || !RegionObject ||
+        !FMCPPackedData::TryGetFloatColumn(*RegionObject, TEXT("min"), Min) || Min.Num() != 3 ||
+        !FMCPPackedData::TryGetFloatColumn(*RegionObject, TEXT("max"), Max) || Max.Num() != 3)
+    {
+        MCP_LOG_WARNING("Missing or invalid 'region' field in build_occupancy_grid command");
+        return CreateErrorResponse("Missing or invalid 'region' field; use {\"min\": [x, y, z], \"max\": [x, y, z]}");
+    }
+    const FVector A(Min[0], Min[1], Min[2]);
+    const FVector B(Max[0], Max[1], Max[2]);
+    Settings.Region = FBox(A.ComponentMin(B), A.ComponentMax(B));
+
+    Params->TryGetNumberField(FStringView(TEXT("resolution")), Settings.Resolution);
+    if (!(Settings.Resolution > 0.0))
+    {
+        return CreateErrorResponse("'resolution' must be positive");
+    }
+
+    FString ChannelName = TEXT("world_static");
+    Params->TryGetStringField(FStringView(TEXT("channel")), ChannelName);
+    ECollisionChannel Channel = ECC_WorldStatic;
+    if (!FMCPTraceBatchHandler::ParseChannel(ChannelName, Channel))
+    {
+        return CreateErrorResponse(FString::Printf(TEXT("Unknown collision channel '%s'"), *ChannelName));
+    }
+    Settings.Channel = Channel;
+
+    FString Format = TEXT("rle");
+    Params->TryGetStringField(FStringView(TEXT("format")), Format);
+    Format = Format.ToLower();
+    if (Format != TEXT("rle") && Format != TEXT("bits"))
+    {
+        return CreateErrorResponse(FString::Printf(TEXT("Unknown grid format '%s'; use 'rle' or 'bits'"), *Format));
+    }
+
+    bool bIncludeGrid = true;
+    bool bIncludeHeightMap = true;
+    Params->TryGetBoolField(FStringView(TEXT("include_grid")), bIncludeGrid);
+    Params->TryGetBoolField(FStringView(TEXT("include_heightmap")), bIncludeHeightMap);
+
+    // Checked before anything is allocated; columns are padded to whole 64-bit words
+    const FVector RegionSize = Settings.Region.GetSize();
+    const int64 NumColumns = static_cast<int64>(FMath::Max(FMath::CeilToDouble(RegionSize.X / Settings.Resolution), 1.0)) *
+        static_cast<int64>(FMath::Max(FMath::CeilToDouble(RegionSize.Y / Settings.Resolution), 1.0));
+    const int64 PaddedVoxels = NumColumns * 64 * FMath::DivideAndRoundUp(FMath::Max(FMath::CeilToInt64(RegionSize.Z / Settings.Resolution), 1ll), 64ll);
+    if (PaddedVoxels > MCPConstants::MAX_OCCUPANCY_VOXELS)
+    {
+        return CreateErrorResponse(FString::Printf(TEXT("The grid is too large (%lld voxels). The limit is %lld; use a coarser resolution or a smaller region"),
+            PaddedVoxels, MCPConstants::MAX_OCCUPANCY_VOXELS));
+    }
+
+    const double StartTime = FPlatformTime::Seconds();
+
+    TArray<AActor*> Actors;
+    FMCPOccupancyBuilder::CollectActors(World, Settings, Actors);
+    const uint64 ContentHash = FMCPOccupancyBuilder::HashContent(World, Actors, Settings);
+    const uint64 CacheKey = ContentHash ^ (Format == TEXT("bits") ? 1ull : 0ull) ^ (bIncludeGrid ? 2ull : 0ull) ^ (bIncludeHeightMap ? 4ull : 0ull);
+    const double CollectTime = FPlatformTime::Seconds();
+
+    FMCPOccupancyCache& Cache = FMCPOccupancyCache::Get();
+    if (const TSharedPtr<FJsonObject> Cached = Cache.Find(CacheKey))
+    {
+        // Timings go on a shallow copy so the cached entry stays untouched
+        TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>(*Cached);
+        Result->SetBoolField("cached", true);
+        Result->SetNumberField("collect_ms", (CollectTime - StartTime) * 1000.0);
+        Result->SetNumberField("voxelize_ms", 0.0);
+        Result->SetNumberField("encode_ms", 0.0);
+
+        MCP_LOG_INFO("Occupancy grid served from cache (%s)", *FMCPSceneHashIndex::HashToString(ContentHash));
+        return CreateSuccessResponse(Result);
+    }
+
+    FMCPOccupancyGrid Grid;
+    FMCPOccupancyStats Stats;
+    FMCPOccupancyBuilder::Build(Actors, Settings, Grid, Stats);
+    const double VoxelizeTime = FPlatformTime::Seconds();
+
+    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+    TSharedPtr<FJsonObject> Columns = MakeShared<FJsonObject>();
+    auto AddColumn = [&Result, &Columns](const FString& Name, const FString& Encoded, const FString& DType, int32 Stride)
+    {
+        Result->SetStringField(Name, Encoded);
+        TSharedPtr<FJsonObject> Column = MakeShared<FJsonObject>();
+        Column->SetStringField("dtype", DType);
+        Column->SetNumberField("stride", Stride);
+        Columns->SetObjectField(Name, Column);
+    };
+
+    if (bIncludeGrid)
+    {
+        if (Format == TEXT("bits"))
+        {
+            TArray<uint8> Bytes;
+            Grid.EncodeBits(Bytes);
+            AddColumn(TEXT("grid"), FMCPPackedData::EncodeBytes(Bytes), TEXT("|u1"), FMath::DivideAndRoundUp(Grid.Size.Z, 8));
+        }
+        else
+        {
+            TArray<uint32> Runs;
+            Grid.EncodeRuns(Runs);
+            AddColumn(TEXT("grid"), FMCPPackedData::EncodeUInt32s(Runs), TEXT("<u4"), 1);
+            Result->SetNumberField("run_count", Runs.Num());
+        }
+    }
+    if (bIncludeHeightMap)
+    {
+        TArray<float> Heights;
+        Grid.BuildHeightMap(Heights);
+        AddColumn(TEXT("heightmap"), FMCPPackedData::EncodeFloats(Heights), TEXT("<f4"), Grid.Size.X);
+    }
+
+    TArray<TSharedPtr<FJsonValue>> SizeArray;
+    SizeArray.Add(MakeShared<FJsonValueNumber>(Grid.Size.X));
+    SizeArray.Add(MakeShared<FJsonValueNumber>(Grid.Size.Y));
+    SizeArray.Add(MakeShared<FJsonValueNumber>(Grid.Size.Z));
+
+    Result->SetObjectField("columns", Columns);
+    Result->SetStringField("format", Format);
+    Result->SetArrayField("size", SizeArray);
+    Result->SetArrayField("origin", FMCPSceneUtils::MakeVectorArray(Grid.Origin));
+    Result->SetNumberField("resolution", Grid.Resolution);
+    Result->SetNumberField("occupied_count", static_cast<double>(Stats.OccupiedCount));
+    Result->SetNumberField("actor_count", Stats.ActorCount);
+    Result->SetNumberField("component_count", Stats.ComponentCount);
+    Result->SetNumberField("shape_count", Stats.ShapeCount);
+    Result->SetNumberField("traced_component_count", Stats.TracedComponentCount);
+    Result->SetStringField("content_hash", FMCPSceneHashIndex::HashToString(ContentHash));
+    Cache.Add(CacheKey, Result);
+
+    const double EndTime = FPlatformTime::Seconds();
+    TSharedPtr<FJsonObject> Response = MakeShared<FJsonObject>(*Result);
+    Response->SetBoolField("cached", false);
+    Response->SetNumberField("collect_ms", (CollectTime - StartTime) * 1000.0);
+    Response->SetNumberField("voxelize_ms", (VoxelizeTime - CollectTime) * 1000.0);
+    Response->SetNumberField("encode_ms", (EndTime - VoxelizeTime) * 1000.0);
+
+    MCP_LOG_INFO("Occupancy grid %dx%dx%d: %lld voxels occupied by %d shapes and %d traced components",
+        Grid.Size.X, Grid.Size.Y, Grid.Size.Z, Stats.OccupiedCount, Stats.ShapeCount, Stats.TracedComponentCount);
+    return CreateSuccessResponse(Response);
+}
@@ -0,0 +1,1716 @@
+#include "MCPCommandHandlers_Scene.h"
+
+#include "Editor.h"
+#include "EngineUtils.h"
+#include "Engine/Level.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "Async/ParallelFor.h"
+#include "CollisionQueryParams.h"
+#include "ScopedTransaction.h"
+#include "ActorEditorUtils.h"
+#include "Selection.h"
+#include "AI/NavigationSystemBase.h"
+#include "GameFramework/WorldSettings.h"
+#include "UObject/UObjectGlobals.h"
+#include "Misc/Paths.h"
+#include "MCPFileLogger.h"
+#include "MCPConstants.h"
+#include "MCPPackedData.h"
+#include "MCPPoissonDiskSampler.h"
+#include "MCPSceneSnapshot.h"
+#include "MCPSceneHashes.h"
+#include "MCPSceneExport.h"
+#include "MCPSceneSummary.h"
+#include "MCPSceneCheckpoint.h"
+#include "MCPSceneDiff.h"
+
+#define LOCTEXT_NAMESPACE "MCPSceneCommands"
+
+namespace
+{
+    bool TryGetVector(const TSharedPtr<FJsonObject>& Object, const FString& FieldName, FVector& OutVector)
+    {
+        const TArray<TSharedPtr<FJsonValue>>* ArrayPtr = nullptr;
+        if (!Object->TryGetArrayField(FieldName, ArrayPtr) || !ArrayPtr || ArrayPtr->Num() != 3)
+        {
+            return false;
+        }
+        OutVector = FVector((*ArrayPtr)[0]->AsNumber(), (*ArrayPtr)[1]->AsNumber(), (*ArrayPtr)[2]->AsNumber());
+        return true;
+    }
+
+    /** Reads an optional [min, max] pair, leaving the default when absent */
+    /** Read an optional [min, max] field; returns false if present but not two numbers, leaving the range as it was */
+    bool GetRange(const TSharedPtr<FJsonObject>& Object, const FString& FieldName, FVector2D& InOutRange)
+    {
+        if (!Object->HasField(FieldName))
+        {
+            return true;
+        }
+        const TArray<TSharedPtr<FJsonValue>>* ArrayPtr = nullptr;
+        double Min = 0.0;
+        double Max = 0.0;
+        if (!Object->TryGetArrayField(FieldName, ArrayPtr) || !ArrayPtr || ArrayPtr->Num() != 2
+            || !(*ArrayPtr)[0]->TryGetNumber(Min) || !(*ArrayPtr)[1]->TryGetNumber(Max))
+        {
+            return false;
+        }
+        InOutRange = FVector2D(Min, Max);
+        return true;
+    }
+
+    TSharedPtr<FJsonObject> DescribeCheckpoint(const FMCPSceneCheckpoint& Checkpoint)
+    {
+        TSharedPtr<FJsonObject> Info = MakeShared<FJsonObject>();
+        Info->SetStringField("id", Checkpoint.Id);
+        if (!Checkpoint.Label.IsEmpty())
+        {
+            Info->SetStringField("label", Checkpoint.Label);
+        }
+        Info->SetNumberField("actor_count", Checkpoint.Entries.Num());
+        Info->SetNumberField("compressed_bytes", static_cast<double>(Checkpoint.CompressedSize));
+        Info->SetNumberField("uncompressed_bytes", static_cast<double>(Checkpoint.UncompressedSize));
+        Info->SetNumberField("scene_version", static_cast<double>(Checkpoint.SceneVersion));
+        Info->SetStringField("created", Checkpoint.CreatedAt.ToIso8601());
+        return Info;
+    }
+
+    TArray<TSharedPtr<FJsonValue>> MakeActorNameArray(const TArray<FName>& Names)
+    {
+        TArray<TSharedPtr<FJsonValue>> Array;
+        for (int32 Index = 0; Index < FMath::Min(Names.Num(), MCPConstants::MAX_ACTORS_IN_RESTORE_REPORT); ++Index)
+        {
+            Array.Add(MakeShared<FJsonValueString>(Names[Index].ToString()));
+        }
+        return Array;
+    }
+}
+
+//
+// FMCPSceneUtils
+//
+AActor* FMCPSceneUtils::FindActorByName(UWorld* World, const FName& ActorName)
+{
+    if (!World || ActorName.IsNone())
+    {
+        return nullptr;
+    }
+
+    // Actors are outered to their level, so a hashed lookup per level replaces a scan of every actor
+    for (ULevel* Level : World->GetLevels())
+    {
+        if (!Level)
+        {
+            continue;
+        }
+
+        AActor* Actor = FindObjectFast<AActor>(Level, ActorName);
+        if (IsValid(Actor))
+        {
+            return Actor;
+        }
+    }
+    return nullptr;
+}
+
+bool FMCPSceneUtils::TryGetNameArray(const TSharedPtr<FJsonObject>& Params, const FString& FieldName, TArray<FName>& OutNames)
+{
+    const TArray<TSharedPtr<FJsonValue>>* NamesArrayPtr = nullptr;
+    if (!Params->TryGetArrayField(FieldName, NamesArrayPtr) || !NamesArrayPtr)
+    {
+        return false;
+    }
+
+    OutNames.Reset(NamesArrayPtr->Num());
+    for (const TSharedPtr<FJsonValue>& Value : *NamesArrayPtr)
+    {
+        OutNames.Add(FName(*Value->AsString()));
+    }
+    return true;
+}
+
+bool FMCPSceneUtils::CollectTargetActors(UWorld* World, const TSharedPtr<FJsonObject>& Params, TArray<AActor*>& OutActors, TArray<TSharedPtr<FJsonValue>>& OutMissing, FString& OutError)
+{
+    TArray<FName> Names;
+    const bool bHasNames = TryGetNameArray(Params, TEXT("names"), Names);
+
+    FMCPActorFilter Filter;
+    const TSharedPtr<FJsonObject>* FilterObject = nullptr;
+    if (Params->TryGetObjectField(FStringView(TEXT("filter")), FilterObject) && FilterObject && !Filter.Parse(*FilterObject, OutError))
+    {
+        return false;
+    }
+
+    // An empty filter matches the whole level, which a bulk edit should never do by accident
+    if (!bHasNames && Filter.IsEmpty())
+    {
+        OutError = TEXT("Missing 'names' or a non-empty 'filter' field");
+        return false;
+    }
+
+    if (bHasNames)
+    {
+        TSet<AActor*> Seen;
+        Seen.Reserve(Names.Num());
+        for (const FName& Name : Names)
+        {
+            AActor* Actor = FindActorByName(World, Name);
+            if (!Actor)
+            {
+                OutMissing.Add(MakeShared<FJsonValueString>(Name.ToString()));
+            }
+            else if (Filter.Matches(Actor) && !Seen.Contains(Actor))
+            {
+                Seen.Add(Actor);
+                OutActors.Add(Actor);
+            }
+        }
+    }
+    else
+    {
+        for (TActorIterator<AActor> It(World); It; ++It)
+        {
+            if (Filter.Matches(*It))
+            {
+                OutActors.Add(*It);
+            }
+        }
+    }
+    return true;
+}
+
+void FMCPSceneUtils::LoadMeshes(const TArray<FString>& MeshPaths, TArray<UStaticMesh*>& OutMeshes)
+{
+    // Request every mesh that is not already in memory in one batch so the packages stream in parallel,
+    // then block on it: the caller spawns right after, so this is a synchronous load, just not a serial one
+    TArray<FSoftObjectPath> PathsToLoad;
+    for (const FString& MeshPath : MeshPaths)
+    {
+        const FSoftObjectPath SoftPath(MeshPath);
+        if (SoftPath.IsValid() && !SoftPath.ResolveObject())
+        {
+            PathsToLoad.AddUnique(SoftPath);
+        }
+    }
+
+    TSharedPtr<FStreamableHandle> Handle;
+    if (PathsToLoad.Num() > 0)
+    {
+        Handle = UAssetManager::GetStreamableManager().RequestAsyncLoad(PathsToLoad, FStreamableDelegate(), FStreamableManager::AsyncLoadHighPriority);
+        if (Handle.IsValid())
+        {
+            Handle->WaitUntilComplete();
+        }
+    }
+
+    OutMeshes.Reset(MeshPaths.Num());
+    for (const FString& MeshPath : MeshPaths)
+    {
+        UStaticMesh* Mesh = Cast<UStaticMesh>(FSoftObjectPath(MeshPath).ResolveObject());
+        if (!Mesh && !MeshPath.IsEmpty())
+        {
+            // Fall back to a synchronous load for path forms the soft path could not resolve
+            Mesh = LoadObject<UStaticMesh>(nullptr, *MeshPath);
+        }
+        if (!Mesh)
+        {
+            MCP_LOG_WARNING("Failed to load mesh %s", *MeshPath);
+        }
+        OutMeshes.Add(Mesh);
+    }
+}
+
+AActor* FMCPSceneUtils::SpawnInstancedMeshActor(
+    UWorld* World,
+    const FString& Label,
+    const TArray<UStaticMesh*>& Meshes,
+    const TArray<TArray<FTransform>>& InstanceTransforms,
+    TArray<UHierarchicalInstancedStaticMeshComponent*>& OutComponents)
+{
+    OutComponents.Reset();
+    if (!World || Meshes.Num() != InstanceTransforms.Num())
+    {
+        return nullptr;
+    }
+
+    FActorSpawnParameters SpawnParams;
+    SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+    AActor* Actor = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParams);
+    if (!Actor)
+    {
+        MCP_LOG_ERROR("Failed to spawn instanced mesh actor");
+        return nullptr;
+    }
+
+    USceneComponent* Root = NewObject<USceneComponent>(Actor, TEXT("Root"), RF_Transactional);
+    Actor->SetRootComponent(Root);
+    Actor->AddInstanceComponent(Root);
+    Root->RegisterComponent();
+
+    for (int32 MeshIndex = 0; MeshIndex < Meshes.Num(); ++MeshIndex)
+    {
+        UStaticMesh* Mesh = Meshes[MeshIndex];
+        if (!Mesh || InstanceTransforms[MeshIndex].Num() == 0)
+        {
+            OutComponents.Add(nullptr);
+            continue;
+        }
+
+        const FName ComponentName = MakeUniqueObjectName(Actor, UHierarchicalInstancedStaticMeshComponent::StaticClass(), Mesh->GetFName());
+        UHierarchicalInstancedStaticMeshComponent* Component = NewObject<UHierarchicalInstancedStaticMeshComponent>(Actor, ComponentName, RF_Transactional);
+        Component->SetStaticMesh(Mesh);
+        Component->SetupAttachment(Root);
+        Actor->AddInstanceComponent(Component);
+        Component->RegisterComponent();
+
+        // One call per mesh so the cluster tree is built once instead of per instance
+        Component->AddInstances(InstanceTransforms[MeshIndex], false, true);
+        OutComponents.Add(Component);
+    }
+
+    Actor->SetActorLabel(Label);
+    return Actor;
+}
+
+TArray<TSharedPtr<FJsonValue>> FMCPSceneUtils::MakeVectorArray(const FVector& Vector)
+{
+    TArray<TSharedPtr<FJsonValue>> Array;
+    Array.Add(MakeShared<FJsonValueNumber>(Vector.X));
+    Array.Add(MakeShared<FJsonValueNumber>(Vector.Y));
+    Array.Add(MakeShared<FJsonValueNumber>(Vector.Z));
+    return Array;
+}
+
+TArray<TSharedPtr<FJsonValue>> FMCPSceneUtils::MakeRotatorArray(const FRotator& Rotator)
+{
+    TArray<TSharedPtr<FJsonValue>> Array;
+    Array.Add(MakeShared<FJsonValueNumber>(Rotator.Pitch));
+    Array.Add(MakeShared<FJsonValueNumber>(Rotator.Yaw));
+    Array.Add(MakeShared<FJsonValueNumber>(Rotator.Roll));
+    return Array;
+}
+
+//
+// FMCPGetSceneChangesHandler
+//
+TSharedPtr<FJsonObject> FMCPGetSceneChangesHandler::Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket)
+{
+    MCP_LOG_INFO("Handling get_scene_changes command");
+
+    FMCPSceneJournal& Journal = FMCPSceneJournal::Get();
+    if (!Journal.IsInitialized())
+    {
+        return CreateErrorResponse("Scene journal is not running");
+    }
+
+    double SinceVersionNumber = 0.0;
+    if (!Params->TryGetNumberField(FStringView(TEXT("since_version")), SinceVersionNumber) || SinceVersionNumber < 0.0)
+    {
+        MCP_LOG_WARNING("Missing or invalid 'since_version' field in get_scene_changes command");
+        return CreateErrorResponse("Missing or invalid 'since_version' field");
+    }
+    const uint64 SinceVersion = static_cast<uint64>(SinceVersionNumber);
+
+    int32 MaxChanges = MCPConstants::MAX_CHANGES_IN_SCENE_DELTA;
+    Params->TryGetNumberField(FStringView(TEXT("max_changes")), MaxChanges);
+    MaxChanges = FMath::Max(MaxChanges, 1);
+
+    bool bCoalesce = true;
+    Params->TryGetBoolField(FStringView(TEXT("coalesce")), bCoalesce);
+
+    TArray<FMCPSceneChange> Changes;
+    bool bTruncated = false;
+    const bool bCovered = Journal.GetChangesSince(SinceVersion, MaxChanges, Changes, bTruncated);
+
+    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+    Result->SetNumberField("current_version", static_cast<double>(Journal.GetCurrentVersion()));
+    Result->SetNumberField("oldest_version", static_cast<double>(Journal.GetResyncFloor()));
+
+    if (!bCovered)
+    {
+        // The client has to fall back to a full get_scene_info, which reports the version to resume from
+        MCP_LOG_INFO("Version %llu is no longer covered by the scene journal, resync required", SinceVersion);
+        Result->SetBoolField("resync_required", true);
+        Result->SetArrayField("changes", TArray<TSharedPtr<FJsonValue>>());
+        return CreateSuccessResponse(Result);
+    }
+
+    // When truncated the client resumes from the last version it received
+    const uint64 ReturnedVersion = Changes.Num() > 0 ? Changes.Last().Version : SinceVersion;
+
+    TArray<TSharedPtr<FJsonValue>> ChangesArray;
+    if (bCoalesce)
+    {
+        TMap<FName, TArray<FName>> Properties;
+        for (const FMCPSceneChange& Change : CoalesceChanges(Changes, Properties))
+        {
+            ChangesArray.Add(MakeShared<FJsonValueObject>(ChangeToJson(Change, Properties.Find(Change.ActorName))));
+        }
+    }
+    else
+    {
+        for (const FMCPSceneChange& Change : Changes)
+        {
+            TArray<FName> Properties;
+            if (!Change.PropertyName.IsNone())
+            {
+                Properties.Add(Change.PropertyName);
+            }
+            ChangesArray.Add(MakeShared<FJsonValueObject>(ChangeToJson(Change, &Properties)));
+        }
+    }
+
+    Result->SetBoolField("resync_required", false);
+    Result->SetNumberField("returned_version", static_cast<double>(ReturnedVersion));
+    Result->SetBoolField("limit_reached", bTruncated);
+    Result->SetArrayField("changes", ChangesArray);
+
+    MCP_LOG_INFO("Sending get_scene_changes response with %d changes (%d journal entries)", ChangesArray.Num(), Changes.Num());
+    return CreateSuccessResponse(Result);
+}
+
+TArray<FMCPSceneChange> FMCPGetSceneChangesHandler::CoalesceChanges(const TArray<FMCPSceneChange>& Changes, TMap<FName, TArray<FName>>& OutProperties)
+{
+    TArray<FMCPSceneChange> Coalesced;
+    TArray<bool> Dropped;
+    TMap<FName, int32> IndexByActor;
+
+    for (const FMCPSceneChange& Change : Changes)
+    {
+        if (!Change.PropertyName.IsNone())
+        {
+            OutProperties.FindOrAdd(Change.ActorName).AddUnique(Change.PropertyName);
+        }
+
+        int32* ExistingIndex = IndexByActor.Find(Change.ActorName);
+        if (!ExistingIndex || Dropped[*ExistingIndex])
+        {
+            IndexByActor.Add(Change.ActorName, Coalesced.Add(Change));
+            Dropped.Add(false);
+            continue;
+        }
+
+        FMCPSceneChange& Existing = Coalesced[*ExistingIndex];
+        const EMCPSceneChangeType PreviousType = Existing.Type;
+        Existing = Change;
+
+        switch (Change.Type)
+        {
+            case EMCPSceneChangeType::Removed:
+                // An actor that was both created and destroyed inside the window never existed for the client
+                if (PreviousType == EMCPSceneChangeType::Added)
+                {
+                    Dropped[*ExistingIndex] = true;
+                    OutProperties.Remove(Change.ActorName);
+                }
+                break;
+
+            case EMCPSceneChangeType::Transform:
+            case EMCPSceneChangeType::Property:
+                // Later edits of a new actor are folded into the add, otherwise a transform change wins over a property change
+                if (PreviousType == EMCPSceneChangeType::Added)
+                {
+                    Existing.Type = EMCPSceneChangeType::Added;
+                }
+                else if (PreviousType == EMCPSceneChangeType::Transform)
+                {
+                    Existing.Type = EMCPSceneChangeType::Transform;
+                }
+                break;
+
+            case EMCPSceneChangeType::Added:
+            default:
+                break;
+        }
+    }
+
+    TArray<FMCPSceneChange> Result;
+    Result.Reserve(Coalesced.Num());
+    for (int32 Index = 0; Index < Coalesced.Num(); ++Index)
+    {
+        if (!Dropped[Index])
+        {
+            Result.Add(MoveTemp(Coalesced[Index]));
+        }
+    }
+    return Result;
+}
+
+TSharedPtr<FJsonObject> FMCPGetSceneChangesHandler::ChangeToJson(const FMCPSceneChange& Change, const TArray<FName>* Properties)
+{
+    TSharedPtr<FJsonObject> ChangeInfo = MakeShared<FJsonObject>();
+    ChangeInfo->SetNumberField("version", static_cast<double>(Change.Version));
+    ChangeInfo->SetStringField("change", FMCPSceneJournal::ChangeTypeToString(Change.Type));
+    ChangeInfo->SetStringField("name", Change.ActorName.ToString());
+    ChangeInfo->SetStringField("type", Change.ClassName.ToString());
+
+    if (Change.Type != EMCPSceneChangeType::Removed)
+    {
+        ChangeInfo->SetStringField("label", Change.Label);
+        ChangeInfo->SetArrayField("location", FMCPSceneUtils::MakeVectorArray(Change.Transform.GetLocation()));
+        ChangeInfo->SetArrayField("rotation", FMCPSceneUtils::MakeRotatorArray(Change.Transform.Rotator()));
+        ChangeInfo->SetArrayField("scale", FMCPSceneUtils::MakeVectorArray(Change.Transform.GetScale3D()));
+    }
+
+    if (Properties && Properties->Num() > 0)
+    {
+        TArray<TSharedPtr<FJsonValue>> PropertiesArray;
+        for (const FName& PropertyName : *Properties)
+        {
+            PropertiesArray.Add(MakeShared<FJsonValueString>(PropertyName.ToString()));
+        }
+        ChangeInfo->SetArrayField("properties", PropertiesArray);
+    }
+
+    return ChangeInfo;
+}
+
+//
+// FMCPModifyObjectsHandler
+//
+TSharedPtr<FJsonObject> FMCPModifyObjectsHandler::Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket)
+{
+    MCP_LOG_INFO("Handling modify_objects command");
+
+    UWorld* World = GEditor->GetEditorWorldContext().World();
+
+    TArray<FName> Names;
+    if (!FMCPSceneUtils::TryGetNameArray(Params, TEXT("names"), Names))
+    {
+        MCP_LOG_WARNING("Missing 'names' field in modify_objects command");
+        return CreateErrorResponse("Missing 'names' field");
+    }
+    const int32 NumActors = Names.Num();
+
+    FString RotationFormat = TEXT("euler");
+    Params->TryGetStringField(FStringView(TEXT("rotation_format")), RotationFormat);
+    const bool bQuatRotations = RotationFormat == TEXT("quat");
+
+    // Every column is optional; a missing column keeps that part of each actor's transform, but a column
+    // that is present must decode, or the batch would apply the other columns alone
+    TArray<float> Locations;
+    TArray<float> Rotations;
+    TArray<float> Scales;
+    const bool bHasLocations = Params->HasField(FStringView(TEXT("locations")));
+    const bool bHasRotations = Params->HasField(FStringView(TEXT("rotations")));
+    const bool bHasScales = Params->HasField(FStringView(TEXT("scales")));
+
+    if (!bHasLocations && !bHasRotations && !bHasScales)
+    {
+        MCP_LOG_WARNING("No 'locations', 'rotations' or 'scales' in modify_objects command");
+        return CreateErrorResponse("No 'locations', 'rotations' or 'scales' specified");
+    }
+
+    const TPair<const TCHAR*, TArray<float>*> Columns[] = {
+        { TEXT("locations"), bHasLocations ? &Locations : nullptr },
+        { TEXT("rotations"), bHasRotations ? &Rotations : nullptr },
+        { TEXT("scales"), bHasScales ? &Scales : nullptr }
+    };
+    for (const TPair<const TCHAR*, TArray<float>*>& Column : Columns)
+    {
+        if (!Column.Value)
+        {
+            continue;
+        }
+        if (!FMCPPackedData::TryGetFloatColumn(Params, Column.Key, *Column.Value))
+        {
+            MCP_LOG_WARNING("Invalid '%s' column in modify_objects command", Column.Key);
+            return CreateErrorResponse(FString::Printf(TEXT("'%s' must be a number array or base64 packed float32 values"), Column.Key));
+        }
+        const int32 Expected = NumActors * (Column.Value == &Rotations && bQuatRotations ? 4 : 3);
+        if (Column.Value->Num() != Expected)
+        {
+            MCP_LOG_WARNING("'%s' has %d values for %d names in modify_objects command", Column.Key, Column.Value->Num(), NumActors);
+            return CreateErrorResponse(FString::Printf(TEXT("'%s' has %d values; expected %d for %d names"), Column.Key, Column.Value->Num(), Expected, NumActors));
+        }
+    }
+
+    bool bTransact = true;
+    Params->TryGetBoolField(FStringView(TEXT("transact")), bTransact);
+
+    TArray<AActor*> MovedActors;
+    MovedActors.Reserve(NumActors);
+    TArray<TSharedPtr<FJsonValue>> MissingArray;
+
+    {
+        // One undo entry for the whole batch. Nothing in the loop invalidates the viewports or the outliner:
+        // SetActorTransform raises no editor events, so the single BroadcastActorsMoved and redraw after the
+        // loop are the only refreshes, and no suspension scope is needed
+        TUniquePtr<FScopedTransaction> Transaction;
+        if (bTransact)
+        {
+            Transaction = MakeUnique<FScopedTransaction>(LOCTEXT("ModifyObjects", "MCP Modify Objects"));
+        }
+
+        for (int32 Index = 0; Index < NumActors; ++Index)
+        {
+            AActor* Actor = FMCPSceneUtils::FindActorByName(World, Names[Index]);
+            if (!Actor)
+            {
+                MissingArray.Add(MakeShared<FJsonValueString>(Names[Index].ToString()));
+                continue;
+            }
+
+            FTransform Transform = Actor->GetActorTransform();
+            if (bHasLocations)
+            {
+                const float* Location = &Locations[Index * 3];
+                Transform.SetLocation(FVector(Location[0], Location[1], Location[2]));
+            }
+            if (bHasRotations)
+            {
+                if (bQuatRotations)
+                {
+                    const float* Rotation = &Rotations[Index * 4];
+                    Transform.SetRotation(FQuat(Rotation[0], Rotation[1], Rotation[2], Rotation[3]).GetNormalized());
+                }
+                else
+                {
+                    const float* Rotation = &Rotations[Index * 3];
+                    Transform.SetRotation(FRotator(Rotation[0], Rotation[1], Rotation[2]).Quaternion());
+                }
+            }
+            if (bHasScales)
+            {
+                const float* Scale = &Scales[Index * 3];
+                Transform.SetScale3D(FVector(Scale[0], Scale[1], Scale[2]));
+            }
+
+            if (bTransact)
+            {
+                Actor->Modify();
+            }
+
+            // A single component transform update instead of one per location/rotation/scale setter
+            Actor->SetActorTransform(Transform, false, nullptr, ETeleportType::TeleportPhysics);
+            FMCPSceneJournal::Get().RecordChange(EMCPSceneChangeType::Transform, Actor);
+            MovedActors.Add(Actor);
+        }
+    }
+
+    if (MovedActors.Num() > 0)
+    {
+        GEngine->BroadcastActorsMoved(MovedActors);
+        GEditor->RedrawLevelEditingViewports();
+    }
+
+    if (MissingArray.Num() > 0)
+    {
+        MCP_LOG_WARNING("modify_objects could not find %d of %d actors", MissingArray.Num(), NumActors);
+    }
+
+    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+    Result->SetNumberField("modified_count", MovedActors.Num());
+    Result->SetArrayField("missing", MissingArray);
+
+    MCP_LOG_INFO("Modified %d actors in one batch", MovedActors.Num());
+    return CreateSuccessResponse(Result);
+}
+
+//
+// FMCPCreateObjectsHandler
+//
+TSharedPtr<FJsonObject> FMCPCreateObjectsHandler::Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket)
+{
+    MCP_LOG_INFO("Handling create_objects command");
+
+    UWorld* World = GEditor->GetEditorWorldContext().World();
+
+    // Meshes are given as a table of unique paths referenced by index, or as a single path for every object
+    TArray<FString> MeshTable;
+    FString SingleMesh;
+    const TArray<TSharedPtr<FJsonValue>>* MeshTablePtr = nullptr;
+    if (Params->TryGetArrayField(FStringView(TEXT("meshes")), MeshTablePtr) && MeshTablePtr)
+    {
+        for (const TSharedPtr<FJsonValue>& Value : *MeshTablePtr)
+        {
+            MeshTable.Add(Value->AsString());
+        }
+    }
+    else if (Params->TryGetStringField(FStringView(TEXT("mesh")), SingleMesh))
+    {
+        MeshTable.Add(SingleMesh);
+    }
+    else
+    {
+        MCP_LOG_WARNING("Missing 'meshes' or 'mesh' field in create_objects command");
+        return CreateErrorResponse("Missing 'meshes' or 'mesh' field");
+    }
+
+    TArray<float> Locations;
+    if (!FMCPPackedData::TryGetFloatColumn(Params, TEXT("locations"), Locations) || Locations.Num() % 3 != 0)
+    {
+        MCP_LOG_WARNING("Missing or invalid 'locations' field in create_objects command");
+        return CreateErrorResponse("Missing or invalid 'locations' field");
+    }
+    const int32 NumObjects = Locations.Num() / 3;
+
+    // Optional columns that are present must decode, so a bad payload is rejected before anything spawns
+    TArray<float> Rotations;
+    TArray<float> Scales;
+    const bool bHasRotations = Params->HasField(FStringView(TEXT("rotations")));
+    const bool bHasScales = Params->HasField(FStringView(TEXT("scales")));
+    if (bHasRotations && !FMCPPackedData::TryGetFloatColumn(Params, TEXT("rotations"), Rotations))
+    {
+        return CreateErrorResponse("'rotations' must be a number array or base64 packed float32 values");
+    }
+    if (bHasScales && !FMCPPackedData::TryGetFloatColumn(Params, TEXT("scales"), Scales))
+    {
+        return CreateErrorResponse("'scales' must be a number array or base64 packed float32 values");
+    }
+    if ((bHasRotations && Rotations.Num() != NumObjects * 3) || (bHasScales && Scales.Num() != NumObjects * 3))
+    {
+        MCP_LOG_WARNING("Column sizes do not match %d objects in create_objects command", NumObjects);
+        return CreateErrorResponse(FString::Printf(TEXT("'rotations' and 'scales' must have 3 values for each of the %d objects"), NumObjects));
+    }
+
+    TArray<uint32> MeshIndices;
+    const bool bHasMeshIndices = Params->HasField(FStringView(TEXT("mesh_indices")));
+    if (bHasMeshIndices && !FMCPPackedData::TryGetUInt32Column(Params, TEXT("mesh_indices"), MeshIndices))
+    {
+        return CreateErrorResponse("'mesh_indices' must be non-negative integers or base64 packed uint32 values");
+    }
+    if (bHasMeshIndices)
+    {
+        if (MeshIndices.Num() != NumObjects)
+        {
+            return CreateErrorResponse(FString::Printf(TEXT("'mesh_indices' must have one entry for each of the %d objects"), NumObjects));
+        }
+        for (uint32 MeshIndex : MeshIndices)
+        {
+            if (MeshIndex >= static_cast<uint32>(MeshTable.Num()))
+            {
+                return CreateErrorResponse(FString::Printf(TEXT("Mesh index %u is out of range"), MeshIndex));
+            }
+        }
+    }
+    else if (MeshTable.Num() == 1)
+    {
+        MeshIndices.Init(0, NumObjects);
+    }
+    else
+    {
+        return CreateErrorResponse("'mesh_indices' is required when more than one mesh is given");
+    }
+
+    FString Mode = TEXT("actors");
+    Params->TryGetStringField(FStringView(TEXT("mode")), Mode);
+    const bool bInstanced = Mode == TEXT("instanced");
+
+    const int32 MaxObjects = bInstanced ? MCPConstants::MAX_INSTANCES_PER_CREATE_OBJECTS : MCPConstants::MAX_ACTORS_PER_CREATE_OBJECTS;
+    if (NumObjects > MaxObjects)
+    {
+        MCP_LOG_WARNING("create_objects request for %d objects exceeds the limit of %d", NumObjects, MaxObjects);
+        return CreateErrorResponse(FString::Printf(TEXT("Too many objects (%d). The limit for mode '%s' is %d"), NumObjects, *Mode, MaxObjects));
+    }
+
+    // Each unique mesh is loaded once, all of them in a single blocking batch
+    TArray<UStaticMesh*> Meshes;
+    FMCPSceneUtils::LoadMeshes(MeshTable, Meshes);
+
+    TArray<FTransform> Transforms;
+    Transforms.SetNum(NumObjects);
+    for (int32 Index = 0; Index < NumObjects; ++Index)
+    {
+        const float* Location = &Locations[Index * 3];
+        Transforms[Index].SetLocation(FVector(Location[0], Location[1], Location[2]));
+        if (bHasRotations)
+        {
+            const float* Rotation = &Rotations[Index * 3];
+            Transforms[Index].SetRotation(FRotator(Rotation[0], Rotation[1], Rotation[2]).Quaternion());
+        }
+        if (bHasScales)
+        {
+            const float* Scale = &Scales[Index * 3];
+            Transforms[Index].SetScale3D(FVector(Scale[0], Scale[1], Scale[2]));
+        }
+    }
+
+    FScopedTransaction Transaction(LOCTEXT("CreateObjects", "MCP Create Objects"));
+    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+
+    if (bInstanced)
+    {
+        TArray<TArray<FTransform>> InstanceTransforms;
+        InstanceTransforms.SetNum(MeshTable.Num());
+        for (int32 Index = 0; Index < NumObjects; ++Index)
+        {
+            InstanceTransforms[MeshIndices[Index]].Add(Transforms[Index]);
+        }
+
+        FString Label = TEXT("MCP_Instances");
+        Params->TryGetStringField(FStringView(TEXT("label")), Label);
+
+        TArray<UHierarchicalInstancedStaticMeshComponent*> Components;
+        AActor* Actor = FMCPSceneUtils::SpawnInstancedMeshActor(World, Label, Meshes, InstanceTransforms, Components);
+        if (!Actor)
+        {
+            return CreateErrorResponse("Failed to create instanced mesh actor");
+        }
+
+        TArray<TSharedPtr<FJsonValue>> ComponentsArray;
+        for (int32 MeshIndex = 0; MeshIndex < Components.Num(); ++MeshIndex)
+        {
+            if (!Components[MeshIndex])
+            {
+                continue;
+            }
+            TSharedPtr<FJsonObject> ComponentInfo = MakeShared<FJsonObject>();
+            ComponentInfo->SetStringField("name", Components[MeshIndex]->GetName());
+            ComponentInfo->SetStringField("mesh", MeshTable[MeshIndex]);
+            ComponentInfo->SetNumberField("instance_count", Components[MeshIndex]->GetInstanceCount());
+            ComponentsArray.Add(MakeShared<FJsonValueObject>(ComponentInfo));
+        }
+
+        Result->SetStringField("name", Actor->GetName());
+        Result->SetStringField("label", Actor->GetActorLabel());
+        Result->SetArrayField("components", ComponentsArray);
+        MCP_LOG_INFO("Created %d instances across %d components", NumObjects, ComponentsArray.Num());
+    }
+    else
+    {
+        const TArray<TSharedPtr<FJsonValue>>* LabelsPtr = nullptr;
+        Params->TryGetArrayField(FStringView(TEXT("labels")), LabelsPtr);
+
+        TArray<TSharedPtr<FJsonValue>> NamesArray;
+        NamesArray.Reserve(NumObjects);
+        for (int32 Index = 0; Index < NumObjects; ++Index)
+        {
+            // Deferred spawn so the mesh is set before the component registers, avoiding a second render/physics setup
+            AStaticMeshActor* Actor = World->SpawnActorDeferred<AStaticMeshActor>(
+                AStaticMeshActor::StaticClass(), Transforms[Index], nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+            if (!Actor)
+            {
+                MCP_LOG_ERROR("Failed to spawn actor %d of %d", Index, NumObjects);
+                continue;
+            }
+
+            if (UStaticMesh* Mesh = Meshes[MeshIndices[Index]])
+            {
+                Actor->GetStaticMeshComponent()->SetStaticMesh(Mesh);
+            }
+            Actor->FinishSpawning(Transforms[Index]);
+
+            if (LabelsPtr && LabelsPtr->IsValidIndex(Index))
+            {
+                Actor->SetActorLabel((*LabelsPtr)[Index]->AsString());
+            }
+            NamesArray.Add(MakeShared<FJsonValueString>(Actor->GetName()));
+        }
+
+        Result->SetArrayField("names", NamesArray);
+        MCP_LOG_INFO("Created %d of %d actors", NamesArray.Num(), NumObjects);
+    }
+
+    TArray<TSharedPtr<FJsonValue>> FailedMeshesArray;
+    for (int32 MeshIndex = 0; MeshIndex < Meshes.Num(); ++MeshIndex)
+    {
+        if (!Meshes[MeshIndex])
+        {
+            FailedMeshesArray.Add(MakeShared<FJsonValueString>(MeshTable[MeshIndex]));
+        }
+    }
+    Result->SetArrayField("failed_meshes", FailedMeshesArray);
+
+    GEditor->RedrawLevelEditingViewports();
+    return CreateSuccessResponse(Result);
+}
+
+//
+// FMCPScatterHandler
+//
+TSharedPtr<FJsonObject> FMCPScatterHandler::Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket)
+{
+    MCP_LOG_INFO("Handling scatter command");
+
+    UWorld* World = GEditor->GetEditorWorldContext().World();
+    const double StartTime = FPlatformTime::Seconds();
+
+    // Region: an axis-aligned box, or a polygon in XY with a separate height range
+    FBox2D Bounds(ForceInit);
+    TArray<FVector2D> Polygon;
+    FVector2D HeightRange(0.0, 0.0);
+    bool bHasHeightRange = false;
+
+    const TSharedPtr<FJsonObject>* BoxObject = nullptr;
+    const TArray<TSharedPtr<FJsonValue>>* PolygonArrayPtr = nullptr;
+    if (Params->TryGetObjectField(FStringView(TEXT("box")), BoxObject) && BoxObject)
+    {
+        FVector Min;
+        FVector Max;
+        if (!TryGetVector(*BoxObject, TEXT("min"), Min) || !TryGetVector(*BoxObject, TEXT("max"), Max))
+        {
+            return CreateErrorResponse("'box' needs 'min' and 'max' as [x, y, z]");
+        }
+        Bounds += FVector2D(Min);
+        Bounds += FVector2D(Max);
+        HeightRange = FVector2D(FMath::Min(Min.Z, Max.Z), FMath::Max(Min.Z, Max.Z));
+        bHasHeightRange = true;
+    }
+    else if (Params->TryGetArrayField(FStringView(TEXT("polygon")), PolygonArrayPtr) && PolygonArrayPtr && PolygonArrayPtr->Num() >= 3)
+    {
+        for (const TSharedPtr<FJsonValue>& VertexValue : *PolygonArrayPtr)
+        {
+            const TArray<TSharedPtr<FJsonValue>>& Vertex = VertexValue->AsArray();
+            if (Vertex.Num() < 2)
+            {
+                return CreateErrorResponse("'polygon' vertices must be [x, y]");
+            }
+            Polygon.Add(FVector2D(Vertex[0]->AsNumber(), Vertex[1]->AsNumber()));
+            Bounds += Polygon.Last();
+        }
+        bHasHeightRange = Params->HasField(FStringView(TEXT("z_range")));
+        if (!GetRange(Params, TEXT("z_range"), HeightRange))
+        {
+            return CreateErrorResponse("'z_range' must be [min, max] numbers");
+        }
+    }
+    else
+    {
+        MCP_LOG_WARNING("Missing 'box' or 'polygon' field in scatter command");
+        return CreateErrorResponse("Missing 'box' or 'polygon' field");
+    }
+
+    TArray<FString> MeshTable;
+    const TArray<TSharedPtr<FJsonValue>>* MeshesPtr = nullptr;
+    if (!Params->TryGetArrayField(FStringView(TEXT("meshes")), MeshesPtr) || !MeshesPtr || MeshesPtr->Num() == 0)
+    {
+        MCP_LOG_WARNING("Missing 'meshes' field in scatter command");
+        return CreateErrorResponse("Missing 'meshes' field");
+    }
+    for (const TSharedPtr<FJsonValue>& Value : *MeshesPtr)
+    {
+        MeshTable.Add(Value->AsString());
+    }
+
+    TArray<float> Weights;
+    if (!FMCPPackedData::TryGetFloatColumn(Params, TEXT("weights"), Weights) || Weights.Num() != MeshTable.Num())
+    {
+        Weights.Init(1.0f, MeshTable.Num());
+    }
+
+    double MinSpacing = 0.0;
+    Params->TryGetNumberField(FStringView(TEXT("min_spacing")), MinSpacing);
+    int32 Seed = 0;
+    Params->TryGetNumberField(FStringView(TEXT("seed")), Seed);
+
+    FMCPPoissonDiskSampler Sampler(Bounds, static_cast<float>(MinSpacing), Seed);
+    Sampler.SetPolygon(Polygon);
+    if (Sampler.GetGridCellCount() > MCPConstants::MAX_SCATTER_GRID_CELLS)
+    {
+        return CreateErrorResponse("'min_spacing' is too small for the size of the region");
+    }
+
+    // Density is in instances per square meter; world units are centimeters
+    int32 TargetCount = 0;
+    double Density = 0.0;
+    if (!Params->TryGetNumberField(FStringView(TEXT("count")), TargetCount))
+    {
+        if (!Params->TryGetNumberField(FStringView(TEXT("density")), Density))
+        {
+            MCP_LOG_WARNING("Missing 'density' or 'count' field in scatter command");
+            return CreateErrorResponse("Missing 'density' or 'count' field");
+        }
+        TargetCount = static_cast<int32>(FMath::Min(Density * Sampler.GetArea() / 10000.0, static_cast<double>(MAX_int32)));
+    }
+    if (TargetCount > MCPConstants::MAX_SCATTER_INSTANCES)
+    {
+        return CreateErrorResponse(FString::Printf(TEXT("Scatter would create %d instances. The limit is %d"), TargetCount, MCPConstants::MAX_SCATTER_INSTANCES));
+    }
+
+    FVector2D YawRange(0.0, 360.0);
+    FVector2D PitchRange(0.0, 0.0);
+    FVector2D RollRange(0.0, 0.0);
+    FVector2D ScaleRange(1.0, 1.0);
+    const TPair<const TCHAR*, FVector2D*> Ranges[] = {
+        { TEXT("yaw_range"), &YawRange },
+        { TEXT("pitch_range"), &PitchRange },
+        { TEXT("roll_range"), &RollRange },
+        { TEXT("scale_range"), &ScaleRange }
+    };
+    for (const TPair<const TCHAR*, FVector2D*>& Range : Ranges)
+    {
+        if (!GetRange(Params, Range.Key, *Range.Value))
+        {
+            return CreateErrorResponse(FString::Printf(TEXT("'%s' must be [min, max] numbers"), Range.Key));
+        }
+    }
+
+    bool bConformToGround = false;
+    Params->TryGetBoolField(FStringView(TEXT("conform_to_ground")), bConformToGround);
+
+    // A polygon without a height range finds the ground at any height instead of only around z = 0
+    if (bConformToGround && !bHasHeightRange)
+    {
+        HeightRange = FVector2D(-HALF_WORLD_MAX, HALF_WORLD_MAX);
+    }
+    bool bAlignToNormal = false;
+    Params->TryGetBoolField(FStringView(TEXT("align_to_normal")), bAlignToNormal);
+
+    TArray<FVector2D> Samples;
+    Sampler.Generate(TargetCount, MCPConstants::SCATTER_ATTEMPTS_PER_POINT, Samples);
+    const double SampleTime = FPlatformTime::Seconds();
+
+    // All per-point randomness is drawn sequentially from the same stream so a seed always gives the same layout
+    FRandomStream& RandomStream = Sampler.GetRandomStream();
+    float TotalWeight = 0.0f;
+    for (float Weight : Weights)
+    {
+        TotalWeight += FMath::Max(Weight, 0.0f);
+    }
+
+    const int32 NumSamples = Samples.Num();
+    TArray<FVector> Points;
+    TArray<FRotator> Rotations;
+    TArray<float> Scales;
+    TArray<int32> MeshChoices;
+    Points.SetNumUninitialized(NumSamples);
+    Rotations.SetNumUninitialized(NumSamples);
+    Scales.SetNumUninitialized(NumSamples);
+    MeshChoices.SetNumUninitialized(NumSamples);
+    for (int32 Index = 0; Index < NumSamples; ++Index)
+    {
+        Points[Index] = FVector(Samples[Index], HeightRange.X);
+        Rotations[Index] = FRotator(
+            RandomStream.FRandRange(PitchRange.X, PitchRange.Y),
+            RandomStream.FRandRange(YawRange.X, YawRange.Y),
+            RandomStream.FRandRange(RollRange.X, RollRange.Y));
+        Scales[Index] = RandomStream.FRandRange(ScaleRange.X, ScaleRange.Y);
+
+        float Pick = RandomStream.GetFraction() * TotalWeight;
+        int32 MeshIndex = 0;
+        while (MeshIndex < Weights.Num() - 1 && Pick >= FMath::Max(Weights[MeshIndex], 0.0f))
+        {
+            Pick -= FMath::Max(Weights[MeshIndex], 0.0f);
+            ++MeshIndex;
+        }
+        MeshChoices[Index] = MeshIndex;
+    }
+
+    TArray<FVector> Normals;
+    TArray<bool> Hits;
+    if (bConformToGround)
+    {
+        ConformToGround(World, Points, HeightRange.Y, HeightRange.X, Normals, Hits);
+    }
+
+    TArray<UStaticMesh*> Meshes;
+    FMCPSceneUtils::LoadMeshes(MeshTable, Meshes);
+
+    TArray<TArray<FTransform>> InstanceTransforms;
+    InstanceTransforms.SetNum(MeshTable.Num());
+    int32 DroppedCount = 0;
+    for (int32 Index = 0; Index < NumSamples; ++Index)
+    {
+        // Points that found no ground would float, so they are left out
+        if (bConformToGround && !Hits[Index])
+        {
+            DroppedCount++;
+            continue;
+        }
+
+        FQuat Rotation = Rotations[Index].Quaternion();
+        if (bConformToGround && bAlignToNormal)
+        {
+            Rotation = FQuat::FindBetweenNormals(FVector::UpVector, Normals[Index]) * Rotation;
+        }
+        InstanceTransforms[MeshChoices[Index]].Add(FTransform(Rotation, Points[Index], FVector(Scales[Index])));
+    }
+
+    FString Label = TEXT("MCP_Scatter");
+    Params->TryGetStringField(FStringView(TEXT("label")), Label);
+
+    FScopedTransaction Transaction(LOCTEXT("Scatter", "MCP Scatter"));
+    TArray<UHierarchicalInstancedStaticMeshComponent*> Components;
+    AActor* Actor = FMCPSceneUtils::SpawnInstancedMeshActor(World, Label, Meshes, InstanceTransforms, Components);
+    if (!Actor)
+    {
+        return CreateErrorResponse("Failed to create scatter actor");
+    }
+
+    TArray<TSharedPtr<FJsonValue>> ComponentsArray;
+    int32 InstanceCount = 0;
+    for (int32 MeshIndex = 0; MeshIndex < Components.Num(); ++MeshIndex)
+    {
+        TSharedPtr<FJsonObject> ComponentInfo = MakeShared<FJsonObject>();
+        ComponentInfo->SetStringField("mesh", MeshTable[MeshIndex]);
+        ComponentInfo->SetBoolField("loaded", Meshes[MeshIndex] != nullptr);
+        ComponentInfo->SetNumberField("instance_count", Components[MeshIndex] ? Components[MeshIndex]->GetInstanceCount() : 0);
+        if (Components[MeshIndex])
+        {
+            ComponentInfo->SetStringField("name", Components[MeshIndex]->GetName());
+            InstanceCount += Components[MeshIndex]->GetInstanceCount();
+        }
+        ComponentsArray.Add(MakeShared<FJsonValueObject>(ComponentInfo));
+    }
+
+    GEditor->RedrawLevelEditingViewports();
+
+    const double EndTime = FPlatformTime::Seconds();
+    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+    Result->SetStringField("name", Actor->GetName());
+    Result->SetStringField("label", Actor->GetActorLabel());
+    Result->SetNumberField("requested_count", TargetCount);
+    Result->SetNumberField("sampled_count", NumSamples);
+    Result->SetNumberField("instance_count", InstanceCount);
+    Result->SetNumberField("dropped_without_ground", DroppedCount);
+    Result->SetBoolField("saturated", NumSamples < TargetCount);
+    Result->SetNumberField("sample_ms", (SampleTime - StartTime) * 1000.0);
+    Result->SetNumberField("total_ms", (EndTime - StartTime) * 1000.0);
+    Result->SetArrayField("components", ComponentsArray);
+
+    MCP_LOG_INFO("Scattered %d instances (%d sampled) in %.1f ms", InstanceCount, NumSamples, (EndTime - StartTime) * 1000.0);
+    return CreateSuccessResponse(Result);
+}
+
+void FMCPScatterHandler::ConformToGround(UWorld* World, TArray<FVector>& Points, double TopZ, double BottomZ, TArray<FVector>& OutNormals, TArray<bool>& OutHit)
+{
+    OutNormals.Init(FVector::UpVector, Points.Num());
+    OutHit.Init(false, Points.Num());
+
+    FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(MCPScatter), false);
+    const double StartZ = TopZ + 1.0;
+    const double EndZ = BottomZ - 1.0;
+
+    // Scene queries only read the physics scene, so the batch is split across worker threads
+    ParallelFor(Points.Num(), [&](int32 Index)
+    {
+        FHitResult Hit;
+        const FVector Start(Points[Index].X, Points[Index].Y, StartZ);
+        const FVector End(Points[Index].X, Points[Index].Y, EndZ);
+        if (World->LineTraceSingleByChannel(Hit, Start, End, ECC_WorldStatic, QueryParams))
+        {
+            Points[Index] = Hit.ImpactPoint;
+            OutNormals[Index] = Hit.ImpactNormal;
+            OutHit[Index] = true;
+        }
+    });
+}
+
+//
+// FMCPDeleteObjectsHandler
+//
+TSharedPtr<FJsonObject> FMCPDeleteObjectsHandler::Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket)
+{
+    MCP_LOG_INFO("Handling delete_objects command");
+
+    UWorld* World = GEditor->GetEditorWorldContext().World();
+
+    bool bDryRun = false;
+    Params->TryGetBoolField(FStringView(TEXT("dry_run")), bDryRun);
+    bool bTransact = true;
+    Params->TryGetBoolField(FStringView(TEXT("transact")), bTransact);
+    bool bCollectGarbage = true;
+    Params->TryGetBoolField(FStringView(TEXT("collect_garbage")), bCollectGarbage);
+
+    // Resolve every target before destroying anything so no iterator is invalidated mid-walk
+    TArray<AActor*> Candidates;
+    TArray<TSharedPtr<FJsonValue>> MissingArray;
+    FString TargetError;
+    if (!FMCPSceneUtils::CollectTargetActors(World, Params, Candidates, MissingArray, TargetError))
+    {
+        MCP_LOG_WARNING("Invalid targets in delete_objects command: %s", *TargetError);
+        return CreateErrorResponse(TargetError);
+    }
+
+    TArray<AActor*> Targets;
+    TArray<TSharedPtr<FJsonValue>> SkippedArray;
+    Targets.Reserve(Candidates.Num());
+    for (AActor* Actor : Candidates)
+    {
+        if (IsProtectedActor(Actor))
+        {
+            SkippedArray.Add(MakeShared<FJsonValueString>(Actor->GetName()));
+        }
+        else
+        {
+            Targets.Add(Actor);
+        }
+    }
+
+    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+    Result->SetArrayField("missing", MissingArray);
+    Result->SetArrayField("skipped", SkippedArray);
+
+    if (bDryRun)
+    {
+        TArray<TSharedPtr<FJsonValue>> NamesArray;
+        NamesArray.Reserve(Targets.Num());
+        for (const AActor* Actor : Targets)
+        {
+            NamesArray.Add(MakeShared<FJsonValueString>(Actor->GetName()));
+        }
+        Result->SetBoolField("dry_run", true);
+        Result->SetNumberField("matched_count", Targets.Num());
+        Result->SetArrayField("names", NamesArray);
+        return CreateSuccessResponse(Result);
+    }
+
+    const double StartTime = FPlatformTime::Seconds();
+    int32 DeletedCount = 0;
+    TArray<TSharedPtr<FJsonValue>> FailedArray;
+
+    if (Targets.Num() > 0)
+    {
+        TUniquePtr<FScopedTransaction> Transaction;
+        if (bTransact)
+        {
+            Transaction = MakeUnique<FScopedTransaction>(LOCTEXT("DeleteObjects", "MCP Delete Objects"));
+        }
+
+        // Navigation rebuilds are held until the lock goes out of scope, so the navmesh updates once for the batch
+        FNavigationLockContext NavigationLock(World, ENavigationLockReason::Unknown);
+
+        // Deselect in one batch so selection listeners are notified once instead of per actor
+        USelection* Selection = GEditor->GetSelectedActors();
+        Selection->BeginBatchSelectOperation();
+        for (AActor* Actor : Targets)
+        {
+            if (Actor->IsSelected())
+            {
+                Selection->Deselect(Actor);
+            }
+        }
+        Selection->EndBatchSelectOperation(false);
+
+        for (AActor* Actor : Targets)
+        {
+            const FString ActorName = Actor->GetName();
+            if (bTransact)
+            {
+                Actor->Modify();
+            }
+
+            if (World->EditorDestroyActor(Actor, true))
+            {
+                DeletedCount++;
+            }
+            else
+            {
+                FailedArray.Add(MakeShared<FJsonValueString>(ActorName));
+            }
+        }
+    }
+
+    if (DeletedCount > 0)
+    {
+        GEditor->NoteSelectionChange();
+        GEditor->RedrawLevelEditingViewports();
+
+        // One collection for the whole batch; with a transaction the actors stay alive in the undo buffer
+        if (bCollectGarbage)
+        {
+            CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+        }
+    }
+
+    const double ElapsedMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+    Result->SetNumberField("deleted_count", DeletedCount);
+    Result->SetArrayField("failed", FailedArray);
+    Result->SetNumberField("elapsed_ms", ElapsedMs);
+
+    MCP_LOG_INFO("Deleted %d actors in one batch (%.1f ms)", DeletedCount, ElapsedMs);
+    return CreateSuccessResponse(Result);
+}
+
+bool FMCPDeleteObjectsHandler::IsProtectedActor(const AActor* Actor)
+{
+    return FActorEditorUtils::IsABuilderBrush(Actor) || Actor->IsA<AWorldSettings>();
+}
+
+//
+// FMCPGetSceneHashesHandler
+//
+TSharedPtr<FJsonObject> FMCPGetSceneHashesHandler::Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket)
+{
+    MCP_LOG_INFO("Handling get_scene_hashes command");
+
+    UWorld* World = GEditor->GetEditorWorldContext().World();
+
+    // Only actors edited since the last call are re-hashed here
+    FMCPSceneHashIndex& HashIndex = FMCPSceneHashIndex::Get();
+    HashIndex.Update(World);
+
+    bool bIncludeCells = false;
+    Params->TryGetBoolField(FStringView(TEXT("cells")), bIncludeCells);
+
+    FString LevelName;
+    Params->TryGetStringField(FStringView(TEXT("level")), LevelName);
+
+    // Cells can be limited to the ones overlapping a region
+    FBox Region(ForceInit);
+    const TSharedPtr<FJsonObject>* RegionObject = nullptr;
+    if (Params->TryGetObjectField(FStringView(TEXT("region")), RegionObject) && RegionObject)
+    {
+        FVector Min;
+        FVector Max;
+        if (!TryGetVector(*RegionObject, TEXT("min"), Min) || !TryGetVector(*RegionObject, TEXT("max"), Max))
+        {
+            return CreateErrorResponse("'region' needs 'min' and 'max' as [x, y, z]");
+        }
+        Region = FBox(Min.ComponentMin(Max), Min.ComponentMax(Max));
+        bIncludeCells = true;
+    }
+
+    const double CellSize = HashIndex.GetCellSize();
+    TArray<TSharedPtr<FJsonValue>> LevelsArray;
+    for (const TPair<FName, FMCPSceneHashLevel>& Level : HashIndex.GetLevels())
+    {
+        if (!LevelName.IsEmpty() && Level.Key.ToString() != LevelName)
+        {
+            continue;
+        }
+
+        TSharedPtr<FJsonObject> LevelInfo = MakeShared<FJsonObject>();
+        LevelInfo->SetStringField("name", Level.Key.ToString());
+        LevelInfo->SetStringField("hash", FMCPSceneHashIndex::HashToString(Level.Value.Hash));
+        LevelInfo->SetNumberField("actor_count", Level.Value.ActorCount);
+        LevelInfo->SetNumberField("cell_count", Level.Value.Cells.Num());
+
+        if (bIncludeCells)
+        {
+            TArray<TSharedPtr<FJsonValue>> CellsArray;
+            for (const TPair<FIntVector, FMCPSceneHashCell>& Cell : Level.Value.Cells)
+            {
+                if (Region.IsValid)
+                {
+                    const FVector CellMin = FVector(Cell.Key) * CellSize;
+                    if (!Region.Intersect(FBox(CellMin, CellMin + FVector(CellSize))))
+                    {
+                        continue;
+                    }
+                }
+
+                TSharedPtr<FJsonObject> CellInfo = MakeShared<FJsonObject>();
+                CellInfo->SetArrayField("cell", FMCPSceneUtils::MakeVectorArray(FVector(Cell.Key)));
+                CellInfo->SetStringField("hash", FMCPSceneHashIndex::HashToString(Cell.Value.Hash));
+                CellInfo->SetNumberField("actor_count", Cell.Value.ActorCount);
+                CellsArray.Add(MakeShared<FJsonValueObject>(CellInfo));
+            }
+            LevelInfo->SetArrayField("cells", CellsArray);
+        }
+
+        LevelsArray.Add(MakeShared<FJsonValueObject>(LevelInfo));
+    }
+
+    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+    Result->SetStringField("root", FMCPSceneHashIndex::HashToString(HashIndex.GetRootHash()));
+    Result->SetNumberField("scene_version", static_cast<double>(FMCPSceneJournal::Get().GetCurrentVersion()));
+    Result->SetNumberField("cell_size", CellSize);
+    Result->SetNumberField("actor_count", HashIndex.GetActorCount());
+    Result->SetArrayField("levels", LevelsArray);
+
+    // Per-actor hashes for an explicit name list and/or every actor matching a filter
+    TArray<FName> Names;
+    const bool bHasNames = FMCPSceneUtils::TryGetNameArray(Params, TEXT("names"), Names);
+
+    FMCPActorFilter Filter;
+    FString FilterError;
+    const TSharedPtr<FJsonObject>* FilterObject = nullptr;
+    const bool bHasFilter = Params->TryGetObjectField(FStringView(TEXT("filter")), FilterObject) && FilterObject;
+    if (bHasFilter && !Filter.Parse(*FilterObject, FilterError))
+    {
+        MCP_LOG_WARNING("Invalid filter in get_scene_hashes command: %s", *FilterError);
+        return CreateErrorResponse(FilterError);
+    }
+
+    if (bHasNames || bHasFilter)
+    {
+        TSharedPtr<FJsonObject> ActorsObject = MakeShared<FJsonObject>();
+        TArray<TSharedPtr<FJsonValue>> MissingArray;
+        int32 ActorHashCount = 0;
+        bool bLimitReached = false;
+
+        auto AddActorHash = [&](FName Name)
+        {
+            uint64 Hash = 0;
+            if (!HashIndex.GetActorHash(Name, Hash))
+            {
+                MissingArray.Add(MakeShared<FJsonValueString>(Name.ToString()));
+            }
+            else if (ActorHashCount < MCPConstants::MAX_ACTORS_IN_SCENE_HASHES)
+            {
+                ActorsObject->SetStringField(Name.ToString(), FMCPSceneHashIndex::HashToString(Hash));
+                ActorHashCount++;
+            }
+            else
+            {
+                bLimitReached = true;
+            }
+        };
+
+        if (bHasNames)
+        {
+            for (const FName& Name : Names)
+            {
+                AddActorHash(Name);
+            }
+        }
+        else
+        {
+            for (TActorIterator<AActor> It(World); It; ++It)
+            {
+                if (Filter.Matches(*It) && FMCPSceneJournal::IsTrackedActor(*It))
+                {
+                    AddActorHash(It->GetFName());
+                }
+            }
+        }
+
+        Result->SetObjectField("actors", ActorsObject);
+        Result->SetArrayField("missing", MissingArray);
+        Result->SetBoolField("limit_reached", bLimitReached);
+    }
+
+    return CreateSuccessResponse(Result);
+}
+
+//
+// FMCPExportSceneSnapshotHandler
+//
+TSharedPtr<FJsonObject> FMCPExportSceneSnapshotHandler::Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket)
+{
+    MCP_LOG_INFO("Handling export_scene_snapshot command");
+
+    UWorld* World = GEditor->GetEditorWorldContext().World();
+
+    FMCPActorFilter Filter;
+    FString FilterError;
+    const TSharedPtr<FJsonObject>* FilterObject = nullptr;
+    if (Params->TryGetObjectField(FStringView(TEXT("filter")), FilterObject) && FilterObject && !Filter.Parse(*FilterObject, FilterError))
+    {
+        MCP_LOG_WARNING("Invalid filter in export_scene_snapshot command: %s", *FilterError);
+        return CreateErrorResponse(FilterError);
+    }
+
+    bool bIncludeComponents = true;
+    Params->TryGetBoolField(FStringView(TEXT("include_components")), bIncludeComponents);
+    bool bWait = false;
+    Params->TryGetBoolField(FStringView(TEXT("wait")), bWait);
+
+    // Relative paths and the default name land in the project's Saved directory
+    FString Path;
+    Params->TryGetStringField(FStringView(TEXT("path")), Path);
+    if (Path.IsEmpty())
+    {
+        Path = FString::Printf(TEXT("%s_%s"), *World->GetName(), *FDateTime::Now().ToString(TEXT("%Y%m%d_%H%M%S")));
+    }
+    if (FPaths::IsRelative(Path))
+    {
+        Path = FPaths::ProjectSavedDir() / MCPConstants::SCENE_SNAPSHOT_DIR_NAME / Path;
+    }
+    if (!Path.EndsWith(MCPSnapshotFormat::FILE_EXTENSION))
+    {
+        Path += MCPSnapshotFormat::FILE_EXTENSION;
+    }
+    Path = FPaths::ConvertRelativePathToFull(Path);
+
+    const double StartTime = FPlatformTime::Seconds();
+    TSharedRef<FMCPSceneExportData> Data = FMCPSceneExporter::Capture(World, Filter.IsEmpty() ? nullptr : &Filter, bIncludeComponents);
+    const double CaptureMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+    TFuture<FMCPSceneExportResult> Future = FMCPSceneExporter::WriteAsync(Data, Path);
+
+    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+    Result->SetStringField("path", Path);
+    Result->SetNumberField("format_version", MCPSnapshotFormat::FORMAT_VERSION);
+    Result->SetNumberField("scene_version", static_cast<double>(Data->SceneVersion));
+    Result->SetNumberField("actor_count", Data->Actors.Num());
+    Result->SetNumberField("component_count", Data->Components.Num());
+    Result->SetNumberField("capture_ms", CaptureMs);
+
+    // Without wait the game thread is released as soon as the copy is taken; the file appears when complete
+    if (!bWait)
+    {
+        Result->SetBoolField("pending", true);
+        return CreateSuccessResponse(Result);
+    }
+
+    const FMCPSceneExportResult ExportResult = Future.Get();
+    if (!ExportResult.bSuccess)
+    {
+        return CreateErrorResponse(ExportResult.Error);
+    }
+
+    Result->SetBoolField("pending", false);
+    Result->SetNumberField("file_size", static_cast<double>(ExportResult.FileSize));
+    Result->SetNumberField("write_ms", ExportResult.WriteSeconds * 1000.0);
+    return CreateSuccessResponse(Result);
+}
+
+//
+// FMCPSummarizeSceneHandler
+//
+TSharedPtr<FJsonObject> FMCPSummarizeSceneHandler::Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket)
+{
+    MCP_LOG_INFO("Handling summarize_scene command");
+
+    UWorld* World = GEditor->GetEditorWorldContext().World();
+
+    FMCPActorFilter Filter;
+    FString FilterError;
+    const TSharedPtr<FJsonObject>* FilterObject = nullptr;
+    if (Params->TryGetObjectField(FStringView(TEXT("filter")), FilterObject) && FilterObject && !Filter.Parse(*FilterObject, FilterError))
+    {
+        MCP_LOG_WARNING("Invalid filter in summarize_scene command: %s", *FilterError);
+        return CreateErrorResponse(FilterError);
+    }
+
+    FMCPSummaryOptions Options;
+    Params->TryGetNumberField(FStringView(TEXT("max_bytes")), Options.MaxBytes);
+    Options.MaxBytes = FMath::Clamp(Options.MaxBytes, 0, MCPConstants::MAX_SUMMARY_BYTES);
+    Params->TryGetStringField(FStringView(TEXT("cluster")), Options.ClusterId);
+    Params->TryGetNumberField(FStringView(TEXT("max_classes")), Options.MaxClasses);
+    Options.MaxClasses = FMath::Clamp(Options.MaxClasses, 0, 20);
+    Params->TryGetNumberField(FStringView(TEXT("max_representatives")), Options.MaxRepresentatives);
+    Options.MaxRepresentatives = FMath::Clamp(Options.MaxRepresentatives, 0, 20);
+
+    const double StartTime = FPlatformTime::Seconds();
+
+    FMCPSnapshotOptions SnapshotOptions;
+    SnapshotOptions.Filter = Filter.IsEmpty() ? nullptr : &Filter;
+    TArray<FMCPActorRecord> Records;
+    FMCPSceneSnapshot::Capture(World, SnapshotOptions, Records);
+    const double CaptureTime = FPlatformTime::Seconds();
+
+    TArray<FMCPSummaryCluster> Clusters;
+    FString Error;
+    if (!FMCPSceneSummary::Build(Records, Options, Clusters, Error))
+    {
+        MCP_LOG_WARNING("summarize_scene failed: %s", *Error);
+        return CreateErrorResponse(Error);
+    }
+
+    TArray<TSharedPtr<FJsonValue>> ClustersArray;
+    bool bTruncated = false;
+    for (const FMCPSummaryCluster& Cluster : Clusters)
+    {
+        ClustersArray.Add(MakeShared<FJsonValueObject>(FMCPSceneSummary::ToJson(Cluster, Records)));
+        bTruncated = bTruncated || (Cluster.bExpandable && !Cluster.bExpanded);
+    }
+
+    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+    Result->SetStringField("cluster", Clusters[0].Id);
+    Result->SetArrayField("clusters", ClustersArray);
+    Result->SetNumberField("actor_count", Records.Num());
+    Result->SetNumberField("cluster_count", Clusters.Num());
+    Result->SetNumberField("max_bytes", Options.MaxBytes);
+    Result->SetBoolField("truncated", bTruncated);
+    Result->SetNumberField("scene_version", static_cast<double>(FMCPSceneJournal::Get().GetCurrentVersion()));
+    Result->SetNumberField("capture_ms", (CaptureTime - StartTime) * 1000.0);
+    Result->SetNumberField("cluster_ms", (FPlatformTime::Seconds() - CaptureTime) * 1000.0);
+
+    MCP_LOG_INFO("Summarized %d actors in %d clusters", Records.Num(), Clusters.Num());
+    return CreateSuccessResponse(Result);
+}
+
+//
+// FMCPCheckpointSceneHandler
+//
+TSharedPtr<FJsonObject> FMCPCheckpointSceneHandler::Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket)
+{
+    MCP_LOG_INFO("Handling checkpoint_scene command");
+
+    FMCPSceneCheckpoints& Checkpoints = FMCPSceneCheckpoints::Get();
+
+    FString DeleteId;
+    if (Params->TryGetStringField(FStringView(TEXT("delete")), DeleteId))
+    {
+        if (!Checkpoints.Remove(DeleteId))
+        {
+            return CreateErrorResponse(FString::Printf(TEXT("Unknown checkpoint '%s'"), *DeleteId));
+        }
+    }
+
+    bool bList = false;
+    Params->TryGetBoolField(FStringView(TEXT("list")), bList);
+
+    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+    if (DeleteId.IsEmpty() && !bList)
+    {
+        UWorld* World = GEditor->GetEditorWorldContext().World();
+
+        FMCPActorFilter Filter;
+        FString FilterError;
+        const TSharedPtr<FJsonObject>* FilterObject = nullptr;
+        if (Params->TryGetObjectField(FStringView(TEXT("filter")), FilterObject) && FilterObject && !Filter.Parse(*FilterObject, FilterError))
+        {
+            MCP_LOG_WARNING("Invalid filter in checkpoint_scene command: %s", *FilterError);
+            return CreateErrorResponse(FilterError);
+        }
+
+        FString Label;
+        Params->TryGetStringField(FStringView(TEXT("label")), Label);
+
+        const double StartTime = FPlatformTime::Seconds();
+        TSharedRef<const FMCPSceneCheckpoint> Checkpoint = Checkpoints.Create(World, Filter, Label);
+
+        Result = DescribeCheckpoint(*Checkpoint);
+        Result->SetNumberField("checkpoint_ms", (FPlatformTime::Seconds() - StartTime) * 1000.0);
+        MCP_LOG_INFO("Created checkpoint %s with %d actors (%lld bytes compressed)",
+            *Checkpoint->Id, Checkpoint->Entries.Num(), Checkpoint->CompressedSize);
+    }
+
+    TArray<TSharedPtr<FJsonValue>> CheckpointsArray;
+    for (const TSharedRef<const FMCPSceneCheckpoint>& Checkpoint : Checkpoints.GetAll())
+    {
+        CheckpointsArray.Add(MakeShared<FJsonValueObject>(DescribeCheckpoint(*Checkpoint)));
+    }
+    Result->SetArrayField("checkpoints", CheckpointsArray);
+    return CreateSuccessResponse(Result);
+}
+
+//
+// FMCPRestoreSceneHandler
+//
+TSharedPtr<FJsonObject> FMCPRestoreSceneHandler::Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket)
+{
+    MCP_LOG_INFO("Handling restore_scene command");
+
+    FString Id;
+    if (!Params->TryGetStringField(FStringView(TEXT("id")), Id))
+    {
+        MCP_LOG_WARNING("Missing 'id' field in restore_scene command");
+        return CreateErrorResponse("Missing 'id' field");
+    }
+
+    TSharedPtr<const FMCPSceneCheckpoint> Checkpoint = FMCPSceneCheckpoints::Get().Find(Id);
+    if (!Checkpoint.IsValid())
+    {
+        return CreateErrorResponse(FString::Printf(TEXT("Unknown checkpoint '%s'; checkpoints are kept in memory until the editor closes or %d newer ones exist"),
+            *Id, MCPConstants::MAX_SCENE_CHECKPOINTS));
+    }
+
+    bool bDryRun = false;
+    Params->TryGetBoolField(FStringView(TEXT("dry_run")), bDryRun);
+    bool bFullCompare = false;
+    Params->TryGetBoolField(FStringView(TEXT("full_compare")), bFullCompare);
+
+    const double StartTime = FPlatformTime::Seconds();
+    FMCPRestoreResult Restore;
+    FString Error;
+    if (!FMCPSceneCheckpoints::Get().Restore(*Checkpoint, bDryRun, bFullCompare, Restore, Error))
+    {
+        MCP_LOG_WARNING("restore_scene failed: %s", *Error);
+        return CreateErrorResponse(Error);
+    }
+
+    TArray<TSharedPtr<FJsonValue>> ErrorsArray;
+    for (int32 Index = 0; Index < FMath::Min(Restore.Errors.Num(), MCPConstants::MAX_ACTORS_IN_RESTORE_REPORT); ++Index)
+    {
+        ErrorsArray.Add(MakeShared<FJsonValueString>(Restore.Errors[Index]));
+    }
+
+    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+    Result->SetStringField("id", Checkpoint->Id);
+    Result->SetBoolField("dry_run", bDryRun);
+    Result->SetNumberField("restored_count", Restore.Restored.Num());
+    Result->SetNumberField("respawned_count", Restore.Respawned.Num());
+    Result->SetNumberField("destroyed_count", Restore.Destroyed.Num());
+    Result->SetNumberField("compared_count", Restore.ComparedCount);
+    Result->SetNumberField("unchanged_count", Checkpoint->Entries.Num() - Restore.Restored.Num() - Restore.Respawned.Num());
+    Result->SetBoolField("full_compare", Restore.bFullCompare);
+    Result->SetArrayField("restored", MakeActorNameArray(Restore.Restored));
+    Result->SetArrayField("respawned", MakeActorNameArray(Restore.Respawned));
+    Result->SetArrayField("destroyed", MakeActorNameArray(Restore.Destroyed));
+    Result->SetArrayField("errors", ErrorsArray);
+    Result->SetNumberField("scene_version", static_cast<double>(FMCPSceneJournal::Get().GetCurrentVersion()));
+    Result->SetNumberField("restore_ms", (FPlatformTime::Seconds() - StartTime) * 1000.0);
+    return CreateSuccessResponse(Result);
+}
+
+//
+// FMCPDiffSceneHandler
+//
+TSharedPtr<FJsonObject> FMCPDiffSceneHandler::Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket)
+{
+    MCP_LOG_INFO("Handling diff_scene command");
+
+    FString FromId;
+    if (!Params->TryGetStringField(FStringView(TEXT("from")), FromId))
+    {
+        MCP_LOG_WARNING("Missing 'from' field in diff_scene command");
+        return CreateErrorResponse("Missing 'from' field");
+    }
+
+    FMCPSceneCheckpoints& Checkpoints = FMCPSceneCheckpoints::Get();
+    TSharedPtr<const FMCPSceneCheckpoint> From = Checkpoints.Find(FromId);
+    if (!From.IsValid())
+    {
+        return CreateErrorResponse(FString::Printf(TEXT("Unknown checkpoint '%s'"), *FromId));
+    }
+
+    // Without a second checkpoint the live world is the later state
+    FString ToId = TEXT("live");
+    Params->TryGetStringField(FStringView(TEXT("to")), ToId);
+    TSharedPtr<const FMCPSceneCheckpoint> To;
+    if (ToId != TEXT("live"))
+    {
+        To = Checkpoints.Find(ToId);
+        if (!To.IsValid())
+        {
+            return CreateErrorResponse(FString::Printf(TEXT("Unknown checkpoint '%s'"), *ToId));
+        }
+    }
+
+    FMCPSceneDiffOptions Options;
+    Params->TryGetBoolField(FStringView(TEXT("properties")), Options.bProperties);
+    Params->TryGetBoolField(FStringView(TEXT("full_compare")), Options.bFullCompare);
+    Params->TryGetNumberField(FStringView(TEXT("max_changes")), Options.MaxChanges);
+    Options.MaxChanges = FMath::Max(Options.MaxChanges, 0);
+
+    const double StartTime = FPlatformTime::Seconds();
+    FMCPSceneDiffResult Diff;
+    FString Error;
+    if (!FMCPSceneDiff::Diff(*From, To.Get(), Options, Diff, Error))
+    {
+        MCP_LOG_WARNING("diff_scene failed: %s", *Error);
+        return CreateErrorResponse(Error);
+    }
+
+    TArray<TSharedPtr<FJsonValue>> ChangedArray;
+    for (const FMCPActorDiff& ActorDiff : Diff.Changed)
+    {
+        ChangedArray.Add(MakeShared<FJsonValueObject>(FMCPSceneDiff::ToJson(ActorDiff)));
+    }
+    TArray<TSharedPtr<FJsonValue>> RemovedArray;
+    for (const FMCPCheckpointRecord& Record : Diff.Removed)
+    {
+        RemovedArray.Add(MakeShared<FJsonValueObject>(FMCPSceneDiff::ToJson(Record)));
+    }
+    TArray<TSharedPtr<FJsonValue>> AddedArray;
+    for (const FMCPCheckpointRecord& Record : Diff.Added)
+    {
+        AddedArray.Add(MakeShared<FJsonValueObject>(FMCPSceneDiff::ToJson(Record)));
+    }
+
+    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+    Result->SetStringField("from", From->Id);
+    Result->SetStringField("to", To.IsValid() ? To->Id : ToId);
+    Result->SetNumberField("changed_count", Diff.ChangedCount);
+    Result->SetNumberField("removed_count", Diff.RemovedCount);
+    Result->SetNumberField("added_count", Diff.AddedCount);
+    Result->SetNumberField("compared_count", Diff.ComparedCount);
+    Result->SetBoolField("full_compare", Diff.bFullCompare);
+    Result->SetBoolField("truncated", Diff.Changed.Num() < Diff.ChangedCount || Diff.Removed.Num() < Diff.RemovedCount || Diff.Added.Num() < Diff.AddedCount);
+    Result->SetArrayField("changed", ChangedArray);
+    Result->SetArrayField("removed", RemovedArray);
+    Result->SetArrayField("added", AddedArray);
+    Result->SetNumberField("scene_version", static_cast<double>(FMCPSceneJournal::Get().GetCurrentVersion()));
+    Result->SetNumberField("diff_ms", (FPlatformTime::Seconds() - StartTime) * 1000.0);
+
+    MCP_LOG_INFO("Diffed %s against %s: %d changed, %d removed, %d added, %d compared",
+        *From->Id, *ToId, Diff.ChangedCount, Diff.RemovedCount, Diff.AddedCount, Diff.ComparedCount);
+    return CreateSuccessResponse(Result);
+}
+
+TArray<FString> FMCPDiffSceneHandler::GetFieldPriorities() const
+{
+    return { TEXT("changed"), TEXT("removed"), TEXT("added") };
+}
+
+#undef LOCTEXT_NAMESPACE
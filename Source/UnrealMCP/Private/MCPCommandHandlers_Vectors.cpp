@@ -0,0 +1,433 @@
+#include "MCPCommandHandlers_Vectors.h"
+
+#include "Editor.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "MCPFileLogger.h"
+#include "MCPConstants.h"
+#include "MCPPackedData.h"
+#include "MCPAssetCatalog.h"
+#include "MCPCommandHandlers_Scene.h"
+#include "MCPVectorIndex.h"
+
+namespace
+{
+    /**
+     * Read vectors given as one flat column (base64 float32 or numbers) or as an array of number arrays
+     * @return False if the field is missing or malformed
+     */
+    bool TryGetVectors(const TSharedPtr<FJsonObject>& Params, const FString& FieldName, int32 Count, TArray<float>& OutValues, int32& OutDimension)
+    {
+        const TArray<TSharedPtr<FJsonValue>>* Rows = nullptr;
+        if (Params->TryGetArrayField(FieldName, Rows) && Rows && Rows->Num() > 0 && (*Rows)[0]->Type == EJson::Array)
+        {
+            OutValues.Reset();
+            OutDimension = INDEX_NONE;
+            for (const TSharedPtr<FJsonValue>& Row : *Rows)
+            {
+                const TArray<TSharedPtr<FJsonValue>>* Values = nullptr;
+                if (!Row->TryGetArray(Values) || (OutDimension != INDEX_NONE && Values->Num() != OutDimension))
+                {
+                    return false;
+                }
+                OutDimension = Values->Num();
+                for (const TSharedPtr<FJsonValue>& Value : *Values)
+                {
+                    double Number = 0.0;
+                    if (!Value->TryGetNumber(Number))
+                    {
+                        return false;
+                    }
+                    OutValues.Add(static_cast<float>(Number));
+                }
+            }
+            return Rows->Num() == Count;
+        }
+
+        if (!FMCPPackedData::TryGetFloatColumn(Params, FieldName, OutValues) || Count == 0 || OutValues.Num() % Count != 0)
+        {
+            return false;
+        }
+        OutDimension = OutValues.Num() / Count;
+        return true;
+    }
+
+    /** Metadata every asset entry gets from the catalog: kind, class and folder */
+    void AddAssetMetadata(const FString& Id, TArray<TPair<FString, FString>>& OutMetadata)
+    {
+        FMCPAssetCatalog& Catalog = FMCPAssetCatalog::Get();
+        const FAssetData* Asset = Catalog.GetAsset(Catalog.Find(FSoftObjectPath(Id)));
+        OutMetadata.Emplace(TEXT("kind"), TEXT("asset"));
+        if (Asset)
+        {
+            OutMetadata.Emplace(TEXT("class"), Asset->AssetClassPath.ToString());
+            OutMetadata.Emplace(TEXT("path"), Asset->PackagePath.ToString());
+        }
+    }
+
+    /** Metadata every actor entry gets from the editor world: kind, class, level, folder and label */
+    void AddActorMetadata(UWorld* World, const FString& Id, TArray<TPair<FString, FString>>& OutMetadata)
+    {
+        OutMetadata.Emplace(TEXT("kind"), TEXT("actor"));
+        const AActor* Actor = World ? FMCPSceneUtils::FindActorByName(World, FName(*Id)) : nullptr;
+        if (Actor)
+        {
+            OutMetadata.Emplace(TEXT("class"), Actor->GetClass()->GetPathName());
+            if (const ULevel* Level = Actor->GetLevel())
+            {
+                OutMetadata.Emplace(TEXT("level"), Level->GetOuter()->GetName());
+            }
+            OutMetadata.Emplace(TEXT("folder"), Actor->GetFolderPath().ToString());
+            OutMetadata.Emplace(TEXT("label"), Actor->GetActorLabel());
+        }
+    }
+
+    /** Read a metadata object; values given explicitly replace derived ones with the same key */
+    bool MergeMetadata(const TSharedPtr<FJsonObject>& Object, TArray<TPair<FString, FString>>& InOutMetadata, FString& OutError)
+    {
+        for (const TPair<FString, TSharedPtr<FJsonValue>>& Field : Object->Values)
+        {
+            FString Value;
+            if (Field.Value->Type == EJson::Array || Field.Value->Type == EJson::Object || !Field.Value->TryGetString(Value))
+            {
+                OutError = FString::Printf(TEXT("Metadata '%s' must be a string, number or bool"), *Field.Key);
+                return false;
+            }
+            InOutMetadata.RemoveAll([&Field](const TPair<FString, FString>& Entry) { return Entry.Key == Field.Key; });
+            InOutMetadata.Emplace(Field.Key, Value);
+        }
+        return true;
+    }
+
+    TSharedPtr<FJsonObject> MakeMetadataObject(const TArray<TPair<FString, FString>>& Metadata)
+    {
+        TSharedPtr<FJsonObject> Object = MakeShared<FJsonObject>();
+        for (const TPair<FString, FString>& Entry : Metadata)
+        {
+            Object->SetStringField(Entry.Key, Entry.Value);
+        }
+        return Object;
+    }
+
+    TSharedPtr<FJsonObject> MakeIndexInfo(const FString& Name, const FMCPVectorIndex* Index)
+    {
+        TSharedPtr<FJsonObject> Info = MakeShared<FJsonObject>();
+        Info->SetStringField("index", Name);
+        Info->SetBoolField("loaded", Index != nullptr);
+        Info->SetStringField("file", FMCPVectorStore::GetPath(Name));
+        if (Index)
+        {
+            Info->SetNumberField("count", Index->Num());
+            Info->SetNumberField("node_count", Index->GetNodeCount());
+            Info->SetNumberField("dimension", Index->GetDimension());
+            Info->SetBoolField("mapped", Index->IsMapped());
+            Info->SetBoolField("unsaved_changes", Index->IsDirty());
+            Info->SetNumberField("memory_bytes", static_cast<double>(Index->GetAllocatedSize()));
+        }
+        return Info;
+    }
+}
+
+//
+// FMCPUpsertEmbeddingsHandler
+//
+TSharedPtr<FJsonObject> FMCPUpsertEmbeddingsHandler::Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket)
+{
+    MCP_LOG_INFO("Handling upsert_embeddings command");
+
+    FString IndexName;
+    if (!Params->TryGetStringField(FStringView(TEXT("index")), IndexName))
+    {
+        MCP_LOG_WARNING("Missing 'index' field in upsert_embeddings command");
+        return CreateErrorResponse("Missing 'index' field");
+    }
+
+    TArray<FString> Ids;
+    if (!Params->TryGetStringArrayField(FStringView(TEXT("ids")), Ids) || Ids.Num() == 0)
+    {
+        MCP_LOG_WARNING("Missing 'ids' field in upsert_embeddings command");
+        return CreateErrorResponse("Missing or empty 'ids' field");
+    }
+    if (Ids.Num() > MCPConstants::MAX_EMBEDDINGS_PER_UPSERT)
+    {
+        return CreateErrorResponse(FString::Printf(TEXT("At most %d embeddings per call"), MCPConstants::MAX_EMBEDDINGS_PER_UPSERT));
+    }
+
+    TArray<float> Values;
+    int32 Dimension = 0;
+    if (!TryGetVectors(Params, TEXT("vectors"), Ids.Num(), Values, Dimension))
+    {
+        MCP_LOG_WARNING("Invalid 'vectors' field in upsert_embeddings command");
+        return CreateErrorResponse("'vectors' must hold one vector per id: a base64 float32 string or number array of ids * dimension values, or an array of number arrays");
+    }
+
+    // kind fills in metadata from the asset catalog or the editor world
+    FString Kind;
+    Params->TryGetStringField(FStringView(TEXT("kind")), Kind);
+    if (!Kind.IsEmpty() && Kind != TEXT("asset") && Kind != TEXT("actor"))
+    {
+        return CreateErrorResponse(FString::Printf(TEXT("Unknown kind '%s'; expected asset or actor"), *Kind));
+    }
+    UWorld* World = nullptr;
+    if (Kind == TEXT("asset"))
+    {
+        FMCPAssetCatalog::Get().EnsureReady();
+    }
+    else if (Kind == TEXT("actor"))
+    {
+        World = GEditor->GetEditorWorldContext().World();
+    }
+
+    const TArray<TSharedPtr<FJsonValue>>* MetadataArray = nullptr;
+    if (Params->TryGetArrayField(FStringView(TEXT("metadata")), MetadataArray) && MetadataArray->Num() != Ids.Num())
+    {
+        return CreateErrorResponse("'metadata' must hold one object per id");
+    }
+
+    FString Error;
+    FMCPVectorIndex* Index = FMCPVectorStore::Get().Find(IndexName, true, Error);
+    if (!Index)
+    {
+        return CreateErrorResponse(Error);
+    }
+
+    const double StartTime = FPlatformTime::Seconds();
+    int32 UpsertedCount = 0;
+    TArray<TSharedPtr<FJsonValue>> RejectedArray;
+    TArray<TPair<FString, FString>> Metadata;
+    for (int32 Entry = 0; Entry < Ids.Num(); ++Entry)
+    {
+        Metadata.Reset();
+        if (Kind == TEXT("asset"))
+        {
+            AddAssetMetadata(Ids[Entry], Metadata);
+        }
+        else if (Kind == TEXT("actor"))
+        {
+            AddActorMetadata(World, Ids[Entry], Metadata);
+        }
+
+        const TSharedPtr<FJsonObject>* MetadataObject = nullptr;
+        const bool bMetadataValid = !MetadataArray || (*MetadataArray)[Entry]->Type == EJson::Null
+            || ((*MetadataArray)[Entry]->TryGetObject(MetadataObject) && MergeMetadata(*MetadataObject, Metadata, Error));
+        if (!bMetadataValid && Error.IsEmpty())
+        {
+            Error = TEXT("Metadata must be an object");
+        }
+
+        if (bMetadataValid && Index->Upsert(Ids[Entry], MakeArrayView(Values.GetData() + static_cast<int64>(Entry) * Dimension, Dimension), Metadata, Error))
+        {
+            UpsertedCount++;
+            continue;
+        }
+
+        TSharedPtr<FJsonObject> Rejected = MakeShared<FJsonObject>();
+        Rejected->SetStringField("id", Ids[Entry]);
+        Rejected->SetStringField("error", Error);
+        RejectedArray.Add(MakeShared<FJsonValueObject>(Rejected));
+        Error.Reset();
+    }
+
+    bool bSave = false;
+    Params->TryGetBoolField(FStringView(TEXT("save")), bSave);
+    if (bSave && !FMCPVectorStore::Get().Save(IndexName, Error))
+    {
+        return CreateErrorResponse(Error);
+    }
+
+    const double ElapsedMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+    MCP_LOG_INFO("Upserted %d of %d embeddings into %s in %.1f ms", UpsertedCount, Ids.Num(), *IndexName, ElapsedMs);
+
+    TSharedPtr<FJsonObject> Result = MakeIndexInfo(IndexName, Index);
+    Result->SetNumberField("upserted_count", UpsertedCount);
+    Result->SetArrayField("rejected", RejectedArray);
+    Result->SetNumberField("elapsed_ms", ElapsedMs);
+    return CreateSuccessResponse(Result);
+}
+
+//
+// FMCPQueryEmbeddingsHandler
+//
+TSharedPtr<FJsonObject> FMCPQueryEmbeddingsHandler::Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket)
+{
+    MCP_LOG_INFO("Handling query_embeddings command");
+
+    FString IndexName;
+    if (!Params->TryGetStringField(FStringView(TEXT("index")), IndexName))
+    {
+        MCP_LOG_WARNING("Missing 'index' field in query_embeddings command");
+        return CreateErrorResponse("Missing 'index' field");
+    }
+
+    TArray<float> Query;
+    if (!FMCPPackedData::TryGetFloatColumn(Params, TEXT("vector"), Query) || Query.Num() == 0)
+    {
+        MCP_LOG_WARNING("Missing 'vector' field in query_embeddings command");
+        return CreateErrorResponse("Missing 'vector' field: a base64 float32 string or a number array");
+    }
+
+    int32 K = 10;
+    Params->TryGetNumberField(FStringView(TEXT("k")), K);
+    K = FMath::Clamp(K, 1, MCPConstants::MAX_VECTOR_SEARCH_K);
+
+    int32 Ef = MCPConstants::DEFAULT_VECTOR_SEARCH_EF;
+    Params->TryGetNumberField(FStringView(TEXT("ef")), Ef);
+    Ef = FMath::Clamp(Ef, 1, MCPConstants::MAX_VECTOR_SEARCH_K * 4);
+
+    FMCPVectorFilter Filter;
+    const TSharedPtr<FJsonObject>* FilterObject = nullptr;
+    if (Params->TryGetObjectField(FStringView(TEXT("filter")), FilterObject) && FilterObject)
+    {
+        FString FilterError;
+        if (!Filter.Parse(*FilterObject, FilterError))
+        {
+            MCP_LOG_WARNING("Invalid filter in query_embeddings command: %s", *FilterError);
+            return CreateErrorResponse(FilterError);
+        }
+    }
+
+    bool bIncludeMetadata = true;
+    Params->TryGetBoolField(FStringView(TEXT("include_metadata")), bIncludeMetadata);
+
+    FString Error;
+    FMCPVectorIndex* Index = FMCPVectorStore::Get().Find(IndexName, false, Error);
+    if (!Index)
+    {
+        return CreateErrorResponse(Error);
+    }
+
+    const double StartTime = FPlatformTime::Seconds();
+    TArray<FMCPVectorHit> Hits;
+    FMCPVectorSearchStats Stats;
+    if (!Index->Search(Query, K, Ef, &Filter, Hits, &Stats))
+    {
+        return CreateErrorResponse(FString::Printf(TEXT("Query vector has %d values; index '%s' holds %d"), Query.Num(), *IndexName, Index->GetDimension()));
+    }
+    const double SearchMicroseconds = (FPlatformTime::Seconds() - StartTime) * 1000000.0;
+
+    TArray<TSharedPtr<FJsonValue>> HitsArray;
+    HitsArray.Reserve(Hits.Num());
+    TArray<TPair<FString, FString>> Metadata;
+    for (const FMCPVectorHit& Hit : Hits)
+    {
+        TSharedPtr<FJsonObject> HitInfo = MakeShared<FJsonObject>();
+        HitInfo->SetStringField("id", Index->GetId(Hit.Node));
+        HitInfo->SetNumberField("score", FMath::RoundToFloat(Hit.Score * 10000.0f) / 10000.0f);
+        if (bIncludeMetadata)
+        {
+            Index->GetMetadata(Hit.Node, Metadata);
+            HitInfo->SetObjectField("metadata", MakeMetadataObject(Metadata));
+        }
+        HitsArray.Add(MakeShared<FJsonValueObject>(HitInfo));
+    }
+
+    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+    Result->SetStringField("index", IndexName);
+    Result->SetNumberField("count", Index->Num());
+    Result->SetArrayField("hits", HitsArray);
+    Result->SetBoolField("exact", Stats.bExact);
+    Result->SetNumberField("visited", Stats.Visited);
+    Result->SetNumberField("search_microseconds", FMath::RoundToDouble(SearchMicroseconds));
+    return CreateSuccessResponse(Result);
+}
+
+//
+// FMCPVectorIndexHandler
+//
+TSharedPtr<FJsonObject> FMCPVectorIndexHandler::Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket)
+{
+    MCP_LOG_INFO("Handling vector_index command");
+
+    FString Action = TEXT("list");
+    Params->TryGetStringField(FStringView(TEXT("action")), Action);
+
+    FMCPVectorStore& Store = FMCPVectorStore::Get();
+    if (Action == TEXT("list"))
+    {
+        TArray<TSharedPtr<FJsonValue>> IndexesArray;
+        for (const FString& Name : Store.GetNames())
+        {
+            IndexesArray.Add(MakeShared<FJsonValueObject>(MakeIndexInfo(Name, Store.FindLoaded(Name))));
+        }
+        TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+        Result->SetArrayField("indexes", IndexesArray);
+        return CreateSuccessResponse(Result);
+    }
+
+    FString IndexName;
+    if (!Params->TryGetStringField(FStringView(TEXT("index")), IndexName))
+    {
+        MCP_LOG_WARNING("Missing 'index' field in vector_index command");
+        return CreateErrorResponse("Missing 'index' field");
+    }
+
+    FString Error;
+    if (Action == TEXT("drop"))
+    {
+        bool bDeleteFile = false;
+        Params->TryGetBoolField(FStringView(TEXT("delete_file")), bDeleteFile);
+        if (!Store.Drop(IndexName, bDeleteFile))
+        {
+            return CreateErrorResponse(FString::Printf(TEXT("No vector index named '%s'"), *IndexName));
+        }
+        TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+        Result->SetStringField("index", IndexName);
+        Result->SetBoolField("file_deleted", bDeleteFile);
+        return CreateSuccessResponse(Result);
+    }
+
+    // Opening is what load does; the other actions open the index too if it is not loaded yet
+    FMCPVectorIndex* Index = Store.Find(IndexName, false, Error);
+    if (!Index)
+    {
+        return CreateErrorResponse(Error);
+    }
+
+    if (Action == TEXT("stats") || Action == TEXT("load"))
+    {
+        return CreateSuccessResponse(MakeIndexInfo(IndexName, Index));
+    }
+    if (Action == TEXT("save"))
+    {
+        const double StartTime = FPlatformTime::Seconds();
+        if (!Store.Save(IndexName, Error))
+        {
+            return CreateErrorResponse(Error);
+        }
+        TSharedPtr<FJsonObject> Result = MakeIndexInfo(IndexName, Index);
+        Result->SetNumberField("elapsed_ms", (FPlatformTime::Seconds() - StartTime) * 1000.0);
+        return CreateSuccessResponse(Result);
+    }
+    if (Action == TEXT("compact"))
+    {
+        const double StartTime = FPlatformTime::Seconds();
+        const int32 Removed = Index->Compact();
+        TSharedPtr<FJsonObject> Result = MakeIndexInfo(IndexName, Index);
+        Result->SetNumberField("removed_count", Removed);
+        Result->SetNumberField("elapsed_ms", (FPlatformTime::Seconds() - StartTime) * 1000.0);
+        return CreateSuccessResponse(Result);
+    }
+    if (Action == TEXT("delete"))
+    {
+        TArray<FString> Ids;
+        if (!Params->TryGetStringArrayField(FStringView(TEXT("ids")), Ids))
+        {
+            return CreateErrorResponse("Missing 'ids' field");
+        }
+        TArray<TSharedPtr<FJsonValue>> MissingArray;
+        for (const FString& Id : Ids)
+        {
+            if (!Index->Remove(Id))
+            {
+                MissingArray.Add(MakeShared<FJsonValueString>(Id));
+            }
+        }
+        TSharedPtr<FJsonObject> Result = MakeIndexInfo(IndexName, Index);
+        Result->SetNumberField("deleted_count", Ids.Num() - MissingArray.Num());
+        Result->SetArrayField("missing", MissingArray);
+        return CreateSuccessResponse(Result);
+    }
+
+    return CreateErrorResponse(FString::Printf(TEXT("Unknown action '%s'; expected list, stats, load, save, compact, drop or delete"), *Action));
+}
@@ -0,0 +1,220 @@
+#include "MCPCommandHandlers_WorldPartition.h"
+
+#include "Editor.h"
+#include "Engine/World.h"
+#include "MCPFileLogger.h"
+#include "MCPConstants.h"
+#include "MCPCommandHandlers_Scene.h"
+#include "MCPPackedData.h"
+#include "MCPSceneSnapshot.h"
+#include "MCPWorldPartition.h"
+
+namespace
+{
+    /** Read a {min: [x, y, z], max: [x, y, z]} object field; returns false if present but malformed */
+    bool TryGetBox(const TSharedPtr<FJsonObject>& Params, const FString& FieldName, FBox& OutBox, bool& bOutPresent)
+    {
+        bOutPresent = false;
+        const TSharedPtr<FJsonObject>* BoxObject = nullptr;
+        if (!Params->TryGetObjectField(FieldName, BoxObject) || !BoxObject)
+        {
+            return true;
+        }
+        bOutPresent = true;
+
+        TArray<float> Min;
+        TArray<float> Max;
+        if (!FMCPPackedData::TryGetFloatColumn(*BoxObject, TEXT("min"), Min) || Min.Num() != 3 ||
+            !FMCPPackedData::TryGetFloatColumn(*BoxObject, TEXT("max"), Max) || Max.Num() != 3)
+        {
+            return false;
+        }
+        const FVector A(Min[0], Min[1], Min[2]);
+        const FVector B(Max[0], Max[1], Max[2]);
+        OutBox = FBox(A.ComponentMin(B), A.ComponentMax(B));
+        return true;
+    }
+
+    TArray<TSharedPtr<FJsonValue>> MakeRegionsArray()
+    {
+        TArray<TSharedPtr<FJsonValue>> RegionsArray;
+        for (const FMCPLoadedRegion& Region : FMCPWorldPartition::Get().GetRegions())
+        {
+            TSharedPtr<FJsonObject> RegionInfo = MakeShared<FJsonObject>();
+            RegionInfo->SetStringField("id", Region.Id);
+            RegionInfo->SetArrayField("min", FMCPSceneUtils::MakeVectorArray(Region.Bounds.Min));
+            RegionInfo->SetArrayField("max", FMCPSceneUtils::MakeVectorArray(Region.Bounds.Max));
+            RegionInfo->SetStringField("status", Region.bLoaded ? TEXT("loaded") : TEXT("loading"));
+            RegionsArray.Add(MakeShared<FJsonValueObject>(RegionInfo));
+        }
+        return RegionsArray;
+    }
+}
+
+//
+// FMCPQueryActorDescsHandler
+//
+TSharedPtr<FJsonObject> FMCPQueryActorDescsHandler::Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket)
+{
+    MCP_LOG_INFO("Handling query_actor_descs command");
+
+    UWorld* World = GEditor->GetEditorWorldContext().World();
+
+    FMCPActorFilter Filter;
+    const TSharedPtr<FJsonObject>* FilterObject = nullptr;
+    if (Params->TryGetObjectField(FStringView(TEXT("filter")), FilterObject) && FilterObject)
+    {
+        FString FilterError;
+        if (!Filter.Parse(*FilterObject, FilterError))
+        {
+            MCP_LOG_WARNING("Invalid filter in query_actor_descs command: %s", *FilterError);
+            return CreateErrorResponse(FilterError);
+        }
+    }
+
+    FMCPActorDescQuery Query;
+    Query.Filter = Filter.IsEmpty() ? nullptr : &Filter;
+
+    bool bHasIntersects = false;
+    if (!TryGetBox(Params, TEXT("intersects"), Query.Intersects, bHasIntersects))
+    {
+        return CreateErrorResponse("'intersects' needs 'min' and 'max' as [x, y, z]");
+    }
+
+    const TArray<TSharedPtr<FJsonValue>>* DataLayersPtr = nullptr;
+    if (Params->TryGetArrayField(FStringView(TEXT("data_layers")), DataLayersPtr) && DataLayersPtr)
+    {
+        for (const TSharedPtr<FJsonValue>& Value : *DataLayersPtr)
+        {
+            Query.DataLayers.Add(FName(*Value->AsString()));
+        }
+    }
+
+    Params->TryGetBoolField(FStringView(TEXT("unloaded_only")), Query.bUnloadedOnly);
+
+    Query.MaxRecords = MCPConstants::MAX_ACTORS_IN_DESC_QUERY;
+    Params->TryGetNumberField(FStringView(TEXT("max_results")), Query.MaxRecords);
+    Query.MaxRecords = FMath::Clamp(Query.MaxRecords, 0, MCPConstants::MAX_ACTORS_IN_DESC_QUERY);
+
+    const double StartTime = FPlatformTime::Seconds();
+
+    TArray<FMCPActorDescRecord> Records;
+    const int32 TotalCount = FMCPWorldPartition::CollectActorDescs(World, Query, Records);
+    if (TotalCount == INDEX_NONE)
+    {
+        return CreateErrorResponse("The editor world does not use World Partition; use get_scene_info instead");
+    }
+
+    TArray<TSharedPtr<FJsonValue>> ActorsArray;
+    ActorsArray.Reserve(Records.Num());
+    for (const FMCPActorDescRecord& Record : Records)
+    {
+        TSharedPtr<FJsonObject> ActorInfo = MakeShared<FJsonObject>();
+        ActorInfo->SetStringField("name", Record.Name.ToString());
+        ActorInfo->SetStringField("label", Record.Label);
+        ActorInfo->SetStringField("class", Record.NativeClass ? Record.NativeClass->GetName() : FString());
+        if (!Record.BaseClass.IsEmpty())
+        {
+            ActorInfo->SetStringField("base_class", Record.BaseClass);
+        }
+        ActorInfo->SetStringField("guid", Record.Guid.ToString(EGuidFormats::DigitsWithHyphens));
+        if (!Record.Folder.IsEmpty())
+        {
+            ActorInfo->SetStringField("folder", Record.Folder);
+        }
+        if (Record.Bounds.IsValid)
+        {
+            ActorInfo->SetArrayField("bounds_min", FMCPSceneUtils::MakeVectorArray(Record.Bounds.Min));
+            ActorInfo->SetArrayField("bounds_max", FMCPSceneUtils::MakeVectorArray(Record.Bounds.Max));
+        }
+        if (Record.DataLayers.Num() > 0)
+        {
+            TArray<TSharedPtr<FJsonValue>> DataLayersArray;
+            for (const FName& DataLayer : Record.DataLayers)
+            {
+                DataLayersArray.Add(MakeShared<FJsonValueString>(DataLayer.ToString()));
+            }
+            ActorInfo->SetArrayField("data_layers", DataLayersArray);
+        }
+        ActorInfo->SetBoolField("loaded", Record.bLoaded);
+        ActorsArray.Add(MakeShared<FJsonValueObject>(ActorInfo));
+    }
+
+    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+    Result->SetArrayField("actors", ActorsArray);
+    Result->SetNumberField("total_count", TotalCount);
+    Result->SetNumberField("returned_count", Records.Num());
+    Result->SetBoolField("limit_reached", TotalCount > Records.Num());
+    Result->SetArrayField("regions", MakeRegionsArray());
+    Result->SetNumberField("query_ms", (FPlatformTime::Seconds() - StartTime) * 1000.0);
+
+    MCP_LOG_INFO("Matched %d actor descriptors", TotalCount);
+    return CreateSuccessResponse(Result);
+}
+
+//
+// FMCPLoadRegionHandler
+//
+TSharedPtr<FJsonObject> FMCPLoadRegionHandler::Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket)
+{
+    MCP_LOG_INFO("Handling load_region command");
+
+    UWorld* World = GEditor->GetEditorWorldContext().World();
+
+    FBox Bounds(ForceInit);
+    bool bHasRegion = false;
+    if (!TryGetBox(Params, TEXT("region"), Bounds, bHasRegion) || !bHasRegion)
+    {
+        MCP_LOG_WARNING("Missing or invalid 'region' field in load_region command");
+        return CreateErrorResponse("Missing or invalid 'region' field; use {\"min\": [x, y, z], \"max\": [x, y, z]}");
+    }
+
+    bool bWait = false;
+    Params->TryGetBoolField(FStringView(TEXT("wait")), bWait);
+
+    FString Error;
+    const FString Id = FMCPWorldPartition::Get().LoadRegion(World, Bounds, bWait, Error);
+    if (Id.IsEmpty())
+    {
+        MCP_LOG_WARNING("load_region failed: %s", *Error);
+        return CreateErrorResponse(Error);
+    }
+
+    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+    Result->SetStringField("id", Id);
+    Result->SetStringField("status", bWait ? TEXT("loaded") : TEXT("loading"));
+    Result->SetArrayField("regions", MakeRegionsArray());
+    return CreateSuccessResponse(Result);
+}
+
+//
+// FMCPUnloadRegionHandler
+//
+TSharedPtr<FJsonObject> FMCPUnloadRegionHandler::Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket)
+{
+    MCP_LOG_INFO("Handling unload_region command");
+
+    FMCPWorldPartition& WorldPartition = FMCPWorldPartition::Get();
+
+    bool bAll = false;
+    Params->TryGetBoolField(FStringView(TEXT("all")), bAll);
+
+    FString Id;
+    if (bAll)
+    {
+        WorldPartition.UnloadAllRegions();
+    }
+    else if (!Params->TryGetStringField(FStringView(TEXT("id")), Id))
+    {
+        MCP_LOG_WARNING("Missing 'id' field in unload_region command");
+        return CreateErrorResponse("Missing 'id' field (or pass 'all': true)");
+    }
+    else if (!WorldPartition.UnloadRegion(Id))
+    {
+        return CreateErrorResponse(FString::Printf(TEXT("No loaded region with id '%s'"), *Id));
+    }
+
+    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+    Result->SetArrayField("regions", MakeRegionsArray());
+    return CreateSuccessResponse(Result);
+}
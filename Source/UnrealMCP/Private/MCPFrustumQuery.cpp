@@ -0,0 +1,440 @@
+#include "MCPFrustumQuery.h"
+
+#include "EngineUtils.h"
+#include "Engine/World.h"
+#include "Engine/StaticMesh.h"
+#include "GameFramework/Actor.h"
+#include "Components/StaticMeshComponent.h"
+#include "StaticMeshResources.h"
+#include "ActorEditorUtils.h"
+#include "Math/VectorRegister.h"
+#include "MCPSceneJournal.h"
+#include "MCPSceneSnapshot.h"
+
+//
+// FMCPBoundsCache
+//
+FMCPBoundsCache& FMCPBoundsCache::Get()
+{
+    static FMCPBoundsCache Instance;
+    return Instance;
+}
+
+void FMCPBoundsCache::Update(UWorld* World)
+{
+    check(IsInGameThread());
+
+    // Without a recording journal there is no version to compare, so every call rebuilds
+    const FMCPSceneJournal& Journal = FMCPSceneJournal::Get();
+    const uint64 Version = Journal.GetCurrentVersion();
+    if (bValid && Journal.IsInitialized() && CachedWorld.Get() == World && CachedVersion == Version)
+    {
+        return;
+    }
+
+    Reset();
+    if (!World)
+    {
+        return;
+    }
+
+    for (TActorIterator<AActor> It(World); It; ++It)
+    {
+        AActor* Actor = *It;
+        if (Actor->IsHiddenEd() || FActorEditorUtils::IsABuilderBrush(Actor))
+        {
+            continue;
+        }
+
+        // Actors without primitive components have nothing a camera could see
+        const FBox Bounds = Actor->GetComponentsBoundingBox(true);
+        if (!Bounds.IsValid)
+        {
+            continue;
+        }
+
+        FVector Center;
+        FVector Extent;
+        Bounds.GetCenterAndExtents(Center, Extent);
+        CenterX.Add(Center.X);
+        CenterY.Add(Center.Y);
+        CenterZ.Add(Center.Z);
+        ExtentX.Add(Extent.X);
+        ExtentY.Add(Extent.Y);
+        ExtentZ.Add(Extent.Z);
+        Actors.Add(Actor);
+    }
+
+    // Pad to whole vector registers; padding lanes are ignored by index
+    const int32 PaddedNum = Align(Actors.Num(), 4);
+    for (TArray<float>* Array : { &CenterX, &CenterY, &CenterZ, &ExtentX, &ExtentY, &ExtentZ })
+    {
+        Array->SetNumZeroed(PaddedNum);
+    }
+
+    CachedWorld = World;
+    CachedVersion = Version;
+    bValid = true;
+}
+
+void FMCPBoundsCache::Reset()
+{
+    CenterX.Reset();
+    CenterY.Reset();
+    CenterZ.Reset();
+    ExtentX.Reset();
+    ExtentY.Reset();
+    ExtentZ.Reset();
+    Actors.Reset();
+    CachedWorld.Reset();
+    bValid = false;
+}
+
+void FMCPBoundsCache::Cull(const FPlane* Planes, int32 NumPlanes, TArray<int32>& OutIndices) const
+{
+    OutIndices.Reset();
+
+    const int32 NumBlocks = GetPaddedNum() / 4;
+    TArray<uint8> OutsideMasks;
+    OutsideMasks.SetNumUninitialized(NumBlocks);
+
+    // Per plane: distance of the box center minus the box's projected radius on the plane normal.
+    // A box is outside if the center is farther out than the radius for any plane.
+    FMCPSceneSnapshot::ParallelForChunks(NumBlocks, [this, Planes, NumPlanes, &OutsideMasks](int32 Start, int32 End)
+    {
+        for (int32 Block = Start; Block < End; ++Block)
+        {
+            const int32 Offset = Block * 4;
+            const VectorRegister4Float CX = VectorLoad(&CenterX[Offset]);
+            const VectorRegister4Float CY = VectorLoad(&CenterY[Offset]);
+            const VectorRegister4Float CZ = VectorLoad(&CenterZ[Offset]);
+            const VectorRegister4Float EX = VectorLoad(&ExtentX[Offset]);
+            const VectorRegister4Float EY = VectorLoad(&ExtentY[Offset]);
+            const VectorRegister4Float EZ = VectorLoad(&ExtentZ[Offset]);
+
+            VectorRegister4Float Outside = VectorZeroFloat();
+            for (int32 PlaneIndex = 0; PlaneIndex < NumPlanes; ++PlaneIndex)
+            {
+                const FPlane& Plane = Planes[PlaneIndex];
+                const VectorRegister4Float NX = VectorSetFloat1(static_cast<float>(Plane.X));
+                const VectorRegister4Float NY = VectorSetFloat1(static_cast<float>(Plane.Y));
+                const VectorRegister4Float NZ = VectorSetFloat1(static_cast<float>(Plane.Z));
+                const VectorRegister4Float NegW = VectorSetFloat1(static_cast<float>(-Plane.W));
+
+                const VectorRegister4Float Distance = VectorMultiplyAdd(NX, CX, VectorMultiplyAdd(NY, CY, VectorMultiplyAdd(NZ, CZ, NegW)));
+                const VectorRegister4Float Radius = VectorMultiplyAdd(VectorAbs(NX), EX, VectorMultiplyAdd(VectorAbs(NY), EY, VectorMultiply(VectorAbs(NZ), EZ)));
+                Outside = VectorBitwiseOr(Outside, VectorCompareGT(Distance, Radius));
+            }
+            OutsideMasks[Block] = static_cast<uint8>(VectorMaskBits(Outside));
+        }
+    });
+
+    const int32 NumBoxes = Num();
+    for (int32 Block = 0; Block < NumBlocks; ++Block)
+    {
+        const uint8 Mask = OutsideMasks[Block];
+        if (Mask == 0xF)
+        {
+            continue;
+        }
+        for (int32 Lane = 0; Lane < 4; ++Lane)
+        {
+            const int32 Index = Block * 4 + Lane;
+            if (!(Mask & (1 << Lane)) && Index < NumBoxes)
+            {
+                OutIndices.Add(Index);
+            }
+        }
+    }
+}
+
+//
+// FMCPCameraView
+//
+void FMCPCameraView::Finalize()
+{
+    const FRotationMatrix RotationMatrix(Rotation);
+    Forward = RotationMatrix.GetScaledAxis(EAxis::X);
+    Right = RotationMatrix.GetScaledAxis(EAxis::Y);
+    Up = RotationMatrix.GetScaledAxis(EAxis::Z);
+
+    FieldOfView = FMath::Clamp(FieldOfView, 1.0, 170.0);
+    AspectRatio = FMath::Max(AspectRatio, 0.01);
+    NearPlane = FMath::Max(NearPlane, 0.01);
+    FarPlane = FMath::Max(FarPlane, NearPlane + 1.0);
+
+    TanHalfHorizontal = FMath::Tan(FMath::DegreesToRadians(FieldOfView * 0.5));
+    TanHalfVertical = TanHalfHorizontal / AspectRatio;
+}
+
+void FMCPCameraView::GetPlanes(FPlane OutPlanes[6]) const
+{
+    auto MakePlane = [](const FVector& Normal, const FVector& Point)
+    {
+        const FVector UnitNormal = Normal.GetSafeNormal();
+        return FPlane(UnitNormal, FVector::DotProduct(UnitNormal, Point));
+    };
+
+    // Side planes pass through the eye; their normals lean back against the view direction by the half-angle
+    OutPlanes[0] = MakePlane(-Forward, Location + Forward * NearPlane);
+    OutPlanes[1] = MakePlane(Forward, Location + Forward * FarPlane);
+    OutPlanes[2] = MakePlane(-Right - Forward * TanHalfHorizontal, Location);
+    OutPlanes[3] = MakePlane(Right - Forward * TanHalfHorizontal, Location);
+    OutPlanes[4] = MakePlane(Up - Forward * TanHalfVertical, Location);
+    OutPlanes[5] = MakePlane(-Up - Forward * TanHalfVertical, Location);
+}
+
+bool FMCPCameraView::ProjectBox(const FBox& Box, FVector2D& OutMin, FVector2D& OutMax, double& OutNearestDepth) const
+{
+    OutMin = FVector2D(MAX_dbl, MAX_dbl);
+    OutMax = FVector2D(-MAX_dbl, -MAX_dbl);
+    OutNearestDepth = MAX_dbl;
+
+    for (int32 Corner = 0; Corner < 8; ++Corner)
+    {
+        const FVector Point(
+            (Corner & 1) ? Box.Max.X : Box.Min.X,
+            (Corner & 2) ? Box.Max.Y : Box.Min.Y,
+            (Corner & 4) ? Box.Max.Z : Box.Min.Z);
+        const FVector ToPoint = Point - Location;
+
+        // Corners behind the near plane are projected as if on it, which widens the rectangle conservatively
+        const double Depth = FMath::Max(FVector::DotProduct(ToPoint, Forward), NearPlane);
+        const FVector2D Projected(
+            FVector::DotProduct(ToPoint, Right) / (Depth * TanHalfHorizontal),
+            FVector::DotProduct(ToPoint, Up) / (Depth * TanHalfVertical));
+
+        OutMin = FVector2D(FMath::Min(OutMin.X, Projected.X), FMath::Min(OutMin.Y, Projected.Y));
+        OutMax = FVector2D(FMath::Max(OutMax.X, Projected.X), FMath::Max(OutMax.Y, Projected.Y));
+        OutNearestDepth = FMath::Min(OutNearestDepth, Depth);
+    }
+
+    if (OutMax.X < -1.0 || OutMin.X > 1.0 || OutMax.Y < -1.0 || OutMin.Y > 1.0)
+    {
+        return false;
+    }
+    OutMin = FVector2D(FMath::Max(OutMin.X, -1.0), FMath::Max(OutMin.Y, -1.0));
+    OutMax = FVector2D(FMath::Min(OutMax.X, 1.0), FMath::Min(OutMax.Y, 1.0));
+    return true;
+}
+
+//
+// FMCPOcclusionBuffer
+//
+FMCPOcclusionBuffer::FMCPOcclusionBuffer(const FMCPCameraView& InView, int32 InWidth)
+    : View(InView)
+    , Width(FMath::Max(InWidth, 1))
+    , Height(FMath::Max(FMath::RoundToInt(InWidth / InView.AspectRatio), 1))
+{
+    Levels.AddDefaulted();
+    Levels[0].Init(MAX_flt, Width * Height);
+    LevelSizes.Add(FIntPoint(Width, Height));
+}
+
+int32 FMCPOcclusionBuffer::RasterizeTriangles(const TArray<FVector>& Positions, const TArray<uint32>& Indices)
+{
+    TArray<float>& Depth = Levels[0];
+    int32 NumRasterized = 0;
+
+    for (int32 Triangle = 0; Triangle + 2 < Indices.Num(); Triangle += 3)
+    {
+        // View space: x right, y up, z depth
+        FVector ViewVertices[3];
+        for (int32 Corner = 0; Corner < 3; ++Corner)
+        {
+            const FVector ToPoint = Positions[Indices[Triangle + Corner]] - View.Location;
+            ViewVertices[Corner] = FVector(
+                FVector::DotProduct(ToPoint, View.Right),
+                FVector::DotProduct(ToPoint, View.Up),
+                FVector::DotProduct(ToPoint, View.Forward));
+        }
+
+        // Clip against the near plane; a triangle becomes at most a quad
+        FVector Clipped[4];
+        int32 NumClipped = 0;
+        for (int32 Corner = 0; Corner < 3; ++Corner)
+        {
+            const FVector& Current = ViewVertices[Corner];
+            const FVector& Next = ViewVertices[(Corner + 1) % 3];
+            const bool bCurrentInside = Current.Z >= View.NearPlane;
+            const bool bNextInside = Next.Z >= View.NearPlane;
+            if (bCurrentInside)
+            {
+                Clipped[NumClipped++] = Current;
+            }
+            if (bCurrentInside != bNextInside)
+            {
+                const double Alpha = (View.NearPlane - Current.Z) / (Next.Z - Current.Z);
+                Clipped[NumClipped++] = FMath::Lerp(Current, Next, Alpha);
+            }
+        }
+        if (NumClipped < 3)
+        {
+            continue;
+        }
+
+        // The farthest depth covers the whole triangle, so an occluder never ends up closer than it is
+        double TriangleDepth = 0.0;
+        FVector2D Screen[4];
+        for (int32 Corner = 0; Corner < NumClipped; ++Corner)
+        {
+            const FVector& Vertex = Clipped[Corner];
+            TriangleDepth = FMath::Max(TriangleDepth, Vertex.Z);
+            Screen[Corner] = FVector2D(
+                (Vertex.X / (Vertex.Z * View.TanHalfHorizontal) * 0.5 + 0.5) * Width,
+                (0.5 - Vertex.Y / (Vertex.Z * View.TanHalfVertical) * 0.5) * Height);
+        }
+        if (TriangleDepth > View.FarPlane)
+        {
+            continue;
+        }
+
+        for (int32 Fan = 1; Fan + 1 < NumClipped; ++Fan)
+        {
+            FVector2D A = Screen[0];
+            FVector2D B = Screen[Fan];
+            FVector2D C = Screen[Fan + 1];
+            double Area = (B.X - A.X) * (C.Y - A.Y) - (B.Y - A.Y) * (C.X - A.X);
+            if (FMath::IsNearlyZero(Area))
+            {
+                continue;
+            }
+            if (Area < 0.0)
+            {
+                Swap(B, C);
+            }
+
+            const int32 MinX = FMath::Max(FMath::FloorToInt(FMath::Min3(A.X, B.X, C.X)), 0);
+            const int32 MaxX = FMath::Min(FMath::CeilToInt(FMath::Max3(A.X, B.X, C.X)), Width - 1);
+            const int32 MinY = FMath::Max(FMath::FloorToInt(FMath::Min3(A.Y, B.Y, C.Y)), 0);
+            const int32 MaxY = FMath::Min(FMath::CeilToInt(FMath::Max3(A.Y, B.Y, C.Y)), Height - 1);
+
+            // Pixel centers inside all three edges are covered
+            for (int32 Y = MinY; Y <= MaxY; ++Y)
+            {
+                for (int32 X = MinX; X <= MaxX; ++X)
+                {
+                    const FVector2D P(X + 0.5, Y + 0.5);
+                    const double E0 = (B.X - A.X) * (P.Y - A.Y) - (B.Y - A.Y) * (P.X - A.X);
+                    const double E1 = (C.X - B.X) * (P.Y - B.Y) - (C.Y - B.Y) * (P.X - B.X);
+                    const double E2 = (A.X - C.X) * (P.Y - C.Y) - (A.Y - C.Y) * (P.X - C.X);
+                    if (E0 >= 0.0 && E1 >= 0.0 && E2 >= 0.0)
+                    {
+                        float& Pixel = Depth[Y * Width + X];
+                        Pixel = FMath::Min(Pixel, static_cast<float>(TriangleDepth));
+                    }
+                }
+            }
+        }
+        NumRasterized++;
+    }
+    return NumRasterized;
+}
+
+int32 FMCPOcclusionBuffer::RasterizeStaticMesh(const UStaticMeshComponent* Component, int32 MaxTriangles)
+{
+    const UStaticMesh* Mesh = Component ? Component->GetStaticMesh() : nullptr;
+    const FStaticMeshRenderData* RenderData = Mesh ? Mesh->GetRenderData() : nullptr;
+    if (!RenderData || RenderData->LODResources.Num() == 0)
+    {
+        return 0;
+    }
+
+    const FStaticMeshLODResources& LOD = RenderData->LODResources.Last();
+    const FPositionVertexBuffer& PositionBuffer = LOD.VertexBuffers.PositionVertexBuffer;
+    if (LOD.GetNumTriangles() > MaxTriangles || PositionBuffer.GetNumVertices() == 0 || !PositionBuffer.GetVertexData())
+    {
+        return 0;
+    }
+
+    TArray<uint32> Indices;
+    LOD.IndexBuffer.GetCopy(Indices);
+    if (Indices.Num() == 0)
+    {
+        return 0;
+    }
+
+    const FTransform& ComponentTransform = Component->GetComponentTransform();
+    TArray<FVector> Positions;
+    Positions.SetNumUninitialized(PositionBuffer.GetNumVertices());
+    for (uint32 Vertex = 0; Vertex < PositionBuffer.GetNumVertices(); ++Vertex)
+    {
+        Positions[Vertex] = ComponentTransform.TransformPosition(FVector(PositionBuffer.VertexPosition(Vertex)));
+    }
+
+    return RasterizeTriangles(Positions, Indices);
+}
+
+void FMCPOcclusionBuffer::BuildHierarchy()
+{
+    Levels.SetNum(1);
+    LevelSizes.SetNum(1);
+
+    while (LevelSizes.Last().X > 1 || LevelSizes.Last().Y > 1)
+    {
+        const FIntPoint SourceSize = LevelSizes.Last();
+        const FIntPoint Size(FMath::DivideAndRoundUp(SourceSize.X, 2), FMath::DivideAndRoundUp(SourceSize.Y, 2));
+        TArray<float> Level;
+        Level.SetNumUninitialized(Size.X * Size.Y);
+
+        const TArray<float>& Source = Levels.Last();
+        for (int32 Y = 0; Y < Size.Y; ++Y)
+        {
+            for (int32 X = 0; X < Size.X; ++X)
+            {
+                // Each texel keeps the farthest of its children, so a test against it never over-occludes
+                const int32 X0 = X * 2;
+                const int32 Y0 = Y * 2;
+                const int32 X1 = FMath::Min(X0 + 1, SourceSize.X - 1);
+                const int32 Y1 = FMath::Min(Y0 + 1, SourceSize.Y - 1);
+                Level[Y * Size.X + X] = FMath::Max(
+                    FMath::Max(Source[Y0 * SourceSize.X + X0], Source[Y0 * SourceSize.X + X1]),
+                    FMath::Max(Source[Y1 * SourceSize.X + X0], Source[Y1 * SourceSize.X + X1]));
+            }
+        }
+
+        Levels.Add(MoveTemp(Level));
+        LevelSizes.Add(Size);
+    }
+}
+
+bool FMCPOcclusionBuffer::IsOccluded(const FBox& Box) const
+{
+    FVector2D ScreenMin;
+    FVector2D ScreenMax;
+    double NearestDepth = 0.0;
+    if (!View.ProjectBox(Box, ScreenMin, ScreenMax, NearestDepth))
+    {
+        return false;
+    }
+
+    int32 X0 = FMath::Clamp(FMath::FloorToInt((ScreenMin.X * 0.5 + 0.5) * Width), 0, Width - 1);
+    int32 X1 = FMath::Clamp(FMath::FloorToInt((ScreenMax.X * 0.5 + 0.5) * Width), 0, Width - 1);
+    int32 Y0 = FMath::Clamp(FMath::FloorToInt((0.5 - ScreenMax.Y * 0.5) * Height), 0, Height - 1);
+    int32 Y1 = FMath::Clamp(FMath::FloorToInt((0.5 - ScreenMin.Y * 0.5) * Height), 0, Height - 1);
+
+    // Pick the level where the rectangle spans at most four texels per side
+    int32 LevelIndex = 0;
+    while (LevelIndex + 1 < Levels.Num() && FMath::Max(X1 - X0, Y1 - Y0) >= 4)
+    {
+        X0 >>= 1;
+        X1 >>= 1;
+        Y0 >>= 1;
+        Y1 >>= 1;
+        LevelIndex++;
+    }
+
+    const TArray<float>& Level = Levels[LevelIndex];
+    const int32 LevelWidth = LevelSizes[LevelIndex].X;
+    for (int32 Y = Y0; Y <= Y1; ++Y)
+    {
+        for (int32 X = X0; X <= X1; ++X)
+        {
+            if (Level[Y * LevelWidth + X] >= NearestDepth)
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,576 @@
+#include "MCPOccupancyGrid.h"
+
+#include "EngineUtils.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "Components/PrimitiveComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "PhysicsEngine/BodySetup.h"
+#include "PhysicsEngine/AggregateGeom.h"
+#include "CollisionQueryParams.h"
+#include "Hash/CityHash.h"
+#include "Async/ParallelFor.h"
+#include "MCPConstants.h"
+#include "MCPSceneHashes.h"
+
+#include <limits>
+
+namespace
+{
+    enum class EShapeType : uint8
+    {
+        Box,
+        Sphere,
+        Capsule,
+        Convex,
+        Trace
+    };
+
+    /** World-space copy of one collision element, safe to read from worker threads */
+    struct FShape
+    {
+        EShapeType Type = EShapeType::Box;
+        FVector Center = FVector::ZeroVector;
+        FQuat Rotation = FQuat::Identity;
+
+        /** Box half size, in the box frame */
+        FVector HalfExtent = FVector::ZeroVector;
+
+        /** Sphere and capsule radius */
+        double Radius = 0.0;
+
+        /** Capsule axis and half length of its segment */
+        FVector Axis = FVector::UpVector;
+        double HalfLength = 0.0;
+
+        /** Convex face planes with outward normals, in FShapeList::Planes */
+        int32 FirstPlane = 0;
+        int32 NumPlanes = 0;
+
+        /** Traced components only; read by worker threads while the game thread waits on them */
+        UPrimitiveComponent* Component = nullptr;
+
+        FBox Bounds = FBox(ForceInit);
+    };
+
+    struct FShapeList
+    {
+        TArray<FShape> Shapes;
+        TArray<FPlane> Planes;
+    };
+
+    bool IsCollider(const UPrimitiveComponent* Primitive, ECollisionChannel Channel)
+    {
+        return Primitive->IsRegistered() && Primitive->IsQueryCollisionEnabled() &&
+            Primitive->GetCollisionResponseToChannel(Channel) == ECR_Block;
+    }
+
+    void AddConvex(const FKConvexElem& Convex, const FTransform& ElemTM, FShapeList& Out)
+    {
+        if (Convex.VertexData.Num() == 0)
+        {
+            return;
+        }
+
+        TArray<FVector> Vertices;
+        Vertices.Reserve(Convex.VertexData.Num());
+        FBox Bounds(ForceInit);
+        FVector Centroid = FVector::ZeroVector;
+        for (const FVector& Vertex : Convex.VertexData)
+        {
+            const FVector& World = Vertices.Add_GetRef(ElemTM.TransformPosition(Vertex));
+            Bounds += World;
+            Centroid += World;
+        }
+        Centroid /= Vertices.Num();
+
+        FShape Shape;
+        Shape.Bounds = Bounds;
+
+        // Hulls cooked without an index buffer fall back to their bounding box
+        if (Convex.IndexData.Num() < 12)
+        {
+            Shape.Type = EShapeType::Box;
+            Shape.Center = Bounds.GetCenter();
+            Shape.HalfExtent = Bounds.GetExtent();
+            Out.Shapes.Add(Shape);
+            return;
+        }
+
+        Shape.Type = EShapeType::Convex;
+        Shape.FirstPlane = Out.Planes.Num();
+        for (int32 Index = 0; Index + 2 < Convex.IndexData.Num(); Index += 3)
+        {
+            const FVector& A = Vertices[Convex.IndexData[Index]];
+            const FVector& B = Vertices[Convex.IndexData[Index + 1]];
+            const FVector& C = Vertices[Convex.IndexData[Index + 2]];
+            FVector Normal = FVector::CrossProduct(B - A, C - A);
+            if (!Normal.Normalize())
+            {
+                continue;
+            }
+
+            // Negative scale flips the winding, so the normal is oriented away from the centroid instead
+            if (FVector::DotProduct(Normal, Centroid - A) > 0.0)
+            {
+                Normal = -Normal;
+            }
+            Out.Planes.Add(FPlane(A, Normal));
+        }
+        Shape.NumPlanes = Out.Planes.Num() - Shape.FirstPlane;
+        Out.Shapes.Add(Shape);
+    }
+
+    /** Copy the simple collision of a body setup placed at a transform */
+    int32 AddAggregateGeom(const FKAggregateGeom& AggGeom, const FTransform& ComponentTM, FShapeList& Out)
+    {
+        const int32 FirstShape = Out.Shapes.Num();
+
+        for (const FKBoxElem& Box : AggGeom.BoxElems)
+        {
+            const FTransform ElemTM = Box.GetTransform() * ComponentTM;
+            FShape& Shape = Out.Shapes.AddDefaulted_GetRef();
+            Shape.Type = EShapeType::Box;
+            Shape.Center = ElemTM.GetLocation();
+            Shape.Rotation = ElemTM.GetRotation();
+            Shape.HalfExtent = FVector(Box.X, Box.Y, Box.Z) * 0.5 * ElemTM.GetScale3D().GetAbs();
+            Shape.Bounds = FBox(-Shape.HalfExtent, Shape.HalfExtent).TransformBy(FTransform(Shape.Rotation, Shape.Center));
+        }
+
+        for (const FKSphereElem& Sphere : AggGeom.SphereElems)
+        {
+            FShape& Shape = Out.Shapes.AddDefaulted_GetRef();
+            Shape.Type = EShapeType::Sphere;
+            Shape.Center = ComponentTM.TransformPosition(Sphere.Center);
+            Shape.Radius = Sphere.Radius * ComponentTM.GetScale3D().GetAbsMax();
+            Shape.Bounds = FBox(Shape.Center, Shape.Center).ExpandBy(Shape.Radius);
+        }
+
+        for (const FKSphylElem& Sphyl : AggGeom.SphylElems)
+        {
+            const FTransform ElemTM = Sphyl.GetTransform() * ComponentTM;
+            const FVector Scale = ElemTM.GetScale3D().GetAbs();
+            FShape& Shape = Out.Shapes.AddDefaulted_GetRef();
+            Shape.Type = EShapeType::Capsule;
+            Shape.Center = ElemTM.GetLocation();
+            Shape.Axis = ElemTM.GetRotation().GetAxisZ();
+            Shape.HalfLength = Sphyl.Length * 0.5 * Scale.Z;
+            Shape.Radius = Sphyl.Radius * FMath::Max(Scale.X, Scale.Y);
+            Shape.Bounds = FBox(Shape.Center - Shape.Axis * Shape.HalfLength, Shape.Center + Shape.Axis * Shape.HalfLength).ExpandBy(Shape.Radius);
+        }
+
+        for (const FKConvexElem& Convex : AggGeom.ConvexElems)
+        {
+            AddConvex(Convex, Convex.GetTransform() * ComponentTM, Out);
+        }
+
+        return Out.Shapes.Num() - FirstShape;
+    }
+
+    /** Range of voxel indices along one axis whose centers lie in [Min, Max] */
+    bool GetVoxelRange(double Min, double Max, double Origin, double Resolution, int32 Count, int32& OutFirst, int32& OutLast)
+    {
+        OutFirst = FMath::Max(FMath::CeilToInt32((Min - Origin) / Resolution - 0.5), 0);
+        OutLast = FMath::Min(FMath::FloorToInt32((Max - Origin) / Resolution - 0.5), Count - 1);
+        return OutFirst <= OutLast;
+    }
+
+    /** @return True if the point is within Margin of the shape */
+    bool IsNear(const FShape& Shape, const TArray<FPlane>& Planes, const FVector& Point, double Margin)
+    {
+        switch (Shape.Type)
+        {
+        case EShapeType::Box:
+        {
+            const FVector Local = Shape.Rotation.UnrotateVector(Point - Shape.Center);
+            const FVector Outside = (Local.GetAbs() - Shape.HalfExtent).ComponentMax(FVector::ZeroVector);
+            return Outside.SizeSquared() <= Margin * Margin;
+        }
+        case EShapeType::Sphere:
+            return FVector::DistSquared(Point, Shape.Center) <= FMath::Square(Shape.Radius + Margin);
+        case EShapeType::Capsule:
+        {
+            const double T = FMath::Clamp(FVector::DotProduct(Point - Shape.Center, Shape.Axis), -Shape.HalfLength, Shape.HalfLength);
+            return FVector::DistSquared(Point, Shape.Center + Shape.Axis * T) <= FMath::Square(Shape.Radius + Margin);
+        }
+        case EShapeType::Convex:
+            for (int32 Index = Shape.FirstPlane; Index < Shape.FirstPlane + Shape.NumPlanes; ++Index)
+            {
+                if (Planes[Index].PlaneDot(Point) > Margin)
+                {
+                    return false;
+                }
+            }
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    uint64 Mix(uint64 A, uint64 B)
+    {
+        return CityHash128to64(Uint128_64(A, B));
+    }
+}
+
+//
+// FMCPOccupancyGrid
+//
+void FMCPOccupancyGrid::Init(const FMCPOccupancySettings& Settings)
+{
+    const FVector RegionSize = Settings.Region.GetSize();
+    Resolution = Settings.Resolution;
+    Origin = Settings.Region.Min;
+    Size = FIntVector(
+        FMath::Max(FMath::CeilToInt32(RegionSize.X / Resolution), 1),
+        FMath::Max(FMath::CeilToInt32(RegionSize.Y / Resolution), 1),
+        FMath::Max(FMath::CeilToInt32(RegionSize.Z / Resolution), 1));
+    WordsPerColumn = FMath::DivideAndRoundUp(Size.Z, 64);
+
+    Words.Reset();
+    Words.SetNumZeroed(static_cast<int32>(GetNumColumns() * WordsPerColumn));
+}
+
+int64 FMCPOccupancyGrid::CountOccupied() const
+{
+    int64 Count = 0;
+    for (const uint64 Word : Words)
+    {
+        Count += FMath::CountBits(Word);
+    }
+    return Count;
+}
+
+void FMCPOccupancyGrid::EncodeBits(TArray<uint8>& OutBytes) const
+{
+    static_assert(PLATFORM_LITTLE_ENDIAN, "Column words are copied byte by byte as little-endian");
+
+    // Bits past NZ are never set, so the leading bytes of each column's words are exactly its packed bits
+    const int32 ColumnBytes = FMath::DivideAndRoundUp(Size.Z, 8);
+    OutBytes.SetNumUninitialized(static_cast<int32>(GetNumColumns() * ColumnBytes));
+    ParallelFor(Size.Y, [this, ColumnBytes, &OutBytes](int32 Y)
+    {
+        for (int32 X = 0; X < Size.X; ++X)
+        {
+            const int64 Column = static_cast<int64>(Y) * Size.X + X;
+            FMemory::Memcpy(&OutBytes[Column * ColumnBytes], &Words[Column * WordsPerColumn], ColumnBytes);
+        }
+    });
+}
+
+void FMCPOccupancyGrid::EncodeRuns(TArray<uint32>& OutRuns) const
+{
+    OutRuns.Reset();
+
+    bool bState = false;
+    uint32 Run = 0;
+    const int64 NumColumns = GetNumColumns();
+    for (int64 Column = 0; Column < NumColumns; ++Column)
+    {
+        const uint64* ColumnWords = &Words[Column * WordsPerColumn];
+        int32 Z = 0;
+        while (Z < Size.Z)
+        {
+            // Scan whole words for the next bit that differs from the current one
+            const bool bBit = (ColumnWords[Z >> 6] >> (Z & 63)) & 1;
+            int32 Next = Size.Z;
+            for (int32 WordIndex = Z >> 6; WordIndex < WordsPerColumn; ++WordIndex)
+            {
+                uint64 Word = bBit ? ~ColumnWords[WordIndex] : ColumnWords[WordIndex];
+                if (WordIndex == (Z >> 6))
+                {
+                    Word &= ~0ull << (Z & 63);
+                }
+                if (Word != 0)
+                {
+                    Next = FMath::Min(WordIndex * 64 + static_cast<int32>(FMath::CountTrailingZeros64(Word)), Size.Z);
+                    break;
+                }
+            }
+
+            const uint32 Length = static_cast<uint32>(Next - Z);
+            if (bBit == bState)
+            {
+                Run += Length;
+            }
+            else
+            {
+                OutRuns.Add(Run);
+                Run = Length;
+                bState = bBit;
+            }
+            Z = Next;
+        }
+    }
+    OutRuns.Add(Run);
+}
+
+void FMCPOccupancyGrid::BuildHeightMap(TArray<float>& OutHeights) const
+{
+    OutHeights.SetNumUninitialized(static_cast<int32>(GetNumColumns()));
+    ParallelFor(Size.Y, [this, &OutHeights](int32 Y)
+    {
+        for (int32 X = 0; X < Size.X; ++X)
+        {
+            const int64 Column = static_cast<int64>(Y) * Size.X + X;
+            const uint64* ColumnWords = &Words[Column * WordsPerColumn];
+            float Height = std::numeric_limits<float>::quiet_NaN();
+            for (int32 WordIndex = WordsPerColumn - 1; WordIndex >= 0; --WordIndex)
+            {
+                if (ColumnWords[WordIndex] != 0)
+                {
+                    const int32 Top = WordIndex * 64 + 63 - static_cast<int32>(FMath::CountLeadingZeros64(ColumnWords[WordIndex]));
+                    Height = static_cast<float>(Origin.Z + (Top + 1) * Resolution);
+                    break;
+                }
+            }
+            OutHeights[Column] = Height;
+        }
+    });
+}
+
+//
+// FMCPOccupancyBuilder
+//
+void FMCPOccupancyBuilder::CollectActors(UWorld* World, const FMCPOccupancySettings& Settings, TArray<AActor*>& OutActors)
+{
+    check(IsInGameThread());
+
+    OutActors.Reset();
+    if (!World)
+    {
+        return;
+    }
+
+    for (TActorIterator<AActor> It(World); It; ++It)
+    {
+        AActor* Actor = *It;
+        bool bInRegion = false;
+        Actor->ForEachComponent<UPrimitiveComponent>(false, [&Settings, &bInRegion](const UPrimitiveComponent* Primitive)
+        {
+            bInRegion = bInRegion || (IsCollider(Primitive, Settings.Channel) && Primitive->Bounds.GetBox().Intersect(Settings.Region));
+        });
+        if (bInRegion)
+        {
+            OutActors.Add(Actor);
+        }
+    }
+}
+
+uint64 FMCPOccupancyBuilder::HashContent(UWorld* World, const TArray<AActor*>& Actors, const FMCPOccupancySettings& Settings)
+{
+    check(IsInGameThread());
+
+    FMCPSceneHashIndex& HashIndex = FMCPSceneHashIndex::Get();
+    HashIndex.Update(World);
+
+    const double SettingsValues[] = {
+        Settings.Region.Min.X, Settings.Region.Min.Y, Settings.Region.Min.Z,
+        Settings.Region.Max.X, Settings.Region.Max.Y, Settings.Region.Max.Z,
+        Settings.Resolution, static_cast<double>(Settings.Channel.GetValue())
+    };
+    const uint64 SettingsHash = CityHash64(reinterpret_cast<const char*>(SettingsValues), sizeof(SettingsValues));
+
+    // Actors combine with XOR of keyed hashes, like the cells of the hash index, so iteration order does not matter
+    uint64 ContentHash = static_cast<uint64>(Actors.Num());
+    for (const AActor* Actor : Actors)
+    {
+        uint64 ActorHash = 0;
+        if (!HashIndex.GetActorHash(Actor->GetFName(), ActorHash))
+        {
+            ActorHash = FMCPSceneHashIndex::HashActor(Actor);
+        }
+        const FString Name = Actor->GetPathName();
+        ContentHash ^= Mix(CityHash64(reinterpret_cast<const char*>(*Name), Name.Len() * sizeof(TCHAR)), ActorHash);
+    }
+    return Mix(SettingsHash, ContentHash);
+}
+
+void FMCPOccupancyBuilder::Build(const TArray<AActor*>& Actors, const FMCPOccupancySettings& Settings, FMCPOccupancyGrid& OutGrid, FMCPOccupancyStats& OutStats)
+{
+    check(IsInGameThread());
+
+    OutStats = FMCPOccupancyStats();
+    OutStats.ActorCount = Actors.Num();
+    OutGrid.Init(Settings);
+
+    // Copy every collision element on the game thread; the worker threads only read this list
+    FShapeList List;
+    for (AActor* Actor : Actors)
+    {
+        Actor->ForEachComponent<UPrimitiveComponent>(false, [&Settings, &List, &OutStats](UPrimitiveComponent* Primitive)
+        {
+            if (!IsCollider(Primitive, Settings.Channel) || !Primitive->Bounds.GetBox().Intersect(Settings.Region))
+            {
+                return;
+            }
+            OutStats.ComponentCount++;
+
+            const UBodySetup* BodySetup = Primitive->GetBodySetup();
+            const bool bHasSimple = BodySetup && BodySetup->AggGeom.GetElementCount() > 0;
+
+            if (const UInstancedStaticMeshComponent* Instanced = Cast<UInstancedStaticMeshComponent>(Primitive))
+            {
+                // Instances without simple collision are left out; tracing the component would only hit its first body
+                if (!bHasSimple)
+                {
+                    return;
+                }
+                for (int32 Instance = 0; Instance < Instanced->GetInstanceCount(); ++Instance)
+                {
+                    FTransform InstanceTM;
+                    if (Instanced->GetInstanceTransform(Instance, InstanceTM, true) &&
+                        BodySetup->AggGeom.CalcAABB(InstanceTM).Intersect(Settings.Region))
+                    {
+                        OutStats.ShapeCount += AddAggregateGeom(BodySetup->AggGeom, InstanceTM, List);
+                    }
+                }
+                return;
+            }
+
+            if (bHasSimple)
+            {
+                OutStats.ShapeCount += AddAggregateGeom(BodySetup->AggGeom, Primitive->GetComponentTransform(), List);
+                return;
+            }
+
+            FShape& Shape = List.Shapes.AddDefaulted_GetRef();
+            Shape.Type = EShapeType::Trace;
+            Shape.Component = Primitive;
+            Shape.Bounds = Primitive->Bounds.GetBox();
+            OutStats.TracedComponentCount++;
+        });
+    }
+
+    // Shapes are bucketed by bands of rows; each task owns one band, so no two tasks write the same column
+    const FIntVector Size = OutGrid.Size;
+    const FVector Origin = OutGrid.Origin;
+    const double Resolution = OutGrid.Resolution;
+    const double Margin = Resolution * 0.5;
+    const int32 BandRows = MCPConstants::OCCUPANCY_BAND_ROWS;
+    const int32 NumBands = FMath::DivideAndRoundUp(Size.Y, BandRows);
+
+    TArray<TArray<int32>> BandShapes;
+    BandShapes.SetNum(NumBands);
+    for (int32 ShapeIndex = 0; ShapeIndex < List.Shapes.Num(); ++ShapeIndex)
+    {
+        const FShape& Shape = List.Shapes[ShapeIndex];
+        const double ShapeMargin = Shape.Type == EShapeType::Trace ? 0.0 : Margin;
+        int32 FirstY, LastY;
+        if (GetVoxelRange(Shape.Bounds.Min.Y - ShapeMargin, Shape.Bounds.Max.Y + ShapeMargin, Origin.Y, Resolution, Size.Y, FirstY, LastY))
+        {
+            for (int32 Band = FirstY / BandRows; Band <= LastY / BandRows; ++Band)
+            {
+                BandShapes[Band].Add(ShapeIndex);
+            }
+        }
+    }
+
+    uint64* Words = OutGrid.Words.GetData();
+    const int32 WordsPerColumn = OutGrid.WordsPerColumn;
+    auto SetRange = [Words, WordsPerColumn](int64 Column, int32 FirstZ, int32 LastZ)
+    {
+        uint64* ColumnWords = Words + Column * WordsPerColumn;
+        for (int32 Z = FirstZ; Z <= LastZ; ++Z)
+        {
+            ColumnWords[Z >> 6] |= 1ull << (Z & 63);
+        }
+    };
+
+    ParallelFor(NumBands, [&](int32 Band)
+    {
+        const int32 BandFirstY = Band * BandRows;
+        const int32 BandLastY = FMath::Min(BandFirstY + BandRows, Size.Y) - 1;
+        const FCollisionQueryParams TraceParams(SCENE_QUERY_STAT(MCPOccupancyGrid), true);
+
+        for (const int32 ShapeIndex : BandShapes[Band])
+        {
+            const FShape& Shape = List.Shapes[ShapeIndex];
+            const bool bTrace = Shape.Type == EShapeType::Trace;
+            const FBox Range = bTrace ? Shape.Bounds : Shape.Bounds.ExpandBy(Margin);
+
+            int32 FirstX, LastX, FirstY, LastY, FirstZ, LastZ;
+            if (!GetVoxelRange(Range.Min.X, Range.Max.X, Origin.X, Resolution, Size.X, FirstX, LastX) ||
+                !GetVoxelRange(Range.Min.Y, Range.Max.Y, Origin.Y, Resolution, Size.Y, FirstY, LastY) ||
+                (!bTrace && !GetVoxelRange(Range.Min.Z, Range.Max.Z, Origin.Z, Resolution, Size.Z, FirstZ, LastZ)))
+            {
+                continue;
+            }
+            FirstY = FMath::Max(FirstY, BandFirstY);
+            LastY = FMath::Min(LastY, BandLastY);
+
+            for (int32 Y = FirstY; Y <= LastY; ++Y)
+            {
+                const double CenterY = Origin.Y + (Y + 0.5) * Resolution;
+                for (int32 X = FirstX; X <= LastX; ++X)
+                {
+                    const double CenterX = Origin.X + (X + 0.5) * Resolution;
+                    const int64 Column = static_cast<int64>(Y) * Size.X + X;
+
+                    if (bTrace)
+                    {
+                        // Solid from the first surface down to the bottom of the bounds; caves under terrain are filled
+                        FHitResult Hit;
+                        const FVector Start(CenterX, CenterY, Shape.Bounds.Max.Z + Resolution);
+                        const FVector End(CenterX, CenterY, Shape.Bounds.Min.Z - Resolution);
+                        if (Shape.Component->LineTraceComponent(Hit, Start, End, TraceParams))
+                        {
+                            const int32 TopZ = FMath::Min(FMath::FloorToInt32((Hit.ImpactPoint.Z - Origin.Z) / Resolution), Size.Z - 1);
+                            const int32 BottomZ = FMath::Max(FMath::FloorToInt32((Shape.Bounds.Min.Z - Origin.Z) / Resolution), 0);
+                            if (BottomZ <= TopZ)
+                            {
+                                SetRange(Column, BottomZ, TopZ);
+                            }
+                        }
+                        continue;
+                    }
+
+                    uint64* ColumnWords = Words + Column * WordsPerColumn;
+                    for (int32 Z = FirstZ; Z <= LastZ; ++Z)
+                    {
+                        const FVector Center(CenterX, CenterY, Origin.Z + (Z + 0.5) * Resolution);
+                        if (IsNear(Shape, List.Planes, Center, Margin))
+                        {
+                            ColumnWords[Z >> 6] |= 1ull << (Z & 63);
+                        }
+                    }
+                }
+            }
+        }
+    });
+
+    OutStats.OccupiedCount = OutGrid.CountOccupied();
+}
+
+//
+// FMCPOccupancyCache
+//
+FMCPOccupancyCache& FMCPOccupancyCache::Get()
+{
+    static FMCPOccupancyCache Instance;
+    return Instance;
+}
+
+TSharedPtr<FJsonObject> FMCPOccupancyCache::Find(uint64 Key)
+{
+    const int32 Index = Entries.IndexOfByPredicate([Key](const TPair<uint64, TSharedPtr<FJsonObject>>& Entry) { return Entry.Key == Key; });
+    if (Index == INDEX_NONE)
+    {
+        return nullptr;
+    }
+
+    TPair<uint64, TSharedPtr<FJsonObject>> Entry = Entries[Index];
+    Entries.RemoveAt(Index);
+    Entries.Insert(Entry, 0);
+    return Entry.Value;
+}
+
+void FMCPOccupancyCache::Add(uint64 Key, const TSharedPtr<FJsonObject>& Result)
+{
+    Entries.RemoveAll([Key](const TPair<uint64, TSharedPtr<FJsonObject>>& Entry) { return Entry.Key == Key; });
+    Entries.Insert(TPair<uint64, TSharedPtr<FJsonObject>>(Key, Result), 0);
+    if (Entries.Num() > MCPConstants::MAX_CACHED_OCCUPANCY_GRIDS)
+    {
+        Entries.SetNum(MCPConstants::MAX_CACHED_OCCUPANCY_GRIDS);
+    }
+}
@@ -0,0 +1,206 @@
+#include "MCPPackedData.h"
+
+#include "Misc/Base64.h"
+#include "Async/ParallelFor.h"
+#include "MCPConstants.h"
+
+namespace
+{
+    template <typename T>
+    FString EncodeRaw(const TArray<T>& Values)
+    {
+        static_assert(PLATFORM_LITTLE_ENDIAN, "Packed columns are defined as little-endian");
+
+        const uint8* Bytes = reinterpret_cast<const uint8*>(Values.GetData());
+        const int64 NumBytes = static_cast<int64>(Values.Num()) * sizeof(T);
+        const int64 ChunkBytes = MCPConstants::PACKED_ENCODE_CHUNK_BYTES;
+        if (NumBytes <= ChunkBytes)
+        {
+            return FBase64::Encode(Bytes, static_cast<uint32>(NumBytes));
+        }
+
+        // Chunks are a multiple of 3 bytes, so each one encodes without padding and the pieces concatenate exactly
+        const int32 NumChunks = static_cast<int32>((NumBytes + ChunkBytes - 1) / ChunkBytes);
+        TArray<FString> Pieces;
+        Pieces.SetNum(NumChunks);
+        ParallelFor(NumChunks, [&Pieces, Bytes, NumBytes, ChunkBytes](int32 ChunkIndex)
+        {
+            const int64 Start = ChunkIndex * ChunkBytes;
+            Pieces[ChunkIndex] = FBase64::Encode(Bytes + Start, static_cast<uint32>(FMath::Min(ChunkBytes, NumBytes - Start)));
+        });
+
+        FString Encoded;
+        Encoded.Reserve(static_cast<int32>(FBase64::GetEncodedDataSize(static_cast<uint32>(NumBytes))));
+        for (const FString& Piece : Pieces)
+        {
+            Encoded += Piece;
+        }
+        return Encoded;
+    }
+}
+
+FString FMCPPackedData::EncodeFloats(const TArray<float>& Values)
+{
+    return EncodeRaw(Values);
+}
+
+bool FMCPPackedData::DecodeFloats(const FString& Encoded, TArray<float>& OutValues)
+{
+    TArray<uint8> Bytes;
+    if (!FBase64::Decode(Encoded, Bytes) || Bytes.Num() % sizeof(float) != 0)
+    {
+        return false;
+    }
+
+    OutValues.SetNumUninitialized(Bytes.Num() / sizeof(float));
+    FMemory::Memcpy(OutValues.GetData(), Bytes.GetData(), Bytes.Num());
+    return true;
+}
+
+FString FMCPPackedData::EncodeUInt16s(const TArray<uint16>& Values)
+{
+    return EncodeRaw(Values);
+}
+
+FString FMCPPackedData::EncodeInt16s(const TArray<int16>& Values)
+{
+    return EncodeRaw(Values);
+}
+
+FString FMCPPackedData::EncodeUInt32s(const TArray<uint32>& Values)
+{
+    return EncodeRaw(Values);
+}
+
+FString FMCPPackedData::EncodeBytes(const TArray<uint8>& Bytes)
+{
+    return EncodeRaw(Bytes);
+}
+
+void FMCPPackedData::QuantizeUnorm16(const TArray<float>& Values, int32 Stride, TArray<float>& OutMin, TArray<float>& OutMax, TArray<uint16>& OutQuantized)
+{
+    check(Stride > 0);
+
+    OutMin.Init(TNumericLimits<float>::Max(), Stride);
+    OutMax.Init(TNumericLimits<float>::Lowest(), Stride);
+    for (int32 Index = 0; Index < Values.Num(); ++Index)
+    {
+        const int32 Component = Index % Stride;
+        OutMin[Component] = FMath::Min(OutMin[Component], Values[Index]);
+        OutMax[Component] = FMath::Max(OutMax[Component], Values[Index]);
+    }
+
+    // An empty input still reports a valid (zero) range
+    if (Values.Num() == 0)
+    {
+        OutMin.Init(0.0f, Stride);
+        OutMax.Init(0.0f, Stride);
+    }
+
+    TArray<float> Scale;
+    Scale.SetNumUninitialized(Stride);
+    for (int32 Component = 0; Component < Stride; ++Component)
+    {
+        const float Range = OutMax[Component] - OutMin[Component];
+        Scale[Component] = Range > UE_SMALL_NUMBER ? 65535.0f / Range : 0.0f;
+    }
+
+    OutQuantized.SetNumUninitialized(Values.Num());
+    for (int32 Index = 0; Index < Values.Num(); ++Index)
+    {
+        const int32 Component = Index % Stride;
+        const float Normalized = (Values[Index] - OutMin[Component]) * Scale[Component];
+        OutQuantized[Index] = static_cast<uint16>(FMath::Clamp(FMath::RoundToInt(Normalized), 0, 65535));
+    }
+}
+
+void FMCPPackedData::QuantizeSnorm16(const TArray<float>& Values, TArray<int16>& OutQuantized)
+{
+    OutQuantized.SetNumUninitialized(Values.Num());
+    for (int32 Index = 0; Index < Values.Num(); ++Index)
+    {
+        OutQuantized[Index] = static_cast<int16>(FMath::RoundToInt(FMath::Clamp(Values[Index], -1.0f, 1.0f) * 32767.0f));
+    }
+}
+
+bool FMCPPackedData::TryGetFloatColumn(const TSharedPtr<FJsonObject>& Object, const FString& FieldName, TArray<float>& OutValues)
+{
+    if (!Object.IsValid())
+    {
+        return false;
+    }
+
+    FString Encoded;
+    if (Object->TryGetStringField(FieldName, Encoded))
+    {
+        return DecodeFloats(Encoded, OutValues);
+    }
+
+    const TArray<TSharedPtr<FJsonValue>>* ArrayPtr = nullptr;
+    if (Object->TryGetArrayField(FieldName, ArrayPtr) && ArrayPtr)
+    {
+        OutValues.Reset(ArrayPtr->Num());
+        for (const TSharedPtr<FJsonValue>& Value : *ArrayPtr)
+        {
+            double Number = 0.0;
+            if (!Value.IsValid() || !Value->TryGetNumber(Number))
+            {
+                return false;
+            }
+            OutValues.Add(static_cast<float>(Number));
+        }
+        return true;
+    }
+
+    return false;
+}
+
+bool FMCPPackedData::TryGetUInt32Column(const TSharedPtr<FJsonObject>& Object, const FString& FieldName, TArray<uint32>& OutValues)
+{
+    if (!Object.IsValid())
+    {
+        return false;
+    }
+
+    FString Encoded;
+    if (Object->TryGetStringField(FieldName, Encoded))
+    {
+        TArray<uint8> Bytes;
+        if (!FBase64::Decode(Encoded, Bytes) || Bytes.Num() % sizeof(uint32) != 0)
+        {
+            return false;
+        }
+        OutValues.SetNumUninitialized(Bytes.Num() / sizeof(uint32));
+        FMemory::Memcpy(OutValues.GetData(), Bytes.GetData(), Bytes.Num());
+        return true;
+    }
+
+    const TArray<TSharedPtr<FJsonValue>>* ArrayPtr = nullptr;
+    if (Object->TryGetArrayField(FieldName, ArrayPtr) && ArrayPtr)
+    {
+        OutValues.Reset(ArrayPtr->Num());
+        for (const TSharedPtr<FJsonValue>& Value : *ArrayPtr)
+        {
+            double Number = 0.0;
+            if (!Value.IsValid() || !Value->TryGetNumber(Number) || Number < 0.0 || Number > MAX_uint32 || Number != FMath::FloorToDouble(Number))
+            {
+                return false;
+            }
+            OutValues.Add(static_cast<uint32>(Number));
+        }
+        return true;
+    }
+
+    return false;
+}
+
+TArray<TSharedPtr<FJsonValue>> FMCPPackedData::MakeNumberArray(const TArray<float>& Values)
+{
+    TArray<TSharedPtr<FJsonValue>> Array;
+    Array.Reserve(Values.Num());
+    for (float Value : Values)
+    {
+        Array.Add(MakeShared<FJsonValueNumber>(Value));
+    }
+    return Array;
+}
@@ -0,0 +1,126 @@
+#include "MCPPoissonDiskSampler.h"
+
+FMCPPoissonDiskSampler::FMCPPoissonDiskSampler(const FBox2D& InBounds, float InMinSpacing, int32 InSeed)
+    : Bounds(InBounds)
+    , MinSpacing(FMath::Max(InMinSpacing, 0.0f))
+    , RandomStream(InSeed)
+{
+    if (MinSpacing > 0.0f)
+    {
+        // A cell's diagonal equals the spacing, so a cell can hold at most one accepted point
+        CellSize = MinSpacing / UE_SQRT_2;
+        const FVector2D Size = Bounds.GetSize();
+        GridWidth = FMath::Max(1, FMath::CeilToInt(Size.X / CellSize));
+        GridHeight = FMath::Max(1, FMath::CeilToInt(Size.Y / CellSize));
+    }
+}
+
+void FMCPPoissonDiskSampler::SetPolygon(const TArray<FVector2D>& InPolygon)
+{
+    Polygon = InPolygon;
+}
+
+int64 FMCPPoissonDiskSampler::GetGridCellCount() const
+{
+    return static_cast<int64>(GridWidth) * GridHeight;
+}
+
+void FMCPPoissonDiskSampler::Generate(int32 TargetCount, int32 MaxAttemptsPerPoint, TArray<FVector2D>& OutPoints)
+{
+    OutPoints.Reset();
+    if (TargetCount <= 0 || !Bounds.bIsValid)
+    {
+        return;
+    }
+
+    const bool bUseGrid = MinSpacing > 0.0f;
+    if (bUseGrid)
+    {
+        Grid.Init(INDEX_NONE, GridWidth * GridHeight);
+    }
+
+    OutPoints.Reserve(TargetCount);
+    const FVector2D Size = Bounds.GetSize();
+    const int64 MaxAttempts = static_cast<int64>(TargetCount) * FMath::Max(MaxAttemptsPerPoint, 1);
+
+    for (int64 Attempt = 0; Attempt < MaxAttempts && OutPoints.Num() < TargetCount; ++Attempt)
+    {
+        const FVector2D Candidate(
+            Bounds.Min.X + RandomStream.GetFraction() * Size.X,
+            Bounds.Min.Y + RandomStream.GetFraction() * Size.Y);
+
+        if (Polygon.Num() >= 3 && !IsInsidePolygon(Polygon, Candidate))
+        {
+            continue;
+        }
+
+        if (bUseGrid)
+        {
+            if (!IsFarEnough(Candidate, OutPoints))
+            {
+                continue;
+            }
+            const int32 CellX = FMath::Clamp(static_cast<int32>((Candidate.X - Bounds.Min.X) / CellSize), 0, GridWidth - 1);
+            const int32 CellY = FMath::Clamp(static_cast<int32>((Candidate.Y - Bounds.Min.Y) / CellSize), 0, GridHeight - 1);
+            Grid[CellY * GridWidth + CellX] = OutPoints.Num();
+        }
+
+        OutPoints.Add(Candidate);
+    }
+
+    Grid.Empty();
+}
+
+double FMCPPoissonDiskSampler::GetArea() const
+{
+    if (Polygon.Num() >= 3)
+    {
+        // Shoelace formula
+        double TwiceArea = 0.0;
+        for (int32 Index = 0; Index < Polygon.Num(); ++Index)
+        {
+            const FVector2D& A = Polygon[Index];
+            const FVector2D& B = Polygon[(Index + 1) % Polygon.Num()];
+            TwiceArea += A.X * B.Y - B.X * A.Y;
+        }
+        return FMath::Abs(TwiceArea) * 0.5;
+    }
+    return Bounds.bIsValid ? Bounds.GetArea() : 0.0;
+}
+
+bool FMCPPoissonDiskSampler::IsInsidePolygon(const TArray<FVector2D>& Polygon, const FVector2D& Point)
+{
+    bool bInside = false;
+    for (int32 Index = 0, Previous = Polygon.Num() - 1; Index < Polygon.Num(); Previous = Index++)
+    {
+        const FVector2D& A = Polygon[Index];
+        const FVector2D& B = Polygon[Previous];
+        if ((A.Y > Point.Y) != (B.Y > Point.Y) &&
+            Point.X < (B.X - A.X) * (Point.Y - A.Y) / (B.Y - A.Y) + A.X)
+        {
+            bInside = !bInside;
+        }
+    }
+    return bInside;
+}
+
+bool FMCPPoissonDiskSampler::IsFarEnough(const FVector2D& Candidate, const TArray<FVector2D>& Points) const
+{
+    const int32 CellX = FMath::Clamp(static_cast<int32>((Candidate.X - Bounds.Min.X) / CellSize), 0, GridWidth - 1);
+    const int32 CellY = FMath::Clamp(static_cast<int32>((Candidate.Y - Bounds.Min.Y) / CellSize), 0, GridHeight - 1);
+    const double MinSpacingSquared = static_cast<double>(MinSpacing) * MinSpacing;
+
+    // Any point within the spacing lies at most two cells away
+    for (int32 Y = FMath::Max(CellY - 2, 0); Y <= FMath::Min(CellY + 2, GridHeight - 1); ++Y)
+    {
+        for (int32 X = FMath::Max(CellX - 2, 0); X <= FMath::Min(CellX + 2, GridWidth - 1); ++X)
+        {
+            const int32 PointIndex = Grid[Y * GridWidth + X];
+            if (PointIndex != INDEX_NONE && FVector2D::DistSquared(Points[PointIndex], Candidate) < MinSpacingSquared)
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,253 @@
+#include "MCPPropertyPath.h"
+
+#include "GameFramework/Actor.h"
+#include "Components/ActorComponent.h"
+#include "UObject/UnrealType.h"
+
+namespace
+{
+    /** Maximum number of object references a single path may follow */
+    constexpr int32 MAX_OBJECT_HOPS = 16;
+
+    UActorComponent* FindComponentByName(const AActor* Actor, FName ComponentName)
+    {
+        TInlineComponentArray<UActorComponent*> Components(Actor);
+        for (UActorComponent* Component : Components)
+        {
+            if (Component && Component->GetFName() == ComponentName)
+            {
+                return Component;
+            }
+        }
+        return nullptr;
+    }
+}
+
+FMCPPropertyPathCache& FMCPPropertyPathCache::Get()
+{
+    static FMCPPropertyPathCache Instance;
+    return Instance;
+}
+
+bool FMCPPropertyPathCache::Resolve(UObject* Root, const FString& Path, FMCPResolvedProperty& OutResolved, FString& OutError)
+{
+    check(IsInGameThread());
+
+    if (!Root)
+    {
+        OutError = TEXT("No object to resolve the path on");
+        return false;
+    }
+
+    UObject* Object = Root;
+    FString Remaining = Path;
+    for (int32 Hop = 0; Hop < MAX_OBJECT_HOPS; ++Hop)
+    {
+        const FCacheEntry& Entry = FindOrBuildChain(Object->GetClass(), Remaining);
+        if (!Entry.bValid)
+        {
+            // On actors, a leading segment that is not a property names a component
+            if (const AActor* Actor = Cast<AActor>(Object))
+            {
+                FString ComponentName = Remaining;
+                FString Rest;
+                Remaining.Split(TEXT("."), &ComponentName, &Rest);
+                if (UActorComponent* Component = FindComponentByName(Actor, FName(*ComponentName)))
+                {
+                    if (Rest.IsEmpty())
+                    {
+                        OutError = FString::Printf(TEXT("'%s' is a component; add a property name after it"), *ComponentName);
+                        return false;
+                    }
+                    Object = Component;
+                    Remaining = Rest;
+                    continue;
+                }
+            }
+            OutError = Entry.Error;
+            return false;
+        }
+
+        UObject* NextObject = nullptr;
+        if (!WalkChain(Object, Entry.Chain, OutResolved, NextObject, OutError))
+        {
+            return false;
+        }
+        if (!NextObject)
+        {
+            return true;
+        }
+
+        Object = NextObject;
+        Remaining = Entry.Chain.RemainingPath;
+    }
+
+    OutError = FString::Printf(TEXT("Path '%s' follows too many object references"), *Path);
+    return false;
+}
+
+void FMCPPropertyPathCache::Reset()
+{
+    Chains.Reset();
+}
+
+const FMCPPropertyPathCache::FCacheEntry& FMCPPropertyPathCache::FindOrBuildChain(const UStruct* Class, const FString& Path)
+{
+    const TPair<FObjectKey, FString> Key(FObjectKey(Class), Path);
+    if (const FCacheEntry* Existing = Chains.Find(Key))
+    {
+        return *Existing;
+    }
+
+    FCacheEntry Entry;
+    Entry.bValid = BuildChain(Class, Path, Entry.Chain, Entry.Error);
+    return Chains.Add(Key, MoveTemp(Entry));
+}
+
+bool FMCPPropertyPathCache::BuildChain(const UStruct* Class, const FString& Path, FMCPPropertyChain& OutChain, FString& OutError)
+{
+    TArray<FString> Segments;
+    Path.ParseIntoArray(Segments, TEXT("."), true);
+    if (Segments.Num() == 0)
+    {
+        OutError = TEXT("Empty property path");
+        return false;
+    }
+
+    const UStruct* Struct = Class;
+    for (int32 SegmentIndex = 0; SegmentIndex < Segments.Num(); ++SegmentIndex)
+    {
+        FString Name = Segments[SegmentIndex];
+        int32 Index = 0;
+        bool bHasIndex = false;
+
+        int32 BracketIndex = INDEX_NONE;
+        if (Name.FindChar(TEXT('['), BracketIndex))
+        {
+            const FString IndexString = Name.Mid(BracketIndex + 1, Name.Len() - BracketIndex - 2);
+
+            // Digits only: IsNumeric also takes signs and fractions, and a negative index would pass the bounds checks
+            bool bDigits = !IndexString.IsEmpty() && IndexString.Len() <= 9;
+            for (const TCHAR Char : IndexString)
+            {
+                bDigits &= FChar::IsDigit(Char);
+            }
+            if (bDigits)
+            {
+                LexFromString(Index, *IndexString);
+            }
+            if (!Name.EndsWith(TEXT("]")) || !bDigits || Index < 0)
+            {
+                OutError = FString::Printf(TEXT("Malformed index in '%s'"), *Segments[SegmentIndex]);
+                return false;
+            }
+            bHasIndex = true;
+            Name.LeftInline(BracketIndex);
+        }
+
+        FProperty* Property = FindFProperty<FProperty>(Struct, *Name);
+        if (!Property)
+        {
+            OutError = FString::Printf(TEXT("No property '%s' on %s"), *Name, *Struct->GetName());
+            return false;
+        }
+
+        // Fixed-size arrays are always addressed one element at a time
+        if (Property->ArrayDim > 1 && !bHasIndex)
+        {
+            OutError = FString::Printf(TEXT("'%s' is a fixed-size array of %d; add an [index]"), *Name, Property->ArrayDim);
+            return false;
+        }
+
+        FMCPPropertyStep& Step = OutChain.Steps.AddDefaulted_GetRef();
+        Step.Property = Property;
+
+        FProperty* ValueProperty = Property;
+        if (bHasIndex)
+        {
+            if (FArrayProperty* ArrayProperty = CastField<FArrayProperty>(Property))
+            {
+                Step.ArrayIndex = Index;
+                ValueProperty = ArrayProperty->Inner;
+            }
+            else if (Index < Property->ArrayDim)
+            {
+                Step.StaticIndex = Index;
+            }
+            else
+            {
+                OutError = FString::Printf(TEXT("'%s' is not an array or index %d is out of range"), *Name, Index);
+                return false;
+            }
+        }
+
+        if (SegmentIndex == Segments.Num() - 1)
+        {
+            break;
+        }
+
+        if (const FStructProperty* StructProperty = CastField<FStructProperty>(ValueProperty))
+        {
+            Struct = StructProperty->Struct;
+        }
+        else if (CastField<FObjectPropertyBase>(ValueProperty))
+        {
+            // The referenced object's class is only known per instance, so the rest is resolved on it
+            OutChain.RemainingPath = FString::Join(TArrayView<const FString>(Segments).RightChop(SegmentIndex + 1), TEXT("."));
+            return true;
+        }
+        else
+        {
+            OutError = FString::Printf(TEXT("'%s' has no members"), *Name);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool FMCPPropertyPathCache::WalkChain(UObject* Object, const FMCPPropertyChain& Chain, FMCPResolvedProperty& OutResolved, UObject*& OutNextObject, FString& OutError)
+{
+    void* Container = Object;
+    void* ValuePtr = nullptr;
+    FProperty* ValueProperty = nullptr;
+
+    for (const FMCPPropertyStep& Step : Chain.Steps)
+    {
+        ValuePtr = Step.Property->ContainerPtrToValuePtr<void>(Container, Step.StaticIndex);
+        ValueProperty = Step.Property;
+
+        if (Step.ArrayIndex != INDEX_NONE)
+        {
+            FArrayProperty* ArrayProperty = CastFieldChecked<FArrayProperty>(Step.Property);
+            FScriptArrayHelper ArrayHelper(ArrayProperty, ValuePtr);
+            if (!ArrayHelper.IsValidIndex(Step.ArrayIndex))
+            {
+                OutError = FString::Printf(TEXT("Index %d is out of range for '%s' with %d elements"),
+                    Step.ArrayIndex, *Step.Property->GetName(), ArrayHelper.Num());
+                return false;
+            }
+            ValuePtr = ArrayHelper.GetRawPtr(Step.ArrayIndex);
+            ValueProperty = ArrayProperty->Inner;
+        }
+
+        Container = ValuePtr;
+    }
+
+    OutResolved.Owner = Object;
+    OutResolved.MemberProperty = Chain.Steps[0].Property;
+    OutResolved.LeafProperty = ValueProperty;
+    OutResolved.ValuePtr = ValuePtr;
+
+    OutNextObject = nullptr;
+    if (!Chain.RemainingPath.IsEmpty())
+    {
+        OutNextObject = CastFieldChecked<FObjectPropertyBase>(ValueProperty)->GetObjectPropertyValue(ValuePtr);
+        if (!OutNextObject)
+        {
+            OutError = FString::Printf(TEXT("'%s' is not set"), *ValueProperty->GetName());
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,280 @@
+#include "MCPResponseBudget.h"
+
+#include "Policies/CondensedJsonPrintPolicy.h"
+#include "MCPConstants.h"
+
+namespace
+{
+    using FCondensedWriterFactory = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>;
+
+    /** @return UTF-8 size of a value serialized without whitespace */
+    int64 MeasureValue(const TSharedPtr<FJsonValue>& Value)
+    {
+        // The serializer only writes whole objects and arrays, so the value is wrapped and the brackets subtracted
+        FString Serialized;
+        const TArray<TSharedPtr<FJsonValue>> Wrapper = { Value };
+        TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer = FCondensedWriterFactory::Create(&Serialized);
+        FJsonSerializer::Serialize(Wrapper, Writer);
+        return FTCHARToUTF8(*Serialized).Length() - 2;
+    }
+
+    /** @return Size of "Name": */
+    int64 MeasureKey(const FString& Name)
+    {
+        return MeasureValue(MakeShared<FJsonValueString>(Name)) + 1;
+    }
+
+    /** Response envelope around a part; a cursor marks it truncated */
+    TSharedPtr<FJsonObject> MakeEnvelope(const TSharedPtr<FJsonObject>& Part, const FString& Cursor)
+    {
+        TSharedPtr<FJsonObject> Response = MakeShared<FJsonObject>();
+        Response->SetStringField("status", "success");
+        Response->SetObjectField("result", Part);
+        Response->SetBoolField("truncated", !Cursor.IsEmpty());
+        if (!Cursor.IsEmpty())
+        {
+            TSharedPtr<FJsonObject> Continuation = MakeShared<FJsonObject>();
+            Continuation->SetStringField("cursor", Cursor);
+            Response->SetObjectField("continuation", Continuation);
+        }
+        return Response;
+    }
+}
+
+FMCPResponseBudget& FMCPResponseBudget::Get()
+{
+    static FMCPResponseBudget Instance;
+    return Instance;
+}
+
+FString FMCPResponseBudget::SerializeCondensed(const TSharedPtr<FJsonObject>& Response)
+{
+    FString Serialized;
+    TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer = FCondensedWriterFactory::Create(&Serialized);
+    FJsonSerializer::Serialize(Response.ToSharedRef(), Writer);
+    return Serialized;
+}
+
+TSharedPtr<FJsonObject> FMCPResponseBudget::Apply(const TSharedPtr<FJsonObject>& Response, const TArray<FString>& FieldPriorities, int64 MaxBytes, const FSocket* Client)
+{
+    // Errors are short and are never cut
+    const TSharedPtr<FJsonObject>* ResultPtr = nullptr;
+    if (!Response.IsValid() || !Response->TryGetObjectField(FStringView(TEXT("result")), ResultPtr) || !ResultPtr)
+    {
+        return Response;
+    }
+    const TSharedPtr<FJsonObject> Result = *ResultPtr;
+
+    // One measurement per field orders the fields and tells whether the response fits as is
+    TArray<FPendingField> Small;
+    TArray<FPendingField> Large;
+    int64 TotalBytes = SerializeCondensed(MakeEnvelope(MakeShared<FJsonObject>(), FString())).Len();
+    for (const TPair<FString, TSharedPtr<FJsonValue>>& Field : Result->Values)
+    {
+        const int64 FieldBytes = MeasureKey(Field.Key) + MeasureValue(Field.Value);
+        TotalBytes += FieldBytes + 1;
+
+        FPendingField Pending;
+        Pending.Name = Field.Key;
+        (FieldBytes <= MCPConstants::RESPONSE_SMALL_FIELD_BYTES ? Small : Large).Add(Pending);
+    }
+    if (TotalBytes <= MaxBytes)
+    {
+        return Response;
+    }
+
+    // Large fields the handler ranks come first, in its order; the rest keep their original order
+    Large.StableSort([&FieldPriorities](const FPendingField& A, const FPendingField& B)
+    {
+        const int32 RankA = FieldPriorities.Find(A.Name);
+        const int32 RankB = FieldPriorities.Find(B.Name);
+        return (RankA == INDEX_NONE ? MAX_int32 : RankA) < (RankB == INDEX_NONE ? MAX_int32 : RankB);
+    });
+
+    TArray<FPendingField> Pending = MoveTemp(Small);
+    Pending.Append(Large);
+    return EmitPart(Result, Pending, MaxBytes, Client);
+}
+
+TSharedPtr<FJsonObject> FMCPResponseBudget::Continue(const FString& Cursor, int64 MaxBytes, const FSocket* Client)
+{
+    // Another connection's cursor reads as unknown, so one client cannot fetch the rest of another's response
+    const int32 Index = Continuations.IndexOfByPredicate([&Cursor, Client](const TPair<FString, FContinuation>& Entry)
+    {
+        return Entry.Key == Cursor && Entry.Value.Client == Client;
+    });
+    if (Index == INDEX_NONE)
+    {
+        TSharedPtr<FJsonObject> Response = MakeShared<FJsonObject>();
+        Response->SetStringField("status", "error");
+        Response->SetStringField("message", FString::Printf(TEXT("Unknown or expired cursor '%s'; run the command again"), *Cursor));
+        return Response;
+    }
+
+    FContinuation Continuation = MoveTemp(Continuations[Index].Value);
+    Continuations.RemoveAt(Index);
+    return EmitPart(Continuation.Result, Continuation.Pending, MaxBytes > 0 ? MaxBytes : Continuation.MaxBytes, Client);
+}
+
+void FMCPResponseBudget::ReleaseClient(const FSocket* Client)
+{
+    Continuations.RemoveAll([Client](const TPair<FString, FContinuation>& Entry) { return Entry.Value.Client == Client; });
+}
+
+TSharedPtr<FJsonObject> FMCPResponseBudget::EmitPart(const TSharedPtr<FJsonObject>& Result, TArray<FPendingField>& Pending, int64 MaxBytes, const FSocket* Client)
+{
+    MaxBytes = FMath::Max<int64>(MaxBytes, MCPConstants::MIN_RESPONSE_BYTES);
+
+    // Sized for the longest cursor this server hands out, so the final envelope stays within the budget
+    const int64 EnvelopeBytes = SerializeCondensed(MakeEnvelope(MakeShared<FJsonObject>(), TEXT("c2147483647"))).Len();
+
+    TSharedPtr<FJsonObject> Part = MakeShared<FJsonObject>();
+    int64 UsedBytes = 0;
+    EmitMembers(*Result, Pending, MaxBytes - EnvelopeBytes, UsedBytes, true, *Part);
+
+    if (Pending.Num() == 0)
+    {
+        return MakeEnvelope(Part, FString());
+    }
+
+    // Oldest continuations of the client are dropped first; a client that abandons a listing does not pin it
+    const FString Cursor = FString::Printf(TEXT("c%d"), NextCursorNumber++);
+    FContinuation Continuation;
+    Continuation.Result = Result;
+    Continuation.Pending = Pending;
+    Continuation.MaxBytes = MaxBytes;
+    Continuation.Client = Client;
+    Continuations.Emplace(Cursor, MoveTemp(Continuation));
+
+    int32 ClientCount = 0;
+    for (int32 Index = Continuations.Num() - 1; Index >= 0; --Index)
+    {
+        if (Continuations[Index].Value.Client == Client && ++ClientCount > MCPConstants::MAX_RESPONSE_CONTINUATIONS)
+        {
+            Continuations.RemoveAt(Index);
+        }
+    }
+    return MakeEnvelope(Part, Cursor);
+}
+
+void FMCPResponseBudget::EmitMembers(const FJsonObject& Object, TArray<FPendingField>& Pending, int64 Budget, int64& UsedBytes, bool bForce, FJsonObject& Part)
+{
+    int32 Done = 0;
+    for (; Done < Pending.Num(); ++Done)
+    {
+        FPendingField& Field = Pending[Done];
+        const TSharedPtr<FJsonValue>* ValuePtr = Object.Values.Find(Field.Name);
+        if (!ValuePtr || !ValuePtr->IsValid())
+        {
+            continue;
+        }
+        const TSharedPtr<FJsonValue>& Value = *ValuePtr;
+        const int64 FieldBytes = (Part.Values.Num() > 0 ? 1 : 0) + MeasureKey(Field.Name);
+        const bool bFirst = bForce && Part.Values.Num() == 0;
+
+        if (Value->Type == EJson::Array)
+        {
+            const TArray<TSharedPtr<FJsonValue>>& Elements = Value->AsArray();
+            TArray<TSharedPtr<FJsonValue>> Emitted;
+            int64 ArrayBytes = FieldBytes + 2;
+            int32 Element = Field.Offset;
+            for (; Element < Elements.Num(); ++Element)
+            {
+                const int64 ElementBytes = MeasureValue(Elements[Element]) + (Emitted.Num() > 0 ? 1 : 0);
+                if (UsedBytes + ArrayBytes + ElementBytes > Budget && !(bFirst && Emitted.Num() == 0))
+                {
+                    break;
+                }
+                ArrayBytes += ElementBytes;
+                Emitted.Add(Elements[Element]);
+            }
+
+            if (Emitted.Num() > 0 || Element == Elements.Num())
+            {
+                Part.SetArrayField(Field.Name, Emitted);
+                UsedBytes += ArrayBytes;
+            }
+            if (Element < Elements.Num())
+            {
+                Field.Offset = Element;
+                break;
+            }
+        }
+        else if (Value->Type == EJson::String)
+        {
+            const FString& Text = Value->AsString();
+            const FString Rest = Text.Mid(Field.Offset);
+            const int64 RestBytes = FieldBytes + MeasureValue(MakeShared<FJsonValueString>(Rest));
+            if (UsedBytes + RestBytes <= Budget)
+            {
+                Part.SetStringField(Field.Name, Rest);
+                UsedBytes += RestBytes;
+                continue;
+            }
+
+            // Cut at a multiple of four characters so base64 pieces decode on their own; shrink further only for escapes
+            int32 Length = static_cast<int32>(FMath::Max<int64>(Budget - UsedBytes - FieldBytes - 2, 0)) & ~3;
+            if (bFirst)
+            {
+                Length = FMath::Max(Length, 4);
+            }
+            FString Piece = Rest.Left(Length);
+            while (Length > 0 && UsedBytes + FieldBytes + MeasureValue(MakeShared<FJsonValueString>(Piece)) > Budget)
+            {
+                Length = (Length / 2) & ~3;
+                Piece = bFirst ? Rest.Left(FMath::Max(Length, 4)) : Rest.Left(Length);
+            }
+            if (!Piece.IsEmpty())
+            {
+                Part.SetStringField(Field.Name, Piece);
+                UsedBytes += FieldBytes + MeasureValue(MakeShared<FJsonValueString>(Piece));
+                Field.Offset += Piece.Len();
+            }
+            break;
+        }
+        else if (Value->Type == EJson::Object && Value->AsObject()->Values.Num() > 0)
+        {
+            const FJsonObject& Members = *Value->AsObject();
+            if (Field.Members.Num() == 0)
+            {
+                const int64 ValueBytes = FieldBytes + MeasureValue(Value);
+                if (UsedBytes + ValueBytes <= Budget)
+                {
+                    Part.SetField(Field.Name, Value);
+                    UsedBytes += ValueBytes;
+                    continue;
+                }
+
+                // Too large to send whole, so its members are cut like result fields
+                for (const TPair<FString, TSharedPtr<FJsonValue>>& Member : Members.Values)
+                {
+                    Field.Members.AddDefaulted_GetRef().Name = Member.Key;
+                }
+            }
+
+            TSharedPtr<FJsonObject> MemberPart = MakeShared<FJsonObject>();
+            int64 MemberBytes = 0;
+            EmitMembers(Members, Field.Members, Budget - UsedBytes - FieldBytes - 2, MemberBytes, bFirst, *MemberPart);
+            if (MemberPart->Values.Num() > 0)
+            {
+                Part.SetObjectField(Field.Name, MemberPart);
+                UsedBytes += FieldBytes + 2 + MemberBytes;
+            }
+            if (Field.Members.Num() > 0)
+            {
+                break;
+            }
+        }
+        else
+        {
+            const int64 ValueBytes = FieldBytes + MeasureValue(Value);
+            if (UsedBytes + ValueBytes > Budget && !bFirst)
+            {
+                break;
+            }
+            Part.SetField(Field.Name, Value);
+            UsedBytes += ValueBytes;
+        }
+    }
+    Pending.RemoveAt(0, Done);
+}
@@ -0,0 +1,564 @@
+#include "MCPSceneCheckpoint.h"
+
+#include "EngineUtils.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "Components/SceneComponent.h"
+#include "Async/ParallelFor.h"
+#include "Hash/CityHash.h"
+#include "Misc/Compression.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/ObjectAndNameAsStringProxyArchive.h"
+#include "UObject/Package.h"
+#include "MCPFileLogger.h"
+#include "MCPSceneHashes.h"
+#include "MCPSceneJournal.h"
+
+namespace
+{
+    /**
+     * Write the tagged properties of an object; persistent archives skip transient properties.
+     * Every property is written, not only those that differ from the archetype, so restore also reverts
+     * values that were at their default when the checkpoint was taken.
+     */
+    void SaveProperties(const UObject* Object, TArray<uint8>& OutBytes)
+    {
+        FMemoryWriter Writer(OutBytes, true);
+        Writer.ArNoDelta = true;
+        FObjectAndNameAsStringProxyArchive Archive(Writer, false);
+        Archive.ArNoDelta = true;
+        Object->SerializeScriptProperties(Archive);
+    }
+
+    /** @return The live actor with this name in any level of the world */
+    AActor* FindLiveActor(UWorld* World, FName ActorName)
+    {
+        for (ULevel* Level : World->GetLevels())
+        {
+            if (Level)
+            {
+                AActor* Actor = FindObjectFast<AActor>(Level, ActorName);
+                if (IsValid(Actor))
+                {
+                    return Actor;
+                }
+            }
+        }
+        return nullptr;
+    }
+}
+
+FArchive& operator<<(FArchive& Ar, FMCPCheckpointComponent& Component)
+{
+    Ar << Component.Name;
+    Ar << Component.ClassPath;
+    Ar << Component.bInstance;
+    Ar << Component.Properties;
+    return Ar;
+}
+
+FArchive& operator<<(FArchive& Ar, FMCPCheckpointRecord& Record)
+{
+    Ar << Record.Name;
+    Ar << Record.ClassPath;
+    Ar << Record.LevelName;
+    Ar << Record.Label;
+    Ar << Record.Folder;
+    Ar << Record.Transform;
+    Ar << Record.Properties;
+    Ar << Record.Components;
+    return Ar;
+}
+
+//
+// FMCPSceneCheckpoint
+//
+bool FMCPSceneCheckpoint::ReadRecord(int32 InEntryIndex, TMap<int32, TArray<uint8>>& ChunkCache, FMCPCheckpointRecord& OutRecord) const
+{
+    const FMCPCheckpointEntry& Entry = Entries[InEntryIndex];
+    const int32 FirstChunk = static_cast<int32>(Entry.Offset / MCPConstants::CHECKPOINT_CHUNK_BYTES);
+    const int32 LastChunk = static_cast<int32>((Entry.Offset + FMath::Max(Entry.Size, 1) - 1) / MCPConstants::CHECKPOINT_CHUNK_BYTES);
+
+    // Records are small next to a chunk, so most reads touch one chunk and a sparse diff decompresses only a few
+    TArray<uint8> Bytes;
+    Bytes.Reserve(Entry.Size);
+    for (int32 ChunkIndex = FirstChunk; ChunkIndex <= LastChunk; ++ChunkIndex)
+    {
+        TArray<uint8>* Chunk = ChunkCache.Find(ChunkIndex);
+        if (!Chunk)
+        {
+            Chunk = &ChunkCache.Add(ChunkIndex);
+            if (!DecompressChunk(ChunkIndex, *Chunk))
+            {
+                return false;
+            }
+        }
+
+        const int64 ChunkStart = static_cast<int64>(ChunkIndex) * MCPConstants::CHECKPOINT_CHUNK_BYTES;
+        const int64 CopyStart = FMath::Max(Entry.Offset, ChunkStart);
+        const int64 CopyEnd = FMath::Min(Entry.Offset + Entry.Size, ChunkStart + Chunk->Num());
+        Bytes.Append(Chunk->GetData() + (CopyStart - ChunkStart), static_cast<int32>(CopyEnd - CopyStart));
+    }
+
+    FMemoryReader Reader(Bytes, true);
+    Reader << OutRecord;
+    return !Reader.IsError();
+}
+
+bool FMCPSceneCheckpoint::DecompressChunk(int32 ChunkIndex, TArray<uint8>& OutBytes) const
+{
+    const int64 Start = static_cast<int64>(ChunkIndex) * MCPConstants::CHECKPOINT_CHUNK_BYTES;
+    const int32 Size = static_cast<int32>(FMath::Min<int64>(MCPConstants::CHECKPOINT_CHUNK_BYTES, UncompressedSize - Start));
+    const TArray<uint8>& Chunk = Chunks[ChunkIndex];
+
+    // Chunks that did not shrink were stored as is
+    if (Chunk.Num() == Size)
+    {
+        OutBytes = Chunk;
+        return true;
+    }
+    OutBytes.SetNumUninitialized(Size);
+    return FCompression::UncompressMemory(NAME_Oodle, OutBytes.GetData(), Size, Chunk.GetData(), Chunk.Num());
+}
+
+//
+// FMCPSceneCheckpoints
+//
+FMCPSceneCheckpoints& FMCPSceneCheckpoints::Get()
+{
+    static FMCPSceneCheckpoints Instance;
+    return Instance;
+}
+
+void FMCPSceneCheckpoints::CaptureRecord(const AActor* Actor, FMCPCheckpointRecord& OutRecord)
+{
+    OutRecord.Name = Actor->GetFName();
+    OutRecord.ClassPath = Actor->GetClass()->GetPathName();
+    OutRecord.LevelName = Actor->GetLevel() ? Actor->GetLevel()->GetOuter()->GetFName() : NAME_None;
+    OutRecord.Label = Actor->GetActorLabel();
+    OutRecord.Folder = Actor->GetFolderPath();
+    OutRecord.Transform = Actor->GetActorTransform();
+    SaveProperties(Actor, OutRecord.Properties);
+
+    // Owned components live in a set; sorting by name keeps the record, and so its hash, stable
+    TInlineComponentArray<UActorComponent*> Components;
+    Actor->GetComponents(Components);
+    Components.Sort([](const UActorComponent& A, const UActorComponent& B) { return A.GetFName().LexicalLess(B.GetFName()); });
+
+    OutRecord.Components.Reset(Components.Num());
+    for (const UActorComponent* Component : Components)
+    {
+        if (!Component || Component->HasAnyFlags(RF_Transient))
+        {
+            continue;
+        }
+
+        FMCPCheckpointComponent& ComponentRecord = OutRecord.Components.AddDefaulted_GetRef();
+        ComponentRecord.Name = Component->GetFName();
+        ComponentRecord.ClassPath = Component->GetClass()->GetPathName();
+        ComponentRecord.bInstance = Component->CreationMethod == EComponentCreationMethod::Instance;
+        SaveProperties(Component, ComponentRecord.Properties);
+    }
+}
+
+void FMCPSceneCheckpoints::LoadProperties(UObject* Object, const TArray<uint8>& Bytes)
+{
+    if (Bytes.Num() == 0)
+    {
+        return;
+    }
+
+    // References resolve by path, so respawned actors and components are found again
+    FMemoryReader Reader(Bytes, true);
+    Reader.ArNoDelta = true;
+    FObjectAndNameAsStringProxyArchive Archive(Reader, true);
+    Archive.ArNoDelta = true;
+    Object->SerializeScriptProperties(Archive);
+}
+
+uint64 FMCPSceneCheckpoints::WriteRecord(FMCPCheckpointRecord& Record, TArray<uint8>& OutBytes)
+{
+    const int64 Start = OutBytes.Num();
+    FMemoryWriter Writer(OutBytes, true, true);
+    Writer << Record;
+    return CityHash64(reinterpret_cast<const char*>(OutBytes.GetData() + Start), OutBytes.Num() - Start);
+}
+
+TSharedRef<const FMCPSceneCheckpoint> FMCPSceneCheckpoints::Create(UWorld* World, const FMCPActorFilter& Filter, const FString& Label)
+{
+    TSharedRef<FMCPSceneCheckpoint> Checkpoint = MakeShared<FMCPSceneCheckpoint>();
+    Checkpoint->Id = FString::Printf(TEXT("cp%d"), NextCheckpointNumber++);
+    Checkpoint->Label = Label;
+    Checkpoint->World = World;
+    Checkpoint->Filter = Filter;
+    Checkpoint->SceneVersion = FMCPSceneJournal::Get().GetCurrentVersion();
+    Checkpoint->CreatedAt = FDateTime::UtcNow();
+
+    // Content hashes let restore skip actors without serializing them again
+    FMCPSceneHashIndex& HashIndex = FMCPSceneHashIndex::Get();
+    HashIndex.Update(World);
+
+    TArray<uint8> Blob;
+    FMCPCheckpointRecord Record;
+    for (TActorIterator<AActor> It(World); It; ++It)
+    {
+        const AActor* Actor = *It;
+        if (!FMCPSceneJournal::IsTrackedActor(Actor))
+        {
+            continue;
+        }
+        Checkpoint->WorldActorNames.Add(Actor->GetFName());
+        if (!Filter.IsEmpty() && !Filter.Matches(Actor))
+        {
+            continue;
+        }
+
+        Record = FMCPCheckpointRecord();
+        CaptureRecord(Actor, Record);
+
+        FMCPCheckpointEntry& Entry = Checkpoint->Entries.AddDefaulted_GetRef();
+        Entry.Name = Record.Name;
+        Entry.Offset = Blob.Num();
+        Entry.StateHash = WriteRecord(Record, Blob);
+        Entry.Size = static_cast<int32>(Blob.Num() - Entry.Offset);
+        if (!HashIndex.GetActorHash(Entry.Name, Entry.ContentHash))
+        {
+            Entry.ContentHash = FMCPSceneHashIndex::HashActor(Actor);
+        }
+        Checkpoint->EntryIndex.Add(Entry.Name, Checkpoint->Entries.Num() - 1);
+    }
+
+    // Chunks compress independently, so the blob compresses on every core
+    const int32 NumChunks = static_cast<int32>(FMath::DivideAndRoundUp<int64>(Blob.Num(), MCPConstants::CHECKPOINT_CHUNK_BYTES));
+    Checkpoint->UncompressedSize = Blob.Num();
+    Checkpoint->Chunks.SetNum(NumChunks);
+    ParallelFor(NumChunks, [&Checkpoint, &Blob](int32 ChunkIndex)
+    {
+        const int64 Start = static_cast<int64>(ChunkIndex) * MCPConstants::CHECKPOINT_CHUNK_BYTES;
+        const int32 Size = static_cast<int32>(FMath::Min<int64>(MCPConstants::CHECKPOINT_CHUNK_BYTES, Blob.Num() - Start));
+        TArray<uint8>& Chunk = Checkpoint->Chunks[ChunkIndex];
+
+        int32 CompressedSize = FCompression::CompressMemoryBound(NAME_Oodle, Size);
+        Chunk.SetNumUninitialized(CompressedSize);
+        if (FCompression::CompressMemory(NAME_Oodle, Chunk.GetData(), CompressedSize, Blob.GetData() + Start, Size) && CompressedSize < Size)
+        {
+            Chunk.SetNum(CompressedSize);
+        }
+        else
+        {
+            Chunk = TArray<uint8>(Blob.GetData() + Start, Size);
+        }
+    });
+    for (const TArray<uint8>& Chunk : Checkpoint->Chunks)
+    {
+        Checkpoint->CompressedSize += Chunk.Num();
+    }
+
+    // Oldest checkpoints go first; each one holds its compressed blob in memory
+    Checkpoints.Add(Checkpoint);
+    if (Checkpoints.Num() > MCPConstants::MAX_SCENE_CHECKPOINTS)
+    {
+        Checkpoints.RemoveAt(0, Checkpoints.Num() - MCPConstants::MAX_SCENE_CHECKPOINTS);
+    }
+    return Checkpoint;
+}
+
+bool FMCPSceneCheckpoints::CompareWithWorld(const FMCPSceneCheckpoint& Checkpoint, bool bFullCompare, FMCPWorldComparison& OutComparison, FString& OutError)
+{
+    UWorld* World = Checkpoint.World.Get();
+    if (!World)
+    {
+        OutError = FString::Printf(TEXT("The world of checkpoint '%s' is no longer loaded"), *Checkpoint.Id);
+        return false;
+    }
+
+    FMCPSceneHashIndex& HashIndex = FMCPSceneHashIndex::Get();
+    HashIndex.Update(World);
+
+    // The journal names actors edited in ways the content hash does not cover, e.g. arbitrary properties
+    TSet<FName> JournalActors;
+    TArray<FMCPSceneChange> Changes;
+    bool bChangesTruncated = false;
+    OutComparison.bFullCompare = bFullCompare ||
+        !FMCPSceneJournal::Get().GetChangesSince(Checkpoint.SceneVersion, MAX_int32, Changes, bChangesTruncated);
+    for (const FMCPSceneChange& Change : Changes)
+    {
+        JournalActors.Add(Change.ActorName);
+    }
+
+    TMap<FName, AActor*> Selected;
+    for (TActorIterator<AActor> It(World); It; ++It)
+    {
+        AActor* Actor = *It;
+        if (FMCPSceneJournal::IsTrackedActor(Actor) && (Checkpoint.Filter.IsEmpty() || Checkpoint.Filter.Matches(Actor)))
+        {
+            Selected.Add(Actor->GetFName(), Actor);
+        }
+    }
+
+    // Only actors whose hash or journal entries point at a change are serialized again
+    TArray<uint8> CurrentBytes;
+    FMCPCheckpointRecord Current;
+    for (int32 Index = 0; Index < Checkpoint.Entries.Num(); ++Index)
+    {
+        const FMCPCheckpointEntry& Entry = Checkpoint.Entries[Index];
+
+        // Actors that left the selection since the checkpoint still count as present
+        AActor* Actor = nullptr;
+        if (!Selected.RemoveAndCopyValue(Entry.Name, Actor))
+        {
+            Actor = FindLiveActor(World, Entry.Name);
+        }
+        if (!Actor)
+        {
+            OutComparison.Missing.Add(Index);
+            continue;
+        }
+
+        uint64 Hash = 0;
+        if (!OutComparison.bFullCompare && !JournalActors.Contains(Entry.Name) && HashIndex.GetActorHash(Entry.Name, Hash) && Hash == Entry.ContentHash)
+        {
+            continue;
+        }
+
+        Current = FMCPCheckpointRecord();
+        CaptureRecord(Actor, Current);
+        CurrentBytes.Reset();
+        OutComparison.ComparedCount++;
+        if (WriteRecord(Current, CurrentBytes) != Entry.StateHash)
+        {
+            OutComparison.Changed.Emplace(Index, Actor);
+        }
+    }
+
+    // What is left of the selection was spawned after the checkpoint; actors that only moved into it are not new
+    for (const TPair<FName, AActor*>& Remaining : Selected)
+    {
+        if (!Checkpoint.WorldActorNames.Contains(Remaining.Key))
+        {
+            OutComparison.Added.Add(Remaining.Value);
+        }
+    }
+    return true;
+}
+
+bool FMCPSceneCheckpoints::Restore(const FMCPSceneCheckpoint& Checkpoint, bool bDryRun, bool bFullCompare, FMCPRestoreResult& OutResult, FString& OutError)
+{
+    FMCPWorldComparison Comparison;
+    if (!CompareWithWorld(Checkpoint, bFullCompare, Comparison, OutError))
+    {
+        return false;
+    }
+    OutResult.ComparedCount = Comparison.ComparedCount;
+    OutResult.bFullCompare = Comparison.bFullCompare;
+
+    if (bDryRun)
+    {
+        for (const TPair<int32, AActor*>& Entry : Comparison.Changed)
+        {
+            OutResult.Restored.Add(Checkpoint.Entries[Entry.Key].Name);
+        }
+        for (const int32 Index : Comparison.Missing)
+        {
+            OutResult.Respawned.Add(Checkpoint.Entries[Index].Name);
+        }
+        for (const AActor* Actor : Comparison.Added)
+        {
+            OutResult.Destroyed.Add(Actor->GetFName());
+        }
+        return true;
+    }
+
+    UWorld* World = Checkpoint.World.Get();
+
+    // No transaction and no Modify: layouts can be restored any number of times without growing the undo buffer
+    for (AActor* Actor : Comparison.Added)
+    {
+        const FName ActorName = Actor->GetFName();
+        if (World->EditorDestroyActor(Actor, true))
+        {
+            OutResult.Destroyed.Add(ActorName);
+        }
+        else
+        {
+            OutResult.Errors.Add(FString::Printf(TEXT("%s: could not be destroyed"), *ActorName.ToString()));
+        }
+    }
+
+    TMap<int32, TArray<uint8>> ChunkCache;
+    FMCPCheckpointRecord Record;
+    for (const int32 Index : Comparison.Missing)
+    {
+        Record = FMCPCheckpointRecord();
+        if (!Checkpoint.ReadRecord(Index, ChunkCache, Record))
+        {
+            OutError = FString::Printf(TEXT("Checkpoint '%s' is corrupt"), *Checkpoint.Id);
+            return false;
+        }
+
+        FString SpawnError;
+        AActor* Actor = Respawn(World, Record, SpawnError);
+        if (!Actor)
+        {
+            OutResult.Errors.Add(FString::Printf(TEXT("%s: %s"), *Record.Name.ToString(), *SpawnError));
+            continue;
+        }
+        ApplyRecord(Actor, Record);
+        OutResult.Respawned.Add(Actor->GetFName());
+    }
+
+    for (const TPair<int32, AActor*>& Entry : Comparison.Changed)
+    {
+        Record = FMCPCheckpointRecord();
+        if (!Checkpoint.ReadRecord(Entry.Key, ChunkCache, Record))
+        {
+            OutError = FString::Printf(TEXT("Checkpoint '%s' is corrupt"), *Checkpoint.Id);
+            return false;
+        }
+        ApplyRecord(Entry.Value, Record);
+
+        // Direct writes raise no editor notifications, so the journal and the hashes are told here
+        FMCPSceneJournal::Get().RecordChange(EMCPSceneChangeType::Property, Entry.Value);
+        OutResult.Restored.Add(Record.Name);
+    }
+
+    MCP_LOG_INFO("Restored checkpoint %s: %d changed, %d respawned, %d destroyed, %d compared",
+        *Checkpoint.Id, OutResult.Restored.Num(), OutResult.Respawned.Num(), OutResult.Destroyed.Num(), OutResult.ComparedCount);
+    return true;
+}
+
+TSharedPtr<const FMCPSceneCheckpoint> FMCPSceneCheckpoints::Find(const FString& Id) const
+{
+    for (const TSharedRef<const FMCPSceneCheckpoint>& Checkpoint : Checkpoints)
+    {
+        if (Checkpoint->Id == Id)
+        {
+            return Checkpoint;
+        }
+    }
+    return nullptr;
+}
+
+bool FMCPSceneCheckpoints::Remove(const FString& Id)
+{
+    return Checkpoints.RemoveAll([&Id](const TSharedRef<const FMCPSceneCheckpoint>& Checkpoint) { return Checkpoint->Id == Id; }) > 0;
+}
+
+AActor* FMCPSceneCheckpoints::Respawn(UWorld* World, const FMCPCheckpointRecord& Record, FString& OutError)
+{
+    UClass* Class = LoadObject<UClass>(nullptr, *Record.ClassPath);
+    if (!Class || !Class->IsChildOf<AActor>())
+    {
+        OutError = FString::Printf(TEXT("class '%s' could not be loaded"), *Record.ClassPath);
+        return nullptr;
+    }
+
+    ULevel* Level = World->PersistentLevel;
+    for (ULevel* Candidate : World->GetLevels())
+    {
+        if (Candidate && Candidate->GetOuter()->GetFName() == Record.LevelName)
+        {
+            Level = Candidate;
+            break;
+        }
+    }
+
+    // A destroyed actor keeps its name until garbage collection; it is renamed out of the way so the respawned
+    // actor gets the recorded name back and later restores still find it. Undoing the deletion brings the old
+    // actor back under its new name
+    if (AActor* Stale = FindObjectFast<AActor>(Level, Record.Name))
+    {
+        if (!IsValid(Stale))
+        {
+            const FName StaleName = MakeUniqueObjectName(Level, Stale->GetClass(), FName(*(Record.Name.ToString() + TEXT("_Destroyed"))));
+            Stale->Rename(*StaleName.ToString(), nullptr, REN_DontCreateRedirectors | REN_NonTransactional | REN_DoNotDirty | REN_ForceNoResetLoaders);
+        }
+    }
+
+    // Requested still falls back to a unique name rather than failing if the name cannot be freed
+    FActorSpawnParameters SpawnParams;
+    SpawnParams.Name = Record.Name;
+    SpawnParams.NameMode = FActorSpawnParameters::ESpawnActorNameMode::Requested;
+    SpawnParams.OverrideLevel = Level;
+    SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+    AActor* Actor = World->SpawnActor(Class, &Record.Transform, SpawnParams);
+    if (!Actor)
+    {
+        OutError = TEXT("spawn failed");
+    }
+    return Actor;
+}
+
+void FMCPSceneCheckpoints::ApplyRecord(AActor* Actor, const FMCPCheckpointRecord& Record)
+{
+    LoadProperties(Actor, Record.Properties);
+    if (Actor->GetActorLabel() != Record.Label)
+    {
+        Actor->SetActorLabel(Record.Label);
+    }
+    if (Actor->GetFolderPath() != Record.Folder)
+    {
+        Actor->SetFolderPath(Record.Folder);
+    }
+
+    // Construction scripts rebuild their components from the restored actor properties first
+    Actor->RerunConstructionScripts();
+
+    TSet<FName> RecordedComponents;
+    for (const FMCPCheckpointComponent& ComponentRecord : Record.Components)
+    {
+        RecordedComponents.Add(ComponentRecord.Name);
+
+        UActorComponent* Component = FindObjectFast<UActorComponent>(Actor, ComponentRecord.Name);
+        bool bCreated = false;
+        if (!IsValid(Component))
+        {
+            // Class and construction script components come back with the actor; only instance components are recreated
+            UClass* ComponentClass = ComponentRecord.bInstance ? LoadObject<UClass>(nullptr, *ComponentRecord.ClassPath) : nullptr;
+            if (!ComponentClass || !ComponentClass->IsChildOf<UActorComponent>())
+            {
+                continue;
+            }
+            Component = NewObject<UActorComponent>(Actor, ComponentClass, ComponentRecord.Name, RF_Transactional);
+            Actor->AddInstanceComponent(Component);
+            bCreated = true;
+        }
+
+        LoadProperties(Component, ComponentRecord.Properties);
+        if (bCreated)
+        {
+            // The restored attach parent does not list the new component yet
+            USceneComponent* SceneComponent = Cast<USceneComponent>(Component);
+            if (SceneComponent && SceneComponent->GetAttachParent())
+            {
+                USceneComponent* Parent = SceneComponent->GetAttachParent();
+                const FName SocketName = SceneComponent->GetAttachSocketName();
+                SceneComponent->SetupAttachment(nullptr);
+                SceneComponent->AttachToComponent(Parent, FAttachmentTransformRules::KeepRelativeTransform, SocketName);
+            }
+            Component->RegisterComponent();
+        }
+        else if (Component->IsRegistered())
+        {
+            Component->ReregisterComponent();
+        }
+    }
+
+    // Components added to the instance after the checkpoint
+    TInlineComponentArray<UActorComponent*> Components;
+    Actor->GetComponents(Components);
+    for (UActorComponent* Component : Components)
+    {
+        if (Component && Component->CreationMethod == EComponentCreationMethod::Instance &&
+            Component != Actor->GetRootComponent() && !Component->HasAnyFlags(RF_Transient) &&
+            !RecordedComponents.Contains(Component->GetFName()))
+        {
+            Component->DestroyComponent();
+        }
+    }
+
+    Actor->SetActorTransform(Record.Transform, false, nullptr, ETeleportType::TeleportPhysics);
+    Actor->MarkComponentsRenderStateDirty();
+}
@@ -0,0 +1,382 @@
+#include "MCPSceneDiff.h"
+
+#include "GameFramework/Actor.h"
+#include "MCPCommandHandlers_Scene.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/ObjectAndNameAsStringProxyArchive.h"
+#include "Serialization/StructuredArchiveAdapters.h"
+#include "UObject/SoftObjectPath.h"
+#include "UObject/UnrealType.h"
+
+namespace
+{
+    /** Below these differences a transform component is reported unchanged */
+    constexpr double LOCATION_TOLERANCE = 1.e-3;
+    constexpr double ROTATION_TOLERANCE = 1.e-5;
+    constexpr double SCALE_TOLERANCE = 1.e-4;
+
+    /** @return [before, after] */
+    TArray<TSharedPtr<FJsonValue>> MakePair(const TArray<TSharedPtr<FJsonValue>>& Before, const TArray<TSharedPtr<FJsonValue>>& After)
+    {
+        TArray<TSharedPtr<FJsonValue>> Array;
+        Array.Add(MakeShared<FJsonValueArray>(Before));
+        Array.Add(MakeShared<FJsonValueArray>(After));
+        return Array;
+    }
+
+    TArray<TSharedPtr<FJsonValue>> MakeNameArray(const TArray<FName>& Names)
+    {
+        TArray<TSharedPtr<FJsonValue>> Array;
+        for (const FName& Name : Names)
+        {
+            Array.Add(MakeShared<FJsonValueString>(Name.ToString()));
+        }
+        return Array;
+    }
+
+    /** @return Class name without its package, e.g. StaticMeshActor or BP_Door_C */
+    FString GetClassName(const FString& ClassPath)
+    {
+        return FSoftObjectPath(ClassPath).GetAssetName();
+    }
+
+    /**
+     * Property values of a class held in plain memory rather than an object, so comparing two serialized
+     * states spawns no actor or component outside a level; starts as a copy of the class defaults
+     */
+    class FDetachedProperties
+    {
+    public:
+        explicit FDetachedProperties(UClass* InClass)
+            : Class(InClass)
+            , Defaults(InClass->GetDefaultObject())
+        {
+            Data = static_cast<uint8*>(FMemory::Malloc(Class->GetPropertiesSize(), Class->GetMinAlignment()));
+            FMemory::Memzero(Data, Class->GetPropertiesSize());
+            Class->InitializeStruct(Data);
+            for (FProperty* Property = Class->PropertyLink; Property; Property = Property->PropertyLinkNext)
+            {
+                Property->CopyCompleteValue_InContainer(Data, Defaults);
+            }
+        }
+
+        ~FDetachedProperties()
+        {
+            Class->DestroyStruct(Data);
+            FMemory::Free(Data);
+        }
+
+        /** Read properties written by FMCPSceneCheckpoints, the way LoadProperties reads them into an object */
+        void Load(const TArray<uint8>& Bytes)
+        {
+            if (Bytes.Num() == 0)
+            {
+                return;
+            }
+            FMemoryReader Reader(Bytes, true);
+            Reader.ArNoDelta = true;
+            FObjectAndNameAsStringProxyArchive Archive(Reader, true);
+            Archive.ArNoDelta = true;
+            Class->SerializeTaggedProperties(FStructuredArchiveFromArchive(Archive).GetSlot(), Data, Class, reinterpret_cast<uint8*>(Defaults));
+        }
+
+        const uint8* Get() const { return Data; }
+
+    private:
+        UClass* Class;
+        UObject* Defaults;
+        uint8* Data = nullptr;
+
+        // Make non-copyable
+        FDetachedProperties(const FDetachedProperties&) = delete;
+        FDetachedProperties& operator=(const FDetachedProperties&) = delete;
+    };
+}
+
+bool FMCPSceneDiff::Diff(const FMCPSceneCheckpoint& From, const FMCPSceneCheckpoint* To, const FMCPSceneDiffOptions& Options, FMCPSceneDiffResult& OutResult, FString& OutError)
+{
+    TMap<int32, TArray<uint8>> FromChunks;
+    TMap<int32, TArray<uint8>> ToChunks;
+    FMCPCheckpointRecord Before;
+    FMCPCheckpointRecord After;
+
+    auto ReadFrom = [&From, &FromChunks, &OutError](int32 Index, FMCPCheckpointRecord& OutRecord)
+    {
+        OutRecord = FMCPCheckpointRecord();
+        if (!From.ReadRecord(Index, FromChunks, OutRecord))
+        {
+            OutError = FString::Printf(TEXT("Checkpoint '%s' is corrupt"), *From.Id);
+            return false;
+        }
+        return true;
+    };
+
+    if (To)
+    {
+        // Record hashes are exact, so equal hashes skip an actor without touching its compressed record
+        for (int32 Index = 0; Index < From.Entries.Num(); ++Index)
+        {
+            const FMCPCheckpointEntry& Entry = From.Entries[Index];
+            const int32* ToIndex = To->EntryIndex.Find(Entry.Name);
+            if (!ToIndex)
+            {
+                // Actors that only left the later checkpoint's filter were not removed
+                if (!To->WorldActorNames.Contains(Entry.Name))
+                {
+                    OutResult.RemovedCount++;
+                    if (OutResult.Removed.Num() < Options.MaxChanges && !ReadFrom(Index, OutResult.Removed.AddDefaulted_GetRef()))
+                    {
+                        return false;
+                    }
+                }
+                continue;
+            }
+
+            const FMCPCheckpointEntry& ToEntry = To->Entries[*ToIndex];
+            if (ToEntry.StateHash == Entry.StateHash)
+            {
+                continue;
+            }
+
+            OutResult.ComparedCount++;
+            OutResult.ChangedCount++;
+            if (OutResult.Changed.Num() < Options.MaxChanges)
+            {
+                if (!ReadFrom(Index, Before))
+                {
+                    return false;
+                }
+                After = FMCPCheckpointRecord();
+                if (!To->ReadRecord(*ToIndex, ToChunks, After))
+                {
+                    OutError = FString::Printf(TEXT("Checkpoint '%s' is corrupt"), *To->Id);
+                    return false;
+                }
+                DiffRecords(Before, After, Options.bProperties, OutResult.Changed.AddDefaulted_GetRef());
+            }
+        }
+
+        for (int32 Index = 0; Index < To->Entries.Num(); ++Index)
+        {
+            const FName Name = To->Entries[Index].Name;
+            if (From.EntryIndex.Contains(Name) || From.WorldActorNames.Contains(Name))
+            {
+                continue;
+            }
+
+            OutResult.AddedCount++;
+            if (OutResult.Added.Num() < Options.MaxChanges)
+            {
+                FMCPCheckpointRecord& Record = OutResult.Added.AddDefaulted_GetRef();
+                if (!To->ReadRecord(Index, ToChunks, Record))
+                {
+                    OutError = FString::Printf(TEXT("Checkpoint '%s' is corrupt"), *To->Id);
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // Against the live world the scene hashes and the journal pick the actors to compare
+    FMCPWorldComparison Comparison;
+    if (!FMCPSceneCheckpoints::Get().CompareWithWorld(From, Options.bFullCompare, Comparison, OutError))
+    {
+        return false;
+    }
+    OutResult.ComparedCount = Comparison.ComparedCount;
+    OutResult.bFullCompare = Comparison.bFullCompare;
+    OutResult.ChangedCount = Comparison.Changed.Num();
+    OutResult.RemovedCount = Comparison.Missing.Num();
+    OutResult.AddedCount = Comparison.Added.Num();
+
+    for (int32 Index = 0; Index < FMath::Min(Comparison.Changed.Num(), Options.MaxChanges); ++Index)
+    {
+        if (!ReadFrom(Comparison.Changed[Index].Key, Before))
+        {
+            return false;
+        }
+        After = FMCPCheckpointRecord();
+        FMCPSceneCheckpoints::CaptureRecord(Comparison.Changed[Index].Value, After);
+        DiffRecords(Before, After, Options.bProperties, OutResult.Changed.AddDefaulted_GetRef());
+    }
+    for (int32 Index = 0; Index < FMath::Min(Comparison.Missing.Num(), Options.MaxChanges); ++Index)
+    {
+        if (!ReadFrom(Comparison.Missing[Index], OutResult.Removed.AddDefaulted_GetRef()))
+        {
+            return false;
+        }
+    }
+    for (int32 Index = 0; Index < FMath::Min(Comparison.Added.Num(), Options.MaxChanges); ++Index)
+    {
+        FMCPSceneCheckpoints::CaptureRecord(Comparison.Added[Index], OutResult.Added.AddDefaulted_GetRef());
+    }
+    return true;
+}
+
+void FMCPSceneDiff::DiffRecords(const FMCPCheckpointRecord& Before, const FMCPCheckpointRecord& After, bool bProperties, FMCPActorDiff& OutDiff)
+{
+    OutDiff.Name = After.Name;
+    OutDiff.ClassPath = After.ClassPath;
+    OutDiff.Before = Before.Transform;
+    OutDiff.After = After.Transform;
+    OutDiff.LabelBefore = Before.Label;
+    OutDiff.LabelAfter = After.Label;
+    OutDiff.FolderBefore = Before.Folder;
+    OutDiff.FolderAfter = After.Folder;
+
+    // Properties of different classes do not line up; the class change is the whole story
+    const bool bSameClass = Before.ClassPath == After.ClassPath;
+    if (!bSameClass)
+    {
+        OutDiff.ClassPathBefore = Before.ClassPath;
+    }
+    else if (bProperties)
+    {
+        DiffProperties(After.ClassPath, Before.Properties, After.Properties, OutDiff.Properties);
+    }
+
+    TMap<FName, const FMCPCheckpointComponent*> BeforeComponents;
+    for (const FMCPCheckpointComponent& Component : Before.Components)
+    {
+        BeforeComponents.Add(Component.Name, &Component);
+    }
+
+    for (const FMCPCheckpointComponent& Component : After.Components)
+    {
+        const FMCPCheckpointComponent* BeforeComponent = nullptr;
+        if (!BeforeComponents.RemoveAndCopyValue(Component.Name, BeforeComponent))
+        {
+            OutDiff.AddedComponents.Add(Component.Name);
+            continue;
+        }
+        if (BeforeComponent->Properties == Component.Properties && BeforeComponent->ClassPath == Component.ClassPath)
+        {
+            continue;
+        }
+
+        TArray<FName> ComponentProperties;
+        if (bProperties && BeforeComponent->ClassPath == Component.ClassPath)
+        {
+            DiffProperties(Component.ClassPath, BeforeComponent->Properties, Component.Properties, ComponentProperties);
+        }
+        OutDiff.ChangedComponents.Emplace(Component.Name, MoveTemp(ComponentProperties));
+    }
+
+    for (const TPair<FName, const FMCPCheckpointComponent*>& Removed : BeforeComponents)
+    {
+        OutDiff.RemovedComponents.Add(Removed.Key);
+    }
+}
+
+void FMCPSceneDiff::DiffProperties(const FString& ClassPath, const TArray<uint8>& Before, const TArray<uint8>& After, TArray<FName>& OutProperties)
+{
+    if (Before == After)
+    {
+        return;
+    }
+
+    UClass* Class = LoadObject<UClass>(nullptr, *ClassPath);
+    if (!Class)
+    {
+        return;
+    }
+
+    // Both states start from the class defaults, so properties neither state overrides compare equal
+    FDetachedProperties BeforeProperties(Class);
+    FDetachedProperties AfterProperties(Class);
+    BeforeProperties.Load(Before);
+    AfterProperties.Load(After);
+
+    for (TFieldIterator<FProperty> It(Class); It; ++It)
+    {
+        const FProperty* Property = *It;
+
+        // Transient state is not checkpointed, and instanced references point at subobjects of whichever actor was saved
+        if (Property->HasAnyPropertyFlags(CPF_Transient | CPF_InstancedReference | CPF_ContainsInstancedReference))
+        {
+            continue;
+        }
+        for (int32 ArrayIndex = 0; ArrayIndex < Property->ArrayDim; ++ArrayIndex)
+        {
+            if (!Property->Identical_InContainer(BeforeProperties.Get(), AfterProperties.Get(), ArrayIndex))
+            {
+                OutProperties.Add(Property->GetFName());
+                break;
+            }
+        }
+    }
+}
+
+TSharedPtr<FJsonObject> FMCPSceneDiff::ToJson(const FMCPActorDiff& Diff)
+{
+    TSharedPtr<FJsonObject> Info = MakeShared<FJsonObject>();
+    Info->SetStringField("name", Diff.Name.ToString());
+    Info->SetStringField("class", GetClassName(Diff.ClassPath));
+    if (!Diff.ClassPathBefore.IsEmpty())
+    {
+        Info->SetStringField("class_before", GetClassName(Diff.ClassPathBefore));
+    }
+
+    if (!Diff.Before.GetLocation().Equals(Diff.After.GetLocation(), LOCATION_TOLERANCE))
+    {
+        Info->SetArrayField("location", MakePair(FMCPSceneUtils::MakeVectorArray(Diff.Before.GetLocation()), FMCPSceneUtils::MakeVectorArray(Diff.After.GetLocation())));
+    }
+    if (!Diff.Before.GetRotation().Equals(Diff.After.GetRotation(), ROTATION_TOLERANCE))
+    {
+        Info->SetArrayField("rotation", MakePair(FMCPSceneUtils::MakeRotatorArray(Diff.Before.Rotator()), FMCPSceneUtils::MakeRotatorArray(Diff.After.Rotator())));
+    }
+    if (!Diff.Before.GetScale3D().Equals(Diff.After.GetScale3D(), SCALE_TOLERANCE))
+    {
+        Info->SetArrayField("scale", MakePair(FMCPSceneUtils::MakeVectorArray(Diff.Before.GetScale3D()), FMCPSceneUtils::MakeVectorArray(Diff.After.GetScale3D())));
+    }
+    if (Diff.LabelBefore != Diff.LabelAfter)
+    {
+        Info->SetArrayField("label", { MakeShared<FJsonValueString>(Diff.LabelBefore), MakeShared<FJsonValueString>(Diff.LabelAfter) });
+    }
+    if (Diff.FolderBefore != Diff.FolderAfter)
+    {
+        Info->SetArrayField("folder", { MakeShared<FJsonValueString>(Diff.FolderBefore.ToString()), MakeShared<FJsonValueString>(Diff.FolderAfter.ToString()) });
+    }
+    if (Diff.Properties.Num() > 0)
+    {
+        Info->SetArrayField("properties", MakeNameArray(Diff.Properties));
+    }
+
+    TSharedPtr<FJsonObject> Components = MakeShared<FJsonObject>();
+    if (Diff.AddedComponents.Num() > 0)
+    {
+        Components->SetArrayField("added", MakeNameArray(Diff.AddedComponents));
+    }
+    if (Diff.RemovedComponents.Num() > 0)
+    {
+        Components->SetArrayField("removed", MakeNameArray(Diff.RemovedComponents));
+    }
+    if (Diff.ChangedComponents.Num() > 0)
+    {
+        TSharedPtr<FJsonObject> Changed = MakeShared<FJsonObject>();
+        for (const TPair<FName, TArray<FName>>& Component : Diff.ChangedComponents)
+        {
+            Changed->SetArrayField(Component.Key.ToString(), MakeNameArray(Component.Value));
+        }
+        Components->SetObjectField("changed", Changed);
+    }
+    if (Components->Values.Num() > 0)
+    {
+        Info->SetObjectField("components", Components);
+    }
+    return Info;
+}
+
+TSharedPtr<FJsonObject> FMCPSceneDiff::ToJson(const FMCPCheckpointRecord& Record)
+{
+    TSharedPtr<FJsonObject> Info = MakeShared<FJsonObject>();
+    Info->SetStringField("name", Record.Name.ToString());
+    Info->SetStringField("class", GetClassName(Record.ClassPath));
+    if (!Record.Label.IsEmpty() && Record.Label != Record.Name.ToString())
+    {
+        Info->SetStringField("label", Record.Label);
+    }
+    Info->SetArrayField("location", FMCPSceneUtils::MakeVectorArray(Record.Transform.GetLocation()));
+    return Info;
+}
@@ -0,0 +1,397 @@
+#include "MCPSceneExport.h"
+
+#include "EngineUtils.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "Engine/StaticMesh.h"
+#include "GameFramework/Actor.h"
+#include "Components/SceneComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Async/Async.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include "MCPFileLogger.h"
+#include "MCPSceneJournal.h"
+
+static_assert(PLATFORM_LITTLE_ENDIAN, "Snapshot files are written as little-endian memory images");
+
+namespace
+{
+    /** Interns strings into the snapshot's UTF-8 string table */
+    class FStringTableBuilder
+    {
+    public:
+        FStringTableBuilder()
+        {
+            Offsets.Add(0);
+        }
+
+        uint32 Add(const FString& Value)
+        {
+            if (Value.IsEmpty())
+            {
+                return MCPSnapshotFormat::NO_STRING;
+            }
+            if (const uint32* Existing = Indices.Find(Value))
+            {
+                return *Existing;
+            }
+
+            const FTCHARToUTF8 Converter(*Value);
+            Bytes.Append(reinterpret_cast<const uint8*>(Converter.Get()), Converter.Length());
+            Offsets.Add(Bytes.Num());
+
+            const uint32 Index = Offsets.Num() - 2;
+            Indices.Add(Value, Index);
+            return Index;
+        }
+
+        uint32 Add(FName Value)
+        {
+            if (Value.IsNone())
+            {
+                return MCPSnapshotFormat::NO_STRING;
+            }
+            if (const uint32* Existing = NameIndices.Find(Value))
+            {
+                return *Existing;
+            }
+            const uint32 Index = Add(Value.ToString());
+            NameIndices.Add(Value, Index);
+            return Index;
+        }
+
+        int32 Num() const { return Offsets.Num() - 1; }
+
+        TArray<uint32> Offsets;
+        TArray<uint8> Bytes;
+
+    private:
+        TMap<FString, uint32> Indices;
+        TMap<FName, uint32> NameIndices;
+    };
+
+    void PackTransform(const FTransform& Transform, FMCPSnapshotTransform& Out)
+    {
+        const FVector Location = Transform.GetLocation();
+        FQuat Rotation = Transform.GetRotation();
+        if (Rotation.W < 0.0)
+        {
+            Rotation = FQuat(-Rotation.X, -Rotation.Y, -Rotation.Z, -Rotation.W);
+        }
+        const FVector Scale = Transform.GetScale3D();
+
+        Out.Location[0] = Location.X;
+        Out.Location[1] = Location.Y;
+        Out.Location[2] = Location.Z;
+        Out.Rotation[0] = Rotation.X;
+        Out.Rotation[1] = Rotation.Y;
+        Out.Rotation[2] = Rotation.Z;
+        Out.Rotation[3] = Rotation.W;
+        Out.Scale[0] = Scale.X;
+        Out.Scale[1] = Scale.Y;
+        Out.Scale[2] = Scale.Z;
+    }
+
+    uint32 GetMobilityFlags(const USceneComponent* Component)
+    {
+        switch (Component->Mobility)
+        {
+            case EComponentMobility::Static:  return MCPSnapshotFormat::StaticMobility;
+            case EComponentMobility::Movable: return MCPSnapshotFormat::MovableMobility;
+            default:                          return 0;
+        }
+    }
+
+    void CaptureComponents(const AActor* Actor, TArray<FMCPExportComponent>& OutComponents)
+    {
+        TInlineComponentArray<UActorComponent*> Components(Actor);
+
+        // Parents are stored as indices into the actor's own component list
+        TMap<const UActorComponent*, int32, TInlineSetAllocator<16>> LocalIndices;
+        for (int32 Index = 0; Index < Components.Num(); ++Index)
+        {
+            LocalIndices.Add(Components[Index], Index);
+        }
+
+        for (const UActorComponent* Component : Components)
+        {
+            FMCPExportComponent& Out = OutComponents.AddDefaulted_GetRef();
+            Out.Name = Component->GetFName();
+            Out.Class = Component->GetClass();
+
+            if (const USceneComponent* SceneComponent = Cast<USceneComponent>(Component))
+            {
+                Out.RelativeTransform = SceneComponent->GetRelativeTransform();
+                Out.Flags |= GetMobilityFlags(SceneComponent);
+                if (SceneComponent->IsVisible())
+                {
+                    Out.Flags |= MCPSnapshotFormat::Visible;
+                }
+                if (const int32* ParentIndex = LocalIndices.Find(SceneComponent->GetAttachParent()))
+                {
+                    Out.Parent = *ParentIndex;
+                }
+            }
+
+            if (const UStaticMeshComponent* MeshComponent = Cast<UStaticMeshComponent>(Component))
+            {
+                if (const UStaticMesh* Mesh = MeshComponent->GetStaticMesh())
+                {
+                    Out.AssetPath = Mesh->GetPathName();
+                }
+            }
+
+            if (const UInstancedStaticMeshComponent* InstancedComponent = Cast<UInstancedStaticMeshComponent>(Component))
+            {
+                Out.InstanceCount = InstancedComponent->GetInstanceCount();
+            }
+        }
+    }
+
+    /** Serialize zeros up to an absolute file offset */
+    void PadTo(FArchive& Writer, int64 Offset)
+    {
+        static const uint8 Zeros[MCPSnapshotFormat::SECTION_ALIGNMENT] = {};
+        while (Writer.Tell() < Offset)
+        {
+            const int64 Count = FMath::Min<int64>(Offset - Writer.Tell(), MCPSnapshotFormat::SECTION_ALIGNMENT);
+            Writer.Serialize(const_cast<uint8*>(Zeros), Count);
+        }
+    }
+}
+
+TSharedRef<FMCPSceneExportData> FMCPSceneExporter::Capture(UWorld* World, const FMCPActorFilter* Filter, bool bIncludeComponents)
+{
+    check(IsInGameThread());
+
+    TSharedRef<FMCPSceneExportData> Data = MakeShared<FMCPSceneExportData>();
+    if (!World)
+    {
+        return Data;
+    }
+
+    Data->WorldName = World->GetName();
+    Data->SceneVersion = FMCPSceneJournal::Get().GetCurrentVersion();
+
+    FMCPSnapshotOptions Options;
+    for (TActorIterator<AActor> It(World); It; ++It)
+    {
+        const AActor* Actor = *It;
+        if (Filter && !Filter->Matches(Actor))
+        {
+            continue;
+        }
+
+        FMCPSceneSnapshot::CaptureActor(Actor, Options, Data->Actors.AddDefaulted_GetRef());
+        Data->ActorLevels.Add(Actor->GetLevel() ? Actor->GetLevel()->GetOuter()->GetFName() : NAME_None);
+        Data->ActorFolders.Add(Actor->GetFolderPath().ToString());
+
+        uint32 Flags = 0;
+        if (Actor->IsHidden())
+        {
+            Flags |= MCPSnapshotFormat::Hidden;
+        }
+        if (Actor->IsHiddenEd())
+        {
+            Flags |= MCPSnapshotFormat::HiddenInEditor;
+        }
+        if (const USceneComponent* Root = Actor->GetRootComponent())
+        {
+            Flags |= GetMobilityFlags(Root);
+        }
+        Data->ActorFlags.Add(Flags);
+
+        Data->ComponentStarts.Add(Data->Components.Num());
+        if (bIncludeComponents)
+        {
+            CaptureComponents(Actor, Data->Components);
+        }
+    }
+    Data->ComponentStarts.Add(Data->Components.Num());
+
+    return Data;
+}
+
+TFuture<FMCPSceneExportResult> FMCPSceneExporter::WriteAsync(TSharedRef<FMCPSceneExportData> Data, const FString& Path)
+{
+    return Async(EAsyncExecution::ThreadPool, [Data, Path]()
+    {
+        FMCPSceneExportResult Result = Write(*Data, Path);
+
+        // The file logger is not thread-safe, so the outcome is reported from the game thread
+        AsyncTask(ENamedThreads::GameThread, [Result]()
+        {
+            if (Result.bSuccess)
+            {
+                MCP_LOG_INFO("Wrote scene snapshot %s (%lld bytes) in %.1f ms", *Result.Path, Result.FileSize, Result.WriteSeconds * 1000.0);
+            }
+            else
+            {
+                MCP_LOG_ERROR("Failed to write scene snapshot %s: %s", *Result.Path, *Result.Error);
+            }
+        });
+        return Result;
+    });
+}
+
+FMCPSceneExportResult FMCPSceneExporter::Write(const FMCPSceneExportData& Data, const FString& Path)
+{
+    const double StartTime = FPlatformTime::Seconds();
+
+    FMCPSceneExportResult Result;
+    Result.Path = Path;
+
+    const int32 ActorCount = Data.Actors.Num();
+    const int32 ComponentCount = Data.Components.Num();
+
+    // Strings are interned sequentially; the fixed-size columns are packed in parallel
+    FStringTableBuilder Strings;
+    const uint32 WorldNameString = Strings.Add(Data.WorldName);
+
+    TArray<FMCPSnapshotActor> Actors;
+    Actors.SetNumZeroed(ActorCount);
+    for (int32 Index = 0; Index < ActorCount; ++Index)
+    {
+        const FMCPActorRecord& Record = Data.Actors[Index];
+        FMCPSnapshotActor& Out = Actors[Index];
+        Out.NameString = Strings.Add(Record.Name);
+        Out.LabelString = Strings.Add(Record.Label);
+        Out.ClassString = Strings.Add(Record.Class ? Record.Class->GetFName() : NAME_None);
+        Out.LevelString = Strings.Add(Data.ActorLevels[Index]);
+        Out.FolderString = Strings.Add(Data.ActorFolders[Index]);
+        Out.FirstComponent = Data.ComponentStarts[Index];
+        Out.ComponentCount = Data.ComponentStarts[Index + 1] - Data.ComponentStarts[Index];
+        Out.Flags = Data.ActorFlags[Index];
+    }
+
+    TArray<FMCPSnapshotComponent> Components;
+    Components.SetNumZeroed(ComponentCount);
+    for (int32 ActorIndex = 0; ActorIndex < ActorCount; ++ActorIndex)
+    {
+        const int32 First = Data.ComponentStarts[ActorIndex];
+        for (int32 Index = First; Index < Data.ComponentStarts[ActorIndex + 1]; ++Index)
+        {
+            const FMCPExportComponent& Component = Data.Components[Index];
+            FMCPSnapshotComponent& Out = Components[Index];
+            Out.ActorIndex = ActorIndex;
+            Out.NameString = Strings.Add(Component.Name);
+            Out.ClassString = Strings.Add(Component.Class ? Component.Class->GetFName() : NAME_None);
+            Out.AssetString = Strings.Add(Component.AssetPath);
+            Out.ParentComponent = Component.Parent == INDEX_NONE ? MCPSnapshotFormat::NO_PARENT : static_cast<uint32>(First + Component.Parent);
+            Out.Flags = Component.Flags;
+            Out.InstanceCount = Component.InstanceCount;
+            PackTransform(Component.RelativeTransform, Out.RelativeTransform);
+        }
+    }
+
+    TArray<FMCPSnapshotTransform> Transforms;
+    TArray<FMCPSnapshotBounds> Bounds;
+    Transforms.SetNumUninitialized(ActorCount);
+    Bounds.SetNumUninitialized(ActorCount);
+    FMCPSceneSnapshot::ParallelForChunks(ActorCount, [&Data, &Transforms, &Bounds](int32 Start, int32 End)
+    {
+        for (int32 Index = Start; Index < End; ++Index)
+        {
+            const FMCPActorRecord& Record = Data.Actors[Index];
+            PackTransform(Record.Transform, Transforms[Index]);
+            for (int32 Axis = 0; Axis < 3; ++Axis)
+            {
+                Bounds[Index].Min[Axis] = Record.Bounds.Min[Axis];
+                Bounds[Index].Max[Axis] = Record.Bounds.Max[Axis];
+            }
+        }
+    });
+
+    // Lay the sections out back to back on aligned offsets after the header and section table
+    struct FSectionData
+    {
+        MCPSnapshotFormat::ESectionId Id;
+        uint32 Stride;
+        int64 Count;
+        const void* Data;
+    };
+    const FSectionData SectionData[] =
+    {
+        { MCPSnapshotFormat::StringOffsets, sizeof(uint32), Strings.Offsets.Num(), Strings.Offsets.GetData() },
+        { MCPSnapshotFormat::StringData, sizeof(uint8), Strings.Bytes.Num(), Strings.Bytes.GetData() },
+        { MCPSnapshotFormat::Actors, sizeof(FMCPSnapshotActor), Actors.Num(), Actors.GetData() },
+        { MCPSnapshotFormat::Transforms, sizeof(FMCPSnapshotTransform), Transforms.Num(), Transforms.GetData() },
+        { MCPSnapshotFormat::Bounds, sizeof(FMCPSnapshotBounds), Bounds.Num(), Bounds.GetData() },
+        { MCPSnapshotFormat::Components, sizeof(FMCPSnapshotComponent), Components.Num(), Components.GetData() },
+    };
+    constexpr int32 SectionCount = UE_ARRAY_COUNT(SectionData);
+
+    TArray<FMCPSnapshotSection> Sections;
+    Sections.SetNumZeroed(SectionCount);
+    int64 Offset = sizeof(FMCPSnapshotFileHeader) + SectionCount * sizeof(FMCPSnapshotSection);
+    for (int32 Index = 0; Index < SectionCount; ++Index)
+    {
+        Offset = Align(Offset, static_cast<int64>(MCPSnapshotFormat::SECTION_ALIGNMENT));
+        Sections[Index].Id = SectionData[Index].Id;
+        Sections[Index].Stride = SectionData[Index].Stride;
+        Sections[Index].Count = SectionData[Index].Count;
+        Sections[Index].Offset = Offset;
+        Sections[Index].Size = SectionData[Index].Count * SectionData[Index].Stride;
+        Offset += Sections[Index].Size;
+    }
+
+    FMCPSnapshotFileHeader Header;
+    FMemory::Memzero(Header);
+    FMemory::Memcpy(Header.Magic, "MCPSNAP", 8);
+    Header.FormatVersion = MCPSnapshotFormat::FORMAT_VERSION;
+    Header.HeaderSize = sizeof(FMCPSnapshotFileHeader);
+    Header.SceneVersion = Data.SceneVersion;
+    Header.CreatedUnixTime = FDateTime::UtcNow().ToUnixTimestamp();
+    Header.ActorCount = ActorCount;
+    Header.ComponentCount = ComponentCount;
+    Header.StringCount = Strings.Num();
+    Header.SectionCount = SectionCount;
+    Header.WorldNameString = WorldNameString;
+
+    // Write to a temporary name and move into place so readers never see a partial file
+    const FString TempPath = Path + TEXT(".tmp");
+    IFileManager& FileManager = IFileManager::Get();
+    FileManager.MakeDirectory(*FPaths::GetPath(Path), true);
+
+    TUniquePtr<FArchive> Writer(FileManager.CreateFileWriter(*TempPath));
+    if (!Writer)
+    {
+        Result.Error = FString::Printf(TEXT("Could not open %s for writing"), *TempPath);
+        return Result;
+    }
+
+    Writer->Serialize(&Header, sizeof(Header));
+    Writer->Serialize(Sections.GetData(), Sections.Num() * sizeof(FMCPSnapshotSection));
+    for (int32 Index = 0; Index < SectionCount; ++Index)
+    {
+        PadTo(*Writer, Sections[Index].Offset);
+        if (Sections[Index].Size > 0)
+        {
+            Writer->Serialize(const_cast<void*>(SectionData[Index].Data), Sections[Index].Size);
+        }
+    }
+
+    Result.FileSize = Writer->Tell();
+    const bool bWriteFailed = !Writer->Close();
+    Writer.Reset();
+
+    if (bWriteFailed)
+    {
+        FileManager.Delete(*TempPath);
+        Result.Error = FString::Printf(TEXT("Error while writing %s"), *TempPath);
+        return Result;
+    }
+
+    if (!FileManager.Move(*Path, *TempPath, true))
+    {
+        FileManager.Delete(*TempPath);
+        Result.Error = FString::Printf(TEXT("Could not move the snapshot into place at %s"), *Path);
+        return Result;
+    }
+
+    Result.bSuccess = true;
+    Result.WriteSeconds = FPlatformTime::Seconds() - StartTime;
+    return Result;
+}
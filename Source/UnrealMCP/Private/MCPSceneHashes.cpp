@@ -0,0 +1,358 @@
+#include "MCPSceneHashes.h"
+
+#include "EngineUtils.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "Engine/StaticMesh.h"
+#include "GameFramework/Actor.h"
+#include "Components/SceneComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Components/LightComponent.h"
+#include "Materials/MaterialInterface.h"
+#include "Hash/CityHash.h"
+#include "MCPFileLogger.h"
+
+namespace
+{
+    /** Streams values into a running 64-bit hash */
+    struct FHashBuilder
+    {
+        uint64 State = 0x9E3779B97F4A7C15ull;
+
+        void AddBytes(const void* Data, int64 Size)
+        {
+            State = CityHash64WithSeed(static_cast<const char*>(Data), static_cast<uint32>(Size), State);
+        }
+
+        template <typename T>
+        void Add(const T& Value)
+        {
+            static_assert(TIsPODType<T>::Value, "Only plain values can be hashed by bytes");
+            AddBytes(&Value, sizeof(T));
+        }
+
+        void AddString(const FString& Value)
+        {
+            Add(Value.Len());
+            AddBytes(*Value, Value.Len() * sizeof(TCHAR));
+        }
+
+        void AddObjectPath(const UObject* Object)
+        {
+            AddString(Object ? Object->GetPathName() : FString());
+        }
+
+        void AddVector(const FVector& Value)
+        {
+            // Adding zero turns -0.0 into +0.0 so equal values always hash the same
+            Add(Value.X + 0.0);
+            Add(Value.Y + 0.0);
+            Add(Value.Z + 0.0);
+        }
+
+        void AddTransform(const FTransform& Transform)
+        {
+            FQuat Rotation = Transform.GetRotation();
+            if (Rotation.W < 0.0)
+            {
+                Rotation = FQuat(-Rotation.X, -Rotation.Y, -Rotation.Z, -Rotation.W);
+            }
+            AddVector(Transform.GetLocation());
+            AddVector(FVector(Rotation.X, Rotation.Y, Rotation.Z));
+            Add(Rotation.W + 0.0);
+            AddVector(Transform.GetScale3D());
+        }
+    };
+
+    uint64 Mix(uint64 A, uint64 B)
+    {
+        return CityHash128to64(Uint128_64(A, B));
+    }
+
+    uint64 HashName(FName Name)
+    {
+        const FString NameString = Name.ToString();
+        return CityHash64(reinterpret_cast<const char*>(*NameString), NameString.Len() * sizeof(TCHAR));
+    }
+
+    uint64 CellContribution(const FIntVector& Cell, const FMCPSceneHashCell& CellHash)
+    {
+        return Mix(CityHash64(reinterpret_cast<const char*>(&Cell), sizeof(FIntVector)), CellHash.Hash);
+    }
+
+    uint64 HashComponent(const UActorComponent* Component)
+    {
+        FHashBuilder Builder;
+        Builder.AddObjectPath(Component->GetClass());
+        Builder.AddString(Component->GetName());
+
+        if (const USceneComponent* SceneComponent = Cast<USceneComponent>(Component))
+        {
+            Builder.AddTransform(SceneComponent->GetRelativeTransform());
+            Builder.Add(SceneComponent->GetVisibleFlag());
+            Builder.Add(static_cast<uint8>(SceneComponent->Mobility.GetValue()));
+        }
+
+        if (const UStaticMeshComponent* MeshComponent = Cast<UStaticMeshComponent>(Component))
+        {
+            Builder.AddObjectPath(MeshComponent->GetStaticMesh());
+            for (const UMaterialInterface* Material : MeshComponent->OverrideMaterials)
+            {
+                Builder.AddObjectPath(Material);
+            }
+        }
+
+        if (const UInstancedStaticMeshComponent* InstancedComponent = Cast<UInstancedStaticMeshComponent>(Component))
+        {
+            // Instance data is plain matrices, so it is hashed as one block
+            const TArray<FInstancedStaticMeshInstanceData>& Instances = InstancedComponent->PerInstanceSMData;
+            Builder.Add(Instances.Num());
+            Builder.AddBytes(Instances.GetData(), Instances.Num() * sizeof(FInstancedStaticMeshInstanceData));
+        }
+
+        if (const ULightComponent* LightComponent = Cast<ULightComponent>(Component))
+        {
+            Builder.Add(LightComponent->Intensity);
+            Builder.Add(LightComponent->LightColor.ToPackedARGB());
+        }
+
+        return Builder.State;
+    }
+}
+
+FMCPSceneHashIndex& FMCPSceneHashIndex::Get()
+{
+    static FMCPSceneHashIndex Instance;
+    return Instance;
+}
+
+void FMCPSceneHashIndex::Initialize(double InCellSize)
+{
+    if (bInitialized)
+    {
+        return;
+    }
+
+    CellSize = FMath::Max(InCellSize, 1.0);
+    bNeedsRebuild = true;
+
+    FMCPSceneJournal& Journal = FMCPSceneJournal::Get();
+    ChangeRecordedHandle = Journal.OnChangeRecorded().AddRaw(this, &FMCPSceneHashIndex::HandleChangeRecorded);
+    InvalidatedHandle = Journal.OnInvalidated().AddRaw(this, &FMCPSceneHashIndex::HandleJournalInvalidated);
+
+    bInitialized = true;
+    MCP_LOG_INFO("Scene hash index initialized with %.0f unit cells", CellSize);
+}
+
+void FMCPSceneHashIndex::Shutdown()
+{
+    if (!bInitialized)
+    {
+        return;
+    }
+
+    FMCPSceneJournal& Journal = FMCPSceneJournal::Get();
+    Journal.OnChangeRecorded().Remove(ChangeRecordedHandle);
+    Journal.OnInvalidated().Remove(InvalidatedHandle);
+
+    Actors.Empty();
+    Levels.Empty();
+    DirtyActors.Empty();
+    bNeedsRebuild = true;
+    bInitialized = false;
+    MCP_LOG_INFO("Scene hash index shut down");
+}
+
+void FMCPSceneHashIndex::Update(UWorld* World)
+{
+    check(IsInGameThread());
+
+    if (bNeedsRebuild)
+    {
+        Rebuild(World);
+        return;
+    }
+
+    for (const TPair<FName, TWeakObjectPtr<const AActor>>& Dirty : DirtyActors)
+    {
+        const AActor* Actor = Dirty.Value.Get();
+        if (IsValid(Actor) && FMCPSceneJournal::IsTrackedActor(Actor))
+        {
+            AddActor(Actor);
+        }
+        else
+        {
+            RemoveActor(Dirty.Key);
+        }
+    }
+    DirtyActors.Reset();
+}
+
+uint64 FMCPSceneHashIndex::GetRootHash() const
+{
+    uint64 Root = 0;
+    for (const TPair<FName, FMCPSceneHashLevel>& Level : Levels)
+    {
+        Root ^= Mix(HashName(Level.Key), Level.Value.Hash);
+    }
+    return Root;
+}
+
+bool FMCPSceneHashIndex::GetActorHash(FName ActorName, uint64& OutHash) const
+{
+    if (const FActorEntry* Entry = Actors.Find(ActorName))
+    {
+        OutHash = Entry->Hash;
+        return true;
+    }
+    return false;
+}
+
+uint64 FMCPSceneHashIndex::HashActor(const AActor* Actor)
+{
+    FHashBuilder Builder;
+    Builder.AddObjectPath(Actor->GetClass());
+    Builder.AddTransform(Actor->GetActorTransform());
+    Builder.AddString(Actor->GetActorLabel());
+    Builder.AddString(Actor->GetFolderPath().ToString());
+    Builder.Add(Actor->IsHidden());
+    Builder.Add(Actor->IsHiddenEd());
+    for (const FName& Tag : Actor->Tags)
+    {
+        Builder.AddString(Tag.ToString());
+    }
+
+    // Component hashes include the component name, so XOR gives the same result in any iteration order
+    TInlineComponentArray<UActorComponent*> Components(Actor);
+    uint64 ComponentsHash = 0;
+    for (const UActorComponent* Component : Components)
+    {
+        if (Component)
+        {
+            ComponentsHash ^= HashComponent(Component);
+        }
+    }
+    Builder.Add(Components.Num());
+    Builder.Add(ComponentsHash);
+
+    return Builder.State;
+}
+
+FString FMCPSceneHashIndex::HashToString(uint64 Hash)
+{
+    return FString::Printf(TEXT("%016llx"), Hash);
+}
+
+void FMCPSceneHashIndex::Rebuild(UWorld* World)
+{
+    const double StartTime = FPlatformTime::Seconds();
+
+    Actors.Reset();
+    Levels.Reset();
+    DirtyActors.Reset();
+
+    if (World)
+    {
+        for (TActorIterator<AActor> It(World); It; ++It)
+        {
+            if (FMCPSceneJournal::IsTrackedActor(*It))
+            {
+                AddActor(*It);
+            }
+        }
+    }
+
+    bNeedsRebuild = false;
+    MCP_LOG_INFO("Built scene hash index for %d actors in %.1f ms", Actors.Num(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+}
+
+void FMCPSceneHashIndex::AddActor(const AActor* Actor)
+{
+    const FName ActorName = Actor->GetFName();
+    RemoveActor(ActorName);
+
+    FActorEntry Entry;
+    Entry.Hash = HashActor(Actor);
+    Entry.Leaf = Mix(HashName(ActorName), Entry.Hash);
+    Entry.Level = Actor->GetLevel() ? Actor->GetLevel()->GetOuter()->GetFName() : NAME_None;
+    Entry.Cell = GetCell(Actor->GetActorLocation());
+
+    ToggleLeaf(Entry.Level, Entry.Cell, Entry.Leaf, 1);
+    Actors.Add(ActorName, Entry);
+}
+
+void FMCPSceneHashIndex::RemoveActor(FName ActorName)
+{
+    FActorEntry Entry;
+    if (Actors.RemoveAndCopyValue(ActorName, Entry))
+    {
+        ToggleLeaf(Entry.Level, Entry.Cell, Entry.Leaf, -1);
+    }
+}
+
+void FMCPSceneHashIndex::ToggleLeaf(FName LevelName, const FIntVector& Cell, uint64 Leaf, int32 CountDelta)
+{
+    FMCPSceneHashLevel& Level = Levels.FindOrAdd(LevelName);
+
+    // Take the cell's old contribution out of the level, update the cell, then put the new one back
+    FMCPSceneHashCell* CellHash = Level.Cells.Find(Cell);
+    if (CellHash)
+    {
+        Level.Hash ^= CellContribution(Cell, *CellHash);
+    }
+    else
+    {
+        CellHash = &Level.Cells.Add(Cell);
+    }
+
+    CellHash->Hash ^= Leaf;
+    CellHash->ActorCount += CountDelta;
+    Level.ActorCount += CountDelta;
+
+    if (CellHash->ActorCount > 0)
+    {
+        Level.Hash ^= CellContribution(Cell, *CellHash);
+    }
+    else
+    {
+        Level.Cells.Remove(Cell);
+    }
+
+    if (Level.ActorCount <= 0)
+    {
+        Levels.Remove(LevelName);
+    }
+}
+
+FIntVector FMCPSceneHashIndex::GetCell(const FVector& Location) const
+{
+    return FIntVector(
+        FMath::FloorToInt32(Location.X / CellSize),
+        FMath::FloorToInt32(Location.Y / CellSize),
+        FMath::FloorToInt32(Location.Z / CellSize));
+}
+
+void FMCPSceneHashIndex::HandleChangeRecorded(EMCPSceneChangeType Type, const AActor* Actor)
+{
+    if (bNeedsRebuild || !Actor)
+    {
+        return;
+    }
+
+    // Removed actors are about to be destroyed, so they are dropped now rather than read later
+    if (Type == EMCPSceneChangeType::Removed)
+    {
+        DirtyActors.Remove(Actor->GetFName());
+        RemoveActor(Actor->GetFName());
+        return;
+    }
+
+    DirtyActors.Add(Actor->GetFName(), Actor);
+}
+
+void FMCPSceneHashIndex::HandleJournalInvalidated()
+{
+    bNeedsRebuild = true;
+    DirtyActors.Reset();
+}
@@ -0,0 +1,321 @@
+#include "MCPSceneJournal.h"
+
+#include "Editor.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "Components/SceneComponent.h"
+#include "UObject/UObjectGlobals.h"
+#include "Misc/TransactionObjectEvent.h"
+#include "MCPFileLogger.h"
+
+FMCPSceneJournal& FMCPSceneJournal::Get()
+{
+    static FMCPSceneJournal Instance;
+    return Instance;
+}
+
+void FMCPSceneJournal::Initialize(int32 InCapacity)
+{
+    if (bInitialized)
+    {
+        return;
+    }
+
+    {
+        FScopeLock ScopeLock(&Lock);
+        Ring.SetNum(FMath::Max(InCapacity, 1));
+        Head = 0;
+        Count = 0;
+    }
+
+    if (GEngine)
+    {
+        ActorAddedHandle = GEngine->OnLevelActorAdded().AddRaw(this, &FMCPSceneJournal::HandleActorAdded);
+        ActorDeletedHandle = GEngine->OnLevelActorDeleted().AddRaw(this, &FMCPSceneJournal::HandleActorDeleted);
+        ActorMovedHandle = GEngine->OnActorMoved().AddRaw(this, &FMCPSceneJournal::HandleActorMoved);
+    }
+    PropertyChangedHandle = FCoreUObjectDelegates::OnObjectPropertyChanged.AddRaw(this, &FMCPSceneJournal::HandleObjectPropertyChanged);
+    MapOpenedHandle = FEditorDelegates::OnMapOpened.AddRaw(this, &FMCPSceneJournal::HandleMapOpened);
+    if (GEditor)
+    {
+        GEditor->RegisterForUndo(this);
+    }
+
+    bInitialized = true;
+    MCP_LOG_INFO("Scene journal initialized with capacity %d", Ring.Num());
+}
+
+void FMCPSceneJournal::Shutdown()
+{
+    if (!bInitialized)
+    {
+        return;
+    }
+
+    if (GEngine)
+    {
+        GEngine->OnLevelActorAdded().Remove(ActorAddedHandle);
+        GEngine->OnLevelActorDeleted().Remove(ActorDeletedHandle);
+        GEngine->OnActorMoved().Remove(ActorMovedHandle);
+    }
+    FCoreUObjectDelegates::OnObjectPropertyChanged.Remove(PropertyChangedHandle);
+    FEditorDelegates::OnMapOpened.Remove(MapOpenedHandle);
+    if (GEditor)
+    {
+        GEditor->UnregisterForUndo(this);
+    }
+    TransactionActors.Reset();
+
+    // Changes made while stopped are never recorded, so anything a client holds must be resynced
+    Invalidate();
+
+    FScopeLock ScopeLock(&Lock);
+    Ring.Empty();
+    bInitialized = false;
+    MCP_LOG_INFO("Scene journal shut down");
+}
+
+uint64 FMCPSceneJournal::GetCurrentVersion() const
+{
+    FScopeLock ScopeLock(&Lock);
+    return CurrentVersion;
+}
+
+uint64 FMCPSceneJournal::GetResyncFloor() const
+{
+    FScopeLock ScopeLock(&Lock);
+    return ResyncFloor;
+}
+
+bool FMCPSceneJournal::GetChangesSince(uint64 SinceVersion, int32 MaxChanges, TArray<FMCPSceneChange>& OutChanges, bool& bOutTruncated) const
+{
+    FScopeLock ScopeLock(&Lock);
+
+    OutChanges.Reset();
+    bOutTruncated = false;
+
+    // Either the ring wrapped past the client's version or the client is from a previous session
+    if (SinceVersion < ResyncFloor || SinceVersion > CurrentVersion)
+    {
+        return false;
+    }
+
+    // Entries are stored in version order, so the first wanted entry is at a fixed offset from the tail
+    const int32 Available = static_cast<int32>(CurrentVersion - SinceVersion);
+    const int32 NumToCopy = FMath::Min(Available, MaxChanges);
+    bOutTruncated = Available > NumToCopy;
+
+    const int32 Capacity = Ring.Num();
+    const int32 Tail = (Head - Count + Capacity) % Capacity;
+    const int32 FirstIndex = Count - Available;
+
+    OutChanges.Reserve(NumToCopy);
+    for (int32 Index = 0; Index < NumToCopy; ++Index)
+    {
+        OutChanges.Add(Ring[(Tail + FirstIndex + Index) % Capacity]);
+    }
+    return true;
+}
+
+void FMCPSceneJournal::RecordChange(EMCPSceneChangeType Type, const AActor* Actor, FName PropertyName)
+{
+    if (!bInitialized || !Actor)
+    {
+        return;
+    }
+
+    {
+        FScopeLock ScopeLock(&Lock);
+
+        const int32 Capacity = Ring.Num();
+        FMCPSceneChange& Entry = Ring[Head];
+
+        // Overwriting the oldest entry moves the floor clients can resume from
+        if (Count == Capacity)
+        {
+            ResyncFloor = Entry.Version;
+        }
+        else
+        {
+            ++Count;
+        }
+
+        Entry.Version = ++CurrentVersion;
+        Entry.Type = Type;
+        Entry.ActorName = Actor->GetFName();
+        Entry.ClassName = Actor->GetClass()->GetFName();
+        Entry.Label = Type == EMCPSceneChangeType::Removed ? FString() : Actor->GetActorLabel();
+        Entry.Transform = Actor->GetActorTransform();
+        Entry.PropertyName = PropertyName;
+
+        Head = (Head + 1) % Capacity;
+    }
+
+    // Listeners run outside the lock so they may query the journal
+    ChangeRecordedDelegate.Broadcast(Type, Actor);
+}
+
+void FMCPSceneJournal::Invalidate()
+{
+    {
+        FScopeLock ScopeLock(&Lock);
+
+        // Bump the version so a client that was fully up to date still sees that it must resync
+        ++CurrentVersion;
+        ResyncFloor = CurrentVersion;
+        Head = 0;
+        Count = 0;
+    }
+
+    InvalidatedDelegate.Broadcast();
+}
+
+FString FMCPSceneJournal::ChangeTypeToString(EMCPSceneChangeType Type)
+{
+    switch (Type)
+    {
+        case EMCPSceneChangeType::Added:     return TEXT("added");
+        case EMCPSceneChangeType::Removed:   return TEXT("removed");
+        case EMCPSceneChangeType::Transform: return TEXT("transform");
+        case EMCPSceneChangeType::Property:  return TEXT("property");
+        default:                             return TEXT("unknown");
+    }
+}
+
+bool FMCPSceneJournal::IsTrackedActor(const AActor* Actor)
+{
+    if (!Actor || Actor->HasAnyFlags(RF_Transient | RF_ClassDefaultObject))
+    {
+        return false;
+    }
+
+    const UWorld* World = Actor->GetWorld();
+    return World && World->WorldType == EWorldType::Editor;
+}
+
+void FMCPSceneJournal::HandleActorAdded(AActor* Actor)
+{
+    if (IsTrackedActor(Actor))
+    {
+        RecordChange(EMCPSceneChangeType::Added, Actor);
+    }
+}
+
+void FMCPSceneJournal::HandleActorDeleted(AActor* Actor)
+{
+    if (IsTrackedActor(Actor))
+    {
+        RecordChange(EMCPSceneChangeType::Removed, Actor);
+    }
+}
+
+void FMCPSceneJournal::HandleActorMoved(AActor* Actor)
+{
+    if (IsTrackedActor(Actor))
+    {
+        RecordChange(EMCPSceneChangeType::Transform, Actor);
+    }
+}
+
+void FMCPSceneJournal::HandleObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& PropertyChangedEvent)
+{
+    if (!Object)
+    {
+        return;
+    }
+
+    // Component edits are attributed to the owning actor
+    AActor* Actor = Cast<AActor>(Object);
+    if (!Actor)
+    {
+        if (const UActorComponent* Component = Cast<UActorComponent>(Object))
+        {
+            Actor = Component->GetOwner();
+        }
+    }
+
+    if (!IsTrackedActor(Actor))
+    {
+        return;
+    }
+
+    const FName PropertyName = PropertyChangedEvent.GetMemberPropertyName();
+    const bool bIsTransformProperty =
+        PropertyName == USceneComponent::GetRelativeLocationPropertyName() ||
+        PropertyName == USceneComponent::GetRelativeRotationPropertyName() ||
+        PropertyName == USceneComponent::GetRelativeScale3DPropertyName();
+
+    RecordChange(bIsTransformProperty ? EMCPSceneChangeType::Transform : EMCPSceneChangeType::Property, Actor, PropertyName);
+}
+
+void FMCPSceneJournal::HandleMapOpened(const FString& Filename, bool bAsTemplate)
+{
+    MCP_LOG_INFO("Map opened (%s), invalidating scene journal", *Filename);
+    Invalidate();
+}
+
+bool FMCPSceneJournal::MatchesContext(const FTransactionContext& InContext, const TArray<TPair<UObject*, FTransactionObjectEvent>>& TransactionObjectContexts) const
+{
+    // Called just before PostUndo and PostRedo with the objects of the transaction, which those do not get
+    TransactionActors.Reset();
+    for (const TPair<UObject*, FTransactionObjectEvent>& ObjectContext : TransactionObjectContexts)
+    {
+        UObject* Object = ObjectContext.Key;
+        if (!Object)
+        {
+            continue;
+        }
+
+        // Component and other subobject edits are attributed to the owning actor
+        AActor* Actor = Cast<AActor>(Object);
+        if (!Actor)
+        {
+            Actor = Object->GetTypedOuter<AActor>();
+        }
+        if (!Actor)
+        {
+            continue;
+        }
+
+        // Only the actor's own garbage flag tells whether it was deleted or brought back
+        bool& bLifetimeChanged = TransactionActors.FindOrAdd(Actor, false);
+        bLifetimeChanged |= Actor == Object && ObjectContext.Value.HasPendingKillChange();
+    }
+    return true;
+}
+
+void FMCPSceneJournal::PostUndo(bool bSuccess)
+{
+    RecordTransactionActors();
+}
+
+void FMCPSceneJournal::PostRedo(bool bSuccess)
+{
+    RecordTransactionActors();
+}
+
+void FMCPSceneJournal::RecordTransactionActors()
+{
+    TMap<TWeakObjectPtr<AActor>, bool> Actors = MoveTemp(TransactionActors);
+    TransactionActors.Reset();
+
+    for (const TPair<TWeakObjectPtr<AActor>, bool>& Entry : Actors)
+    {
+        // Deleted actors are garbage but still in memory, so the weak pointer is read even when stale
+        AActor* Actor = Entry.Key.Get(true);
+        if (!IsTrackedActor(Actor))
+        {
+            continue;
+        }
+
+        if (Entry.Value)
+        {
+            RecordChange(IsValid(Actor) ? EMCPSceneChangeType::Added : EMCPSceneChangeType::Removed, Actor);
+        }
+        else if (IsValid(Actor))
+        {
+            RecordChange(EMCPSceneChangeType::Property, Actor);
+        }
+    }
+}
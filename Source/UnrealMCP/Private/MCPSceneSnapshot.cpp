@@ -0,0 +1,209 @@
+#include "MCPSceneSnapshot.h"
+
+#include "EngineUtils.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "Async/ParallelFor.h"
+#include "MCPConstants.h"
+
+bool FMCPActorFilter::Parse(const TSharedPtr<FJsonObject>& Object, FString& OutError)
+{
+    if (!Object.IsValid())
+    {
+        return true;
+    }
+
+    const TArray<TSharedPtr<FJsonValue>>* ClassesPtr = nullptr;
+    FString SingleClass;
+    if (Object->TryGetArrayField(FStringView(TEXT("classes")), ClassesPtr) && ClassesPtr)
+    {
+        for (const TSharedPtr<FJsonValue>& Value : *ClassesPtr)
+        {
+            ClassNames.AddUnique(FName(*Value->AsString()));
+        }
+    }
+    else if (Object->TryGetStringField(FStringView(TEXT("classes")), SingleClass))
+    {
+        ClassNames.Add(FName(*SingleClass));
+    }
+
+    Object->TryGetStringField(FStringView(TEXT("name")), NamePattern);
+    Object->TryGetStringField(FStringView(TEXT("label")), LabelPattern);
+    Object->TryGetStringField(FStringView(TEXT("folder")), FolderPath);
+    FolderPath.RemoveFromEnd(TEXT("/"));
+
+    const TSharedPtr<FJsonObject>* RegionObject = nullptr;
+    if (Object->TryGetObjectField(FStringView(TEXT("region")), RegionObject) && RegionObject)
+    {
+        const TArray<TSharedPtr<FJsonValue>>* MinPtr = nullptr;
+        const TArray<TSharedPtr<FJsonValue>>* MaxPtr = nullptr;
+        if (!(*RegionObject)->TryGetArrayField(FStringView(TEXT("min")), MinPtr) || !MinPtr || MinPtr->Num() != 3 ||
+            !(*RegionObject)->TryGetArrayField(FStringView(TEXT("max")), MaxPtr) || !MaxPtr || MaxPtr->Num() != 3)
+        {
+            OutError = TEXT("Filter 'region' needs 'min' and 'max' as [x, y, z]");
+            return false;
+        }
+        const FVector Min((*MinPtr)[0]->AsNumber(), (*MinPtr)[1]->AsNumber(), (*MinPtr)[2]->AsNumber());
+        const FVector Max((*MaxPtr)[0]->AsNumber(), (*MaxPtr)[1]->AsNumber(), (*MaxPtr)[2]->AsNumber());
+        Region = FBox(Min.ComponentMin(Max), Min.ComponentMax(Max));
+    }
+
+    return true;
+}
+
+bool FMCPActorFilter::IsEmpty() const
+{
+    return ClassNames.Num() == 0 && NamePattern.IsEmpty() && LabelPattern.IsEmpty() && FolderPath.IsEmpty() && !Region.IsValid;
+}
+
+bool FMCPActorFilter::Matches(const AActor* Actor) const
+{
+    if (!Actor)
+    {
+        return false;
+    }
+
+    // Cheapest predicates first; labels and folders are only read when needed
+    if (Region.IsValid && !Region.IsInsideOrOn(Actor->GetActorLocation()))
+    {
+        return false;
+    }
+
+    if (!MatchesClass(Actor->GetClass()))
+    {
+        return false;
+    }
+
+    if (!NamePattern.IsEmpty() && !Actor->GetName().MatchesWildcard(NamePattern))
+    {
+        return false;
+    }
+
+    if (!LabelPattern.IsEmpty() && !Actor->GetActorLabel().MatchesWildcard(LabelPattern))
+    {
+        return false;
+    }
+
+    if (!FolderPath.IsEmpty() && !MatchesFolder(Actor->GetFolderPath().ToString()))
+    {
+        return false;
+    }
+
+    return true;
+}
+
+bool FMCPActorFilter::MatchesFields(const UClass* Class, const FTopLevelAssetPath& BaseClass, FName Name, const FString& Label, const FString& Folder, const FVector& Location) const
+{
+    if (Region.IsValid && !Region.IsInsideOrOn(Location))
+    {
+        return false;
+    }
+
+    // Blueprint classes are not loaded with the descriptor, so only the class itself can be compared
+    const bool bBaseClassMatches = BaseClass.IsValid() &&
+        (ClassNames.Contains(BaseClass.GetAssetName()) || ClassNames.Contains(FName(*BaseClass.ToString())));
+    if (!bBaseClassMatches && !MatchesClass(Class))
+    {
+        return false;
+    }
+    if (!NamePattern.IsEmpty() && !Name.ToString().MatchesWildcard(NamePattern))
+    {
+        return false;
+    }
+    if (!LabelPattern.IsEmpty() && !Label.MatchesWildcard(LabelPattern))
+    {
+        return false;
+    }
+    if (!FolderPath.IsEmpty() && !MatchesFolder(Folder))
+    {
+        return false;
+    }
+    return true;
+}
+
+bool FMCPActorFilter::MatchesClass(const UClass* Class) const
+{
+    if (ClassNames.Num() == 0)
+    {
+        return true;
+    }
+    for (; Class; Class = Class->GetSuperClass())
+    {
+        if (ClassNames.Contains(Class->GetFName()))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool FMCPActorFilter::MatchesFolder(const FString& Folder) const
+{
+    return Folder == FolderPath || Folder.StartsWith(FolderPath + TEXT("/"));
+}
+
+int32 FMCPSceneSnapshot::Capture(UWorld* World, const FMCPSnapshotOptions& Options, TArray<FMCPActorRecord>& OutRecords)
+{
+    check(IsInGameThread());
+
+    OutRecords.Reset();
+    if (!World)
+    {
+        return 0;
+    }
+
+    int32 TotalCount = 0;
+    for (TActorIterator<AActor> It(World); It; ++It)
+    {
+        if (Options.Filter && !Options.Filter->Matches(*It))
+        {
+            continue;
+        }
+
+        TotalCount++;
+        if (OutRecords.Num() < Options.MaxRecords)
+        {
+            CaptureActor(*It, Options, OutRecords.AddDefaulted_GetRef());
+        }
+    }
+    return TotalCount;
+}
+
+void FMCPSceneSnapshot::CaptureActor(const AActor* Actor, const FMCPSnapshotOptions& Options, FMCPActorRecord& OutRecord)
+{
+    OutRecord.Name = Actor->GetFName();
+    OutRecord.Class = Actor->GetClass();
+    OutRecord.Transform = Actor->GetActorTransform();
+
+    if (Options.bIncludeLabels)
+    {
+        OutRecord.Label = Actor->GetActorLabel();
+    }
+
+    if (Options.bIncludeBounds)
+    {
+        OutRecord.Bounds = Actor->GetComponentsBoundingBox(true);
+    }
+    if (!OutRecord.Bounds.IsValid)
+    {
+        OutRecord.Bounds = FBox(OutRecord.Transform.GetLocation(), OutRecord.Transform.GetLocation());
+    }
+}
+
+void FMCPSceneSnapshot::ParallelForChunks(int32 Num, TFunctionRef<void(int32 Start, int32 End)> Func)
+{
+    if (Num <= 0)
+    {
+        return;
+    }
+
+    const int32 ChunkSize = MCPConstants::SCENE_ENCODE_CHUNK_SIZE;
+    const int32 NumChunks = FMath::DivideAndRoundUp(Num, ChunkSize);
+
+    // Small scenes are cheaper to encode inline than to dispatch
+    ParallelFor(NumChunks, [&Func, Num, ChunkSize](int32 ChunkIndex)
+    {
+        const int32 Start = ChunkIndex * ChunkSize;
+        Func(Start, FMath::Min(Start + ChunkSize, Num));
+    }, NumChunks == 1 ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+}
@@ -0,0 +1,272 @@
+#include "MCPSceneStats.h"
+
+#include "EngineUtils.h"
+#include "Engine/World.h"
+#include "Engine/Level.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/SkinnedAsset.h"
+#include "GameFramework/Actor.h"
+#include "Components/StaticMeshComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Components/SkinnedMeshComponent.h"
+#include "Components/DirectionalLightComponent.h"
+#include "Components/SpotLightComponent.h"
+#include "Components/PointLightComponent.h"
+#include "Components/RectLightComponent.h"
+#include "Components/SkyLightComponent.h"
+#include "Materials/MaterialInterface.h"
+#include "Rendering/SkeletalMeshRenderData.h"
+#include "StaticMeshResources.h"
+#include "Async/ParallelFor.h"
+#include "MCPConstants.h"
+#include "MCPSceneSnapshot.h"
+
+namespace
+{
+    EMCPLightKind GetLightKind(const UActorComponent* Component)
+    {
+        // Spot lights derive from point lights, so they are tested first
+        if (Component->IsA<USpotLightComponent>())
+        {
+            return EMCPLightKind::Spot;
+        }
+        if (Component->IsA<UPointLightComponent>())
+        {
+            return EMCPLightKind::Point;
+        }
+        if (Component->IsA<URectLightComponent>())
+        {
+            return EMCPLightKind::Rect;
+        }
+        if (Component->IsA<UDirectionalLightComponent>())
+        {
+            return EMCPLightKind::Directional;
+        }
+        if (Component->IsA<USkyLightComponent>())
+        {
+            return EMCPLightKind::Sky;
+        }
+        return EMCPLightKind::None;
+    }
+}
+
+void FMCPSceneStats::Merge(const FMCPSceneStats& Other)
+{
+    ActorCount += Other.ActorCount;
+    for (const TPair<const UClass*, int32>& ClassCount : Other.ClassCounts)
+    {
+        ClassCounts.FindOrAdd(ClassCount.Key) += ClassCount.Value;
+    }
+
+    MeshComponentCount += Other.MeshComponentCount;
+    InstanceCount += Other.InstanceCount;
+    TriangleCount += Other.TriangleCount;
+    Meshes.Append(Other.Meshes);
+    Materials.Append(Other.Materials);
+
+    for (int32 Kind = 0; Kind < static_cast<int32>(EMCPLightKind::Count); ++Kind)
+    {
+        for (int32 Mobility = 0; Mobility < 3; ++Mobility)
+        {
+            LightCounts[Kind][Mobility] += Other.LightCounts[Kind][Mobility];
+        }
+    }
+
+    if (LevelActorCounts.Num() < Other.LevelActorCounts.Num())
+    {
+        LevelActorCounts.SetNumZeroed(Other.LevelActorCounts.Num());
+        while (LevelBounds.Num() < LevelActorCounts.Num())
+        {
+            LevelBounds.Add(FBox(ForceInit));
+        }
+    }
+    for (int32 Level = 0; Level < Other.LevelActorCounts.Num(); ++Level)
+    {
+        LevelActorCounts[Level] += Other.LevelActorCounts[Level];
+        LevelBounds[Level] += Other.LevelBounds[Level];
+    }
+}
+
+void FMCPSceneStatsCollector::Capture(UWorld* World, const FMCPActorFilter* Filter, FMCPSceneStatsCapture& OutCapture)
+{
+    check(IsInGameThread());
+
+    OutCapture = FMCPSceneStatsCapture();
+    if (!World)
+    {
+        return;
+    }
+
+    // Triangle counts come from render data, so each mesh is looked up once
+    TMap<const UObject*, int32> MeshTriangles;
+    auto GetMeshTriangles = [&MeshTriangles](const UObject* Mesh) -> int32
+    {
+        if (const int32* Cached = MeshTriangles.Find(Mesh))
+        {
+            return *Cached;
+        }
+
+        int32 Triangles = 0;
+        if (const UStaticMesh* StaticMesh = Cast<UStaticMesh>(Mesh))
+        {
+            const FStaticMeshRenderData* RenderData = StaticMesh->GetRenderData();
+            if (RenderData && RenderData->LODResources.Num() > 0)
+            {
+                Triangles = RenderData->LODResources[0].GetNumTriangles();
+            }
+        }
+        else if (const USkinnedAsset* SkinnedAsset = Cast<USkinnedAsset>(Mesh))
+        {
+            const FSkeletalMeshRenderData* RenderData = const_cast<USkinnedAsset*>(SkinnedAsset)->GetResourceForRendering();
+            if (RenderData && RenderData->LODRenderData.Num() > 0)
+            {
+                Triangles = RenderData->LODRenderData[0].GetTotalFaces();
+            }
+        }
+        MeshTriangles.Add(Mesh, Triangles);
+        return Triangles;
+    };
+
+    TMap<const ULevel*, int32> LevelIndices;
+    TInlineComponentArray<UActorComponent*> Components;
+
+    for (TActorIterator<AActor> It(World); It; ++It)
+    {
+        const AActor* Actor = *It;
+        if (Filter && !Filter->Matches(Actor))
+        {
+            continue;
+        }
+
+        FMCPStatsActor& ActorRecord = OutCapture.Actors.AddDefaulted_GetRef();
+        ActorRecord.Class = Actor->GetClass();
+        ActorRecord.FirstComponent = OutCapture.Components.Num();
+
+        const ULevel* Level = Actor->GetLevel();
+        if (Level)
+        {
+            int32* LevelIndex = LevelIndices.Find(Level);
+            if (!LevelIndex)
+            {
+                LevelIndex = &LevelIndices.Add(Level, OutCapture.Levels.Num());
+                OutCapture.Levels.Add(Level->GetOuter()->GetFName());
+            }
+            ActorRecord.Level = *LevelIndex;
+        }
+
+        Components.Reset();
+        Actor->GetComponents(Components);
+        for (const UActorComponent* Component : Components)
+        {
+            const UPrimitiveComponent* Primitive = Cast<UPrimitiveComponent>(Component);
+            const EMCPLightKind LightKind = GetLightKind(Component);
+            if (!Primitive && LightKind == EMCPLightKind::None)
+            {
+                continue;
+            }
+
+            FMCPStatsComponent& ComponentRecord = OutCapture.Components.AddDefaulted_GetRef();
+            ComponentRecord.LightKind = LightKind;
+            ComponentRecord.Mobility = static_cast<uint8>(CastChecked<USceneComponent>(Component)->Mobility.GetValue());
+
+            if (!Primitive)
+            {
+                continue;
+            }
+
+            if (Primitive->IsRegistered())
+            {
+                ActorRecord.Bounds += Primitive->Bounds.GetBox();
+            }
+
+            if (const UStaticMeshComponent* MeshComponent = Cast<UStaticMeshComponent>(Primitive))
+            {
+                ComponentRecord.Mesh = MeshComponent->GetStaticMesh();
+                const UInstancedStaticMeshComponent* Instanced = Cast<UInstancedStaticMeshComponent>(MeshComponent);
+                ComponentRecord.Instances = Instanced ? Instanced->GetInstanceCount() : 1;
+            }
+            else if (const USkinnedMeshComponent* SkinnedComponent = Cast<USkinnedMeshComponent>(Primitive))
+            {
+                ComponentRecord.Mesh = SkinnedComponent->GetSkinnedAsset();
+                ComponentRecord.Instances = 1;
+            }
+            if (ComponentRecord.Mesh)
+            {
+                ComponentRecord.Triangles = static_cast<int64>(GetMeshTriangles(ComponentRecord.Mesh)) * ComponentRecord.Instances;
+            }
+
+            ComponentRecord.FirstMaterial = OutCapture.Materials.Num();
+            const int32 NumMaterials = Primitive->GetNumMaterials();
+            for (int32 MaterialIndex = 0; MaterialIndex < NumMaterials; ++MaterialIndex)
+            {
+                if (const UMaterialInterface* Material = Primitive->GetMaterial(MaterialIndex))
+                {
+                    OutCapture.Materials.Add(Material);
+                }
+            }
+            ComponentRecord.MaterialCount = OutCapture.Materials.Num() - ComponentRecord.FirstMaterial;
+        }
+
+        ActorRecord.ComponentCount = OutCapture.Components.Num() - ActorRecord.FirstComponent;
+        if (!ActorRecord.Bounds.IsValid)
+        {
+            const FVector Location = Actor->GetActorLocation();
+            ActorRecord.Bounds = FBox(Location, Location);
+        }
+    }
+}
+
+void FMCPSceneStatsCollector::Reduce(const FMCPSceneStatsCapture& Capture, FMCPSceneStats& OutStats)
+{
+    OutStats = FMCPSceneStats();
+    OutStats.LevelActorCounts.SetNumZeroed(Capture.Levels.Num());
+    OutStats.LevelBounds.Init(FBox(ForceInit), Capture.Levels.Num());
+
+    const int32 NumActors = Capture.Actors.Num();
+    const int32 NumLevels = Capture.Levels.Num();
+
+    // Each task accumulates into its own context; contexts are merged once at the end, so the loop takes no locks
+    TArray<FMCPSceneStats> Contexts;
+    ParallelForWithTaskContext(Contexts, NumActors, [&Capture, NumLevels](FMCPSceneStats& Stats, int32 ActorIndex)
+    {
+        if (Stats.LevelActorCounts.Num() != NumLevels)
+        {
+            Stats.LevelActorCounts.SetNumZeroed(NumLevels);
+            Stats.LevelBounds.Init(FBox(ForceInit), NumLevels);
+        }
+
+        const FMCPStatsActor& Actor = Capture.Actors[ActorIndex];
+        Stats.ActorCount++;
+        Stats.ClassCounts.FindOrAdd(Actor.Class)++;
+        if (Actor.Level != INDEX_NONE)
+        {
+            Stats.LevelActorCounts[Actor.Level]++;
+            Stats.LevelBounds[Actor.Level] += Actor.Bounds;
+        }
+
+        for (int32 ComponentIndex = Actor.FirstComponent; ComponentIndex < Actor.FirstComponent + Actor.ComponentCount; ++ComponentIndex)
+        {
+            const FMCPStatsComponent& Component = Capture.Components[ComponentIndex];
+            if (Component.LightKind != EMCPLightKind::None)
+            {
+                Stats.LightCounts[static_cast<int32>(Component.LightKind)][FMath::Min<int32>(Component.Mobility, 2)]++;
+            }
+            if (Component.Mesh)
+            {
+                Stats.MeshComponentCount++;
+                Stats.InstanceCount += Component.Instances;
+                Stats.TriangleCount += Component.Triangles;
+                Stats.Meshes.Add(Component.Mesh);
+            }
+            for (int32 MaterialIndex = Component.FirstMaterial; MaterialIndex < Component.FirstMaterial + Component.MaterialCount; ++MaterialIndex)
+            {
+                Stats.Materials.Add(Capture.Materials[MaterialIndex]);
+            }
+        }
+    }, NumActors < MCPConstants::SCENE_ENCODE_CHUNK_SIZE ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+
+    for (const FMCPSceneStats& Context : Contexts)
+    {
+        OutStats.Merge(Context);
+    }
+}
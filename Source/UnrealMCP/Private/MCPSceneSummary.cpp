@@ -0,0 +1,263 @@
+#include "MCPSceneSummary.h"
+
+#include "Async/ParallelFor.h"
+
+namespace
+{
+    TArray<TSharedPtr<FJsonValue>> MakeRoundedArray(const FVector& Vector)
+    {
+        TArray<TSharedPtr<FJsonValue>> Array;
+        Array.Add(MakeShared<FJsonValueNumber>(FMath::RoundToDouble(Vector.X)));
+        Array.Add(MakeShared<FJsonValueNumber>(FMath::RoundToDouble(Vector.Y)));
+        Array.Add(MakeShared<FJsonValueNumber>(FMath::RoundToDouble(Vector.Z)));
+        return Array;
+    }
+
+    /** @return UTF-8 size of an object serialized the way responses are */
+    int32 MeasureJson(const TSharedPtr<FJsonObject>& Object)
+    {
+        FString Serialized;
+        TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Serialized);
+        FJsonSerializer::Serialize(Object.ToSharedRef(), Writer);
+        return FTCHARToUTF8(*Serialized).Length();
+    }
+
+    bool IsExpandable(const FMCPSummaryCluster& Cluster, const FMCPSummaryOptions& Options)
+    {
+        // Clusters small enough to be fully listed by their representatives have nothing left to show
+        return Cluster.Members.Num() > Options.MaxRepresentatives &&
+            Cluster.LocationBounds.GetSize().GetMax() > MCPConstants::MIN_SUMMARY_CLUSTER_EXTENT;
+    }
+}
+
+bool FMCPSceneSummary::Build(const TArray<FMCPActorRecord>& Records, const FMCPSummaryOptions& Options, TArray<FMCPSummaryCluster>& OutClusters, FString& OutError)
+{
+    OutClusters.Reset();
+
+    TArray<FString> Path;
+    Options.ClusterId.ParseIntoArray(Path, TEXT("."));
+    if (Path.Num() == 0 || Path[0] != TEXT("r"))
+    {
+        OutError = FString::Printf(TEXT("Invalid cluster id '%s'; ids start with 'r'"), *Options.ClusterId);
+        return false;
+    }
+
+    FMCPSummaryCluster Top;
+    Top.Id = TEXT("r");
+    Top.Members.SetNumUninitialized(Records.Num());
+    for (int32 Index = 0; Index < Records.Num(); ++Index)
+    {
+        Top.Members[Index] = Index;
+    }
+    ComputeStats(Top, Records, Options);
+
+    // Drilling down replays the splits along the id, so a cluster is found again without any server-side state
+    TArray<FMCPSummaryCluster> Children;
+    for (int32 Step = 1; Step < Path.Num(); ++Step)
+    {
+        const FString ChildId = Top.Id + TEXT(".") + Path[Step];
+        Split(Top, Records, Children);
+        FMCPSummaryCluster* Child = Children.FindByPredicate([&ChildId](const FMCPSummaryCluster& Candidate) { return Candidate.Id == ChildId; });
+        if (!Child)
+        {
+            OutError = FString::Printf(TEXT("Cluster '%s' does not exist; the scene or filter may have changed since it was listed"), *ChildId);
+            return false;
+        }
+        Top = MoveTemp(*Child);
+        ComputeStats(Top, Records, Options);
+    }
+
+    Top.bExpandable = IsExpandable(Top, Options);
+    int32 TotalBytes = MeasureJson(ToJson(Top, Records));
+    OutClusters.Add(MoveTemp(Top));
+
+    // Always split the cluster with the most actors next; it is the one a reader knows least about per byte
+    auto ByCount = [&OutClusters](int32 A, int32 B) { return OutClusters[A].Members.Num() > OutClusters[B].Members.Num(); };
+    TArray<int32> Candidates;
+    if (OutClusters[0].bExpandable)
+    {
+        Candidates.HeapPush(0, ByCount);
+    }
+
+    TArray<int32> ChildBytes;
+    while (Candidates.Num() > 0)
+    {
+        int32 ParentIndex = INDEX_NONE;
+        Candidates.HeapPop(ParentIndex, ByCount, EAllowShrinking::No);
+
+        Split(OutClusters[ParentIndex], Records, Children);
+        ChildBytes.SetNumZeroed(Children.Num());
+        ParallelFor(Children.Num(), [&Children, &ChildBytes, &Records, &Options](int32 ChildIndex)
+        {
+            FMCPSummaryCluster& Child = Children[ChildIndex];
+            ComputeStats(Child, Records, Options);
+            Child.bExpandable = IsExpandable(Child, Options);
+            ChildBytes[ChildIndex] = MeasureJson(ToJson(Child, Records));
+        });
+
+        int32 SplitBytes = 0;
+        for (const int32 Bytes : ChildBytes)
+        {
+            SplitBytes += Bytes;
+        }
+        if (TotalBytes + SplitBytes > Options.MaxBytes)
+        {
+            break;
+        }
+
+        TotalBytes += SplitBytes;
+        OutClusters[ParentIndex].bExpanded = true;
+        for (FMCPSummaryCluster& Child : Children)
+        {
+            const bool bExpandable = Child.bExpandable;
+            const int32 ChildIndex = OutClusters.Add(MoveTemp(Child));
+            if (bExpandable)
+            {
+                Candidates.HeapPush(ChildIndex, ByCount);
+            }
+        }
+    }
+
+    return true;
+}
+
+TSharedPtr<FJsonObject> FMCPSceneSummary::ToJson(const FMCPSummaryCluster& Cluster, const TArray<FMCPActorRecord>& Records)
+{
+    TSharedPtr<FJsonObject> Info = MakeShared<FJsonObject>();
+    Info->SetStringField("id", Cluster.Id);
+    if (!Cluster.ParentId.IsEmpty())
+    {
+        Info->SetStringField("parent", Cluster.ParentId);
+    }
+    Info->SetNumberField("count", Cluster.Members.Num());
+    if (Cluster.Bounds.IsValid)
+    {
+        Info->SetArrayField("min", MakeRoundedArray(Cluster.Bounds.Min));
+        Info->SetArrayField("max", MakeRoundedArray(Cluster.Bounds.Max));
+    }
+    Info->SetArrayField("center", MakeRoundedArray(Cluster.Centroid));
+
+    TArray<TSharedPtr<FJsonValue>> ClassesArray;
+    for (const TPair<const UClass*, int32>& ClassCount : Cluster.TopClasses)
+    {
+        TSharedPtr<FJsonObject> ClassInfo = MakeShared<FJsonObject>();
+        ClassInfo->SetStringField("class", ClassCount.Key ? ClassCount.Key->GetName() : FString());
+        ClassInfo->SetNumberField("count", ClassCount.Value);
+        ClassesArray.Add(MakeShared<FJsonValueObject>(ClassInfo));
+    }
+    Info->SetArrayField("classes", ClassesArray);
+
+    TArray<TSharedPtr<FJsonValue>> RepresentativesArray;
+    for (const int32 RecordIndex : Cluster.Representatives)
+    {
+        const FMCPActorRecord& Record = Records[RecordIndex];
+        TSharedPtr<FJsonObject> ActorInfo = MakeShared<FJsonObject>();
+        ActorInfo->SetStringField("name", Record.Name.ToString());
+        if (!Record.Label.IsEmpty() && Record.Label != Record.Name.ToString())
+        {
+            ActorInfo->SetStringField("label", Record.Label);
+        }
+        ActorInfo->SetStringField("class", Record.Class ? Record.Class->GetName() : FString());
+        RepresentativesArray.Add(MakeShared<FJsonValueObject>(ActorInfo));
+    }
+    Info->SetArrayField("representatives", RepresentativesArray);
+
+    Info->SetBoolField("expandable", Cluster.bExpandable);
+    return Info;
+}
+
+void FMCPSceneSummary::ComputeStats(FMCPSummaryCluster& Cluster, const TArray<FMCPActorRecord>& Records, const FMCPSummaryOptions& Options)
+{
+    Cluster.Bounds = FBox(ForceInit);
+    Cluster.LocationBounds = FBox(ForceInit);
+    Cluster.Centroid = FVector::ZeroVector;
+    Cluster.Representatives.Reset();
+
+    TMap<const UClass*, int32> ClassCounts;
+    TArray<double> RepresentativeSizes;
+    for (const int32 RecordIndex : Cluster.Members)
+    {
+        const FMCPActorRecord& Record = Records[RecordIndex];
+        const FVector Location = Record.Transform.GetLocation();
+        if (Record.Bounds.IsValid)
+        {
+            Cluster.Bounds += Record.Bounds;
+        }
+        Cluster.LocationBounds += Location;
+        Cluster.Centroid += Location;
+        ClassCounts.FindOrAdd(Record.Class)++;
+
+        // Keep the largest members by bounds diagonal, in a short sorted list
+        const double Size = Record.Bounds.IsValid ? Record.Bounds.GetSize().SizeSquared() : 0.0;
+        int32 Position = RepresentativeSizes.Num();
+        while (Position > 0 && RepresentativeSizes[Position - 1] < Size)
+        {
+            Position--;
+        }
+        if (Position < Options.MaxRepresentatives)
+        {
+            RepresentativeSizes.Insert(Size, Position);
+            Cluster.Representatives.Insert(RecordIndex, Position);
+            if (RepresentativeSizes.Num() > Options.MaxRepresentatives)
+            {
+                RepresentativeSizes.Pop(EAllowShrinking::No);
+                Cluster.Representatives.Pop(EAllowShrinking::No);
+            }
+        }
+    }
+    if (Cluster.Members.Num() > 0)
+    {
+        Cluster.Centroid /= Cluster.Members.Num();
+    }
+
+    Cluster.TopClasses = ClassCounts.Array();
+    Cluster.TopClasses.Sort([](const TPair<const UClass*, int32>& A, const TPair<const UClass*, int32>& B)
+    {
+        if (A.Value != B.Value)
+        {
+            return A.Value > B.Value;
+        }
+        const FString NameA = A.Key ? A.Key->GetName() : FString();
+        const FString NameB = B.Key ? B.Key->GetName() : FString();
+        return NameA < NameB;
+    });
+    if (Cluster.TopClasses.Num() > Options.MaxClasses)
+    {
+        Cluster.TopClasses.SetNum(Options.MaxClasses);
+    }
+}
+
+void FMCPSceneSummary::Split(const FMCPSummaryCluster& Parent, const TArray<FMCPActorRecord>& Records, TArray<FMCPSummaryCluster>& OutChildren)
+{
+    OutChildren.Reset();
+
+    const FVector Center = Parent.LocationBounds.GetCenter();
+    TArray<uint8> Octants;
+    Octants.SetNumUninitialized(Parent.Members.Num());
+    FMCPSceneSnapshot::ParallelForChunks(Parent.Members.Num(), [&Parent, &Records, &Center, &Octants](int32 Start, int32 End)
+    {
+        for (int32 Index = Start; Index < End; ++Index)
+        {
+            const FVector Location = Records[Parent.Members[Index]].Transform.GetLocation();
+            Octants[Index] = (Location.X >= Center.X ? 1 : 0) | (Location.Y >= Center.Y ? 2 : 0) | (Location.Z >= Center.Z ? 4 : 0);
+        }
+    });
+
+    // Bucketing is sequential so members keep their record order
+    TArray<int32> Buckets[8];
+    for (int32 Index = 0; Index < Parent.Members.Num(); ++Index)
+    {
+        Buckets[Octants[Index]].Add(Parent.Members[Index]);
+    }
+
+    for (int32 Octant = 0; Octant < 8; ++Octant)
+    {
+        if (Buckets[Octant].Num() > 0)
+        {
+            FMCPSummaryCluster& Child = OutChildren.AddDefaulted_GetRef();
+            Child.Id = FString::Printf(TEXT("%s.%d"), *Parent.Id, Octant);
+            Child.ParentId = Parent.Id;
+            Child.Members = MoveTemp(Buckets[Octant]);
+        }
+    }
+}
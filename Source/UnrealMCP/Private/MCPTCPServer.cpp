@@ -18,6 +18,18 @@
 #include "MCPCommandHandlers.h"
 #include "MCPCommandHandlers_Blueprints.h"
 #include "MCPCommandHandlers_Materials.h"
+#include "MCPCommandHandlers_Scene.h"
+#include "MCPCommandHandlers_Properties.h"
+#include "MCPCommandHandlers_Queries.h"
+#include "MCPCommandHandlers_WorldPartition.h"
+#include "MCPCommandHandlers_Vectors.h"
+#include "MCPSceneJournal.h"
+#include "MCPSceneHashes.h"
+#include "MCPAssetCatalog.h"
+#include "MCPAssetSearch.h"
+#include "MCPAssetDependencies.h"
+#include "MCPVectorIndex.h"
+#include "MCPResponseBudget.h"
 #include "HAL/PlatformFilemanager.h"
 #include "Misc/FileHelper.h"
 #include "Misc/Paths.h"
@@ -36,8 +48,44 @@ FMCPTCPServer::FMCPTCPServer(const FMCPTCPServerConfig& InConfig)
     RegisterCommandHandler(MakeShared<FMCPModifyObjectHandler>());
     RegisterCommandHandler(MakeShared<FMCPDeleteObjectHandler>());
 
+    // Scene command handlers
+    RegisterCommandHandler(MakeShared<FMCPGetSceneChangesHandler>());
+    RegisterCommandHandler(MakeShared<FMCPModifyObjectsHandler>());
+    RegisterCommandHandler(MakeShared<FMCPCreateObjectsHandler>());
+    RegisterCommandHandler(MakeShared<FMCPScatterHandler>());
+    RegisterCommandHandler(MakeShared<FMCPDeleteObjectsHandler>());
+    RegisterCommandHandler(MakeShared<FMCPGetSceneHashesHandler>());
+    RegisterCommandHandler(MakeShared<FMCPExportSceneSnapshotHandler>());
+    RegisterCommandHandler(MakeShared<FMCPSummarizeSceneHandler>());
+    RegisterCommandHandler(MakeShared<FMCPCheckpointSceneHandler>());
+    RegisterCommandHandler(MakeShared<FMCPRestoreSceneHandler>());
+    RegisterCommandHandler(MakeShared<FMCPDiffSceneHandler>());
+
+    // Property command handlers
+    RegisterCommandHandler(MakeShared<FMCPGetPropertiesHandler>());
+    RegisterCommandHandler(MakeShared<FMCPSetPropertiesHandler>());
+
+    // Query command handlers
+    RegisterCommandHandler(MakeShared<FMCPTraceBatchHandler>());
+    RegisterCommandHandler(MakeShared<FMCPGetSceneStatsHandler>());
+    RegisterCommandHandler(MakeShared<FMCPQueryFrustumHandler>());
+    RegisterCommandHandler(MakeShared<FMCPBuildOccupancyGridHandler>());
+
+    // World Partition command handlers
+    RegisterCommandHandler(MakeShared<FMCPQueryActorDescsHandler>());
+    RegisterCommandHandler(MakeShared<FMCPLoadRegionHandler>());
+    RegisterCommandHandler(MakeShared<FMCPUnloadRegionHandler>());
+
+    // Vector index command handlers
+    RegisterCommandHandler(MakeShared<FMCPUpsertEmbeddingsHandler>());
+    RegisterCommandHandler(MakeShared<FMCPQueryEmbeddingsHandler>());
+    RegisterCommandHandler(MakeShared<FMCPVectorIndexHandler>());
+
     // ADDED 
     RegisterCommandHandler(MakeShared<FMCPGetAsasetInfoHandler>());
+    RegisterCommandHandler(MakeShared<FMCPSearchAssetsHandler>());
+    RegisterCommandHandler(MakeShared<FMCPGetAssetDependenciesHandler>());
+    RegisterCommandHandler(MakeShared<FMCPGetAssetReferencersHandler>());
     RegisterCommandHandler(MakeShared<FMCPImportAssetHandler>());
     
     RegisterCommandHandler(MakeShared<FMCPExecutePythonHandler>());
@@ -161,6 +209,13 @@ bool FMCPTCPServer::Start()
     // Clear any existing client connections
     ClientConnections.Empty();
 
+    // Start recording scene changes so clients can request deltas instead of full dumps
+    FMCPSceneJournal::Get().Initialize();
+    FMCPSceneHashIndex::Get().Initialize();
+    FMCPAssetCatalog::Get().Initialize();
+    FMCPAssetSearchIndex::Get().Initialize();
+    FMCPAssetDependencyGraph::Get().Initialize();
+
     TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FMCPTCPServer::Tick), Config.TickIntervalSeconds);
     bRunning = true;
     MCP_LOG_INFO("MCP Server started on port %d", Config.Port);
@@ -183,6 +238,13 @@ void FMCPTCPServer::Stop()
         FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
         TickerHandle.Reset();
     }
+
+    FMCPSceneHashIndex::Get().Shutdown();
+    FMCPVectorStore::Get().Shutdown();
+    FMCPAssetSearchIndex::Get().Shutdown();
+    FMCPAssetDependencyGraph::Get().Shutdown();
+    FMCPAssetCatalog::Get().Shutdown();
+    FMCPSceneJournal::Get().Shutdown();
     
     bRunning = false;
     MCP_LOG_INFO("MCP Server stopped");
@@ -381,6 +443,9 @@ void FMCPTCPServer::CleanupClientConnection(FMCPClientConnection& ClientConnecti
     if (!ClientConnection.Socket) return;
     
     MCP_LOG_INFO("Cleaning up client connection from %s", *ClientConnection.Endpoint.ToString());
+
+    // A later connection may get the same socket address, so it must not inherit these cursors
+    FMCPResponseBudget::Get().ReleaseClient(ClientConnection.Socket);
     
     try
     {
@@ -435,6 +500,19 @@ void FMCPTCPServer::ProcessCommand(const FString& CommandJson, FSocket* ClientSo
     TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(CommandJson);
     if (FJsonSerializer::Deserialize(Reader, Command) && Command.IsValid())
     {
+        // Envelope options: a byte budget for the response, or a cursor to the rest of a cut response
+        double MaxResponseBytes = 0.0;
+        Command->TryGetNumberField(FStringView(TEXT("max_response_bytes")), MaxResponseBytes);
+        const bool bBudgeted = MaxResponseBytes > 0.0;
+
+        FString Cursor;
+        if (Command->TryGetStringField(FStringView(TEXT("cursor")), Cursor))
+        {
+            MCP_LOG_INFO("Continuing response %s", *Cursor);
+            SendResponse(ClientSocket, FMCPResponseBudget::Get().Continue(Cursor, static_cast<int64>(MaxResponseBytes), ClientSocket), true);
+            return;
+        }
+
         FString Type;
         if (Command->TryGetStringField(FStringView(TEXT("type")), Type))
         {
@@ -453,9 +531,13 @@ void FMCPTCPServer::ProcessCommand(const FString& CommandJson, FSocket* ClientSo
                 
                 // Handle the command and get the response
                 TSharedPtr<FJsonObject> Response = Handler->Execute(Params, ClientSocket);
+                if (bBudgeted)
+                {
+                    Response = FMCPResponseBudget::Get().Apply(Response, Handler->GetFieldPriorities(), static_cast<int64>(MaxResponseBytes), ClientSocket);
+                }
                 
                 // Send the response
-                SendResponse(ClientSocket, Response);
+                SendResponse(ClientSocket, Response, bBudgeted);
             }
             else
             {
@@ -491,13 +573,20 @@ void FMCPTCPServer::ProcessCommand(const FString& CommandJson, FSocket* ClientSo
     // Do not close the socket here
 }
 
-void FMCPTCPServer::SendResponse(FSocket* Client, const TSharedPtr<FJsonObject>& Response)
+void FMCPTCPServer::SendResponse(FSocket* Client, const TSharedPtr<FJsonObject>& Response, bool bCondensed)
 {
     if (!Client) return;
     
     FString ResponseStr;
-    TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&ResponseStr);
-    FJsonSerializer::Serialize(Response.ToSharedRef(), Writer);
+    if (bCondensed)
+    {
+        ResponseStr = FMCPResponseBudget::SerializeCondensed(Response);
+    }
+    else
+    {
+        TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&ResponseStr);
+        FJsonSerializer::Serialize(Response.ToSharedRef(), Writer);
+    }
     
     if (Config.bEnableVerboseLogging)
     {
@@ -0,0 +1,1312 @@
+#include "MCPVectorIndex.h"
+
+#include "Algo/Sort.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/Paths.h"
+#include "MCPFileLogger.h"
+
+#if PLATFORM_CPU_X86_FAMILY
+#include <immintrin.h>
+#elif PLATFORM_CPU_ARM_FAMILY
+#include <arm_neon.h>
+#endif
+
+static_assert(PLATFORM_LITTLE_ENDIAN, "Vector index files are written and mapped as little-endian memory images");
+
+// The AVX2 kernel is compiled for AVX2 on its own and only called when the CPU reports support
+#if PLATFORM_CPU_X86_FAMILY && (defined(__clang__) || defined(__GNUC__))
+#define MCP_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define MCP_TARGET_AVX2
+#endif
+
+namespace
+{
+    /** Vectors are padded to a multiple of the widest kernel's step so kernels need no tail loop */
+    constexpr int32 VECTOR_ALIGNMENT = 32;
+
+    /** Quantized values stay within +-127 so the SIMD kernels' pairwise 16-bit sums cannot saturate */
+    constexpr float QUANTIZED_MAX = 127.0f;
+
+    using FDotFunction = int32 (*)(const int8*, const int8*, int32);
+
+    int32 DotScalar(const int8* A, const int8* B, int32 Count)
+    {
+        int32 Sum = 0;
+        for (int32 Index = 0; Index < Count; ++Index)
+        {
+            Sum += static_cast<int32>(A[Index]) * static_cast<int32>(B[Index]);
+        }
+        return Sum;
+    }
+
+#if PLATFORM_CPU_X86_FAMILY
+    MCP_TARGET_AVX2 int32 DotAVX2(const int8* A, const int8* B, int32 Count)
+    {
+        const __m256i Ones = _mm256_set1_epi16(1);
+        __m256i Sum = _mm256_setzero_si256();
+        for (int32 Index = 0; Index < Count; Index += 32)
+        {
+            const __m256i VA = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(A + Index));
+            const __m256i VB = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(B + Index));
+
+            // maddubs multiplies unsigned by signed bytes, so A's sign is moved onto B
+            const __m256i Products = _mm256_maddubs_epi16(_mm256_sign_epi8(VA, VA), _mm256_sign_epi8(VB, VA));
+            Sum = _mm256_add_epi32(Sum, _mm256_madd_epi16(Products, Ones));
+        }
+        __m128i Half = _mm_add_epi32(_mm256_castsi256_si128(Sum), _mm256_extracti128_si256(Sum, 1));
+        Half = _mm_add_epi32(Half, _mm_shuffle_epi32(Half, _MM_SHUFFLE(1, 0, 3, 2)));
+        Half = _mm_add_epi32(Half, _mm_shuffle_epi32(Half, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_cvtsi128_si32(Half);
+    }
+
+#if PLATFORM_ALWAYS_HAS_SSE4_1
+    int32 DotSSSE3(const int8* A, const int8* B, int32 Count)
+    {
+        const __m128i Ones = _mm_set1_epi16(1);
+        __m128i Sum = _mm_setzero_si128();
+        for (int32 Index = 0; Index < Count; Index += 16)
+        {
+            const __m128i VA = _mm_loadu_si128(reinterpret_cast<const __m128i*>(A + Index));
+            const __m128i VB = _mm_loadu_si128(reinterpret_cast<const __m128i*>(B + Index));
+            const __m128i Products = _mm_maddubs_epi16(_mm_sign_epi8(VA, VA), _mm_sign_epi8(VB, VA));
+            Sum = _mm_add_epi32(Sum, _mm_madd_epi16(Products, Ones));
+        }
+        Sum = _mm_add_epi32(Sum, _mm_shuffle_epi32(Sum, _MM_SHUFFLE(1, 0, 3, 2)));
+        Sum = _mm_add_epi32(Sum, _mm_shuffle_epi32(Sum, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_cvtsi128_si32(Sum);
+    }
+#endif
+#endif
+
+#if PLATFORM_CPU_ARM_FAMILY
+    int32 DotNEON(const int8* A, const int8* B, int32 Count)
+    {
+        int32x4_t Sum = vdupq_n_s32(0);
+        for (int32 Index = 0; Index < Count; Index += 16)
+        {
+            const int8x16_t VA = vld1q_s8(A + Index);
+            const int8x16_t VB = vld1q_s8(B + Index);
+            Sum = vpadalq_s16(Sum, vmull_s8(vget_low_s8(VA), vget_low_s8(VB)));
+            Sum = vpadalq_s16(Sum, vmull_s8(vget_high_s8(VA), vget_high_s8(VB)));
+        }
+        return vaddvq_s32(Sum);
+    }
+#endif
+
+    FDotFunction SelectDotFunction()
+    {
+#if PLATFORM_CPU_X86_FAMILY
+        if (FPlatformMisc::HasAVX2InstructionSupport())
+        {
+            return &DotAVX2;
+        }
+#if PLATFORM_ALWAYS_HAS_SSE4_1
+        return &DotSSSE3;
+#endif
+#elif PLATFORM_CPU_ARM_FAMILY
+        return &DotNEON;
+#endif
+        return &DotScalar;
+    }
+
+    int32 Dot(const int8* A, const int8* B, int32 Count)
+    {
+        static const FDotFunction Function = SelectDotFunction();
+        return Function(A, B, Count);
+    }
+
+    uint64 MakeMetaKey(int32 Key, int32 Value)
+    {
+        return (static_cast<uint64>(static_cast<uint32>(Key)) << 32) | static_cast<uint32>(Value);
+    }
+}
+
+//
+// FMCPVectorFilter
+//
+bool FMCPVectorFilter::Parse(const TSharedPtr<FJsonObject>& Object, FString& OutError)
+{
+    Conditions.Reset();
+    for (const TPair<FString, TSharedPtr<FJsonValue>>& Field : Object->Values)
+    {
+        TArray<FString> Values;
+        FString Value;
+        const TArray<TSharedPtr<FJsonValue>>* Array = nullptr;
+        if (Field.Value->TryGetString(Value))
+        {
+            Values.Add(Value);
+        }
+        else if (Field.Value->TryGetArray(Array))
+        {
+            for (const TSharedPtr<FJsonValue>& Element : *Array)
+            {
+                if (!Element->TryGetString(Value))
+                {
+                    OutError = FString::Printf(TEXT("Filter values of '%s' must be strings"), *Field.Key);
+                    return false;
+                }
+                Values.Add(Value);
+            }
+        }
+        else
+        {
+            OutError = FString::Printf(TEXT("Filter '%s' must be a string or an array of strings"), *Field.Key);
+            return false;
+        }
+        Conditions.Emplace(Field.Key, MoveTemp(Values));
+    }
+    return true;
+}
+
+//
+// FMCPVectorIndex
+//
+FMCPVectorIndex::FMCPVectorIndex(const FString& InName)
+    : Name(InName)
+    , LevelRandom(static_cast<int32>(GetTypeHash(InName)))
+{
+    MetaStarts.Add(0);
+}
+
+FMCPVectorIndex::~FMCPVectorIndex() = default;
+
+void FMCPVectorIndex::Reset()
+{
+    MappedRegion.Reset();
+    MappedFile.Reset();
+    Dimension = 0;
+    Stride = 0;
+    M = MCPConstants::VECTOR_INDEX_M;
+    M0 = 2 * MCPConstants::VECTOR_INDEX_M;
+    NodeCount = 0;
+    DeletedCount = 0;
+    EntryPoint = INDEX_NONE;
+    MaxLevel = -1;
+    OwnedVectors.Empty();
+    OwnedLinks0.Empty();
+    Scales.Empty();
+    Levels.Empty();
+    Flags.Empty();
+    UpperOffsets.Empty();
+    UpperLinks.Empty();
+    IdStrings.Empty();
+    MetaStarts.Reset();
+    MetaStarts.Add(0);
+    MetaPairs.Empty();
+    Strings.Empty();
+    StringIds.Empty();
+    NodeByIdString.Empty();
+    MetaPostings.Empty();
+    VisitMarks.Empty();
+    VisitEpoch = 0;
+    RefreshViews();
+}
+
+int64 FMCPVectorIndex::GetAllocatedSize() const
+{
+    int64 Size = OwnedVectors.GetAllocatedSize() + OwnedLinks0.GetAllocatedSize() + Scales.GetAllocatedSize()
+        + Levels.GetAllocatedSize() + Flags.GetAllocatedSize() + UpperOffsets.GetAllocatedSize() + UpperLinks.GetAllocatedSize()
+        + IdStrings.GetAllocatedSize() + MetaStarts.GetAllocatedSize() + MetaPairs.GetAllocatedSize()
+        + Strings.GetAllocatedSize() + StringIds.GetAllocatedSize() + NodeByIdString.GetAllocatedSize()
+        + MetaPostings.GetAllocatedSize() + VisitMarks.GetAllocatedSize();
+    for (const FString& String : Strings)
+    {
+        Size += String.GetAllocatedSize();
+    }
+    for (const TPair<uint64, TArray<int32>>& Posting : MetaPostings)
+    {
+        Size += Posting.Value.GetAllocatedSize();
+    }
+    return Size;
+}
+
+void FMCPVectorIndex::MakeWritable()
+{
+    if (!MappedRegion.IsValid())
+    {
+        return;
+    }
+
+    OwnedVectors.SetNumUninitialized(static_cast<int64>(NodeCount) * Stride);
+    FMemory::Memcpy(OwnedVectors.GetData(), Vectors, OwnedVectors.Num());
+    OwnedLinks0.SetNumUninitialized(static_cast<int64>(NodeCount) * (M0 + 1));
+    FMemory::Memcpy(OwnedLinks0.GetData(), Links0, OwnedLinks0.Num() * sizeof(int32));
+
+    MappedRegion.Reset();
+    MappedFile.Reset();
+    RefreshViews();
+}
+
+void FMCPVectorIndex::RefreshViews()
+{
+    if (!MappedRegion.IsValid())
+    {
+        Vectors = OwnedVectors.GetData();
+        Links0 = OwnedLinks0.GetData();
+    }
+}
+
+int32 FMCPVectorIndex::InternString(const FString& Value)
+{
+    if (const int32* Existing = StringIds.Find(Value))
+    {
+        return *Existing;
+    }
+    const int32 Index = Strings.Add(Value);
+    StringIds.Add(Value, Index);
+    return Index;
+}
+
+const int32* FMCPVectorIndex::GetLinks(int32 Node, int32 Level) const
+{
+    if (Level == 0)
+    {
+        return Links0 + static_cast<int64>(Node) * (M0 + 1);
+    }
+    return &UpperLinks[UpperOffsets[Node] + (Level - 1) * (M + 1)];
+}
+
+int32* FMCPVectorIndex::GetMutableLinks(int32 Node, int32 Level)
+{
+    if (Level == 0)
+    {
+        return &OwnedLinks0[static_cast<int64>(Node) * (M0 + 1)];
+    }
+    return &UpperLinks[UpperOffsets[Node] + (Level - 1) * (M + 1)];
+}
+
+float FMCPVectorIndex::Quantize(TArrayView<const float> Vector, int8* Out) const
+{
+    FMemory::Memzero(Out, Stride);
+
+    double SquaredNorm = 0.0;
+    float MaxAbs = 0.0f;
+    for (const float Value : Vector)
+    {
+        SquaredNorm += static_cast<double>(Value) * Value;
+        MaxAbs = FMath::Max(MaxAbs, FMath::Abs(Value));
+    }
+    if (SquaredNorm <= 0.0 || !FMath::IsFinite(MaxAbs))
+    {
+        return 0.0f;
+    }
+
+    // Scale so the largest component maps to 127; the dot product of two quantized vectors times both
+    // scales then approximates the cosine of the originals
+    const float InvNorm = static_cast<float>(1.0 / FMath::Sqrt(SquaredNorm));
+    const float Scale = MaxAbs * InvNorm / QUANTIZED_MAX;
+    const float ToQuantized = InvNorm / Scale;
+    for (int32 Index = 0; Index < Vector.Num(); ++Index)
+    {
+        Out[Index] = static_cast<int8>(FMath::Clamp(FMath::RoundToInt(Vector[Index] * ToQuantized), -127, 127));
+    }
+    return Scale;
+}
+
+float FMCPVectorIndex::Similarity(const int8* Query, float QueryScale, int32 Node) const
+{
+    return static_cast<float>(Dot(Query, GetVector(Node), Stride)) * QueryScale * Scales[Node];
+}
+
+float FMCPVectorIndex::NodeSimilarity(int32 A, int32 B) const
+{
+    return Similarity(GetVector(A), Scales[A], B);
+}
+
+bool FMCPVectorIndex::Matches(int32 Node, const FCompiledFilter& Filter) const
+{
+    const uint32 Start = MetaStarts[Node];
+    const uint32 End = MetaStarts[Node + 1];
+    for (const FCompiledFilter::FCondition& Condition : Filter.Conditions)
+    {
+        int32 Value = INDEX_NONE;
+        for (uint32 Pair = Start; Pair < End; ++Pair)
+        {
+            if (static_cast<int32>(MetaPairs[2 * Pair]) == Condition.Key)
+            {
+                Value = static_cast<int32>(MetaPairs[2 * Pair + 1]);
+                break;
+            }
+        }
+        if (Value == INDEX_NONE)
+        {
+            return false;
+        }
+        if (!Condition.Values.Contains(Value)
+            && !Condition.Prefixes.ContainsByPredicate([this, Value](const FString& Prefix) { return Strings[Value].StartsWith(Prefix); }))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void FMCPVectorIndex::CompileFilter(const FMCPVectorFilter& Filter, FCompiledFilter& OutFilter) const
+{
+    OutFilter = FCompiledFilter();
+    for (const TPair<FString, TArray<FString>>& Condition : Filter.Conditions)
+    {
+        FCompiledFilter::FCondition& Compiled = OutFilter.Conditions.AddDefaulted_GetRef();
+        const int32* Key = StringIds.Find(Condition.Key);
+        Compiled.Key = Key ? *Key : INDEX_NONE;
+        for (const FString& Value : Condition.Value)
+        {
+            if (Value.EndsWith(TEXT("*")))
+            {
+                Compiled.Prefixes.Add(Value.LeftChop(1));
+            }
+            else if (const int32* ValueId = StringIds.Find(Value))
+            {
+                Compiled.Values.Add(*ValueId);
+            }
+        }
+
+        // A key or values never stored cannot match any node
+        if (Compiled.Key == INDEX_NONE || (Compiled.Values.Num() == 0 && Compiled.Prefixes.Num() == 0))
+        {
+            OutFilter.bEmpty = true;
+        }
+    }
+}
+
+void FMCPVectorIndex::SearchLevel(const int8* Query, float QueryScale, const TArray<FCandidate>& Entries, int32 Ef, int32 Level,
+    const FCompiledFilter* Filter, bool bLiveOnly, TArray<FCandidate>& OutResults, int32& InOutVisited)
+{
+    const auto BetterFirst = [](const FCandidate& A, const FCandidate& B) { return A.Similarity > B.Similarity; };
+    const auto WorseFirst = [](const FCandidate& A, const FCandidate& B) { return A.Similarity < B.Similarity; };
+    const auto Admits = [this, Filter, bLiveOnly](int32 Node)
+    {
+        return (!bLiveOnly || IsLive(Node)) && (!Filter || Matches(Node, *Filter));
+    };
+
+    // Epochs instead of clearing a visited set per walk; on wrap-around the marks are cleared once
+    if (++VisitEpoch == 0)
+    {
+        FMemory::Memzero(VisitMarks.GetData(), VisitMarks.Num() * sizeof(uint32));
+        VisitEpoch = 1;
+    }
+
+    TArray<FCandidate> Frontier;
+    OutResults.Reset();
+    for (const FCandidate& Entry : Entries)
+    {
+        VisitMarks[Entry.Node] = VisitEpoch;
+        Frontier.HeapPush(Entry, BetterFirst);
+        if (Admits(Entry.Node))
+        {
+            OutResults.HeapPush(Entry, WorseFirst);
+        }
+    }
+
+    // A selective filter admits few nodes, so the walk is capped rather than left to cover the graph
+    const int32 VisitLimit = InOutVisited + MCPConstants::MAX_VECTOR_SEARCH_VISITS;
+    while (Frontier.Num() > 0 && InOutVisited < VisitLimit)
+    {
+        FCandidate Current;
+        Frontier.HeapPop(Current, BetterFirst, EAllowShrinking::No);
+        if (OutResults.Num() >= Ef && Current.Similarity < OutResults.HeapTop().Similarity)
+        {
+            break;
+        }
+
+        const int32* Links = GetLinks(Current.Node, Level);
+        const int32 LinkCount = Links[0];
+        for (int32 LinkIndex = 1; LinkIndex <= LinkCount; ++LinkIndex)
+        {
+            const int32 Neighbour = Links[LinkIndex];
+            if (VisitMarks[Neighbour] == VisitEpoch)
+            {
+                continue;
+            }
+            VisitMarks[Neighbour] = VisitEpoch;
+            InOutVisited++;
+
+            const float NeighbourSimilarity = Similarity(Query, QueryScale, Neighbour);
+            if (OutResults.Num() < Ef || NeighbourSimilarity > OutResults.HeapTop().Similarity)
+            {
+                Frontier.HeapPush(FCandidate{ NeighbourSimilarity, Neighbour }, BetterFirst);
+                if (Admits(Neighbour))
+                {
+                    OutResults.HeapPush(FCandidate{ NeighbourSimilarity, Neighbour }, WorseFirst);
+                    if (OutResults.Num() > Ef)
+                    {
+                        OutResults.HeapPopDiscard(WorseFirst, EAllowShrinking::No);
+                    }
+                }
+            }
+        }
+    }
+
+    OutResults.Sort(BetterFirst);
+}
+
+void FMCPVectorIndex::SelectNeighbours(const TArray<FCandidate>& Candidates, int32 MaxCount, TArray<int32>& OutNeighbours) const
+{
+    // The HNSW heuristic: skipping candidates that are closer to an already kept neighbour than to the
+    // new node spreads the links over directions and keeps clusters connected to each other
+    OutNeighbours.Reset();
+    for (const FCandidate& Candidate : Candidates)
+    {
+        if (OutNeighbours.Num() >= MaxCount)
+        {
+            break;
+        }
+
+        bool bKeep = true;
+        for (const int32 Kept : OutNeighbours)
+        {
+            if (NodeSimilarity(Candidate.Node, Kept) > Candidate.Similarity)
+            {
+                bKeep = false;
+                break;
+            }
+        }
+        if (bKeep)
+        {
+            OutNeighbours.Add(Candidate.Node);
+        }
+    }
+}
+
+void FMCPVectorIndex::AddLink(int32 Node, int32 Neighbour, int32 Level)
+{
+    int32* Links = GetMutableLinks(Node, Level);
+    const int32 MaxLinks = GetMaxLinks(Level);
+    if (Links[0] < MaxLinks)
+    {
+        Links[++Links[0]] = Neighbour;
+        return;
+    }
+
+    // Full: choose again among the current links plus the new one
+    TArray<FCandidate> Candidates;
+    Candidates.Reserve(MaxLinks + 1);
+    for (int32 LinkIndex = 1; LinkIndex <= Links[0]; ++LinkIndex)
+    {
+        Candidates.Add(FCandidate{ NodeSimilarity(Node, Links[LinkIndex]), Links[LinkIndex] });
+    }
+    Candidates.Add(FCandidate{ NodeSimilarity(Node, Neighbour), Neighbour });
+    Candidates.Sort([](const FCandidate& A, const FCandidate& B) { return A.Similarity > B.Similarity; });
+
+    TArray<int32> Kept;
+    SelectNeighbours(Candidates, MaxLinks, Kept);
+    Links[0] = Kept.Num();
+    for (int32 KeptIndex = 0; KeptIndex < Kept.Num(); ++KeptIndex)
+    {
+        Links[KeptIndex + 1] = Kept[KeptIndex];
+    }
+}
+
+void FMCPVectorIndex::Connect(int32 Node)
+{
+    const int32 NodeLevel = Levels[Node];
+    if (EntryPoint == INDEX_NONE)
+    {
+        EntryPoint = Node;
+        MaxLevel = NodeLevel;
+        return;
+    }
+
+    const int8* Query = GetVector(Node);
+    const float QueryScale = Scales[Node];
+    int32 Visited = 0;
+
+    // Descend greedily to the node's top level, then link it on every level it lives on
+    TArray<FCandidate> Entries;
+    Entries.Add(FCandidate{ Similarity(Query, QueryScale, EntryPoint), EntryPoint });
+    TArray<FCandidate> Results;
+    for (int32 Level = MaxLevel; Level > NodeLevel; --Level)
+    {
+        SearchLevel(Query, QueryScale, Entries, 1, Level, nullptr, false, Results, Visited);
+        Entries = Results;
+    }
+
+    TArray<int32> Neighbours;
+    for (int32 Level = FMath::Min(NodeLevel, MaxLevel); Level >= 0; --Level)
+    {
+        SearchLevel(Query, QueryScale, Entries, MCPConstants::VECTOR_INDEX_EF_CONSTRUCTION, Level, nullptr, false, Results, Visited);
+        SelectNeighbours(Results, GetMaxLinks(Level), Neighbours);
+
+        int32* Links = GetMutableLinks(Node, Level);
+        Links[0] = Neighbours.Num();
+        for (int32 NeighbourIndex = 0; NeighbourIndex < Neighbours.Num(); ++NeighbourIndex)
+        {
+            Links[NeighbourIndex + 1] = Neighbours[NeighbourIndex];
+        }
+        for (const int32 Neighbour : Neighbours)
+        {
+            AddLink(Neighbour, Node, Level);
+        }
+        Entries = Results;
+    }
+
+    if (NodeLevel > MaxLevel)
+    {
+        EntryPoint = Node;
+        MaxLevel = NodeLevel;
+    }
+}
+
+bool FMCPVectorIndex::Upsert(const FString& Id, TArrayView<const float> Vector, const TArray<TPair<FString, FString>>& Metadata, FString& OutError)
+{
+    check(IsInGameThread());
+
+    if (Dimension == 0)
+    {
+        if (Vector.Num() == 0 || Vector.Num() > MCPConstants::MAX_VECTOR_DIMENSION)
+        {
+            OutError = FString::Printf(TEXT("Vector length must be between 1 and %d"), MCPConstants::MAX_VECTOR_DIMENSION);
+            return false;
+        }
+        Dimension = Vector.Num();
+        Stride = Align(Dimension, VECTOR_ALIGNMENT);
+    }
+    else if (Vector.Num() != Dimension)
+    {
+        OutError = FString::Printf(TEXT("Vector of '%s' has %d values; index '%s' holds %d"), *Id, Vector.Num(), *Name, Dimension);
+        return false;
+    }
+
+    MakeWritable();
+
+    // Quantize into the new node's slot first so a rejected vector leaves nothing behind
+    const int32 Node = NodeCount;
+    OwnedVectors.AddUninitialized(Stride);
+    const float Scale = Quantize(Vector, &OwnedVectors[static_cast<int64>(Node) * Stride]);
+    if (Scale <= 0.0f)
+    {
+        OwnedVectors.SetNum(static_cast<int64>(Node) * Stride, EAllowShrinking::No);
+        OutError = FString::Printf(TEXT("Vector of '%s' is zero or not finite"), *Id);
+        return false;
+    }
+
+    const int32 IdString = InternString(Id);
+    if (const int32* Existing = NodeByIdString.Find(IdString))
+    {
+        Flags[*Existing] |= MCPVectorFormat::Deleted;
+        DeletedCount++;
+    }
+
+    const double LevelMultiplier = 1.0 / FMath::Loge(static_cast<double>(M));
+    const double Uniform = FMath::Max(static_cast<double>(LevelRandom.GetFraction()), UE_DOUBLE_SMALL_NUMBER);
+    const int32 Level = FMath::Min(FMath::FloorToInt32(-FMath::Loge(Uniform) * LevelMultiplier), MCPConstants::VECTOR_INDEX_MAX_LEVEL);
+
+    AddNode(IdString, Scale, Level, Metadata);
+    bDirty = true;
+    return true;
+}
+
+void FMCPVectorIndex::AddNode(int32 IdString, float Scale, int32 Level, const TArray<TPair<FString, FString>>& Metadata)
+{
+    const int32 Node = NodeCount;
+    Scales.Add(Scale);
+    Levels.Add(static_cast<uint8>(Level));
+    Flags.Add(0);
+    OwnedLinks0.AddZeroed(M0 + 1);
+    UpperOffsets.Add(Level > 0 ? UpperLinks.Num() : INDEX_NONE);
+    if (Level > 0)
+    {
+        UpperLinks.AddZeroed(Level * (M + 1));
+    }
+    IdStrings.Add(IdString);
+    NodeByIdString.Add(IdString, Node);
+
+    for (const TPair<FString, FString>& Entry : Metadata)
+    {
+        const int32 Key = InternString(Entry.Key);
+        const int32 Value = InternString(Entry.Value);
+        MetaPairs.Add(Key);
+        MetaPairs.Add(Value);
+        MetaPostings.FindOrAdd(MakeMetaKey(Key, Value)).Add(Node);
+    }
+    MetaStarts.Add(MetaPairs.Num() / 2);
+
+    VisitMarks.Add(0);
+    NodeCount++;
+    RefreshViews();
+    Connect(Node);
+}
+
+bool FMCPVectorIndex::Remove(const FString& Id)
+{
+    const int32* IdString = StringIds.Find(Id);
+    int32 Node = INDEX_NONE;
+    if (!IdString || !NodeByIdString.RemoveAndCopyValue(*IdString, Node))
+    {
+        return false;
+    }
+
+    Flags[Node] |= MCPVectorFormat::Deleted;
+    DeletedCount++;
+    bDirty = true;
+    return true;
+}
+
+int32 FMCPVectorIndex::Compact()
+{
+    check(IsInGameThread());
+    if (DeletedCount == 0)
+    {
+        return 0;
+    }
+
+    MakeWritable();
+    const int32 OldNodeCount = NodeCount;
+    const int32 Removed = DeletedCount;
+    const int32 KeptDimension = Dimension;
+    const int32 KeptStride = Stride;
+    const int32 KeptM = M;
+    const int32 KeptM0 = M0;
+    const TArray<int8> OldVectors = MoveTemp(OwnedVectors);
+    const TArray<float> OldScales = MoveTemp(Scales);
+    const TArray<uint8> OldLevels = MoveTemp(Levels);
+    const TArray<uint8> OldFlags = MoveTemp(Flags);
+    const TArray<int32> OldIdStrings = MoveTemp(IdStrings);
+    const TArray<uint32> OldMetaStarts = MoveTemp(MetaStarts);
+    const TArray<uint32> OldMetaPairs = MoveTemp(MetaPairs);
+    const TArray<FString> OldStrings = MoveTemp(Strings);
+
+    Reset();
+    Dimension = KeptDimension;
+    Stride = KeptStride;
+    M = KeptM;
+    M0 = KeptM0;
+
+    // Relink the live nodes on their old levels; strings only deleted nodes used are dropped with them
+    const int32 LiveCount = OldNodeCount - Removed;
+    OwnedVectors.Reserve(static_cast<int64>(LiveCount) * Stride);
+    OwnedLinks0.Reserve(static_cast<int64>(LiveCount) * (M0 + 1));
+    TArray<TPair<FString, FString>> Metadata;
+    for (int32 Node = 0; Node < OldNodeCount; ++Node)
+    {
+        if (OldFlags[Node] & MCPVectorFormat::Deleted)
+        {
+            continue;
+        }
+        OwnedVectors.Append(&OldVectors[static_cast<int64>(Node) * Stride], Stride);
+        Metadata.Reset();
+        for (uint32 Pair = OldMetaStarts[Node]; Pair < OldMetaStarts[Node + 1]; ++Pair)
+        {
+            Metadata.Emplace(OldStrings[OldMetaPairs[2 * Pair]], OldStrings[OldMetaPairs[2 * Pair + 1]]);
+        }
+        AddNode(InternString(OldStrings[OldIdStrings[Node]]), OldScales[Node], OldLevels[Node], Metadata);
+    }
+
+    bDirty = true;
+    return Removed;
+}
+
+bool FMCPVectorIndex::Search(TArrayView<const float> Query, int32 K, int32 Ef, const FMCPVectorFilter* Filter, TArray<FMCPVectorHit>& OutHits, FMCPVectorSearchStats* OutStats)
+{
+    check(IsInGameThread());
+
+    OutHits.Reset();
+    FMCPVectorSearchStats Stats;
+    if (NodeCount == 0)
+    {
+        if (OutStats)
+        {
+            *OutStats = Stats;
+        }
+        return true;
+    }
+    if (Query.Num() != Dimension)
+    {
+        return false;
+    }
+
+    TArray<int8> QueryVector;
+    QueryVector.SetNumUninitialized(Stride);
+    const float QueryScale = Quantize(Query, QueryVector.GetData());
+    if (QueryScale <= 0.0f || K <= 0)
+    {
+        return true;
+    }
+
+    FCompiledFilter CompiledFilter;
+    const bool bFiltered = Filter && !Filter->IsEmpty();
+    if (bFiltered)
+    {
+        CompileFilter(*Filter, CompiledFilter);
+        if (CompiledFilter.bEmpty)
+        {
+            if (OutStats)
+            {
+                Stats.bExact = true;
+                *OutStats = Stats;
+            }
+            return true;
+        }
+    }
+
+    // Candidates for an exhaustive comparison: the smallest posting union among exact-value conditions,
+    // or every node of a small index
+    constexpr int32 MaxCandidateLists = 64;
+    const TArray<int32>* CandidateLists[MaxCandidateLists];
+    int32 CandidateListCount = 0;
+    int64 CandidateCount = NodeCount;
+    if (bFiltered)
+    {
+        for (const FCompiledFilter::FCondition& Condition : CompiledFilter.Conditions)
+        {
+            if (Condition.Prefixes.Num() > 0 || Condition.Values.Num() > MaxCandidateLists)
+            {
+                continue;
+            }
+
+            int64 ConditionCount = 0;
+            const TArray<int32>* Lists[MaxCandidateLists];
+            int32 ListCount = 0;
+            for (const int32 Value : Condition.Values)
+            {
+                if (const TArray<int32>* Posting = MetaPostings.Find(MakeMetaKey(Condition.Key, Value)))
+                {
+                    Lists[ListCount++] = Posting;
+                    ConditionCount += Posting->Num();
+                }
+            }
+            if (ConditionCount < CandidateCount)
+            {
+                CandidateCount = ConditionCount;
+                CandidateListCount = ListCount;
+                FMemory::Memcpy(CandidateLists, Lists, ListCount * sizeof(Lists[0]));
+            }
+        }
+    }
+
+    const auto WorseFirst = [](const FMCPVectorHit& A, const FMCPVectorHit& B) { return A.Score < B.Score; };
+    const auto BetterFirst = [](const FMCPVectorHit& A, const FMCPVectorHit& B) { return A.Score != B.Score ? A.Score > B.Score : A.Node < B.Node; };
+    if (CandidateCount <= MCPConstants::VECTOR_EXACT_SEARCH_LIMIT)
+    {
+        Stats.bExact = true;
+        auto Consider = [&](int32 Node)
+        {
+            if (!IsLive(Node) || (bFiltered && !Matches(Node, CompiledFilter)))
+            {
+                return;
+            }
+            Stats.Visited++;
+            const FMCPVectorHit Hit{ Node, Similarity(QueryVector.GetData(), QueryScale, Node) };
+            if (OutHits.Num() < K)
+            {
+                OutHits.HeapPush(Hit, WorseFirst);
+            }
+            else if (Hit.Score > OutHits.HeapTop().Score)
+            {
+                OutHits.HeapPopDiscard(WorseFirst, EAllowShrinking::No);
+                OutHits.HeapPush(Hit, WorseFirst);
+            }
+        };
+
+        if (CandidateListCount > 0)
+        {
+            // A node has one value per key, so the lists of one condition do not overlap
+            for (int32 ListIndex = 0; ListIndex < CandidateListCount; ++ListIndex)
+            {
+                for (const int32 Node : *CandidateLists[ListIndex])
+                {
+                    Consider(Node);
+                }
+            }
+        }
+        else if (CandidateCount > 0 && (!bFiltered || CandidateCount == NodeCount))
+        {
+            for (int32 Node = 0; Node < NodeCount; ++Node)
+            {
+                Consider(Node);
+            }
+        }
+        OutHits.Sort(BetterFirst);
+        if (OutStats)
+        {
+            *OutStats = Stats;
+        }
+        return true;
+    }
+
+    // Greedy descent through the upper levels, then a filtered best-first walk of level 0
+    TArray<FCandidate> Entries;
+    Entries.Add(FCandidate{ Similarity(QueryVector.GetData(), QueryScale, EntryPoint), EntryPoint });
+    TArray<FCandidate> Results;
+    for (int32 Level = MaxLevel; Level > 0; --Level)
+    {
+        SearchLevel(QueryVector.GetData(), QueryScale, Entries, 1, Level, nullptr, false, Results, Stats.Visited);
+        Entries = Results;
+    }
+    SearchLevel(QueryVector.GetData(), QueryScale, Entries, FMath::Max(Ef, K), 0, bFiltered ? &CompiledFilter : nullptr, true, Results, Stats.Visited);
+
+    const int32 HitCount = FMath::Min(K, Results.Num());
+    OutHits.Reserve(HitCount);
+    for (int32 Index = 0; Index < HitCount; ++Index)
+    {
+        OutHits.Add(FMCPVectorHit{ Results[Index].Node, Results[Index].Similarity });
+    }
+    if (OutStats)
+    {
+        *OutStats = Stats;
+    }
+    return true;
+}
+
+const FString& FMCPVectorIndex::GetId(int32 Node) const
+{
+    return Strings[IdStrings[Node]];
+}
+
+void FMCPVectorIndex::GetMetadata(int32 Node, TArray<TPair<FString, FString>>& OutMetadata) const
+{
+    OutMetadata.Reset();
+    for (uint32 Pair = MetaStarts[Node]; Pair < MetaStarts[Node + 1]; ++Pair)
+    {
+        OutMetadata.Emplace(Strings[MetaPairs[2 * Pair]], Strings[MetaPairs[2 * Pair + 1]]);
+    }
+}
+
+bool FMCPVectorIndex::Save(const FString& Path, FString& OutError)
+{
+    // The file being replaced may be the one mapped
+    MakeWritable();
+
+    TArray<uint32> StringOffsets;
+    TArray<uint8> StringData;
+    StringOffsets.Reserve(Strings.Num() + 1);
+    StringOffsets.Add(0);
+    for (const FString& String : Strings)
+    {
+        const FTCHARToUTF8 Converter(*String);
+        StringData.Append(reinterpret_cast<const uint8*>(Converter.Get()), Converter.Length());
+        StringOffsets.Add(StringData.Num());
+    }
+
+    struct FSectionData
+    {
+        MCPVectorFormat::ESectionId Id;
+        uint32 Stride;
+        int64 Count;
+        const void* Data;
+    };
+    const FSectionData SectionData[] =
+    {
+        { MCPVectorFormat::Vectors, sizeof(int8), OwnedVectors.Num(), OwnedVectors.GetData() },
+        { MCPVectorFormat::Scales, sizeof(float), Scales.Num(), Scales.GetData() },
+        { MCPVectorFormat::Levels, sizeof(uint8), Levels.Num(), Levels.GetData() },
+        { MCPVectorFormat::Flags, sizeof(uint8), Flags.Num(), Flags.GetData() },
+        { MCPVectorFormat::Links0, sizeof(int32), OwnedLinks0.Num(), OwnedLinks0.GetData() },
+        { MCPVectorFormat::UpperOffsets, sizeof(int32), UpperOffsets.Num(), UpperOffsets.GetData() },
+        { MCPVectorFormat::UpperLinks, sizeof(int32), UpperLinks.Num(), UpperLinks.GetData() },
+        { MCPVectorFormat::Ids, sizeof(uint32), IdStrings.Num(), IdStrings.GetData() },
+        { MCPVectorFormat::MetaStarts, sizeof(uint32), MetaStarts.Num(), MetaStarts.GetData() },
+        { MCPVectorFormat::MetaPairs, sizeof(uint32), MetaPairs.Num(), MetaPairs.GetData() },
+        { MCPVectorFormat::StringOffsets, sizeof(uint32), StringOffsets.Num(), StringOffsets.GetData() },
+        { MCPVectorFormat::StringData, sizeof(uint8), StringData.Num(), StringData.GetData() },
+    };
+    constexpr int32 SectionCount = UE_ARRAY_COUNT(SectionData);
+
+    TArray<FMCPVectorSection> Sections;
+    Sections.SetNumZeroed(SectionCount);
+    int64 Offset = sizeof(FMCPVectorFileHeader) + SectionCount * sizeof(FMCPVectorSection);
+    for (int32 Index = 0; Index < SectionCount; ++Index)
+    {
+        Offset = Align(Offset, static_cast<int64>(MCPVectorFormat::SECTION_ALIGNMENT));
+        Sections[Index].Id = SectionData[Index].Id;
+        Sections[Index].Stride = SectionData[Index].Stride;
+        Sections[Index].Count = SectionData[Index].Count;
+        Sections[Index].Offset = Offset;
+        Sections[Index].Size = SectionData[Index].Count * SectionData[Index].Stride;
+        Offset += Sections[Index].Size;
+    }
+
+    FMCPVectorFileHeader Header;
+    FMemory::Memzero(Header);
+    FMemory::Memcpy(Header.Magic, "MCPVEC\0", 8);
+    Header.FormatVersion = MCPVectorFormat::FORMAT_VERSION;
+    Header.HeaderSize = sizeof(FMCPVectorFileHeader);
+    Header.Dimension = Dimension;
+    Header.Stride = Stride;
+    Header.NodeCount = NodeCount;
+    Header.DeletedCount = DeletedCount;
+    Header.M = M;
+    Header.M0 = M0;
+    Header.EntryPoint = EntryPoint;
+    Header.MaxLevel = MaxLevel;
+    Header.StringCount = Strings.Num();
+    Header.SectionCount = SectionCount;
+
+    // Write to a temporary name and move into place so readers never see a partial file
+    const FString TempPath = Path + TEXT(".tmp");
+    IFileManager& FileManager = IFileManager::Get();
+    FileManager.MakeDirectory(*FPaths::GetPath(Path), true);
+
+    TUniquePtr<FArchive> Writer(FileManager.CreateFileWriter(*TempPath));
+    if (!Writer)
+    {
+        OutError = FString::Printf(TEXT("Could not open %s for writing"), *TempPath);
+        return false;
+    }
+
+    static const uint8 Zeros[MCPVectorFormat::SECTION_ALIGNMENT] = {};
+    Writer->Serialize(&Header, sizeof(Header));
+    Writer->Serialize(Sections.GetData(), Sections.Num() * sizeof(FMCPVectorSection));
+    for (int32 Index = 0; Index < SectionCount; ++Index)
+    {
+        const int64 Padding = Sections[Index].Offset - Writer->Tell();
+        check(Padding >= 0 && Padding < MCPVectorFormat::SECTION_ALIGNMENT);
+        Writer->Serialize(const_cast<uint8*>(Zeros), Padding);
+        if (Sections[Index].Size > 0)
+        {
+            Writer->Serialize(const_cast<void*>(SectionData[Index].Data), Sections[Index].Size);
+        }
+    }
+
+    const bool bWriteFailed = !Writer->Close();
+    Writer.Reset();
+    if (bWriteFailed)
+    {
+        FileManager.Delete(*TempPath);
+        OutError = FString::Printf(TEXT("Error while writing %s"), *TempPath);
+        return false;
+    }
+    if (!FileManager.Move(*Path, *TempPath, true))
+    {
+        FileManager.Delete(*TempPath);
+        OutError = FString::Printf(TEXT("Could not move the vector index into place at %s"), *Path);
+        return false;
+    }
+
+    bDirty = false;
+    return true;
+}
+
+bool FMCPVectorIndex::Load(const FString& Path, FString& OutError)
+{
+    check(IsInGameThread());
+    Reset();
+
+    IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+    TUniquePtr<IMappedFileHandle> File(PlatformFile.OpenMapped(*Path));
+    if (!File)
+    {
+        OutError = FString::Printf(TEXT("Could not map %s"), *Path);
+        return false;
+    }
+    const int64 FileSize = File->GetFileSize();
+    if (FileSize < static_cast<int64>(sizeof(FMCPVectorFileHeader)))
+    {
+        OutError = FString::Printf(TEXT("%s is not a vector index"), *Path);
+        return false;
+    }
+    TUniquePtr<IMappedFileRegion> Region(File->MapRegion(0, FileSize));
+    if (!Region)
+    {
+        OutError = FString::Printf(TEXT("Could not map %s"), *Path);
+        return false;
+    }
+
+    const uint8* Base = Region->GetMappedPtr();
+    FMCPVectorFileHeader Header;
+    FMemory::Memcpy(&Header, Base, sizeof(Header));
+    if (FMemory::Memcmp(Header.Magic, "MCPVEC\0", 8) != 0 || Header.FormatVersion != MCPVectorFormat::FORMAT_VERSION
+        || Header.HeaderSize != sizeof(FMCPVectorFileHeader) || Header.M == 0 || Header.M0 == 0
+        || Header.Stride % VECTOR_ALIGNMENT != 0 || Header.Dimension > Header.Stride
+        || static_cast<int64>(sizeof(Header) + Header.SectionCount * sizeof(FMCPVectorSection)) > FileSize)
+    {
+        OutError = FString::Printf(TEXT("%s is not a vector index of format version %u"), *Path, MCPVectorFormat::FORMAT_VERSION);
+        return false;
+    }
+
+    // The same limits Upsert enforces; an index of another length could never match a query
+    if ((Header.NodeCount > 0 && Header.Dimension == 0) || Header.Dimension > static_cast<uint32>(MCPConstants::MAX_VECTOR_DIMENSION)
+        || Header.Stride != static_cast<uint32>(Align(Header.Dimension, VECTOR_ALIGNMENT)))
+    {
+        OutError = FString::Printf(TEXT("%s has %u nodes of dimension %u; the dimension must be between 1 and %d"),
+            *Path, Header.NodeCount, Header.Dimension, MCPConstants::MAX_VECTOR_DIMENSION);
+        return false;
+    }
+
+    // Look every section up and bounds-check it before anything reads from the mapping
+    const FMCPVectorSection* SectionTable = reinterpret_cast<const FMCPVectorSection*>(Base + sizeof(Header));
+    auto FindSection = [&](MCPVectorFormat::ESectionId Id, uint32 ElementSize, uint64 ExpectedCount, bool bExactCount, const FMCPVectorSection*& OutSection)
+    {
+        for (uint32 Index = 0; Index < Header.SectionCount; ++Index)
+        {
+            const FMCPVectorSection& Section = SectionTable[Index];
+            if (Section.Id == Id)
+            {
+                if (Section.Stride != ElementSize || Section.Size != Section.Count * ElementSize
+                    || Section.Offset % MCPVectorFormat::SECTION_ALIGNMENT != 0 || Section.Offset + Section.Size > static_cast<uint64>(FileSize)
+                    || (bExactCount && Section.Count != ExpectedCount))
+                {
+                    return false;
+                }
+                OutSection = &Section;
+                return true;
+            }
+        }
+        return false;
+    };
+
+    const uint64 Nodes = Header.NodeCount;
+    const FMCPVectorSection* VectorsSection = nullptr;
+    const FMCPVectorSection* ScalesSection = nullptr;
+    const FMCPVectorSection* LevelsSection = nullptr;
+    const FMCPVectorSection* FlagsSection = nullptr;
+    const FMCPVectorSection* Links0Section = nullptr;
+    const FMCPVectorSection* UpperOffsetsSection = nullptr;
+    const FMCPVectorSection* UpperLinksSection = nullptr;
+    const FMCPVectorSection* IdsSection = nullptr;
+    const FMCPVectorSection* MetaStartsSection = nullptr;
+    const FMCPVectorSection* MetaPairsSection = nullptr;
+    const FMCPVectorSection* StringOffsetsSection = nullptr;
+    const FMCPVectorSection* StringDataSection = nullptr;
+    if (!FindSection(MCPVectorFormat::Vectors, sizeof(int8), Nodes * Header.Stride, true, VectorsSection)
+        || !FindSection(MCPVectorFormat::Scales, sizeof(float), Nodes, true, ScalesSection)
+        || !FindSection(MCPVectorFormat::Levels, sizeof(uint8), Nodes, true, LevelsSection)
+        || !FindSection(MCPVectorFormat::Flags, sizeof(uint8), Nodes, true, FlagsSection)
+        || !FindSection(MCPVectorFormat::Links0, sizeof(int32), Nodes * (Header.M0 + 1), true, Links0Section)
+        || !FindSection(MCPVectorFormat::UpperOffsets, sizeof(int32), Nodes, true, UpperOffsetsSection)
+        || !FindSection(MCPVectorFormat::UpperLinks, sizeof(int32), 0, false, UpperLinksSection)
+        || !FindSection(MCPVectorFormat::Ids, sizeof(uint32), Nodes, true, IdsSection)
+        || !FindSection(MCPVectorFormat::MetaStarts, sizeof(uint32), Nodes + 1, true, MetaStartsSection)
+        || !FindSection(MCPVectorFormat::MetaPairs, sizeof(uint32), 0, false, MetaPairsSection)
+        || !FindSection(MCPVectorFormat::StringOffsets, sizeof(uint32), static_cast<uint64>(Header.StringCount) + 1, true, StringOffsetsSection)
+        || !FindSection(MCPVectorFormat::StringData, sizeof(uint8), 0, false, StringDataSection))
+    {
+        OutError = FString::Printf(TEXT("%s has missing or malformed sections"), *Path);
+        return false;
+    }
+
+    auto CopySection = [Base](const FMCPVectorSection* Section, auto& OutArray)
+    {
+        OutArray.SetNumUninitialized(Section->Count);
+        FMemory::Memcpy(OutArray.GetData(), Base + Section->Offset, Section->Size);
+    };
+    CopySection(ScalesSection, Scales);
+    CopySection(LevelsSection, Levels);
+    CopySection(FlagsSection, Flags);
+    CopySection(UpperOffsetsSection, UpperOffsets);
+    CopySection(UpperLinksSection, UpperLinks);
+    CopySection(IdsSection, IdStrings);
+    CopySection(MetaStartsSection, MetaStarts);
+    CopySection(MetaPairsSection, MetaPairs);
+
+    const uint32* StringOffsets = reinterpret_cast<const uint32*>(Base + StringOffsetsSection->Offset);
+    const uint8* StringData = Base + StringDataSection->Offset;
+    Strings.Reserve(Header.StringCount);
+    for (uint32 Index = 0; Index < Header.StringCount; ++Index)
+    {
+        const uint32 Start = StringOffsets[Index];
+        const uint32 End = StringOffsets[Index + 1];
+        if (Start > End || End > StringDataSection->Size)
+        {
+            Reset();
+            OutError = FString::Printf(TEXT("%s has a corrupt string table"), *Path);
+            return false;
+        }
+        const FUTF8ToTCHAR Converter(reinterpret_cast<const ANSICHAR*>(StringData + Start), End - Start);
+        const int32 StringIndex = Strings.Emplace(Converter.Length(), Converter.Get());
+        StringIds.Add(Strings[StringIndex], StringIndex);
+    }
+
+    // Indices into the other sections are checked once here so searches need no bounds checks
+    const int32 StringCount = Strings.Num();
+    bool bValid = MetaStarts[0] == 0 && MetaStarts.Last() * 2 == static_cast<uint32>(MetaPairs.Num())
+        && Header.DeletedCount <= Header.NodeCount
+        && (Nodes == 0
+            ? (Header.EntryPoint == INDEX_NONE && Header.MaxLevel == -1)
+            : (Header.EntryPoint >= 0 && static_cast<uint64>(Header.EntryPoint) < Nodes
+                && Header.MaxLevel >= 0 && Header.MaxLevel <= MCPConstants::VECTOR_INDEX_MAX_LEVEL
+                && Levels[Header.EntryPoint] == Header.MaxLevel));
+    uint32 DeletedNodes = 0;
+    const int32* MappedLinks0 = reinterpret_cast<const int32*>(Base + Links0Section->Offset);
+    for (uint64 Node = 0; Node < Nodes && bValid; ++Node)
+    {
+        const int32 NodeLevel = Levels[Node];
+        DeletedNodes += (Flags[Node] & MCPVectorFormat::Deleted) ? 1 : 0;
+        bValid = IdStrings[Node] >= 0 && IdStrings[Node] < StringCount && MetaStarts[Node] <= MetaStarts[Node + 1]
+            && NodeLevel <= Header.MaxLevel
+            && (NodeLevel == 0 || (UpperOffsets[Node] >= 0 && UpperOffsets[Node] + NodeLevel * static_cast<int64>(Header.M + 1) <= UpperLinks.Num()));
+        const int32* Links = MappedLinks0 + Node * (Header.M0 + 1);
+        bValid = bValid && Links[0] >= 0 && Links[0] <= static_cast<int32>(Header.M0);
+        for (int32 LinkIndex = 1; bValid && LinkIndex <= Links[0]; ++LinkIndex)
+        {
+            bValid = Links[LinkIndex] >= 0 && static_cast<uint64>(Links[LinkIndex]) < Nodes;
+        }
+        for (int32 Level = 1; bValid && Level <= NodeLevel; ++Level)
+        {
+            const int32* UpperList = &UpperLinks[UpperOffsets[Node] + (Level - 1) * (Header.M + 1)];
+            bValid = UpperList[0] >= 0 && UpperList[0] <= static_cast<int32>(Header.M);
+            // A level L list may only point at nodes that have level L lists of their own
+            for (int32 LinkIndex = 1; bValid && LinkIndex <= UpperList[0]; ++LinkIndex)
+            {
+                bValid = UpperList[LinkIndex] >= 0 && static_cast<uint64>(UpperList[LinkIndex]) < Nodes
+                    && Levels[UpperList[LinkIndex]] >= Level;
+            }
+        }
+    }
+    bValid = bValid && DeletedNodes == Header.DeletedCount;
+    for (int32 Index = 0; Index < MetaPairs.Num() && bValid; ++Index)
+    {
+        bValid = MetaPairs[Index] < static_cast<uint32>(StringCount);
+    }
+    if (!bValid)
+    {
+        Reset();
+        OutError = FString::Printf(TEXT("%s has out-of-range node, link or string indices"), *Path);
+        return false;
+    }
+
+    Dimension = Header.Dimension;
+    Stride = Header.Stride;
+    M = Header.M;
+    M0 = Header.M0;
+    NodeCount = Header.NodeCount;
+    DeletedCount = Header.DeletedCount;
+    EntryPoint = Header.EntryPoint;
+    MaxLevel = Header.MaxLevel;
+
+    for (int32 Node = 0; Node < NodeCount; ++Node)
+    {
+        if (IsLive(Node))
+        {
+            NodeByIdString.Add(IdStrings[Node], Node);
+        }
+        for (uint32 Pair = MetaStarts[Node]; Pair < MetaStarts[Node + 1]; ++Pair)
+        {
+            MetaPostings.FindOrAdd(MakeMetaKey(MetaPairs[2 * Pair], MetaPairs[2 * Pair + 1])).Add(Node);
+        }
+    }
+    VisitMarks.SetNumZeroed(NodeCount);
+
+    Vectors = reinterpret_cast<const int8*>(Base + VectorsSection->Offset);
+    Links0 = MappedLinks0;
+    MappedFile = MoveTemp(File);
+    MappedRegion = MoveTemp(Region);
+    bDirty = false;
+    return true;
+}
+
+//
+// FMCPVectorStore
+//
+FMCPVectorStore& FMCPVectorStore::Get()
+{
+    static FMCPVectorStore Instance;
+    return Instance;
+}
+
+bool FMCPVectorStore::IsValidName(const FString& Name)
+{
+    if (Name.IsEmpty() || Name.Len() > 64)
+    {
+        return false;
+    }
+    for (const TCHAR Char : Name)
+    {
+        if (!FChar::IsAlnum(Char) && Char != TEXT('_') && Char != TEXT('-'))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+FString FMCPVectorStore::GetPath(const FString& Name)
+{
+    return FPaths::ConvertRelativePathToFull(FPaths::ProjectSavedDir() / MCPConstants::VECTOR_INDEX_DIR_NAME / Name + MCPVectorFormat::FILE_EXTENSION);
+}
+
+FMCPVectorIndex* FMCPVectorStore::Find(const FString& Name, bool bCreate, FString& OutError)
+{
+    if (!IsValidName(Name))
+    {
+        OutError = FString::Printf(TEXT("Invalid index name '%s'; use up to 64 letters, digits, '_' or '-'"), *Name);
+        return nullptr;
+    }
+    if (TUniquePtr<FMCPVectorIndex>* Loaded = Indexes.Find(Name))
+    {
+        return Loaded->Get();
+    }
+
+    TUniquePtr<FMCPVectorIndex> Index = MakeUnique<FMCPVectorIndex>(Name);
+    const FString Path = GetPath(Name);
+    if (IFileManager::Get().FileExists(*Path))
+    {
+        const double StartTime = FPlatformTime::Seconds();
+        if (!Index->Load(Path, OutError))
+        {
+            MCP_LOG_WARNING("Could not open vector index %s: %s", *Name, *OutError);
+            return nullptr;
+        }
+        MCP_LOG_INFO("Opened vector index %s with %d entries in %.1f ms", *Name, Index->Num(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+    }
+    else if (!bCreate)
+    {
+        OutError = FString::Printf(TEXT("No vector index named '%s'"), *Name);
+        return nullptr;
+    }
+
+    return Indexes.Add(Name, MoveTemp(Index)).Get();
+}
+
+bool FMCPVectorStore::Save(const FString& Name, FString& OutError)
+{
+    TUniquePtr<FMCPVectorIndex>* Index = Indexes.Find(Name);
+    if (!Index)
+    {
+        OutError = FString::Printf(TEXT("Vector index '%s' is not loaded"), *Name);
+        return false;
+    }
+    return (*Index)->Save(GetPath(Name), OutError);
+}
+
+bool FMCPVectorStore::Drop(const FString& Name, bool bDeleteFile)
+{
+    const bool bWasLoaded = Indexes.Remove(Name) > 0;
+    const FString Path = GetPath(Name);
+    const bool bHadFile = IsValidName(Name) && IFileManager::Get().FileExists(*Path);
+    if (bDeleteFile && bHadFile)
+    {
+        IFileManager::Get().Delete(*Path);
+    }
+    return bWasLoaded || bHadFile;
+}
+
+TArray<FString> FMCPVectorStore::GetNames() const
+{
+    TArray<FString> Names;
+    Indexes.GetKeys(Names);
+
+    TArray<FString> Files;
+    IFileManager::Get().FindFiles(Files, *(FPaths::ProjectSavedDir() / MCPConstants::VECTOR_INDEX_DIR_NAME / TEXT("*") + MCPVectorFormat::FILE_EXTENSION), true, false);
+    for (const FString& File : Files)
+    {
+        Names.AddUnique(FPaths::GetBaseFilename(File));
+    }
+    Names.Sort();
+    return Names;
+}
+
+const FMCPVectorIndex* FMCPVectorStore::FindLoaded(const FString& Name) const
+{
+    const TUniquePtr<FMCPVectorIndex>* Index = Indexes.Find(Name);
+    return Index ? Index->Get() : nullptr;
+}
+
+void FMCPVectorStore::Shutdown()
+{
+    for (TPair<FString, TUniquePtr<FMCPVectorIndex>>& Index : Indexes)
+    {
+        if (Index.Value->IsDirty())
+        {
+            FString Error;
+            if (!Index.Value->Save(GetPath(Index.Key), Error))
+            {
+                MCP_LOG_WARNING("Could not save vector index %s: %s", *Index.Key, *Error);
+            }
+        }
+    }
+    Indexes.Empty();
+}
@@ -0,0 +1,196 @@
+#include "MCPWorldPartition.h"
+
+#include "Engine/World.h"
+#include "Containers/Ticker.h"
+#include "WorldPartition/WorldPartition.h"
+#include "WorldPartition/WorldPartitionHelpers.h"
+#include "WorldPartition/WorldPartitionActorDesc.h"
+#include "WorldPartition/WorldPartitionActorDescInstance.h"
+#include "WorldPartition/WorldPartitionEditorLoaderAdapter.h"
+#include "WorldPartition/LoaderAdapter/LoaderAdapterShape.h"
+#include "MCPFileLogger.h"
+#include "MCPSceneSnapshot.h"
+
+FMCPWorldPartition& FMCPWorldPartition::Get()
+{
+    static FMCPWorldPartition Instance;
+    return Instance;
+}
+
+int32 FMCPWorldPartition::CollectActorDescs(UWorld* World, const FMCPActorDescQuery& Query, TArray<FMCPActorDescRecord>& OutRecords)
+{
+    check(IsInGameThread());
+
+    OutRecords.Reset();
+    UWorldPartition* WorldPartition = World ? World->GetWorldPartition() : nullptr;
+    if (!WorldPartition)
+    {
+        return INDEX_NONE;
+    }
+
+    int32 TotalCount = 0;
+
+    // Descriptors come from every container the partition has registered (main map, content bundles,
+    // external data layers), and are read from their cached metadata, so no actor is loaded
+    FWorldPartitionHelpers::ForEachActorDescInstance(WorldPartition, [&Query, &OutRecords, &TotalCount](const FWorldPartitionActorDescInstance* Desc)
+    {
+        if (Query.bUnloadedOnly && Desc->IsLoaded())
+        {
+            return true;
+        }
+
+        // Cheapest predicates first; strings are only built for descriptors that pass the bounds tests
+        const FBox Bounds = Desc->GetEditorBounds();
+        if (Query.Intersects.IsValid && !(Bounds.IsValid && Bounds.Intersect(Query.Intersects)))
+        {
+            return true;
+        }
+
+        const TArray<FName> DataLayers = Desc->GetDataLayerInstanceNames().ToArray();
+        if (Query.DataLayers.Num() > 0 && !DataLayers.ContainsByPredicate([&Query](const FName& DataLayer) { return Query.DataLayers.Contains(DataLayer); }))
+        {
+            return true;
+        }
+
+        const FName Name = Desc->GetActorName();
+        const FString Label = Desc->GetActorLabel().ToString();
+        const FString Folder = Desc->GetActorDesc()->GetFolderPath().ToString();
+        if (Query.Filter && !Query.Filter->MatchesFields(Desc->GetActorNativeClass(), Desc->GetBaseClass(), Name, Label, Folder, Bounds.GetCenter()))
+        {
+            return true;
+        }
+
+        TotalCount++;
+        if (OutRecords.Num() < Query.MaxRecords)
+        {
+            FMCPActorDescRecord& Record = OutRecords.AddDefaulted_GetRef();
+            Record.Guid = Desc->GetGuid();
+            Record.Name = Name;
+            Record.Label = Label;
+            Record.NativeClass = Desc->GetActorNativeClass();
+            if (Desc->GetBaseClass().IsValid())
+            {
+                Record.BaseClass = Desc->GetBaseClass().ToString();
+            }
+            Record.Folder = Folder;
+            Record.Bounds = Bounds;
+            Record.DataLayers = DataLayers;
+            Record.bLoaded = Desc->IsLoaded();
+        }
+        return true;
+    });
+
+    return TotalCount;
+}
+
+FString FMCPWorldPartition::LoadRegion(UWorld* World, const FBox& Bounds, bool bWait, FString& OutError)
+{
+    check(IsInGameThread());
+
+    UWorldPartition* WorldPartition = World ? World->GetWorldPartition() : nullptr;
+    if (!WorldPartition)
+    {
+        OutError = TEXT("The editor world does not use World Partition");
+        return FString();
+    }
+
+    // The same loader the editor creates for "Load Region From Selection"; it shows in the World Partition editor
+    UWorldPartitionEditorLoaderAdapter* Adapter = WorldPartition->CreateEditorLoaderAdapter<FLoaderAdapterShape>(World, Bounds, TEXT("MCP Region"));
+    if (!Adapter || !Adapter->GetLoaderAdapter())
+    {
+        OutError = TEXT("Failed to create a loader for the region");
+        return FString();
+    }
+    Adapter->GetLoaderAdapter()->SetUserCreated(true);
+
+    FMCPLoadedRegion Region;
+    Region.Id = FString::Printf(TEXT("region_%d"), NextRegionNumber++);
+    Region.Bounds = Bounds;
+    Region.World = World;
+    Region.Adapter = Adapter;
+    const FString Id = Region.Id;
+    Regions.Add(Id, MoveTemp(Region));
+
+    if (bWait)
+    {
+        FinishLoad(Id);
+    }
+    else
+    {
+        // Loading can take seconds on large maps, so it runs on the next tick after the response is sent
+        FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([Id](float DeltaTime)
+        {
+            FMCPWorldPartition::Get().FinishLoad(Id);
+            return false;
+        }));
+    }
+
+    return Id;
+}
+
+void FMCPWorldPartition::FinishLoad(const FString& Id)
+{
+    // The region may have been unloaded before its deferred load ran
+    FMCPLoadedRegion* Region = Regions.Find(Id);
+    if (!Region || Region->bLoaded || !Region->Adapter.IsValid())
+    {
+        return;
+    }
+
+    const double StartTime = FPlatformTime::Seconds();
+    Region->Adapter->GetLoaderAdapter()->Load();
+    Region->bLoaded = true;
+
+    MCP_LOG_INFO("Loaded World Partition region %s in %.1f ms", *Id, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+}
+
+bool FMCPWorldPartition::UnloadRegion(const FString& Id)
+{
+    check(IsInGameThread());
+
+    FMCPLoadedRegion Region;
+    if (!Regions.RemoveAndCopyValue(Id, Region))
+    {
+        return false;
+    }
+
+    UWorldPartitionEditorLoaderAdapter* Adapter = Region.Adapter.Get();
+    UWorld* World = Region.World.Get();
+    if (Adapter && World && World->GetWorldPartition())
+    {
+        if (Region.bLoaded)
+        {
+            Adapter->GetLoaderAdapter()->Unload();
+        }
+        World->GetWorldPartition()->ReleaseEditorLoaderAdapter(Adapter);
+    }
+
+    MCP_LOG_INFO("Unloaded World Partition region %s", *Id);
+    return true;
+}
+
+void FMCPWorldPartition::UnloadAllRegions()
+{
+    TArray<FString> Ids;
+    Regions.GenerateKeyArray(Ids);
+    for (const FString& Id : Ids)
+    {
+        UnloadRegion(Id);
+    }
+}
+
+TArray<FMCPLoadedRegion> FMCPWorldPartition::GetRegions()
+{
+    // Loaders die with their world, so regions of a closed map are simply forgotten
+    for (auto It = Regions.CreateIterator(); It; ++It)
+    {
+        if (!It->Value.World.IsValid() || !It->Value.Adapter.IsValid())
+        {
+            It.RemoveCurrent();
+        }
+    }
+
+    TArray<FMCPLoadedRegion> Result;
+    Regions.GenerateValueArray(Result);
+    return Result;
+}
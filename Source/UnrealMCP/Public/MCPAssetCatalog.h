@@ -0,0 +1,258 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetRegistry/AssetData.h"
+#include "Async/Future.h"
+#include "Containers/Ticker.h"
+
+/**
+ * Selection of catalog assets; all set predicates must match, an empty query matches every asset
+ */
+struct FMCPAssetQuery
+{
+    /** Asset classes, e.g. /Script/Engine.StaticMesh */
+    TArray<FTopLevelAssetPath> ClassPaths;
+
+    /** Also match classes derived from ClassPaths, including blueprint classes */
+    bool bIncludeSubclasses = false;
+
+    /** Package path roots, e.g. /Game/Props */
+    TArray<FName> PackagePaths;
+
+    /** Also match assets in folders below PackagePaths */
+    bool bRecursivePaths = true;
+};
+
+/** Fired with the slot index of an asset added to or removed from the catalog */
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnMCPAssetCatalogSlotChanged, int32 /* Index */);
+
+/**
+ * Orders of catalog query results
+ */
+enum class EMCPAssetSort : uint8
+{
+    /** Slot order */
+    None,
+    /** Asset name, then package */
+    Name,
+    /** Package path, then asset name */
+    Path,
+    /** Package size on disk */
+    Size,
+    /** Package file modification time */
+    Modified
+};
+
+/**
+ * A sorted query result kept so it can be paged while the catalog changes underneath
+ */
+struct FMCPAssetResultSet
+{
+    FString Id;
+
+    /** Matching assets in result order; assets removed since the query are skipped when paged */
+    TArray<FSoftObjectPath> Assets;
+
+    EMCPAssetSort SortBy = EMCPAssetSort::None;
+
+    /** Catalog version the result was computed at */
+    uint64 Version = 0;
+};
+
+/**
+ * Server-owned copy of the asset registry with class and folder indexes
+ *
+ * The catalog is filled once, after the registry's initial scan, from a single snapshot of the registry;
+ * the indexes are built on a worker thread so the editor keeps running. From then on it follows the
+ * registry's added, removed, renamed and updated events, so queries never rescan the project. Events that
+ * arrive while the background build runs are queued and replayed onto the finished tables.
+ *
+ * Assets keep their slot index for as long as they exist, so indices can be held across queries; removed
+ * slots are reused. Only touched on the game thread.
+ */
+class UNREALMCP_API FMCPAssetCatalog
+{
+public:
+    static FMCPAssetCatalog& Get();
+
+    /**
+     * Follow the asset registry and start the background build once its initial scan has finished
+     */
+    void Initialize();
+
+    /**
+     * Stop following the registry and drop the tables
+     */
+    void Shutdown();
+
+    /** @return True once the tables are built */
+    bool IsReady() const { return Tables.IsValid(); }
+
+    /** @return True while the registry is still discovering assets; the catalog then lacks what it has not found yet */
+    bool IsScanning() const;
+
+    /**
+     * Make the tables available, waiting for a running build or building from the registry's current state
+     */
+    void EnsureReady();
+
+    /** @return Counter bumped by every change to the tables */
+    uint64 GetVersion() const { return Version; }
+
+    /** @return Number of assets in the catalog */
+    int32 Num() const;
+
+    /** @return Number of slots, live or free; valid indices are below it */
+    int32 GetSlotCount() const;
+
+    /**
+     * Look up an asset by slot
+     * @param Index - Slot index from Query or Find
+     * @return The asset, or null for a free slot
+     */
+    const FAssetData* GetAsset(int32 Index) const;
+
+    /**
+     * Look up an asset by object path
+     * @param ObjectPath - e.g. /Game/Props/SM_Chair.SM_Chair
+     * @return The slot index, or INDEX_NONE
+     */
+    int32 Find(const FSoftObjectPath& ObjectPath) const;
+
+    /**
+     * Select assets through the class and folder indexes
+     * @param Query - The predicates
+     * @param OutIndices - Matching slot indices in ascending order
+     */
+    void Query(const FMCPAssetQuery& Query, TArray<int32>& OutIndices) const;
+
+    /**
+     * Order query results; size and modification time are read once per asset and cached until it changes
+     * @param Indices - Slot indices to sort in place
+     * @param SortBy - The key
+     * @param bDescending - Largest, latest or last first
+     */
+    void Sort(TArray<int32>& Indices, EMCPAssetSort SortBy, bool bDescending);
+
+    /** @return Package size on disk, or -1 if not read yet by a size sort */
+    int64 GetPackageSize(int32 Index) const;
+
+    /** @return Package file modification time, or FDateTime::MinValue() if not read yet by a modified sort */
+    FDateTime GetModifiedTime(int32 Index) const;
+
+    /**
+     * Keep a sorted result for paging; the oldest result is dropped past MAX_ASSET_RESULT_SETS
+     * @param Indices - Slot indices in result order
+     * @param SortBy - The order they are in
+     * @return The stored result
+     */
+    const FMCPAssetResultSet& StoreResultSet(const TArray<int32>& Indices, EMCPAssetSort SortBy);
+
+    /** @return A stored result, or null if unknown or dropped */
+    const FMCPAssetResultSet* FindResultSet(const FString& Id) const;
+
+    /** @return Fired after an asset is added; an updated or renamed asset is removed and added again */
+    FOnMCPAssetCatalogSlotChanged& OnAssetAdded() { return AssetAddedEvent; }
+
+    /** @return Fired after an asset is removed; its slot is already free */
+    FOnMCPAssetCatalogSlotChanged& OnAssetRemoved() { return AssetRemovedEvent; }
+
+    /** @return Fired when the tables are replaced by a build; every slot index is new */
+    FSimpleMulticastDelegate& OnRebuilt() { return RebuiltEvent; }
+
+private:
+    FMCPAssetCatalog() = default;
+
+    // Make non-copyable
+    FMCPAssetCatalog(const FMCPAssetCatalog&) = delete;
+    FMCPAssetCatalog& operator=(const FMCPAssetCatalog&) = delete;
+
+    /** Assets plus the indexes over them */
+    struct FTables
+    {
+        TArray<FAssetData> Assets;
+        TArray<int32> FreeSlots;
+        TMap<FSoftObjectPath, int32> ByObjectPath;
+        TMap<FTopLevelAssetPath, TSet<int32>> ByClass;
+
+        /** Slots by the folder directly containing the package */
+        TMap<FName, TSet<int32>> ByFolder;
+
+        /** Per-slot sort keys, -1 until first read */
+        TArray<int64> PackageSizes;
+        TArray<int64> ModifiedTicks;
+
+        /** Add an asset, or replace the asset with the same object path; returns its slot */
+        int32 Add(const FAssetData& AssetData);
+
+        /** Remove an asset; returns the freed slot, or INDEX_NONE if it was not in the tables */
+        int32 Remove(const FSoftObjectPath& ObjectPath);
+    };
+
+    enum class EEventType : uint8
+    {
+        Added,
+        Removed,
+        Renamed,
+        Updated
+    };
+
+    /** A registry event queued during the background build */
+    struct FPendingEvent
+    {
+        EEventType Type;
+        FAssetData AssetData;
+        FSoftObjectPath OldObjectPath;
+    };
+
+    /** Snapshot the registry and index it on a worker thread */
+    void StartBuild();
+
+    /** Swap in the built tables and replay queued events */
+    void FinishBuild();
+
+    bool TickBuild(float DeltaTime);
+
+    /**
+     * Apply a registry event to the tables
+     * @param Event - The event
+     * @param bBroadcast - Tell listeners about the slots it changed
+     */
+    void ApplyEvent(const FPendingEvent& Event, bool bBroadcast);
+
+    void HandleFilesLoaded();
+    void HandleAssetAdded(const FAssetData& AssetData);
+    void HandleAssetRemoved(const FAssetData& AssetData);
+    void HandleAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath);
+    void HandleAssetUpdated(const FAssetData& AssetData);
+
+    /** Route an event to the tables, or to the queue while a build runs */
+    void OnEvent(FPendingEvent&& Event);
+
+    TUniquePtr<FTables> Tables;
+
+    /** The running background build */
+    TFuture<TUniquePtr<FTables>> BuildFuture;
+    bool bBuilding = false;
+    double BuildStartTime = 0.0;
+
+    TArray<FPendingEvent> PendingEvents;
+
+    /** Stored results, oldest first */
+    TArray<FMCPAssetResultSet> ResultSets;
+    int32 NextResultSetNumber = 1;
+
+    uint64 Version = 0;
+    bool bInitialized = false;
+
+    FOnMCPAssetCatalogSlotChanged AssetAddedEvent;
+    FOnMCPAssetCatalogSlotChanged AssetRemovedEvent;
+    FSimpleMulticastDelegate RebuiltEvent;
+
+    FTSTicker::FDelegateHandle BuildTickerHandle;
+    FDelegateHandle FilesLoadedHandle;
+    FDelegateHandle AssetAddedHandle;
+    FDelegateHandle AssetRemovedHandle;
+    FDelegateHandle AssetRenamedHandle;
+    FDelegateHandle AssetUpdatedHandle;
+};
@@ -0,0 +1,196 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MCPConstants.h"
+
+class IAssetRegistry;
+
+/**
+ * Kinds of package reference, as bits; one edge can carry several
+ */
+namespace EMCPDependencyFlags
+{
+    constexpr uint8 Hard = 1;         // Loaded with the referencing package
+    constexpr uint8 Soft = 2;         // Soft object path or other reference loaded on demand
+    constexpr uint8 Manage = 4;       // Managed by one of the package's primary assets (bundles, chunking)
+    constexpr uint8 EditorOnly = 8;   // Only used in the editor; absent from cooked builds
+}
+
+/**
+ * A traversal of the package reference graph
+ */
+struct FMCPDependencyQuery
+{
+    /** Packages to start from; they are not part of the result */
+    TArray<int32> Roots;
+
+    /** Follow referencers instead of dependencies */
+    bool bReverse = false;
+
+    /** Edges followed from a root, 0 for the whole closure */
+    int32 MaxDepth = 1;
+
+    /** EMCPDependencyFlags kinds an edge needs one of to be followed */
+    uint8 Kinds = EMCPDependencyFlags::Hard | EMCPDependencyFlags::Soft;
+
+    /** Follow editor-only edges too */
+    bool bIncludeEditorOnly = true;
+};
+
+/**
+ * A package reached by a traversal
+ */
+struct FMCPDependencyHit
+{
+    int32 Node = INDEX_NONE;
+
+    /** Edges from the nearest root */
+    int32 Depth = 0;
+
+    /** The package it was first reached from */
+    int32 Via = INDEX_NONE;
+
+    /** EMCPDependencyFlags of the edge it was reached through */
+    uint8 Flags = 0;
+};
+
+/**
+ * Package dependency graph from the asset registry, kept as forward and reverse compressed sparse rows
+ *
+ * Built on first use: every package in the asset catalog is asked for its dependencies in parallel, and
+ * each direction's edges are laid out as flat target and flag arrays indexed by per-node row offsets, so
+ * a transitive traversal is a breadth-first walk over contiguous memory with no hashing.
+ *
+ * Packages changed afterwards, which the catalog reports as asset events, are re-read lazily before the
+ * next query and kept in a small overlay that replaces their rows; reverse rows skip overridden sources
+ * and add the overlay's edges. Once the overlay grows past a share of the graph, both rows are rebuilt
+ * from the current edges without asking the registry again.
+ *
+ * Packages referenced but not in the catalog, such as /Script packages or deleted assets, are nodes with
+ * no dependencies of their own. Only touched on the game thread.
+ */
+class UNREALMCP_API FMCPAssetDependencyGraph
+{
+public:
+    static FMCPAssetDependencyGraph& Get();
+
+    /**
+     * Follow the asset catalog's changes
+     */
+    void Initialize();
+
+    /**
+     * Stop following the catalog and drop the graph
+     */
+    void Shutdown();
+
+    /**
+     * Build the graph if needed and re-read packages changed since the last query
+     * @return True if the graph was built or its rows rebuilt by this call
+     */
+    bool EnsureCurrent();
+
+    /**
+     * Walk the graph breadth first
+     * @param Query - Start packages, direction, depth and edge kinds
+     * @param OutHits - Reached packages, nearest first
+     * @return Greatest depth reached
+     */
+    int32 Traverse(const FMCPDependencyQuery& Query, TArray<FMCPDependencyHit>& OutHits);
+
+    /** @return Node of a package, or INDEX_NONE if no package references it and it is not in the catalog */
+    int32 FindPackage(FName PackageName) const;
+
+    /** @return Package name of a node */
+    FName GetPackage(int32 Node) const { return Packages[Node]; }
+
+    /** @return Number of catalog assets in a package; 0 for script packages and missing ones */
+    int32 GetAssetCount(int32 Node) const { return AssetCounts[Node]; }
+
+    int32 GetNodeCount() const { return Packages.Num(); }
+
+    /** @return Edges in the rows plus the overlay */
+    int32 GetEdgeCount() const;
+
+    /** @return Packages whose edges are held in the overlay */
+    int32 GetOverlayCount() const { return ForwardOverrides.Num(); }
+
+private:
+    FMCPAssetDependencyGraph() = default;
+
+    // Make non-copyable
+    FMCPAssetDependencyGraph(const FMCPAssetDependencyGraph&) = delete;
+    FMCPAssetDependencyGraph& operator=(const FMCPAssetDependencyGraph&) = delete;
+
+    /** An edge to, or in reverse rows from, another node */
+    struct FEdge
+    {
+        int32 Node;
+        uint8 Flags;
+    };
+
+    /**
+     * Ask the asset registry for a package's dependencies; safe to call from worker threads
+     * @param AssetRegistry - The registry, looked up on the game thread
+     * @param PackageName - The package
+     * @param OutDependencies - Referenced packages with EMCPDependencyFlags
+     */
+    static void ReadDependencies(const IAssetRegistry& AssetRegistry, FName PackageName, TArray<TPair<FName, uint8>>& OutDependencies);
+
+    int32 FindOrAddNode(FName PackageName);
+
+    /** Read the dependencies of packages and resolve them to edges, adding nodes for new targets */
+    void ReadEdges(const TArray<int32>& Nodes, TArray<TArray<FEdge>>& OutEdges);
+
+    /** Lay out the rows from per-node edge lists and clear the overlay */
+    void BuildRows(TArray<TArray<FEdge>>& Edges);
+
+    /** Replace a node's edges through the overlay */
+    void SetOverride(int32 Node, TArray<FEdge>&& Edges);
+
+    /** Call a function with the node and flags of every current edge of a node */
+    template <typename FunctionType>
+    void ForEachEdge(int32 Node, bool bReverse, FunctionType&& Function) const;
+
+    void Build();
+    void Reset();
+    void HandleAssetAdded(int32 Index);
+    void HandleAssetRemoved(int32 Index);
+    void HandleCatalogRebuilt();
+
+    TArray<FName> Packages;
+    TMap<FName, int32> NodeByPackage;
+    TArray<int32> AssetCounts;
+
+    /** Nodes covered by the rows; nodes added later have edges only in the overlay */
+    int32 RowNodeCount = 0;
+
+    TArray<int32> ForwardOffsets;
+    TArray<int32> ForwardTargets;
+    TArray<uint8> ForwardFlags;
+    TArray<int32> ReverseOffsets;
+    TArray<int32> ReverseSources;
+    TArray<uint8> ReverseFlags;
+
+    /** Overlay: replacement edges of changed nodes, and the same edges reversed */
+    TMap<int32, TArray<FEdge>> ForwardOverrides;
+    TMap<int32, TArray<FEdge>> ReverseAdditions;
+    TBitArray<> Overridden;
+
+    /** Package of every catalog slot, kept because a removed slot's asset is already gone */
+    TArray<FName> SlotPackages;
+
+    /** Packages changed since the last query */
+    TSet<FName> PendingPackages;
+
+    /** Visit marks of the running traversal; a node is visited if its mark equals VisitEpoch */
+    TArray<uint32> VisitMarks;
+    uint32 VisitEpoch = 0;
+
+    bool bBuilt = false;
+    bool bInitialized = false;
+
+    FDelegateHandle AssetAddedHandle;
+    FDelegateHandle AssetRemovedHandle;
+    FDelegateHandle RebuiltHandle;
+};
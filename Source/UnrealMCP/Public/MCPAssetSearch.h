@@ -0,0 +1,152 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MCPConstants.h"
+
+/**
+ * Parts of an asset a search term can match, as bits
+ */
+namespace EMCPAssetSearchField
+{
+    constexpr uint8 Name = 1;
+    constexpr uint8 Path = 2;
+    constexpr uint8 Tags = 4;
+}
+
+/**
+ * Options for a fuzzy asset search
+ */
+struct FMCPAssetSearchOptions
+{
+    int32 MaxResults = MCPConstants::DEFAULT_ASSET_SEARCH_RESULTS;
+
+    /** Fraction of the query's trigrams an asset must contain; lower tolerates more typos */
+    float MinMatch = MCPConstants::DEFAULT_ASSET_SEARCH_MIN_MATCH;
+
+    /** Catalog slots allowed in the result, or null for all */
+    const TBitArray<>* AllowedSlots = nullptr;
+};
+
+/**
+ * One search result
+ */
+struct FMCPAssetSearchHit
+{
+    /** Catalog slot of the asset */
+    int32 Index = INDEX_NONE;
+
+    /** Relevance between 0 and 1 */
+    float Score = 0.0f;
+
+    /** EMCPAssetSearchField bits of the parts that matched */
+    uint8 MatchedFields = 0;
+};
+
+/**
+ * Trigram inverted index over the asset catalog for ranked fuzzy search
+ *
+ * Asset names, package paths, class names and short registry tag values are split into words at
+ * separators, case changes and digits; every lowercased word contributes the trigrams of itself padded
+ * with a space on each side. A query is split the same way, and an asset scores by how many of the
+ * query's trigrams it contains, mostly in its name: a typo only costs the three trigrams around it,
+ * so "wodden chiar" still finds SM_WoodenChair.
+ *
+ * Posting lists are kept per trigram, sorted by slot, and follow the catalog's slot events through binary
+ * search, so the index never rebuilds after the first time. Only touched on the game thread.
+ */
+class UNREALMCP_API FMCPAssetSearchIndex
+{
+public:
+    static FMCPAssetSearchIndex& Get();
+
+    /**
+     * Follow the asset catalog and build once it is ready
+     */
+    void Initialize();
+
+    /**
+     * Stop following the catalog and drop the index
+     */
+    void Shutdown();
+
+    /**
+     * Build the index from the catalog if it has not been built since the catalog's last build
+     */
+    void EnsureBuilt();
+
+    /**
+     * Find the assets best matching a free-text query
+     * @param Query - Words or fragments, e.g. "wooden chair" or "SM_Rock_03"
+     * @param Options - Result count, match threshold and slot filter
+     * @param OutHits - Best hits first
+     * @return Number of assets that passed the threshold, of which OutHits holds the best
+     */
+    int32 Search(const FString& Query, const FMCPAssetSearchOptions& Options, TArray<FMCPAssetSearchHit>& OutHits);
+
+    /** @return Number of distinct trigrams indexed */
+    int32 GetTrigramCount() const { return Postings.Num(); }
+
+    /**
+     * Split text into words and collect the distinct trigrams of the padded, lowercased words
+     * @param Text - The text
+     * @param OutTrigrams - Appended trigrams, three 21-bit characters each
+     */
+    static void ExtractTrigrams(const FString& Text, TArray<uint64>& OutTrigrams);
+
+private:
+    FMCPAssetSearchIndex() = default;
+
+    // Make non-copyable
+    FMCPAssetSearchIndex(const FMCPAssetSearchIndex&) = delete;
+    FMCPAssetSearchIndex& operator=(const FMCPAssetSearchIndex&) = delete;
+
+    /** Trigrams of one catalog slot, kept so the slot can be taken out of the posting lists */
+    struct FSlot
+    {
+        /** Distinct trigrams, each with the EMCPAssetSearchField bits it occurs in */
+        TArray<TPair<uint64, uint8>> Trigrams;
+
+        /** Distinct trigrams in the asset name */
+        int32 NameTrigramCount = 0;
+    };
+
+    /** Per-slot match counters of a running search */
+    struct FAccumulator
+    {
+        uint16 Hits = 0;
+        uint16 NameHits = 0;
+        float Weight = 0.0f;
+        uint8 Fields = 0;
+    };
+
+    /**
+     * Collect the trigrams of a catalog asset
+     * @param Index - Catalog slot
+     * @param OutSlot - The trigrams
+     */
+    static void ExtractSlot(int32 Index, FSlot& OutSlot);
+
+    void AddToPostings(int32 Index);
+    void RemoveFromPostings(int32 Index);
+
+    void Build();
+    void HandleAssetAdded(int32 Index);
+    void HandleAssetRemoved(int32 Index);
+    void HandleCatalogRebuilt();
+
+    /** Slots by trigram in ascending order, each entry the slot index shifted left by 3 with the field bits below */
+    TMap<uint64, TArray<uint32>> Postings;
+
+    TArray<FSlot> Slots;
+
+    /** Search scratch, sized to the slot count and reset after every search */
+    TArray<FAccumulator> Accumulators;
+    TArray<int32> Touched;
+
+    bool bBuilt = false;
+    bool bInitialized = false;
+
+    FDelegateHandle AssetAddedHandle;
+    FDelegateHandle AssetRemovedHandle;
+    FDelegateHandle RebuiltHandle;
+};
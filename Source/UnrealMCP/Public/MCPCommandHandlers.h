@@ -5,6 +5,8 @@
 #include "Engine/World.h"
 #include "Engine/StaticMeshActor.h"
 #include "Components/StaticMeshComponent.h"
+#include "MCPSceneSnapshot.h"
+#include "MCPAssetCatalog.h"
 
 /**
  * Base class for MCP command handlers
@@ -82,6 +84,19 @@ public:
      * @return JSON response object
      */
     virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket) override;
+
+    /** Column descriptions, ids and transforms are kept before bounds and labels */
+    virtual TArray<FString> GetFieldPriorities() const override;
+
+protected:
+    /**
+     * Build the columnar response: one ids array plus base64 packed transform and bounds columns
+     * @param World - The world to read actors from
+     * @param Params - The command parameters (quantize, include_bounds, include_labels)
+     * @param Filter - Selects the actors to return
+     * @return JSON response object
+     */
+    TSharedPtr<FJsonObject> ExecuteColumnar(UWorld* World, const TSharedPtr<FJsonObject>& Params, const FMCPActorFilter& Filter);
 };
 
 /**
@@ -102,6 +117,94 @@ public:
      * @return JSON response object
      */
     virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket) override;
+
+    /**
+     * Read an asset query
+     * @param Params - The command parameters (type, classes, include_subclasses, paths, recursive, sort, descending)
+     * @param OutQuery - The catalog query
+     * @param OutSortBy - Result order
+     * @param bOutDescending - Reverse the order
+     * @param OutError - Why the parameters are invalid
+     * @return False on invalid parameters
+     */
+    static bool ParseQuery(const TSharedPtr<FJsonObject>& Params, FMCPAssetQuery& OutQuery, EMCPAssetSort& OutSortBy, bool& bOutDescending, FString& OutError);
+
+protected:
+    /**
+     * Add fields that need the asset in memory, loading the assets synchronously in parallel batches
+     * @param Assets - The assets to describe
+     * @param AssetInfos - JSON object of each asset, filled in place
+     * @param DeepFields - Requested fields: bounds, material_slots, metadata
+     */
+    void AddDeepInfo(const TArray<FAssetData>& Assets, const TArray<TSharedPtr<FJsonObject>>& AssetInfos, const TSet<FString>& DeepFields);
+};
+
+/**
+ * Handler for the search_assets command
+ * Ranks assets by fuzzy match of a free-text query against names, paths and registry tags
+ */
+class FMCPSearchAssetsHandler : public FMCPCommandHandlerBase
+{
+public:
+    FMCPSearchAssetsHandler()
+        : FMCPCommandHandlerBase("search_assets")
+    {
+    }
+
+    /**
+     * Execute the search_assets command
+     * @param Params - The command parameters
+     * @param ClientSocket - The client socket
+     * @return JSON response object
+     */
+    virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket) override;
+};
+
+/**
+ * Handler for the get_asset_dependencies command
+ * Lists the packages assets depend on, transitively up to a depth, from the cached dependency graph
+ */
+class FMCPGetAssetDependenciesHandler : public FMCPCommandHandlerBase
+{
+public:
+    FMCPGetAssetDependenciesHandler()
+        : FMCPGetAssetDependenciesHandler("get_asset_dependencies", false)
+    {
+    }
+
+    /**
+     * Execute the get_asset_dependencies command
+     * @param Params - The command parameters
+     * @param ClientSocket - The client socket
+     * @return JSON response object
+     */
+    virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket) override;
+
+protected:
+    /**
+     * @param InCommandName - The command handled
+     * @param bInReverse - Follow references backwards, to referencers
+     */
+    FMCPGetAssetDependenciesHandler(const FString& InCommandName, bool bInReverse)
+        : FMCPCommandHandlerBase(InCommandName)
+        , bReverse(bInReverse)
+    {
+    }
+
+    bool bReverse;
+};
+
+/**
+ * Handler for the get_asset_referencers command
+ * Lists the packages referencing assets, transitively up to a depth; the same parameters as get_asset_dependencies
+ */
+class FMCPGetAssetReferencersHandler : public FMCPGetAssetDependenciesHandler
+{
+public:
+    FMCPGetAssetReferencersHandler()
+        : FMCPGetAssetDependenciesHandler("get_asset_referencers", true)
+    {
+    }
 };
 
 /**
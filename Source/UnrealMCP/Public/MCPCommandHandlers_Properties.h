@@ -0,0 +1,61 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MCPCommandHandlers.h"
+
+struct FMCPResolvedProperty;
+
+/**
+ * Handler for the get_properties command
+ * Reads reflected property values by dotted path from a set of actors
+ */
+class FMCPGetPropertiesHandler : public FMCPCommandHandlerBase
+{
+public:
+    FMCPGetPropertiesHandler() : FMCPCommandHandlerBase(TEXT("get_properties")) {}
+
+    /**
+     * Execute the get_properties command
+     * @param Params - The command parameters
+     * @param ClientSocket - The client socket
+     * @return JSON response object
+     */
+    virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket) override;
+
+private:
+    /**
+     * Convert a resolved value to JSON
+     * @param Resolved - The resolved property
+     * @return JSON value; structs become objects, enums and object references become strings
+     */
+    static TSharedPtr<FJsonValue> ValueToJson(const FMCPResolvedProperty& Resolved);
+};
+
+/**
+ * Handler for the set_properties command
+ * Applies reflected property values by dotted path to a set of actors in one transaction
+ */
+class FMCPSetPropertiesHandler : public FMCPCommandHandlerBase
+{
+public:
+    FMCPSetPropertiesHandler() : FMCPCommandHandlerBase(TEXT("set_properties")) {}
+
+    /**
+     * Execute the set_properties command
+     * @param Params - The command parameters
+     * @param ClientSocket - The client socket
+     * @return JSON response object
+     */
+    virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket) override;
+
+private:
+    /**
+     * Write a JSON value into a resolved property
+     * Strings are imported as property text, so enums, structs and object paths use their exported form
+     * @param Resolved - The resolved property
+     * @param Value - The value to write
+     * @param OutError - Why the value could not be written
+     * @return True if the value was written
+     */
+    static bool WriteValue(const FMCPResolvedProperty& Resolved, const TSharedPtr<FJsonValue>& Value, FString& OutError);
+};
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CollisionShape.h"
+#include "Engine/EngineTypes.h"
+#include "MCPCommandHandlers.h"
+
+/**
+ * Handler for the trace_batch command
+ * Runs many line traces, shape sweeps and overlaps against the editor world in parallel and returns packed results
+ */
+class FMCPTraceBatchHandler : public FMCPCommandHandlerBase
+{
+public:
+    FMCPTraceBatchHandler() : FMCPCommandHandlerBase(TEXT("trace_batch")) {}
+
+    /**
+     * Execute the trace_batch command
+     * @param Params - The command parameters
+     * @param ClientSocket - The client socket
+     * @return JSON response object
+     */
+    virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket) override;
+
+    /** Hit actors and distances are kept before positions, normals and overlaps */
+    virtual TArray<FString> GetFieldPriorities() const override;
+
+    /**
+     * Map a channel name to a collision channel
+     * @param Name - One of visibility, camera, world_static, world_dynamic, pawn, physics_body, vehicle, destructible
+     * @param OutChannel - The channel
+     * @return True if the name is known
+     */
+    static bool ParseChannel(const FString& Name, ECollisionChannel& OutChannel);
+
+private:
+    /**
+     * Parse a collision shape description
+     * @param ShapeObject - {"type": "sphere" | "box" | "capsule", "radius", "half_extent", "half_height", "rotation"}
+     * @param OutShape - The parsed shape
+     * @param OutRotation - Shape rotation, identity if not given
+     * @param OutError - Why the description was rejected
+     * @return True if the shape is valid
+     */
+    static bool ParseShape(const TSharedPtr<FJsonObject>& ShapeObject, FCollisionShape& OutShape, FQuat& OutRotation, FString& OutError);
+};
+
+/**
+ * Handler for the get_scene_stats command
+ * Returns aggregate scene statistics (classes, triangles, meshes, materials, lights, level bounds) in one small response
+ */
+class FMCPGetSceneStatsHandler : public FMCPCommandHandlerBase
+{
+public:
+    FMCPGetSceneStatsHandler() : FMCPCommandHandlerBase(TEXT("get_scene_stats")) {}
+
+    /**
+     * Execute the get_scene_stats command
+     * @param Params - The command parameters
+     * @param ClientSocket - The client socket
+     * @return JSON response object
+     */
+    virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket) override;
+};
+
+/**
+ * Handler for the query_frustum command
+ * Lists the actors a camera would see, culled on the CPU and sorted by screen coverage
+ */
+class FMCPQueryFrustumHandler : public FMCPCommandHandlerBase
+{
+public:
+    FMCPQueryFrustumHandler() : FMCPCommandHandlerBase(TEXT("query_frustum")) {}
+
+    /**
+     * Execute the query_frustum command
+     * @param Params - The command parameters
+     * @param ClientSocket - The client socket
+     * @return JSON response object
+     */
+    virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket) override;
+};
+
+/**
+ * Handler for the build_occupancy_grid command
+ * Voxelizes the collision geometry of a region into a packed 3D grid and a 2.5D height map for path planning
+ */
+class FMCPBuildOccupancyGridHandler : public FMCPCommandHandlerBase
+{
+public:
+    FMCPBuildOccupancyGridHandler() : FMCPCommandHandlerBase(TEXT("build_occupancy_grid")) {}
+
+    /**
+     * Execute the build_occupancy_grid command
+     * @param Params - The command parameters
+     * @param ClientSocket - The client socket
+     * @return JSON response object
+     */
+    virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket) override;
+};
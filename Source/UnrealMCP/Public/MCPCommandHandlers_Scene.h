@@ -0,0 +1,308 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MCPCommandHandlers.h"
+#include "MCPSceneJournal.h"
+
+class UStaticMesh;
+class UHierarchicalInstancedStaticMeshComponent;
+
+/**
+ * Common utilities for scene operations
+ */
+class FMCPSceneUtils
+{
+public:
+    /**
+     * Find an actor by object name without iterating the world
+     * @param World - The world to search
+     * @param ActorName - The actor's object name
+     * @return The actor, or nullptr if no live actor has that name
+     */
+    static AActor* FindActorByName(UWorld* World, const FName& ActorName);
+
+    /**
+     * Read a list of actor names from a JSON array field
+     * @param Params - The command parameters
+     * @param FieldName - The field holding the names
+     * @param OutNames - The names read
+     * @return True if the field was present
+     */
+    static bool TryGetNameArray(const TSharedPtr<FJsonObject>& Params, const FString& FieldName, TArray<FName>& OutNames);
+
+    /**
+     * Collect the actors a bulk command targets from its 'names' and 'filter' fields
+     * With both given the filter narrows the named set; a missing or empty filter without names is rejected
+     * @param World - The world to search
+     * @param Params - The command parameters
+     * @param OutActors - Targeted actors, each at most once
+     * @param OutMissing - Names that were not found
+     * @param OutError - Why the parameters were rejected
+     * @return False if nothing is selected or the filter is malformed
+     */
+    static bool CollectTargetActors(UWorld* World, const TSharedPtr<FJsonObject>& Params, TArray<AActor*>& OutActors, TArray<TSharedPtr<FJsonValue>>& OutMissing, FString& OutError);
+
+    /**
+     * Load a set of static meshes synchronously: the missing packages are requested as one batch so they
+     * stream in parallel, and the call blocks until all of them are in memory
+     * @param MeshPaths - Unique mesh object paths
+     * @param OutMeshes - Loaded meshes, nullptr where a path failed to load
+     */
+    static void LoadMeshes(const TArray<FString>& MeshPaths, TArray<UStaticMesh*>& OutMeshes);
+
+    /**
+     * Spawn one actor holding a hierarchical instanced static mesh component per mesh
+     * @param World - The world to spawn in
+     * @param Label - Outliner label for the actor
+     * @param Meshes - One mesh per component
+     * @param InstanceTransforms - World-space instance transforms for each mesh
+     * @param OutComponents - The created components, parallel to Meshes
+     * @return The spawned actor, or nullptr on failure
+     */
+    static AActor* SpawnInstancedMeshActor(
+        UWorld* World,
+        const FString& Label,
+        const TArray<UStaticMesh*>& Meshes,
+        const TArray<TArray<FTransform>>& InstanceTransforms,
+        TArray<UHierarchicalInstancedStaticMeshComponent*>& OutComponents);
+
+    /** @return [x, y, z] */
+    static TArray<TSharedPtr<FJsonValue>> MakeVectorArray(const FVector& Vector);
+
+    /** @return [pitch, yaw, roll] */
+    static TArray<TSharedPtr<FJsonValue>> MakeRotatorArray(const FRotator& Rotator);
+};
+
+/**
+ * Handler for the get_scene_changes command
+ * Returns the journal entries recorded after a client-supplied version
+ */
+class FMCPGetSceneChangesHandler : public FMCPCommandHandlerBase
+{
+public:
+    FMCPGetSceneChangesHandler() : FMCPCommandHandlerBase(TEXT("get_scene_changes")) {}
+
+    /**
+     * Execute the get_scene_changes command
+     * @param Params - The command parameters
+     * @param ClientSocket - The client socket
+     * @return JSON response object
+     */
+    virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket) override;
+
+private:
+    /**
+     * Collapse the changes so every actor appears at most once with its final state
+     * @param Changes - Changes in version order
+     * @param OutProperties - Changed property names per actor
+     * @return Coalesced changes in order of each actor's first appearance
+     */
+    TArray<FMCPSceneChange> CoalesceChanges(const TArray<FMCPSceneChange>& Changes, TMap<FName, TArray<FName>>& OutProperties);
+
+    /**
+     * Convert a journal entry to JSON
+     * @param Change - The journal entry
+     * @param Properties - Changed property names for the actor
+     * @return JSON object for the entry
+     */
+    TSharedPtr<FJsonObject> ChangeToJson(const FMCPSceneChange& Change, const TArray<FName>* Properties);
+};
+
+/**
+ * Handler for the modify_objects command
+ * Applies packed transforms to many actors in one transaction
+ */
+class FMCPModifyObjectsHandler : public FMCPCommandHandlerBase
+{
+public:
+    FMCPModifyObjectsHandler() : FMCPCommandHandlerBase(TEXT("modify_objects")) {}
+
+    /**
+     * Execute the modify_objects command
+     * @param Params - The command parameters
+     * @param ClientSocket - The client socket
+     * @return JSON response object
+     */
+    virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket) override;
+};
+
+/**
+ * Handler for the create_objects command
+ * Spawns many static mesh actors, or one instanced component per unique mesh
+ */
+class FMCPCreateObjectsHandler : public FMCPCommandHandlerBase
+{
+public:
+    FMCPCreateObjectsHandler() : FMCPCommandHandlerBase(TEXT("create_objects")) {}
+
+    /**
+     * Execute the create_objects command
+     * @param Params - The command parameters
+     * @param ClientSocket - The client socket
+     * @return JSON response object
+     */
+    virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket) override;
+};
+
+/**
+ * Handler for the scatter command
+ * Places Poisson-disk distributed instances over a region into instanced mesh components
+ */
+class FMCPScatterHandler : public FMCPCommandHandlerBase
+{
+public:
+    FMCPScatterHandler() : FMCPCommandHandlerBase(TEXT("scatter")) {}
+
+    /**
+     * Execute the scatter command
+     * @param Params - The command parameters
+     * @param ClientSocket - The client socket
+     * @return JSON response object
+     */
+    virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket) override;
+
+private:
+    /**
+     * Drop points onto the geometry below them with parallel line traces
+     * @param World - The world to trace against
+     * @param Points - Sample positions; Z is updated for points that hit
+     * @param TopZ - Height traces start from
+     * @param BottomZ - Height traces end at
+     * @param OutNormals - Surface normal under each point
+     * @param OutHit - Whether each point found ground
+     */
+    void ConformToGround(UWorld* World, TArray<FVector>& Points, double TopZ, double BottomZ, TArray<FVector>& OutNormals, TArray<bool>& OutHit);
+};
+
+/**
+ * Handler for the delete_objects command
+ * Deletes actors selected by name and/or filter in one transaction with a single cleanup pass
+ */
+class FMCPDeleteObjectsHandler : public FMCPCommandHandlerBase
+{
+public:
+    FMCPDeleteObjectsHandler() : FMCPCommandHandlerBase(TEXT("delete_objects")) {}
+
+    /**
+     * Execute the delete_objects command
+     * @param Params - The command parameters
+     * @param ClientSocket - The client socket
+     * @return JSON response object
+     */
+    virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket) override;
+
+private:
+    /** Returns true for actors the level needs that must never be deleted */
+    static bool IsProtectedActor(const AActor* Actor);
+};
+
+/**
+ * Handler for the get_scene_hashes command
+ * Returns root, level, cell and actor content hashes so clients can validate a cached world model
+ */
+class FMCPGetSceneHashesHandler : public FMCPCommandHandlerBase
+{
+public:
+    FMCPGetSceneHashesHandler() : FMCPCommandHandlerBase(TEXT("get_scene_hashes")) {}
+
+    /**
+     * Execute the get_scene_hashes command
+     * @param Params - The command parameters
+     * @param ClientSocket - The client socket
+     * @return JSON response object
+     */
+    virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket) override;
+};
+
+/**
+ * Handler for the export_scene_snapshot command
+ * Copies the scene on the game thread and writes a memory-mappable binary snapshot on a worker thread
+ */
+class FMCPExportSceneSnapshotHandler : public FMCPCommandHandlerBase
+{
+public:
+    FMCPExportSceneSnapshotHandler() : FMCPCommandHandlerBase(TEXT("export_scene_snapshot")) {}
+
+    /**
+     * Execute the export_scene_snapshot command
+     * @param Params - The command parameters
+     * @param ClientSocket - The client socket
+     * @return JSON response object
+     */
+    virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket) override;
+};
+
+/**
+ * Handler for the summarize_scene command
+ * Returns a hierarchy of spatial actor clusters sized to a byte budget; clients drill into a cluster by id
+ */
+class FMCPSummarizeSceneHandler : public FMCPCommandHandlerBase
+{
+public:
+    FMCPSummarizeSceneHandler() : FMCPCommandHandlerBase(TEXT("summarize_scene")) {}
+
+    /**
+     * Execute the summarize_scene command
+     * @param Params - The command parameters
+     * @param ClientSocket - The client socket
+     * @return JSON response object
+     */
+    virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket) override;
+};
+
+/**
+ * Handler for the checkpoint_scene command
+ * Captures the serialized state of the scene, or of the actors a filter selects, into a compressed in-memory checkpoint
+ */
+class FMCPCheckpointSceneHandler : public FMCPCommandHandlerBase
+{
+public:
+    FMCPCheckpointSceneHandler() : FMCPCommandHandlerBase(TEXT("checkpoint_scene")) {}
+
+    /**
+     * Execute the checkpoint_scene command
+     * @param Params - The command parameters
+     * @param ClientSocket - The client socket
+     * @return JSON response object
+     */
+    virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket) override;
+};
+
+/**
+ * Handler for the restore_scene command
+ * Writes back only the actors that differ from a checkpoint, outside the undo buffer
+ */
+class FMCPRestoreSceneHandler : public FMCPCommandHandlerBase
+{
+public:
+    FMCPRestoreSceneHandler() : FMCPCommandHandlerBase(TEXT("restore_scene")) {}
+
+    /**
+     * Execute the restore_scene command
+     * @param Params - The command parameters
+     * @param ClientSocket - The client socket
+     * @return JSON response object
+     */
+    virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket) override;
+};
+
+/**
+ * Handler for the diff_scene command
+ * Lists added, removed and changed actors between two checkpoints or a checkpoint and the live world
+ */
+class FMCPDiffSceneHandler : public FMCPCommandHandlerBase
+{
+public:
+    FMCPDiffSceneHandler() : FMCPCommandHandlerBase(TEXT("diff_scene")) {}
+
+    /**
+     * Execute the diff_scene command
+     * @param Params - The command parameters
+     * @param ClientSocket - The client socket
+     * @return JSON response object
+     */
+    virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket) override;
+
+    /** Changed actors come before removed and added ones */
+    virtual TArray<FString> GetFieldPriorities() const override;
+};
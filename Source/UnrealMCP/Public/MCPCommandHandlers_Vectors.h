@@ -0,0 +1,58 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MCPCommandHandlers.h"
+
+/**
+ * Handler for the upsert_embeddings command
+ * Inserts or replaces embeddings of assets, actors or arbitrary ids in a named vector index
+ */
+class FMCPUpsertEmbeddingsHandler : public FMCPCommandHandlerBase
+{
+public:
+    FMCPUpsertEmbeddingsHandler() : FMCPCommandHandlerBase(TEXT("upsert_embeddings")) {}
+
+    /**
+     * Execute the upsert_embeddings command
+     * @param Params - The command parameters
+     * @param ClientSocket - The client socket
+     * @return JSON response object
+     */
+    virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket) override;
+};
+
+/**
+ * Handler for the query_embeddings command
+ * Returns the entries of a vector index most similar to a query embedding, optionally filtered by metadata
+ */
+class FMCPQueryEmbeddingsHandler : public FMCPCommandHandlerBase
+{
+public:
+    FMCPQueryEmbeddingsHandler() : FMCPCommandHandlerBase(TEXT("query_embeddings")) {}
+
+    /**
+     * Execute the query_embeddings command
+     * @param Params - The command parameters
+     * @param ClientSocket - The client socket
+     * @return JSON response object
+     */
+    virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket) override;
+};
+
+/**
+ * Handler for the vector_index command
+ * Lists, inspects, saves, compacts, drops and deletes entries of vector indexes
+ */
+class FMCPVectorIndexHandler : public FMCPCommandHandlerBase
+{
+public:
+    FMCPVectorIndexHandler() : FMCPCommandHandlerBase(TEXT("vector_index")) {}
+
+    /**
+     * Execute the vector_index command
+     * @param Params - The command parameters
+     * @param ClientSocket - The client socket
+     * @return JSON response object
+     */
+    virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket) override;
+};
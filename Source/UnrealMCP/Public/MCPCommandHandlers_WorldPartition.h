@@ -0,0 +1,58 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MCPCommandHandlers.h"
+
+/**
+ * Handler for the query_actor_descs command
+ * Searches World Partition actor descriptors, including actors that are not loaded
+ */
+class FMCPQueryActorDescsHandler : public FMCPCommandHandlerBase
+{
+public:
+    FMCPQueryActorDescsHandler() : FMCPCommandHandlerBase(TEXT("query_actor_descs")) {}
+
+    /**
+     * Execute the query_actor_descs command
+     * @param Params - The command parameters
+     * @param ClientSocket - The client socket
+     * @return JSON response object
+     */
+    virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket) override;
+};
+
+/**
+ * Handler for the load_region command
+ * Loads the actors of a World Partition region in the editor, by default on the next tick
+ */
+class FMCPLoadRegionHandler : public FMCPCommandHandlerBase
+{
+public:
+    FMCPLoadRegionHandler() : FMCPCommandHandlerBase(TEXT("load_region")) {}
+
+    /**
+     * Execute the load_region command
+     * @param Params - The command parameters
+     * @param ClientSocket - The client socket
+     * @return JSON response object
+     */
+    virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket) override;
+};
+
+/**
+ * Handler for the unload_region command
+ * Unloads regions created by load_region
+ */
+class FMCPUnloadRegionHandler : public FMCPCommandHandlerBase
+{
+public:
+    FMCPUnloadRegionHandler() : FMCPCommandHandlerBase(TEXT("unload_region")) {}
+
+    /**
+     * Execute the unload_region command
+     * @param Params - The command parameters
+     * @param ClientSocket - The client socket
+     * @return JSON response object
+     */
+    virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket) override;
+};
@@ -18,12 +18,83 @@ namespace MCPConstants
     constexpr const TCHAR* PYTHON_TEMP_DIR_NAME = TEXT("PythonTemp");
     constexpr const TCHAR* PYTHON_TEMP_FILE_PREFIX = TEXT("mcp_temp_script_");
     
+    // Export constants
+    constexpr const TCHAR* SCENE_SNAPSHOT_DIR_NAME = TEXT("MCPSnapshots"); // Under Saved/, for relative export paths
+    constexpr const TCHAR* VECTOR_INDEX_DIR_NAME = TEXT("MCPVectors");     // Under Saved/, one .mcpvec file per vector index
+    
     // Logging constants
     constexpr bool DEFAULT_VERBOSE_LOGGING = false;
     
     // Performance constants
     constexpr int32 MAX_ACTORS_IN_SCENE_INFO = 1000;
-    constexpr int32 MAX_ACTORS_IN_ASSET_INFO = 2000;
+    constexpr int32 MAX_ACTORS_IN_COLUMNAR_SCENE_INFO = 200000; // Packed columns are ~50 bytes per actor
+    constexpr int32 MAX_ACTORS_IN_ASSET_INFO = 2000;     // Largest page get_asset_info returns
+    constexpr int32 DEFAULT_ASSET_PAGE_SIZE = 200;       // Assets per get_asset_info page when page_size is not given
+    constexpr int32 MAX_ASSET_RESULT_SETS = 16;          // Paged get_asset_info results kept before the oldest is dropped
+    constexpr int32 MAX_ASSETS_WITH_DEEP_INFO = 200;     // Assets get_asset_info loads for deep fields per call
+    constexpr int32 ASSET_INFO_LOAD_BATCH = 32;          // Assets loaded and released together for deep fields
+    constexpr int32 MAX_ASSET_TAG_VALUE_CHARS = 512;     // Longer registry tag values, e.g. blueprint search data, are omitted
+    constexpr int32 DEFAULT_ASSET_SEARCH_RESULTS = 20;   // Hits search_assets returns when max_results is not given
+    constexpr int32 MAX_ASSET_SEARCH_RESULTS = 500;      // Largest max_results search_assets accepts
+    constexpr float DEFAULT_ASSET_SEARCH_MIN_MATCH = 0.34f; // Share of query trigrams a hit must contain; one typo per word still passes
+    constexpr int32 MAX_ASSET_SEARCH_QUERY_CHARS = 256;  // Longer search queries are cut
+    constexpr int32 MAX_SEARCH_TAG_VALUE_CHARS = 64;     // Registry tag values indexed for search; longer ones are not words
+    constexpr int32 DEFAULT_DEPENDENCY_RESULTS = 1000;   // Packages get_asset_dependencies/referencers list when max_results is not given
+    constexpr int32 MAX_DEPENDENCY_RESULTS = 100000;     // Largest max_results get_asset_dependencies/referencers accept
+    constexpr int32 DEPENDENCY_OVERLAY_MIN_REBUILD = 1024; // Changed packages kept beside the dependency rows before they are rebuilt (at least 1/16 of the graph)
+    constexpr int32 SCENE_ENCODE_CHUNK_SIZE = 2048;      // Actors encoded per worker task
+    constexpr int32 PACKED_ENCODE_CHUNK_BYTES = 196608;  // Bytes base64-encoded per worker task (multiple of 3)
+
+    // Response budget constants
+    constexpr int64 MIN_RESPONSE_BYTES = 1024;           // Smallest max_response_bytes honoured; lower budgets are raised to it
+    constexpr int64 RESPONSE_SMALL_FIELD_BYTES = 256;    // Result fields up to this size are sent before any prioritized field
+    constexpr int32 MAX_RESPONSE_CONTINUATIONS = 16;     // Cut responses kept per client for continuation before its oldest is dropped
+
+    // Scene journal constants
+    constexpr int32 SCENE_JOURNAL_CAPACITY = 65536;     // Number of change entries kept before the ring wraps
+    constexpr int32 MAX_CHANGES_IN_SCENE_DELTA = 10000; // Default cap on entries returned by get_scene_changes
+    constexpr double SCENE_HASH_CELL_SIZE = 10000.0;    // Edge of the spatial hash cells in world units (100 m)
+    constexpr int32 MAX_ACTORS_IN_SCENE_HASHES = 100000; // Per-actor hashes returned by one get_scene_hashes call
+    constexpr int32 DEFAULT_SUMMARY_BYTES = 16384;      // Default byte budget of a summarize_scene response
+    constexpr int32 MAX_SUMMARY_BYTES = 1048576;        // Largest byte budget summarize_scene accepts
+    constexpr double MIN_SUMMARY_CLUSTER_EXTENT = 1.0;  // Clusters whose members all lie within this distance are not split
+    constexpr int32 MAX_SCENE_CHECKPOINTS = 32;         // In-memory checkpoints kept before the oldest is dropped
+    constexpr int32 CHECKPOINT_CHUNK_BYTES = 1048576;   // Uncompressed checkpoint bytes compressed by one worker task
+    constexpr int32 MAX_ACTORS_IN_RESTORE_REPORT = 1000; // Actor names listed per category in a restore_scene response
+    constexpr int32 MAX_CHANGES_IN_SCENE_DIFF = 1000;   // Default cap on actors described per list by diff_scene
+
+    // Bulk edit constants
+    constexpr int32 MAX_ACTORS_PER_CREATE_OBJECTS = 20000;     // Separate actors spawned by one create_objects call
+    constexpr int32 MAX_INSTANCES_PER_CREATE_OBJECTS = 2000000; // Instances added by one instanced create_objects call
+    constexpr int32 MAX_SCATTER_INSTANCES = 2000000;            // Instances generated by one scatter call
+    constexpr int64 MAX_SCATTER_GRID_CELLS = 64 * 1024 * 1024;   // Poisson-disk grid cells (4 bytes each)
+    constexpr int32 SCATTER_ATTEMPTS_PER_POINT = 30;            // Darts thrown per wanted point before the sampler gives up
+    constexpr int32 MAX_ACTORS_PER_PROPERTY_BATCH = 20000;      // Actors read or written by one get/set_properties call
+    constexpr int32 MAX_PROPERTY_ERRORS_REPORTED = 100;         // Per-value errors listed in a set_properties response
+
+    // Query constants
+    constexpr int32 MAX_QUERIES_PER_TRACE_BATCH = 1000000; // Traces, sweeps and overlaps run by one trace_batch call
+    constexpr int32 MAX_ACTORS_PER_OVERLAP = 256;          // Overlapping actors reported for a single overlap query
+    constexpr int32 MAX_CLASSES_IN_SCENE_STATS = 50;       // Default number of classes listed by get_scene_stats
+    constexpr int32 MAX_ACTORS_IN_DESC_QUERY = 20000;      // World Partition actor descriptors returned by one query_actor_descs call
+    constexpr int32 MAX_ACTORS_IN_FRUSTUM_QUERY = 5000;    // Visible actors returned by one query_frustum call
+    constexpr int32 OCCLUSION_BUFFER_WIDTH = 256;          // Width of the query_frustum occlusion depth buffer in pixels
+    constexpr int32 MAX_OCCLUDERS = 64;                    // Largest on-screen actors rasterized as occluders
+    constexpr int32 MAX_OCCLUDER_TRIANGLES = 20000;        // Meshes with more triangles in their coarsest LOD are not used as occluders
+    constexpr int64 MAX_OCCUPANCY_VOXELS = 1ll << 30;      // Voxels in one build_occupancy_grid call, counting column padding to 64 bits
+    constexpr int32 OCCUPANCY_BAND_ROWS = 8;               // Grid rows voxelized by one worker task
+    constexpr int32 MAX_CACHED_OCCUPANCY_GRIDS = 4;        // build_occupancy_grid results kept for repeated requests
+
+    // Vector index constants
+    constexpr int32 VECTOR_INDEX_M = 16;                  // Links per node on the upper graph levels; level 0 keeps twice as many
+    constexpr int32 VECTOR_INDEX_EF_CONSTRUCTION = 128;   // Candidates considered when linking a new node
+    constexpr int32 VECTOR_INDEX_MAX_LEVEL = 15;          // Highest graph level a node is placed on
+    constexpr int32 DEFAULT_VECTOR_SEARCH_EF = 64;        // Candidates kept by a query_embeddings graph walk when ef is not given
+    constexpr int32 MAX_VECTOR_SEARCH_K = 1000;           // Largest k query_embeddings accepts
+    constexpr int32 MAX_VECTOR_DIMENSION = 4096;          // Longest embedding an index accepts
+    constexpr int32 MAX_EMBEDDINGS_PER_UPSERT = 10000;    // Entries written by one upsert_embeddings call
+    constexpr int32 VECTOR_EXACT_SEARCH_LIMIT = 4096;     // Candidate counts up to this are compared exhaustively instead of walking the graph
+    constexpr int32 MAX_VECTOR_SEARCH_VISITS = 100000;    // Nodes one graph walk compares before it stops, for filters that admit few nodes
 
     // Path constants - use these instead of hardcoded paths
     // These will be initialized at runtime in the module startup
@@ -0,0 +1,162 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtr.h"
+
+class AActor;
+class UStaticMeshComponent;
+class UWorld;
+
+/**
+ * World-space bounds of every visible actor, stored as structure-of-arrays for SIMD culling
+ *
+ * Centers and extents are split into one float array per axis, padded to a multiple of four, so a
+ * kernel can test four boxes per vector register. The cache is rebuilt only when the scene journal
+ * version or the world changes.
+ */
+class UNREALMCP_API FMCPBoundsCache
+{
+public:
+    static FMCPBoundsCache& Get();
+
+    /**
+     * Rebuild the arrays if the scene changed since the last call; must run on the game thread
+     * @param World - The world to read
+     */
+    void Update(UWorld* World);
+
+    /** @return Number of boxes; arrays hold GetPaddedNum() entries */
+    int32 Num() const { return Actors.Num(); }
+
+    /** @return Array length, a multiple of four */
+    int32 GetPaddedNum() const { return CenterX.Num(); }
+
+    /** Drop the cached arrays */
+    void Reset();
+
+    /**
+     * Find the boxes inside or intersecting a convex volume, four boxes per SIMD step
+     * @param Planes - Planes with outward normals; a box is culled if it lies fully outside any of them
+     * @param NumPlanes - Number of planes
+     * @param OutIndices - Indices of the boxes that are not culled, in ascending order
+     */
+    void Cull(const FPlane* Planes, int32 NumPlanes, TArray<int32>& OutIndices) const;
+
+    TArray<float> CenterX;
+    TArray<float> CenterY;
+    TArray<float> CenterZ;
+    TArray<float> ExtentX;
+    TArray<float> ExtentY;
+    TArray<float> ExtentZ;
+
+    /** Actor of each box */
+    TArray<TWeakObjectPtr<AActor>> Actors;
+
+private:
+    FMCPBoundsCache() = default;
+
+    // Make non-copyable
+    FMCPBoundsCache(const FMCPBoundsCache&) = delete;
+    FMCPBoundsCache& operator=(const FMCPBoundsCache&) = delete;
+
+    TWeakObjectPtr<UWorld> CachedWorld;
+    uint64 CachedVersion = 0;
+    bool bValid = false;
+};
+
+/**
+ * Pinhole camera description for frustum queries
+ */
+struct FMCPCameraView
+{
+    FVector Location = FVector::ZeroVector;
+    FRotator Rotation = FRotator::ZeroRotator;
+
+    /** Horizontal field of view in degrees */
+    double FieldOfView = 90.0;
+
+    /** Width over height */
+    double AspectRatio = 16.0 / 9.0;
+
+    double NearPlane = 10.0;
+    double FarPlane = 1000000.0;
+
+    /** Camera axes, filled by Finalize */
+    FVector Forward = FVector::ForwardVector;
+    FVector Right = FVector::RightVector;
+    FVector Up = FVector::UpVector;
+    double TanHalfHorizontal = 1.0;
+    double TanHalfVertical = 1.0;
+
+    /** Compute the axes and projection terms from the settings */
+    void Finalize();
+
+    /**
+     * Build the six frustum planes with outward normals; a point p is outside plane i if dot(N, p) > W
+     * @param OutPlanes - Near, far, left, right, top, bottom
+     */
+    void GetPlanes(FPlane OutPlanes[6]) const;
+
+    /**
+     * Project a box to normalized screen space, clamped to the screen
+     * @param Box - World-space box
+     * @param OutMin - Lower corner in [-1, 1]
+     * @param OutMax - Upper corner in [-1, 1]
+     * @param OutNearestDepth - Smallest view depth of the box, at least the near plane
+     * @return False if the box projects outside the screen
+     */
+    bool ProjectBox(const FBox& Box, FVector2D& OutMin, FVector2D& OutMax, double& OutNearestDepth) const;
+};
+
+/**
+ * Coarse CPU occlusion: large occluders are rasterized into a small depth buffer, reduced into a
+ * max-depth pyramid, and boxes are tested against the pyramid level their screen rectangle fits in
+ *
+ * Occluder triangles are written at the depth of their farthest vertex, so occlusion stays conservative
+ * along the depth axis. Pixels no occluder covers are infinitely far and never occlude.
+ */
+class UNREALMCP_API FMCPOcclusionBuffer
+{
+public:
+    /**
+     * @param InView - The camera; must outlive the buffer
+     * @param InWidth - Depth buffer width in pixels
+     */
+    FMCPOcclusionBuffer(const FMCPCameraView& InView, int32 InWidth);
+
+    /**
+     * Rasterize a world-space triangle list
+     * @param Positions - Vertex positions
+     * @param Indices - Three indices per triangle
+     * @return Number of triangles rasterized
+     */
+    int32 RasterizeTriangles(const TArray<FVector>& Positions, const TArray<uint32>& Indices);
+
+    /**
+     * Rasterize the coarsest LOD of a static mesh component; must run on the game thread
+     * Meshes whose CPU copy of the render data is not available are skipped
+     * @param Component - The component
+     * @param MaxTriangles - Meshes with more triangles in their coarsest LOD are skipped
+     * @return Number of triangles rasterized
+     */
+    int32 RasterizeStaticMesh(const UStaticMeshComponent* Component, int32 MaxTriangles);
+
+    /** Build the depth pyramid; call after every occluder is rasterized and before testing */
+    void BuildHierarchy();
+
+    /**
+     * Test a box against the occluders
+     * @param Box - World-space box
+     * @return True if every pixel the box covers has an occluder in front of the whole box
+     */
+    bool IsOccluded(const FBox& Box) const;
+
+private:
+    const FMCPCameraView& View;
+    int32 Width;
+    int32 Height;
+
+    /** Level 0 is the full-resolution buffer; each level halves the size and keeps the farthest depth */
+    TArray<TArray<float>> Levels;
+    TArray<FIntPoint> LevelSizes;
+};
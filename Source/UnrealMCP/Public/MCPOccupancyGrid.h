@@ -0,0 +1,162 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+#include "Dom/JsonObject.h"
+
+class AActor;
+class UWorld;
+
+/**
+ * Options for voxelizing a region
+ */
+struct FMCPOccupancySettings
+{
+    /** The region to voxelize; the grid origin is its minimum corner */
+    FBox Region = FBox(ForceInit);
+
+    /** Voxel edge length in world units */
+    double Resolution = 50.0;
+
+    /** Only components that block this channel are voxelized */
+    TEnumAsByte<ECollisionChannel> Channel = ECC_WorldStatic;
+};
+
+/**
+ * Counters reported alongside a grid
+ */
+struct FMCPOccupancyStats
+{
+    int32 ActorCount = 0;
+    int32 ComponentCount = 0;
+
+    /** Simple collision elements (boxes, spheres, capsules, convexes) voxelized */
+    int32 ShapeCount = 0;
+
+    /** Components without simple collision, such as landscapes, sampled with per-column traces */
+    int32 TracedComponentCount = 0;
+
+    int64 OccupiedCount = 0;
+};
+
+/**
+ * Bit-packed 3D occupancy grid stored column by column
+ *
+ * Column (x, y) holds the bits of its NZ voxels, bit z at position z % 64 of word z / 64. Columns are
+ * laid out row-major with x fastest, so the whole grid reads as an [NY][NX][NZ] array.
+ */
+struct UNREALMCP_API FMCPOccupancyGrid
+{
+    FIntVector Size = FIntVector::ZeroValue;
+    FVector Origin = FVector::ZeroVector;
+    double Resolution = 50.0;
+
+    /** 64-bit words per column */
+    int32 WordsPerColumn = 0;
+
+    TArray<uint64> Words;
+
+    /** Allocate an empty grid covering the settings' region */
+    void Init(const FMCPOccupancySettings& Settings);
+
+    /** @return Number of columns, NX * NY */
+    int64 GetNumColumns() const { return static_cast<int64>(Size.X) * Size.Y; }
+
+    /** @return Number of voxels */
+    int64 GetNumVoxels() const { return GetNumColumns() * Size.Z; }
+
+    /** @return Number of occupied voxels */
+    int64 CountOccupied() const;
+
+    /**
+     * Pack the grid one column at a time, each column padded to whole bytes with bit z at byte z / 8, bit z % 8
+     * @param OutBytes - Receives NX * NY * ceil(NZ / 8) bytes
+     */
+    void EncodeBits(TArray<uint8>& OutBytes) const;
+
+    /**
+     * Run-length encode the grid in [NY][NX][NZ] order
+     * @param OutRuns - Alternating run lengths, starting with an empty run that may be zero
+     */
+    void EncodeRuns(TArray<uint32>& OutRuns) const;
+
+    /**
+     * Build the 2.5D height map
+     * @param OutHeights - Top of the highest occupied voxel of each column in [NY][NX] order, NaN for empty columns
+     */
+    void BuildHeightMap(TArray<float>& OutHeights) const;
+};
+
+/**
+ * Voxelizes collision geometry for agent path planning
+ *
+ * Simple collision (boxes, spheres, capsules, convex hulls) is copied on the game thread and voxelized on
+ * worker threads, one band of rows per task so no two tasks write the same column. A voxel is occupied if
+ * its center lies within half a voxel of a shape, which keeps thin walls and floors in the grid. Components
+ * with no simple collision (landscapes, meshes that use complex collision) are sampled with a downward trace
+ * per column and filled from the hit down to the bottom of their bounds.
+ */
+class UNREALMCP_API FMCPOccupancyBuilder
+{
+public:
+    /**
+     * Find the actors with a component that blocks the channel inside the region; must run on the game thread
+     * @param World - The world to read
+     * @param Settings - The region and channel
+     * @param OutActors - The actors, in iteration order
+     */
+    static void CollectActors(UWorld* World, const FMCPOccupancySettings& Settings, TArray<AActor*>& OutActors);
+
+    /**
+     * Hash the content of the region from the scene hash index; must run on the game thread
+     * @param World - The world; its scene hash index is brought up to date first
+     * @param Actors - The actors returned by CollectActors
+     * @param Settings - The settings, which are part of the key
+     * @return Key that changes whenever an actor in the region or a setting changes
+     */
+    static uint64 HashContent(UWorld* World, const TArray<AActor*>& Actors, const FMCPOccupancySettings& Settings);
+
+    /**
+     * Voxelize the actors; must run on the game thread, the voxelization itself runs on worker threads
+     * @param Actors - The actors returned by CollectActors
+     * @param Settings - The region, resolution and channel
+     * @param OutGrid - The grid
+     * @param OutStats - Counters
+     */
+    static void Build(const TArray<AActor*>& Actors, const FMCPOccupancySettings& Settings, FMCPOccupancyGrid& OutGrid, FMCPOccupancyStats& OutStats);
+};
+
+/**
+ * Recent build_occupancy_grid results keyed by region content hash, most recent first
+ */
+class UNREALMCP_API FMCPOccupancyCache
+{
+public:
+    static FMCPOccupancyCache& Get();
+
+    /**
+     * Look up a result and mark it most recently used
+     * @param Key - The key from FMCPOccupancyBuilder::HashContent mixed with the output options
+     * @return The cached result, or null
+     */
+    TSharedPtr<FJsonObject> Find(uint64 Key);
+
+    /**
+     * Store a result, evicting the least recently used one past MAX_CACHED_OCCUPANCY_GRIDS
+     * @param Key - The key
+     * @param Result - The response payload
+     */
+    void Add(uint64 Key, const TSharedPtr<FJsonObject>& Result);
+
+    /** Drop every cached result */
+    void Reset() { Entries.Reset(); }
+
+private:
+    FMCPOccupancyCache() = default;
+
+    // Make non-copyable
+    FMCPOccupancyCache(const FMCPOccupancyCache&) = delete;
+    FMCPOccupancyCache& operator=(const FMCPOccupancyCache&) = delete;
+
+    TArray<TPair<uint64, TSharedPtr<FJsonObject>>> Entries;
+};
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Json.h"
+
+/**
+ * Helpers for packing numeric columns into base64 strings
+ * All packed data is little-endian, matching numpy's '<f4', '<u2' and '<i2' dtypes
+ */
+class UNREALMCP_API FMCPPackedData
+{
+public:
+    /**
+     * Encode float32 values as base64
+     * @param Values - The values to encode
+     * @return Base64 string of the raw little-endian floats
+     */
+    static FString EncodeFloats(const TArray<float>& Values);
+
+    /**
+     * Decode base64 float32 values
+     * @param Encoded - Base64 string produced by EncodeFloats or numpy's tobytes()
+     * @param OutValues - The decoded values
+     * @return True if the string decoded to a whole number of floats
+     */
+    static bool DecodeFloats(const FString& Encoded, TArray<float>& OutValues);
+
+    /**
+     * Encode uint16 values as base64
+     * @param Values - The values to encode
+     * @return Base64 string of the raw little-endian values
+     */
+    static FString EncodeUInt16s(const TArray<uint16>& Values);
+
+    /**
+     * Encode int16 values as base64
+     * @param Values - The values to encode
+     * @return Base64 string of the raw little-endian values
+     */
+    static FString EncodeInt16s(const TArray<int16>& Values);
+
+    /**
+     * Encode uint32 values as base64
+     * @param Values - The values to encode
+     * @return Base64 string of the raw little-endian values
+     */
+    static FString EncodeUInt32s(const TArray<uint32>& Values);
+
+    /**
+     * Encode raw bytes as base64
+     * @param Bytes - The bytes to encode
+     * @return Base64 string of the bytes
+     */
+    static FString EncodeBytes(const TArray<uint8>& Bytes);
+
+    /**
+     * Quantize interleaved values to 16 bits against a per-component range
+     * @param Values - Interleaved values, Stride components per element
+     * @param Stride - Number of components per element
+     * @param OutMin - Minimum of each component
+     * @param OutMax - Maximum of each component
+     * @param OutQuantized - Values mapped to [0, 65535] within their component's range
+     */
+    static void QuantizeUnorm16(const TArray<float>& Values, int32 Stride, TArray<float>& OutMin, TArray<float>& OutMax, TArray<uint16>& OutQuantized);
+
+    /**
+     * Quantize values in [-1, 1] to signed 16 bits
+     * @param Values - The values to quantize
+     * @param OutQuantized - Values mapped to [-32767, 32767]
+     */
+    static void QuantizeSnorm16(const TArray<float>& Values, TArray<int16>& OutQuantized);
+
+    /**
+     * Read a float column that is either a base64 string or a JSON number array
+     * @param Object - The JSON object holding the field
+     * @param FieldName - The field to read
+     * @param OutValues - The values read
+     * @return True if the field was present and valid
+     */
+    static bool TryGetFloatColumn(const TSharedPtr<FJsonObject>& Object, const FString& FieldName, TArray<float>& OutValues);
+
+    /**
+     * Read an index column that is either a base64 uint32 string or a JSON number array
+     * @param Object - The JSON object holding the field
+     * @param FieldName - The field to read
+     * @param OutValues - The values read
+     * @return True if the field was present and valid
+     */
+    static bool TryGetUInt32Column(const TSharedPtr<FJsonObject>& Object, const FString& FieldName, TArray<uint32>& OutValues);
+
+    /**
+     * Build a JSON number array from a list of floats
+     * @param Values - The values
+     * @return JSON values
+     */
+    static TArray<TSharedPtr<FJsonValue>> MakeNumberArray(const TArray<float>& Values);
+};
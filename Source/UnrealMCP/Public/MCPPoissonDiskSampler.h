@@ -0,0 +1,73 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Math/RandomStream.h"
+
+/**
+ * Deterministic 2D Poisson-disk sampler
+ * Throws uniform darts over a rectangle (optionally clipped to a polygon) and rejects any closer than
+ * the minimum spacing to an accepted point, using a background grid with one point per cell for the test
+ */
+class UNREALMCP_API FMCPPoissonDiskSampler
+{
+public:
+    /**
+     * Constructor
+     * @param InBounds - Rectangle to sample
+     * @param InMinSpacing - Minimum distance between points, 0 for plain uniform sampling
+     * @param InSeed - Seed for the random stream; the same seed always gives the same points
+     */
+    FMCPPoissonDiskSampler(const FBox2D& InBounds, float InMinSpacing, int32 InSeed);
+
+    /**
+     * Restrict samples to the inside of a polygon
+     * @param InPolygon - Polygon vertices in order, inside the sampling rectangle
+     */
+    void SetPolygon(const TArray<FVector2D>& InPolygon);
+
+    /**
+     * Number of grid cells the sampler would allocate for the current bounds and spacing
+     * @return Cell count, 0 when no spacing test is needed
+     */
+    int64 GetGridCellCount() const;
+
+    /**
+     * Generate points
+     * @param TargetCount - Number of points wanted; fewer are returned if the spacing saturates the region
+     * @param MaxAttemptsPerPoint - Dart budget per wanted point before giving up
+     * @param OutPoints - Accepted points in generation order
+     */
+    void Generate(int32 TargetCount, int32 MaxAttemptsPerPoint, TArray<FVector2D>& OutPoints);
+
+    /**
+     * Area that points can be placed in
+     * @return Polygon area if set, otherwise the rectangle area
+     */
+    double GetArea() const;
+
+    /** @return The random stream, continued after Generate for any further per-point randomness */
+    FRandomStream& GetRandomStream() { return RandomStream; }
+
+    /**
+     * Even-odd point in polygon test
+     * @param Polygon - Polygon vertices in order
+     * @param Point - The point to test
+     * @return True if the point is inside
+     */
+    static bool IsInsidePolygon(const TArray<FVector2D>& Polygon, const FVector2D& Point);
+
+private:
+    /** Returns true if no accepted point is within the minimum spacing of the candidate */
+    bool IsFarEnough(const FVector2D& Candidate, const TArray<FVector2D>& Points) const;
+
+    FBox2D Bounds;
+    float MinSpacing;
+    TArray<FVector2D> Polygon;
+    FRandomStream RandomStream;
+
+    /** Background grid: index of the accepted point in each cell, or INDEX_NONE */
+    TArray<int32> Grid;
+    double CellSize = 0.0;
+    int32 GridWidth = 0;
+    int32 GridHeight = 0;
+};
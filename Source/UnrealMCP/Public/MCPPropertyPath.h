@@ -0,0 +1,114 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+
+class AActor;
+class FProperty;
+class UObject;
+class UStruct;
+
+/**
+ * One step of a resolved property path inside a single object's memory
+ */
+struct FMCPPropertyStep
+{
+    /** Property to read from the current container */
+    FProperty* Property = nullptr;
+
+    /** Element of a fixed-size C array property */
+    int32 StaticIndex = 0;
+
+    /** Element of a TArray property, INDEX_NONE when not indexing a TArray */
+    int32 ArrayIndex = INDEX_NONE;
+};
+
+/**
+ * Path segments resolved against one class, up to the end of the path or the next object reference
+ */
+struct FMCPPropertyChain
+{
+    /** Steps through the object's own memory, structs and arrays */
+    TArray<FMCPPropertyStep> Steps;
+
+    /** Path left to resolve on the object the last step points to; empty if the last step is the leaf */
+    FString RemainingPath;
+};
+
+/**
+ * A property path resolved on a concrete object, ready to read or write
+ */
+struct FMCPResolvedProperty
+{
+    /** Object that owns the value; receives Modify and edit notifications */
+    UObject* Owner = nullptr;
+
+    /** Top-level property of Owner that contains the value */
+    FProperty* MemberProperty = nullptr;
+
+    /** Property describing the value itself */
+    FProperty* LeafProperty = nullptr;
+
+    /** Address of the value */
+    void* ValuePtr = nullptr;
+};
+
+/**
+ * Resolves dotted property paths such as "StaticMeshComponent0.Mobility", "LightComponent.Intensity"
+ * or "Tags[0]" through FProperty reflection
+ *
+ * A segment is a property name, optionally followed by [index] for TArray properties; fixed-size
+ * C array properties always need the index, so a resolved value is never a whole C array.
+ * Segments continue into struct members and through object references. On an actor, a first segment
+ * that is not a property is looked up as a component name. Resolution of each path against a class
+ * is cached, so batches of actors of the same class do the name lookups once.
+ */
+class UNREALMCP_API FMCPPropertyPathCache
+{
+public:
+    static FMCPPropertyPathCache& Get();
+
+    /**
+     * Resolve a path on an object
+     * @param Root - The object to start from
+     * @param Path - Dotted property path
+     * @param OutResolved - The resolved value
+     * @param OutError - Why resolution failed
+     * @return True if the path resolved to a value
+     */
+    bool Resolve(UObject* Root, const FString& Path, FMCPResolvedProperty& OutResolved, FString& OutError);
+
+    /** Drop all cached chains */
+    void Reset();
+
+private:
+    FMCPPropertyPathCache() = default;
+
+    // Make non-copyable
+    FMCPPropertyPathCache(const FMCPPropertyPathCache&) = delete;
+    FMCPPropertyPathCache& operator=(const FMCPPropertyPathCache&) = delete;
+
+    /** Cached result of resolving a path on a class; failures are cached too so bad paths stay cheap */
+    struct FCacheEntry
+    {
+        FMCPPropertyChain Chain;
+        FString Error;
+        bool bValid = false;
+    };
+
+    /**
+     * Find or build the chain for a path on a class
+     * @param Class - The class or struct the path starts in
+     * @param Path - Dotted property path
+     * @return The cache entry for the pair
+     */
+    const FCacheEntry& FindOrBuildChain(const UStruct* Class, const FString& Path);
+
+    static bool BuildChain(const UStruct* Class, const FString& Path, FMCPPropertyChain& OutChain, FString& OutError);
+
+    /** Walk a chain through an object's memory, following the final object reference if any */
+    static bool WalkChain(UObject* Object, const FMCPPropertyChain& Chain, FMCPResolvedProperty& OutResolved, UObject*& OutNextObject, FString& OutError);
+
+    /** Chains keyed by class and path; only touched on the game thread */
+    TMap<TPair<FObjectKey, FString>, FCacheEntry> Chains;
+};
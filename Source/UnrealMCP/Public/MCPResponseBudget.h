@@ -0,0 +1,109 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Json.h"
+
+class FSocket;
+
+/**
+ * Cuts command responses to a client byte budget and serves the remainder through continuation cursors
+ *
+ * Budgeted responses are serialized without whitespace, so sizes are exact. Result fields are emitted
+ * small ones first (counts, versions, flags), then large ones in the handler's priority order. The field
+ * that crosses the budget is cut: arrays between elements, strings at a multiple of four characters so
+ * base64 columns stay decodable piecewise, and objects between members, cutting the member that crosses
+ * the budget the same way. Everything after the cut is kept server-side under a cursor that only the
+ * client connection that received it can use; each continuation holds the next fields or the next
+ * elements of a cut field, to be appended to the previous part by field name, recursively for objects.
+ */
+class UNREALMCP_API FMCPResponseBudget
+{
+public:
+    static FMCPResponseBudget& Get();
+
+    /**
+     * Fit a response to a budget; responses that already fit are returned unchanged
+     * @param Response - The response envelope from a handler
+     * @param FieldPriorities - Result fields from most to least important; unlisted large fields follow in their original order
+     * @param MaxBytes - Budget for the serialized envelope
+     * @param Client - The connection the response is sent on, which owns the continuation
+     * @return The response to send; a cut response carries "truncated": true and a "continuation" object with the cursor
+     */
+    TSharedPtr<FJsonObject> Apply(const TSharedPtr<FJsonObject>& Response, const TArray<FString>& FieldPriorities, int64 MaxBytes, const FSocket* Client);
+
+    /**
+     * Serve the next part of a cut response
+     * @param Cursor - The cursor from the previous part
+     * @param MaxBytes - Budget for this part, or 0 to keep the original budget
+     * @param Client - The requesting connection; cursors handed to other connections are unknown to it
+     * @return The next part, or an error response if the cursor is unknown or expired
+     */
+    TSharedPtr<FJsonObject> Continue(const FString& Cursor, int64 MaxBytes, const FSocket* Client);
+
+    /**
+     * Drop the continuations of a connection, before its socket is destroyed and the address reused
+     * @param Client - The closed connection
+     */
+    void ReleaseClient(const FSocket* Client);
+
+    /**
+     * Serialize a response the way budgeted responses are sent
+     * @param Response - The response envelope
+     * @return The JSON text without whitespace
+     */
+    static FString SerializeCondensed(const TSharedPtr<FJsonObject>& Response);
+
+private:
+    FMCPResponseBudget() = default;
+
+    // Make non-copyable
+    FMCPResponseBudget(const FMCPResponseBudget&) = delete;
+    FMCPResponseBudget& operator=(const FMCPResponseBudget&) = delete;
+
+    /** A result field still to be sent, from an element (arrays) or character (strings) offset */
+    struct FPendingField
+    {
+        FString Name;
+        int32 Offset = 0;
+
+        /** Members still to be sent of a cut object; empty until the object is cut */
+        TArray<FPendingField> Members;
+    };
+
+    /** What is left of a cut response */
+    struct FContinuation
+    {
+        TSharedPtr<FJsonObject> Result;
+        TArray<FPendingField> Pending;
+        int64 MaxBytes = 0;
+
+        /** The connection the cursor was handed to; only compared, never dereferenced */
+        const FSocket* Client = nullptr;
+    };
+
+    /**
+     * Emit pending fields of a result into a new part until the budget is reached
+     * At least one element, character run or value is emitted so every part makes progress
+     * @param Result - The full result
+     * @param Pending - Fields to send, in order; on return, what is left
+     * @param MaxBytes - Budget for the whole envelope
+     * @return The response envelope for this part, with a continuation if anything is left
+     */
+    TSharedPtr<FJsonObject> EmitPart(const TSharedPtr<FJsonObject>& Result, TArray<FPendingField>& Pending, int64 MaxBytes, const FSocket* Client);
+
+    /**
+     * Emit pending members of an object until a byte budget is reached
+     * @param Object - The full object
+     * @param Pending - Members to send, in order; on return, what is left
+     * @param Budget - Bytes available for the members, without the braces
+     * @param UsedBytes - Bytes emitted so far, updated
+     * @param bForce - Emit at least one element, character run or value even past the budget
+     * @param Part - Receives the emitted members
+     */
+    static void EmitMembers(const FJsonObject& Object, TArray<FPendingField>& Pending, int64 Budget, int64& UsedBytes, bool bForce, FJsonObject& Part);
+
+    /** Continuations by cursor, oldest first; only touched on the game thread */
+    TArray<TPair<FString, FContinuation>> Continuations;
+
+    int32 NextCursorNumber = 1;
+};
@@ -0,0 +1,261 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MCPConstants.h"
+#include "MCPSceneSnapshot.h"
+
+class AActor;
+class UWorld;
+
+/**
+ * Serialized state of one component of a checkpointed actor
+ */
+struct FMCPCheckpointComponent
+{
+    FName Name;
+
+    /** Class path, used to recreate components added to the actor instance */
+    FString ClassPath;
+
+    /** True if the component was added to the actor instance rather than by its class or construction script */
+    bool bInstance = false;
+
+    /** Tagged properties that differ from the archetype; object references are stored as paths */
+    TArray<uint8> Properties;
+
+    friend FArchive& operator<<(FArchive& Ar, FMCPCheckpointComponent& Component);
+};
+
+/**
+ * Serialized state of one checkpointed actor
+ */
+struct FMCPCheckpointRecord
+{
+    FName Name;
+    FString ClassPath;
+
+    /** Name of the world that owns the actor's level, as in the scene hashes */
+    FName LevelName;
+
+    FString Label;
+    FName Folder;
+    FTransform Transform;
+
+    /** Tagged properties that differ from the archetype; object references are stored as paths */
+    TArray<uint8> Properties;
+
+    TArray<FMCPCheckpointComponent> Components;
+
+    friend FArchive& operator<<(FArchive& Ar, FMCPCheckpointRecord& Record);
+};
+
+/**
+ * Index entry of one actor in a checkpoint
+ */
+struct FMCPCheckpointEntry
+{
+    FName Name;
+
+    /** Scene hash of the actor when it was captured; a cheap first test for changes */
+    uint64 ContentHash = 0;
+
+    /** Hash of the serialized record; decides whether the actor really differs */
+    uint64 StateHash = 0;
+
+    /** Byte range of the record in the uncompressed blob */
+    int64 Offset = 0;
+    int32 Size = 0;
+};
+
+/**
+ * Serialized state of a set of actors, kept in memory as independently compressed chunks
+ */
+struct UNREALMCP_API FMCPSceneCheckpoint
+{
+    FString Id;
+
+    /** Optional client-given name */
+    FString Label;
+
+    TWeakObjectPtr<UWorld> World;
+
+    /** Actors the checkpoint covers; restore only adds, removes or edits actors this filter selects */
+    FMCPActorFilter Filter;
+
+    /** Scene journal version at capture; journal entries after it mark actors to compare */
+    uint64 SceneVersion = 0;
+
+    FDateTime CreatedAt;
+
+    /** Captured actors in capture order */
+    TArray<FMCPCheckpointEntry> Entries;
+
+    /** Entry index by actor name */
+    TMap<FName, int32> EntryIndex;
+
+    /** Every tracked actor in the world at capture, so actors that merely moved into the filter are not treated as new */
+    TSet<FName> WorldActorNames;
+
+    /** Compressed chunks of MCPConstants::CHECKPOINT_CHUNK_BYTES uncompressed bytes each; the last may be shorter */
+    TArray<TArray<uint8>> Chunks;
+
+    int64 UncompressedSize = 0;
+    int64 CompressedSize = 0;
+
+    /**
+     * Read one record, decompressing only the chunks it spans
+     * @param EntryIndex - Index into Entries
+     * @param ChunkCache - Decompressed chunks by index, reused across reads of the same checkpoint
+     * @param OutRecord - The record
+     * @return False if a chunk is corrupt
+     */
+    bool ReadRecord(int32 EntryIndex, TMap<int32, TArray<uint8>>& ChunkCache, FMCPCheckpointRecord& OutRecord) const;
+
+private:
+    bool DecompressChunk(int32 ChunkIndex, TArray<uint8>& OutBytes) const;
+};
+
+/**
+ * How the live world differs from a checkpoint
+ */
+struct FMCPWorldComparison
+{
+    /** Checkpoint entry indices whose actor's serialized state differs, with the live actor */
+    TArray<TPair<int32, AActor*>> Changed;
+
+    /** Checkpoint entry indices whose actor no longer exists */
+    TArray<int32> Missing;
+
+    /** Actors the checkpoint's filter selects that did not exist when it was taken */
+    TArray<AActor*> Added;
+
+    /** Actors that were serialized and compared because their hash or the journal pointed at a change */
+    int32 ComparedCount = 0;
+
+    /** True if every actor was compared, on request or because the journal no longer covered the checkpoint */
+    bool bFullCompare = false;
+};
+
+/**
+ * What a restore did, or would do for a dry run
+ */
+struct FMCPRestoreResult
+{
+    /** Actors whose state was written back */
+    TArray<FName> Restored;
+
+    /** Actors deleted since the checkpoint and spawned again */
+    TArray<FName> Respawned;
+
+    /** Actors added since the checkpoint and destroyed */
+    TArray<FName> Destroyed;
+
+    /** Actors that were serialized and compared because their hash or the journal pointed at a change */
+    int32 ComparedCount = 0;
+
+    /** True if every actor was compared, on request or because the journal no longer covered the checkpoint */
+    bool bFullCompare = false;
+
+    /** Actors that could not be restored, with the reason */
+    TArray<FString> Errors;
+};
+
+/**
+ * In-memory scene checkpoints for fast layout iteration
+ *
+ * A checkpoint serializes the tagged properties of each selected actor and its components through a
+ * name-and-path proxy archive, so object references survive actors being destroyed and respawned. The
+ * records are packed into one blob that is compressed in fixed-size chunks on worker threads; reads only
+ * decompress the chunks a record spans.
+ *
+ * Restoring applies only the difference: actors are compared only where the scene hash or the scene
+ * journal points at a change, deleted actors are respawned under their old names, renaming a destroyed actor
+ * still in memory out of the way, and actors added since the checkpoint are destroyed. Restores write state
+ * directly without transactions, so iterating over many layouts never grows the undo buffer; a restore is
+ * itself not undoable.
+ */
+class UNREALMCP_API FMCPSceneCheckpoints
+{
+public:
+    static FMCPSceneCheckpoints& Get();
+
+    /**
+     * Capture a checkpoint; must run on the game thread
+     * The oldest checkpoint is dropped once MCPConstants::MAX_SCENE_CHECKPOINTS are kept
+     * @param World - The editor world
+     * @param Filter - Actors to capture; empty for every tracked actor
+     * @param Label - Optional name to keep with the checkpoint
+     * @return The new checkpoint
+     */
+    TSharedRef<const FMCPSceneCheckpoint> Create(UWorld* World, const FMCPActorFilter& Filter, const FString& Label);
+
+    /**
+     * Find the actors that differ between a checkpoint and its world; must run on the game thread
+     * @param Checkpoint - The checkpoint to compare
+     * @param bFullCompare - Compare every actor, for edits made without the editor's change notifications
+     * @param OutComparison - The differences
+     * @param OutError - Why nothing could be compared
+     * @return False if the checkpoint's world is gone
+     */
+    bool CompareWithWorld(const FMCPSceneCheckpoint& Checkpoint, bool bFullCompare, FMCPWorldComparison& OutComparison, FString& OutError);
+
+    /**
+     * Write a checkpoint back into its world; must run on the game thread
+     * @param Checkpoint - The checkpoint to restore
+     * @param bDryRun - Only report what would change
+     * @param bFullCompare - Compare every actor, for edits made without the editor's change notifications
+     * @param OutResult - What changed
+     * @param OutError - Why nothing could be restored
+     * @return False if the checkpoint's world is gone or its data is corrupt
+     */
+    bool Restore(const FMCPSceneCheckpoint& Checkpoint, bool bDryRun, bool bFullCompare, FMCPRestoreResult& OutResult, FString& OutError);
+
+    /** @return The checkpoint with this id, or null */
+    TSharedPtr<const FMCPSceneCheckpoint> Find(const FString& Id) const;
+
+    /** @return True if a checkpoint was dropped */
+    bool Remove(const FString& Id);
+
+    /** @return Checkpoints from oldest to newest */
+    const TArray<TSharedRef<const FMCPSceneCheckpoint>>& GetAll() const { return Checkpoints; }
+
+    /**
+     * Serialize an actor the way checkpoints store it; must run on the game thread
+     * @param Actor - The actor to capture
+     * @param OutRecord - The record
+     */
+    static void CaptureRecord(const AActor* Actor, FMCPCheckpointRecord& OutRecord);
+
+    /**
+     * Load serialized properties from a record onto an object
+     * @param Object - The object to write
+     * @param Bytes - Properties from a checkpoint record
+     */
+    static void LoadProperties(UObject* Object, const TArray<uint8>& Bytes);
+
+    /**
+     * Serialize a record to bytes and hash them
+     * @param Record - The record
+     * @param OutBytes - The serialized record, appended to
+     * @return Hash of the appended bytes
+     */
+    static uint64 WriteRecord(FMCPCheckpointRecord& Record, TArray<uint8>& OutBytes);
+
+private:
+    FMCPSceneCheckpoints() = default;
+
+    // Make non-copyable
+    FMCPSceneCheckpoints(const FMCPSceneCheckpoints&) = delete;
+    FMCPSceneCheckpoints& operator=(const FMCPSceneCheckpoints&) = delete;
+
+    /** Spawn a deleted actor again in its old level and under its old name, renaming a destroyed actor that still holds it */
+    static AActor* Respawn(UWorld* World, const FMCPCheckpointRecord& Record, FString& OutError);
+
+    /** Write a record's state onto an actor and its components */
+    static void ApplyRecord(AActor* Actor, const FMCPCheckpointRecord& Record);
+
+    /** Checkpoints from oldest to newest; only touched on the game thread */
+    TArray<TSharedRef<const FMCPSceneCheckpoint>> Checkpoints;
+
+    int32 NextCheckpointNumber = 1;
+};
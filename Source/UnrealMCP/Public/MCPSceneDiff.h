@@ -0,0 +1,123 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Json.h"
+#include "MCPConstants.h"
+#include "MCPSceneCheckpoint.h"
+
+/**
+ * How one actor differs between two states
+ */
+struct FMCPActorDiff
+{
+    FName Name;
+    FString ClassPath;
+
+    FTransform Before;
+    FTransform After;
+
+    /** Set when the class differs, e.g. an actor deleted and replaced under the same name */
+    FString ClassPathBefore;
+
+    FString LabelBefore;
+    FString LabelAfter;
+    FName FolderBefore;
+    FName FolderAfter;
+
+    /** Actor properties whose values differ */
+    TArray<FName> Properties;
+
+    TArray<FName> AddedComponents;
+    TArray<FName> RemovedComponents;
+
+    /** Components present in both states, with the properties that differ */
+    TArray<TPair<FName, TArray<FName>>> ChangedComponents;
+};
+
+/**
+ * Options for diffing scene states
+ */
+struct FMCPSceneDiffOptions
+{
+    /** Name the changed properties of changed actors and components */
+    bool bProperties = true;
+
+    /** Serialize and compare every live actor instead of only those the hashes and journal point at */
+    bool bFullCompare = false;
+
+    /** Actors described per list; the counts always cover every difference */
+    int32 MaxChanges = MCPConstants::MAX_CHANGES_IN_SCENE_DIFF;
+};
+
+/**
+ * Differences between two scene states
+ */
+struct FMCPSceneDiffResult
+{
+    /** Actors only in the later state */
+    TArray<FMCPCheckpointRecord> Added;
+
+    /** Actors only in the earlier state */
+    TArray<FMCPCheckpointRecord> Removed;
+
+    TArray<FMCPActorDiff> Changed;
+
+    int32 AddedCount = 0;
+    int32 RemovedCount = 0;
+    int32 ChangedCount = 0;
+
+    /** Actors whose records were compared because their hashes differ */
+    int32 ComparedCount = 0;
+
+    /** True if every live actor was compared */
+    bool bFullCompare = false;
+};
+
+/**
+ * Structured diffs between checkpoints, or between a checkpoint and the live world
+ *
+ * Unchanged actors are skipped by comparing per-actor hashes: for two checkpoints the stored record
+ * hashes, for the live world the scene hash index plus the journal entries since the checkpoint.
+ * Only the records of the few actors that differ are read back, from the compressed chunks they live in,
+ * and compared field by field. Properties are compared by loading both serialized states into transient
+ * objects of the actor or component class.
+ */
+class UNREALMCP_API FMCPSceneDiff
+{
+public:
+    /**
+     * Diff two states; must run on the game thread
+     * @param From - The earlier checkpoint
+     * @param To - The later checkpoint, or null for the live world
+     * @param Options - Detail and limits
+     * @param OutResult - The differences
+     * @param OutError - Why the states could not be compared
+     * @return False if the live world is gone or a checkpoint is corrupt
+     */
+    static bool Diff(const FMCPSceneCheckpoint& From, const FMCPSceneCheckpoint* To, const FMCPSceneDiffOptions& Options, FMCPSceneDiffResult& OutResult, FString& OutError);
+
+    /**
+     * Compare two records of the same actor
+     * @param Before - The earlier record
+     * @param After - The later record
+     * @param bProperties - Name the changed properties
+     * @param OutDiff - The differences
+     */
+    static void DiffRecords(const FMCPCheckpointRecord& Before, const FMCPCheckpointRecord& After, bool bProperties, FMCPActorDiff& OutDiff);
+
+    /** @return A changed actor as JSON; only the parts that differ are present */
+    static TSharedPtr<FJsonObject> ToJson(const FMCPActorDiff& Diff);
+
+    /** @return An added or removed actor as JSON */
+    static TSharedPtr<FJsonObject> ToJson(const FMCPCheckpointRecord& Record);
+
+private:
+    /**
+     * Name the properties that differ between two serialized states of an object
+     * @param ClassPath - Class of the object
+     * @param Before - Earlier serialized properties
+     * @param After - Later serialized properties
+     * @param OutProperties - Names of the differing properties
+     */
+    static void DiffProperties(const FString& ClassPath, const TArray<uint8>& Before, const TArray<uint8>& After, TArray<FName>& OutProperties);
+};
@@ -0,0 +1,212 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/Future.h"
+#include "MCPSceneSnapshot.h"
+
+class UWorld;
+
+/**
+ * Binary scene snapshot file layout (.mcpsnap)
+ *
+ * Everything is little-endian and every section starts on a 64-byte boundary, so a reader can mmap the
+ * file and view each section as a fixed-stride array without parsing:
+ *
+ *   FMCPSnapshotFileHeader
+ *   FMCPSnapshotSection[SectionCount]
+ *   sections...
+ *
+ * Strings (names, labels, classes, levels, folders, asset paths) are stored once in a string table and
+ * referenced by index. String i is the UTF-8 bytes StringData[StringOffsets[i], StringOffsets[i + 1]).
+ * Index NO_STRING means "none".
+ */
+namespace MCPSnapshotFormat
+{
+    constexpr uint32 FORMAT_VERSION = 1;
+    constexpr uint32 SECTION_ALIGNMENT = 64;
+    constexpr uint32 NO_STRING = 0xFFFFFFFFu;
+    constexpr uint32 NO_PARENT = 0xFFFFFFFFu;
+    constexpr const TCHAR* FILE_EXTENSION = TEXT(".mcpsnap");
+
+    /** Section ids in the section table */
+    enum ESectionId : uint32
+    {
+        StringOffsets = 1,       // uint32[StringCount + 1]
+        StringData = 2,          // uint8[], UTF-8
+        Actors = 3,              // FMCPSnapshotActor[ActorCount]
+        Transforms = 4,          // FMCPSnapshotTransform[ActorCount], world space
+        Bounds = 5,              // FMCPSnapshotBounds[ActorCount], world space
+        Components = 6           // FMCPSnapshotComponent[ComponentCount]
+    };
+
+    /** Actor and component flags */
+    enum EFlags : uint32
+    {
+        Hidden = 1 << 0,
+        HiddenInEditor = 1 << 1,
+        Visible = 1 << 2,
+        StaticMobility = 1 << 3,
+        MovableMobility = 1 << 4
+    };
+}
+
+#pragma pack(push, 1)
+
+/** File header, 64 bytes */
+struct FMCPSnapshotFileHeader
+{
+    /** "MCPSNAP" followed by a zero byte */
+    uint8 Magic[8];
+    uint32 FormatVersion;
+    uint32 HeaderSize;
+    uint64 SceneVersion;
+    int64 CreatedUnixTime;
+    uint32 ActorCount;
+    uint32 ComponentCount;
+    uint32 StringCount;
+    uint32 SectionCount;
+    uint32 WorldNameString;
+    uint8 Reserved[12];
+};
+
+/** Section table entry, 32 bytes */
+struct FMCPSnapshotSection
+{
+    uint32 Id;
+    uint32 Stride;
+    uint64 Count;
+    uint64 Offset;
+    uint64 Size;
+};
+
+/** Actor record, 32 bytes */
+struct FMCPSnapshotActor
+{
+    uint32 NameString;
+    uint32 LabelString;
+    uint32 ClassString;
+    uint32 LevelString;
+    uint32 FolderString;
+    uint32 FirstComponent;
+    uint32 ComponentCount;
+    uint32 Flags;
+};
+
+/** Transform record, 40 bytes: location xyz, rotation quaternion xyzw (w >= 0), scale xyz */
+struct FMCPSnapshotTransform
+{
+    float Location[3];
+    float Rotation[4];
+    float Scale[3];
+};
+
+/** Axis-aligned bounds record, 24 bytes */
+struct FMCPSnapshotBounds
+{
+    float Min[3];
+    float Max[3];
+};
+
+/** Component record, 80 bytes; the transform is relative to the attach parent */
+struct FMCPSnapshotComponent
+{
+    uint32 ActorIndex;
+    uint32 NameString;
+    uint32 ClassString;
+    uint32 AssetString;
+    uint32 ParentComponent;
+    uint32 Flags;
+    uint32 InstanceCount;
+    uint32 Reserved;
+    FMCPSnapshotTransform RelativeTransform;
+    uint8 Padding[8];
+};
+
+#pragma pack(pop)
+
+static_assert(sizeof(FMCPSnapshotFileHeader) == 64, "Snapshot header layout changed");
+static_assert(sizeof(FMCPSnapshotSection) == 32, "Snapshot section layout changed");
+static_assert(sizeof(FMCPSnapshotActor) == 32, "Snapshot actor layout changed");
+static_assert(sizeof(FMCPSnapshotTransform) == 40, "Snapshot transform layout changed");
+static_assert(sizeof(FMCPSnapshotBounds) == 24, "Snapshot bounds layout changed");
+static_assert(sizeof(FMCPSnapshotComponent) == 80, "Snapshot component layout changed");
+
+/**
+ * Plain copy of one component, captured on the game thread
+ */
+struct FMCPExportComponent
+{
+    FName Name;
+    const UClass* Class = nullptr;
+
+    /** Static mesh path for mesh components, empty otherwise */
+    FString AssetPath;
+
+    /** Index of the attach parent in the actor's component list, INDEX_NONE for the root */
+    int32 Parent = INDEX_NONE;
+    FTransform RelativeTransform;
+    uint32 Flags = 0;
+    int32 InstanceCount = 0;
+};
+
+/**
+ * Plain copy of everything an export writes, captured on the game thread
+ */
+struct FMCPSceneExportData
+{
+    FString WorldName;
+    uint64 SceneVersion = 0;
+    TArray<FMCPActorRecord> Actors;
+    TArray<FName> ActorLevels;
+    TArray<FString> ActorFolders;
+    TArray<uint32> ActorFlags;
+
+    /** Components of all actors; actor i owns [ComponentStarts[i], ComponentStarts[i + 1]) */
+    TArray<FMCPExportComponent> Components;
+    TArray<int32> ComponentStarts;
+};
+
+/**
+ * Outcome of writing a snapshot file
+ */
+struct FMCPSceneExportResult
+{
+    bool bSuccess = false;
+    FString Error;
+    FString Path;
+    int64 FileSize = 0;
+    double WriteSeconds = 0.0;
+};
+
+/**
+ * Writes binary scene snapshots: the game thread copies the scene, a worker thread encodes and writes it
+ */
+class UNREALMCP_API FMCPSceneExporter
+{
+public:
+    /**
+     * Copy the scene into plain data; must run on the game thread
+     * @param World - The world to export
+     * @param Filter - Only actors matching the filter are exported, when set
+     * @param bIncludeComponents - Whether to copy the component table
+     * @return The captured data
+     */
+    static TSharedRef<FMCPSceneExportData> Capture(UWorld* World, const FMCPActorFilter* Filter, bool bIncludeComponents);
+
+    /**
+     * Encode and write captured data on a worker thread
+     * The file is written under a temporary name and renamed when complete, so a file at Path is always whole
+     * @param Data - Data from Capture
+     * @param Path - Destination file
+     * @return Future completed when the file is written
+     */
+    static TFuture<FMCPSceneExportResult> WriteAsync(TSharedRef<FMCPSceneExportData> Data, const FString& Path);
+
+    /**
+     * Encode and write captured data on the calling thread
+     * @param Data - Data from Capture
+     * @param Path - Destination file
+     * @return The outcome
+     */
+    static FMCPSceneExportResult Write(const FMCPSceneExportData& Data, const FString& Path);
+};
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MCPConstants.h"
+#include "MCPSceneJournal.h"
+
+class AActor;
+class UWorld;
+
+/**
+ * Hash of one spatial cell: every tracked actor whose location falls in the cell
+ */
+struct FMCPSceneHashCell
+{
+    /** Order-independent combination of the leaf hashes of the actors in the cell */
+    uint64 Hash = 0;
+
+    /** Number of actors in the cell */
+    int32 ActorCount = 0;
+};
+
+/**
+ * Hash of one level: its cells plus the combined hash over them
+ */
+struct FMCPSceneHashLevel
+{
+    /** Combination of the cell hashes, each keyed by its cell coordinate */
+    uint64 Hash = 0;
+
+    /** Number of actors in the level */
+    int32 ActorCount = 0;
+
+    /** Non-empty cells by cell coordinate */
+    TMap<FIntVector, FMCPSceneHashCell> Cells;
+};
+
+/**
+ * Content hashes of the editor world arranged as a tree: scene -> level -> spatial cell -> actor
+ * Each actor has a 64-bit hash over its class, transform, key properties and components. Parents
+ * combine their children with XOR of keyed child hashes, so a single actor edit updates its cell,
+ * level and the root in constant time. Edits arrive through the scene journal and are re-hashed
+ * lazily the next time the hashes are read.
+ */
+class UNREALMCP_API FMCPSceneHashIndex
+{
+public:
+    static FMCPSceneHashIndex& Get();
+
+    /**
+     * Start following the scene journal; the first read builds the index
+     * @param InCellSize - Edge length of the spatial cells in world units
+     */
+    void Initialize(double InCellSize = MCPConstants::SCENE_HASH_CELL_SIZE);
+
+    /**
+     * Stop following the journal and drop all hashes
+     */
+    void Shutdown();
+
+    /**
+     * Bring the index up to date: a full build if needed, otherwise re-hash only dirty actors; must run on the game thread
+     * @param World - The editor world
+     */
+    void Update(UWorld* World);
+
+    /** @return Root hash over every level */
+    uint64 GetRootHash() const;
+
+    /** @return Levels by name */
+    const TMap<FName, FMCPSceneHashLevel>& GetLevels() const { return Levels; }
+
+    /**
+     * Look up an actor's content hash
+     * @param ActorName - The actor name
+     * @param OutHash - The actor's hash
+     * @return False if the actor is not indexed
+     */
+    bool GetActorHash(FName ActorName, uint64& OutHash) const;
+
+    /** @return Edge length of the spatial cells */
+    double GetCellSize() const { return CellSize; }
+
+    /** @return Number of indexed actors */
+    int32 GetActorCount() const { return Actors.Num(); }
+
+    /**
+     * Compute the content hash of an actor; must run on the game thread
+     * @param Actor - The actor to hash
+     * @return Hash over the class, transform, label, folder, tags, visibility and components
+     */
+    static uint64 HashActor(const AActor* Actor);
+
+    /** @return Hash as the 16-digit hex string used in responses */
+    static FString HashToString(uint64 Hash);
+
+private:
+    FMCPSceneHashIndex() = default;
+
+    // Make non-copyable
+    FMCPSceneHashIndex(const FMCPSceneHashIndex&) = delete;
+    FMCPSceneHashIndex& operator=(const FMCPSceneHashIndex&) = delete;
+
+    /** Where an actor's leaf hash is currently counted */
+    struct FActorEntry
+    {
+        uint64 Leaf = 0;
+        uint64 Hash = 0;
+        FName Level;
+        FIntVector Cell;
+    };
+
+    void Rebuild(UWorld* World);
+    void AddActor(const AActor* Actor);
+    void RemoveActor(FName ActorName);
+
+    /** Add or remove a leaf from a cell and propagate the change to the level hash */
+    void ToggleLeaf(FName LevelName, const FIntVector& Cell, uint64 Leaf, int32 CountDelta);
+
+    FIntVector GetCell(const FVector& Location) const;
+
+    void HandleChangeRecorded(EMCPSceneChangeType Type, const AActor* Actor);
+    void HandleJournalInvalidated();
+
+    TMap<FName, FActorEntry> Actors;
+    TMap<FName, FMCPSceneHashLevel> Levels;
+
+    /** Actors edited since the last update; re-hashed in Update */
+    TMap<FName, TWeakObjectPtr<const AActor>> DirtyActors;
+
+    double CellSize = MCPConstants::SCENE_HASH_CELL_SIZE;
+    bool bInitialized = false;
+    bool bNeedsRebuild = true;
+
+    FDelegateHandle ChangeRecordedHandle;
+    FDelegateHandle InvalidatedHandle;
+};
@@ -0,0 +1,179 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "EditorUndoClient.h"
+#include "MCPConstants.h"
+
+class AActor;
+class UObject;
+struct FPropertyChangedEvent;
+
+/**
+ * Kind of change recorded in the scene journal
+ */
+enum class EMCPSceneChangeType : uint8
+{
+    Added,
+    Removed,
+    Transform,
+    Property
+};
+
+/**
+ * A single versioned entry in the scene journal
+ */
+struct FMCPSceneChange
+{
+    /** Version assigned to this change (monotonically increasing) */
+    uint64 Version = 0;
+
+    /** What happened to the actor */
+    EMCPSceneChangeType Type = EMCPSceneChangeType::Property;
+
+    /** Actor object name, the id used by all scene commands */
+    FName ActorName;
+
+    /** Actor class name */
+    FName ClassName;
+
+    /** Actor label, not captured for removed actors */
+    FString Label;
+
+    /** Actor transform at the time of the change */
+    FTransform Transform;
+
+    /** Name of the changed property for property changes */
+    FName PropertyName;
+};
+
+/** Broadcast on the game thread after a change is recorded */
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnMCPSceneChangeRecorded, EMCPSceneChangeType /*Type*/, const AActor* /*Actor*/);
+
+/** Broadcast when every recorded change is dropped and derived state must be rebuilt */
+DECLARE_MULTICAST_DELEGATE(FOnMCPSceneJournalInvalidated);
+
+/**
+ * Ring journal of actor changes in the editor world
+ * Lets clients ask for everything that changed since a version they already know about
+ * instead of re-reading the whole scene
+ *
+ * Undo and redo raise none of the actor or property delegates, so the journal is also an undo client
+ * and records every actor the transaction touched.
+ */
+class UNREALMCP_API FMCPSceneJournal : public FEditorUndoClient
+{
+public:
+    static FMCPSceneJournal& Get();
+
+    /**
+     * Start recording changes from the editor delegates
+     * @param InCapacity - Number of entries kept before the ring wraps
+     */
+    void Initialize(int32 InCapacity = MCPConstants::SCENE_JOURNAL_CAPACITY);
+
+    /**
+     * Stop recording and release the ring
+     */
+    void Shutdown();
+
+    /** @return True if the journal is recording */
+    bool IsInitialized() const { return bInitialized; }
+
+    /** @return The version of the most recent change */
+    uint64 GetCurrentVersion() const;
+
+    /** @return The oldest version a client can resume from without a resync */
+    uint64 GetResyncFloor() const;
+
+    /**
+     * Collect the changes made after a version
+     * @param SinceVersion - Last version the client has seen
+     * @param MaxChanges - Maximum number of entries to return
+     * @param OutChanges - Changes in version order
+     * @param bOutTruncated - Set when more than MaxChanges entries were available
+     * @return False if the journal no longer covers SinceVersion and the client must resync
+     */
+    bool GetChangesSince(uint64 SinceVersion, int32 MaxChanges, TArray<FMCPSceneChange>& OutChanges, bool& bOutTruncated) const;
+
+    /**
+     * Record a change for an actor
+     * @param Type - Kind of change
+     * @param Actor - The changed actor
+     * @param PropertyName - Changed property for property changes
+     */
+    void RecordChange(EMCPSceneChangeType Type, const AActor* Actor, FName PropertyName = NAME_None);
+
+    /**
+     * Drop all entries and force every client to resync, e.g. after a map change
+     */
+    void Invalidate();
+
+    /** @return String form of a change type used in responses */
+    static FString ChangeTypeToString(EMCPSceneChangeType Type);
+
+    /**
+     * Check whether an actor is one the journal records changes for
+     * @param Actor - The actor to check
+     * @return True for non-transient actors in the editor world
+     */
+    static bool IsTrackedActor(const AActor* Actor);
+
+    /** @return Delegate fired for every recorded change, so derived indexes can update incrementally */
+    FOnMCPSceneChangeRecorded& OnChangeRecorded() { return ChangeRecordedDelegate; }
+
+    /** @return Delegate fired when the journal is invalidated */
+    FOnMCPSceneJournalInvalidated& OnInvalidated() { return InvalidatedDelegate; }
+
+    //~ FEditorUndoClient
+    virtual bool MatchesContext(const FTransactionContext& InContext, const TArray<TPair<UObject*, FTransactionObjectEvent>>& TransactionObjectContexts) const override;
+    virtual void PostUndo(bool bSuccess) override;
+    virtual void PostRedo(bool bSuccess) override;
+
+private:
+    FMCPSceneJournal() = default;
+
+    // Make non-copyable
+    FMCPSceneJournal(const FMCPSceneJournal&) = delete;
+    FMCPSceneJournal& operator=(const FMCPSceneJournal&) = delete;
+
+    void HandleActorAdded(AActor* Actor);
+    void HandleActorDeleted(AActor* Actor);
+    void HandleActorMoved(AActor* Actor);
+    void HandleObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& PropertyChangedEvent);
+    void HandleMapOpened(const FString& Filename, bool bAsTemplate);
+
+    /** Record the actors of the undone or redone transaction */
+    void RecordTransactionActors();
+
+    /** Fixed-size ring of entries */
+    TArray<FMCPSceneChange> Ring;
+
+    /** Index the next entry is written to */
+    int32 Head = 0;
+
+    /** Number of valid entries in the ring */
+    int32 Count = 0;
+
+    /** Version of the most recent entry */
+    uint64 CurrentVersion = 0;
+
+    /** Changes at or before this version are no longer available */
+    uint64 ResyncFloor = 0;
+
+    /** Actors touched by the transaction being undone or redone, and whether each one was deleted or restored */
+    mutable TMap<TWeakObjectPtr<AActor>, bool> TransactionActors;
+
+    bool bInitialized = false;
+
+    FDelegateHandle ActorAddedHandle;
+    FDelegateHandle ActorDeletedHandle;
+    FDelegateHandle ActorMovedHandle;
+    FDelegateHandle PropertyChangedHandle;
+    FDelegateHandle MapOpenedHandle;
+
+    FOnMCPSceneChangeRecorded ChangeRecordedDelegate;
+    FOnMCPSceneJournalInvalidated InvalidatedDelegate;
+
+    mutable FCriticalSection Lock;
+};
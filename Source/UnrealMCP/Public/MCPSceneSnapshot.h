@@ -0,0 +1,143 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/Function.h"
+#include "UObject/TopLevelAssetPath.h"
+#include "Json.h"
+
+class AActor;
+class UClass;
+class UWorld;
+
+/**
+ * Plain copy of the actor state the scene commands read
+ * Captured on the game thread so encoding can run on worker threads without touching UObjects
+ */
+struct FMCPActorRecord
+{
+    /** Actor object name, the id used by all scene commands */
+    FName Name;
+
+    /** Actor class; only its name is read off the game thread */
+    const UClass* Class = nullptr;
+
+    /** User-facing label */
+    FString Label;
+
+    /** Actor transform */
+    FTransform Transform;
+
+    /** Bounds of the actor's components, collapsed to the location when the actor has none */
+    FBox Bounds = FBox(ForceInit);
+};
+
+/**
+ * Predicates for selecting actors, shared by every command that queries or edits a set of scene actors
+ * All set predicates must match; an empty filter matches every actor
+ */
+struct UNREALMCP_API FMCPActorFilter
+{
+    /** Class names; an actor matches if its class or any of its super classes is listed */
+    TArray<FName> ClassNames;
+
+    /** Wildcard pattern (* and ?) matched against the actor name */
+    FString NamePattern;
+
+    /** Wildcard pattern (* and ?) matched against the actor label */
+    FString LabelPattern;
+
+    /** Outliner folder; actors in this folder or any subfolder match */
+    FString FolderPath;
+
+    /** Region the actor location must lie in, when valid */
+    FBox Region = FBox(ForceInit);
+
+    /**
+     * Read the filter from a JSON object
+     * Fields: classes, name, label, folder, and region as {min: [x, y, z], max: [x, y, z]}
+     * @param Object - The filter object
+     * @param OutError - Description of the first invalid field
+     * @return False if a field is malformed
+     */
+    bool Parse(const TSharedPtr<FJsonObject>& Object, FString& OutError);
+
+    /** @return True if no predicate is set */
+    bool IsEmpty() const;
+
+    /**
+     * Test an actor against every set predicate; must run on the game thread
+     * @param Actor - The actor to test
+     * @return True if the actor matches
+     */
+    bool Matches(const AActor* Actor) const;
+
+    /**
+     * Test plain actor fields against every set predicate, for actors that are not loaded
+     * @param Class - The actor's native class
+     * @param BaseClass - The Blueprint class of the actor, if any; matched by name (BP_Tree_C) or path, but
+     *                    its Blueprint parents are not known without loading it
+     * @param Name - The actor object name
+     * @param Label - The actor label
+     * @param Folder - The outliner folder path
+     * @param Location - The point tested against the region
+     * @return True if the fields match
+     */
+    bool MatchesFields(const UClass* Class, const FTopLevelAssetPath& BaseClass, FName Name, const FString& Label, const FString& Folder, const FVector& Location) const;
+
+private:
+    /** @return True if no classes are set or Class or one of its super classes is listed */
+    bool MatchesClass(const UClass* Class) const;
+
+    /** @return True if Folder is the filter folder or one of its subfolders */
+    bool MatchesFolder(const FString& Folder) const;
+};
+
+/**
+ * Options for capturing a scene snapshot
+ */
+struct FMCPSnapshotOptions
+{
+    /** Maximum number of records to capture; the total is still counted past it */
+    int32 MaxRecords = MAX_int32;
+
+    /** Whether to compute component bounds, the most expensive part of the copy */
+    bool bIncludeBounds = true;
+
+    /** Whether to copy labels */
+    bool bIncludeLabels = true;
+
+    /** Only actors matching this filter are counted and captured, when set */
+    const FMCPActorFilter* Filter = nullptr;
+};
+
+/**
+ * Game-thread snapshot of the actors in a world plus helpers to process it in parallel
+ */
+class UNREALMCP_API FMCPSceneSnapshot
+{
+public:
+    /**
+     * Copy actor records out of the world; must run on the game thread
+     * @param World - The world to read
+     * @param Options - What to capture
+     * @param OutRecords - Captured records in iteration order
+     * @return Total number of actors in the world that match the filter
+     */
+    static int32 Capture(UWorld* World, const FMCPSnapshotOptions& Options, TArray<FMCPActorRecord>& OutRecords);
+
+    /**
+     * Copy a single actor's record; must run on the game thread
+     * @param Actor - The actor to read
+     * @param Options - What to capture
+     * @param OutRecord - The captured record
+     */
+    static void CaptureActor(const AActor* Actor, const FMCPSnapshotOptions& Options, FMCPActorRecord& OutRecord);
+
+    /**
+     * Split [0, Num) into contiguous chunks and process them on worker threads
+     * Chunks are ordered, so writing results by index keeps them in record order
+     * @param Num - Number of items
+     * @param Func - Called once per chunk with [Start, End)
+     */
+    static void ParallelForChunks(int32 Num, TFunctionRef<void(int32 Start, int32 End)> Func);
+};
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UClass;
+class UObject;
+class UWorld;
+struct FMCPActorFilter;
+
+/**
+ * Kinds of light components counted by the scene statistics
+ */
+enum class EMCPLightKind : uint8
+{
+    None,
+    Directional,
+    Point,
+    Spot,
+    Rect,
+    Sky,
+    Count
+};
+
+/**
+ * Plain copy of one primitive or light component, captured on the game thread
+ */
+struct FMCPStatsComponent
+{
+    /** Mesh asset, used only as an identity key off the game thread */
+    const UObject* Mesh = nullptr;
+
+    /** Materials are Materials[FirstMaterial, FirstMaterial + MaterialCount) of the capture */
+    int32 FirstMaterial = 0;
+    int32 MaterialCount = 0;
+
+    /** LOD0 triangles of the mesh times the instance count */
+    int64 Triangles = 0;
+
+    /** Rendered instances; 1 for a plain mesh component */
+    int32 Instances = 0;
+
+    EMCPLightKind LightKind = EMCPLightKind::None;
+
+    /** EComponentMobility value */
+    uint8 Mobility = 0;
+};
+
+/**
+ * Plain copy of one actor, captured on the game thread
+ */
+struct FMCPStatsActor
+{
+    /** Actor class; only its name is read, on the game thread */
+    const UClass* Class = nullptr;
+
+    /** Index into the capture's level names */
+    int32 Level = INDEX_NONE;
+
+    /** Bounds of the actor's components, collapsed to the location when the actor has none */
+    FBox Bounds = FBox(ForceInit);
+
+    /** Components are Components[FirstComponent, FirstComponent + ComponentCount) of the capture */
+    int32 FirstComponent = 0;
+    int32 ComponentCount = 0;
+};
+
+/**
+ * Everything the statistics reduction reads, copied out of the world on the game thread
+ */
+struct FMCPSceneStatsCapture
+{
+    TArray<FName> Levels;
+    TArray<FMCPStatsActor> Actors;
+    TArray<FMCPStatsComponent> Components;
+    TArray<const UObject*> Materials;
+};
+
+/**
+ * Aggregated scene statistics
+ * Also used as the per-thread accumulator of the parallel reduction, so partial results merge into a total
+ */
+struct FMCPSceneStats
+{
+    int32 ActorCount = 0;
+    TMap<const UClass*, int32> ClassCounts;
+
+    int32 MeshComponentCount = 0;
+    int64 InstanceCount = 0;
+    int64 TriangleCount = 0;
+    TSet<const UObject*> Meshes;
+    TSet<const UObject*> Materials;
+
+    /** Light counts indexed by [EMCPLightKind][EComponentMobility] */
+    int32 LightCounts[static_cast<int32>(EMCPLightKind::Count)][3] = {};
+
+    /** Per level of the capture */
+    TArray<int32> LevelActorCounts;
+    TArray<FBox> LevelBounds;
+
+    /**
+     * Add another partial result into this one
+     * @param Other - The partial result to add
+     */
+    void Merge(const FMCPSceneStats& Other);
+};
+
+/**
+ * Computes scene statistics: a game-thread copy of the components, then a parallel reduction over it
+ */
+class UNREALMCP_API FMCPSceneStatsCollector
+{
+public:
+    /**
+     * Copy the data the statistics need; must run on the game thread
+     * @param World - The world to read
+     * @param Filter - Only actors matching the filter are counted, when set
+     * @param OutCapture - The captured data
+     */
+    static void Capture(UWorld* World, const FMCPActorFilter* Filter, FMCPSceneStatsCapture& OutCapture);
+
+    /**
+     * Reduce a capture to statistics on worker threads, one accumulator per task
+     * @param Capture - Data from Capture
+     * @param OutStats - The totals
+     */
+    static void Reduce(const FMCPSceneStatsCapture& Capture, FMCPSceneStats& OutStats);
+};
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Json.h"
+#include "MCPConstants.h"
+#include "MCPSceneSnapshot.h"
+
+/**
+ * One node of a scene summary: a spatial cluster of actors
+ */
+struct FMCPSummaryCluster
+{
+    /** Path from the root: "r" for the root, then one octant digit per level, e.g. "r.3.5" */
+    FString Id;
+
+    /** Id of the enclosing cluster, empty for the root */
+    FString ParentId;
+
+    /** Record indices of the member actors */
+    TArray<int32> Members;
+
+    /** Union of the member bounds */
+    FBox Bounds = FBox(ForceInit);
+
+    /** Bounds of the member locations; clusters split at its center */
+    FBox LocationBounds = FBox(ForceInit);
+
+    /** Mean member location */
+    FVector Centroid = FVector::ZeroVector;
+
+    /** Most common classes, most frequent first */
+    TArray<TPair<const UClass*, int32>> TopClasses;
+
+    /** Record indices of the largest members, largest first */
+    TArray<int32> Representatives;
+
+    /** True if the cluster can be split further */
+    bool bExpandable = false;
+
+    /** True if the cluster's children are part of the summary */
+    bool bExpanded = false;
+};
+
+/**
+ * Options for summarizing a scene
+ */
+struct FMCPSummaryOptions
+{
+    /** Approximate size of the serialized clusters; the top cluster is always returned */
+    int32 MaxBytes = MCPConstants::DEFAULT_SUMMARY_BYTES;
+
+    /** Cluster to summarize, "r" for the whole selection */
+    FString ClusterId = TEXT("r");
+
+    /** Classes listed per cluster */
+    int32 MaxClasses = 3;
+
+    /** Representative actors listed per cluster */
+    int32 MaxRepresentatives = 3;
+};
+
+/**
+ * Hierarchical, budgeted summaries of a set of actors
+ *
+ * Actors are clustered with an adaptive octree over their locations: a cluster splits into the non-empty
+ * octants around the center of its members' location bounds, so cluster ids are stable for an unchanged
+ * scene and any cluster can be rebuilt from its id alone. The summary grows by always splitting the largest
+ * expandable cluster, so each added byte describes the most actors, and stops when the next split would
+ * exceed the byte budget.
+ */
+class UNREALMCP_API FMCPSceneSummary
+{
+public:
+    /**
+     * Build a summary; octant assignment and cluster statistics run on worker threads
+     * @param Records - The actors to summarize
+     * @param Options - Budget, top cluster and list sizes
+     * @param OutClusters - Clusters in the order they were added, the top cluster first
+     * @param OutError - Why the summary could not be built
+     * @return False if the cluster id is malformed or names an empty cluster
+     */
+    static bool Build(const TArray<FMCPActorRecord>& Records, const FMCPSummaryOptions& Options, TArray<FMCPSummaryCluster>& OutClusters, FString& OutError);
+
+    /**
+     * Describe a cluster as JSON, with coordinates rounded to whole units
+     * @param Cluster - The cluster
+     * @param Records - The records its indices refer to
+     * @return The cluster object
+     */
+    static TSharedPtr<FJsonObject> ToJson(const FMCPSummaryCluster& Cluster, const TArray<FMCPActorRecord>& Records);
+
+private:
+    /** Fill the bounds, centroid, classes and representatives of a cluster from its members */
+    static void ComputeStats(FMCPSummaryCluster& Cluster, const TArray<FMCPActorRecord>& Records, const FMCPSummaryOptions& Options);
+
+    /** Split a cluster into its non-empty octants; children get their ids and members but no statistics */
+    static void Split(const FMCPSummaryCluster& Parent, const TArray<FMCPActorRecord>& Records, TArray<FMCPSummaryCluster>& OutChildren);
+};
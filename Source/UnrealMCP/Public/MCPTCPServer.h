@@ -84,6 +84,12 @@ public:
      * @return JSON response object
      */
     virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject>& Params, FSocket* ClientSocket) = 0;
+
+    /**
+     * Rank the result fields kept first when a response is cut to a client's max_response_bytes
+     * @return Large result fields from most to least important; unlisted ones follow in their original order
+     */
+    virtual TArray<FString> GetFieldPriorities() const { return TArray<FString>(); }
 };
 
 /**
@@ -152,8 +158,9 @@ public:
      * Send a response to a client
      * @param Client - The client socket
      * @param Response - The response to send
+     * @param bCondensed - Serialize without whitespace, as budgeted responses are measured
      */
-    void SendResponse(FSocket* Client, const TSharedPtr<FJsonObject>& Response);
+    void SendResponse(FSocket* Client, const TSharedPtr<FJsonObject>& Response, bool bCondensed = false);
 
     /**
      * Get the command handlers map (for testing purposes)
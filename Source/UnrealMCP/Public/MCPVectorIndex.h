@@ -0,0 +1,432 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Json.h"
+#include "Math/RandomStream.h"
+#include "MCPConstants.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/**
+ * Vector index file layout (.mcpvec)
+ *
+ * Little-endian, every section on a 64-byte boundary, same header-plus-section-table scheme as scene
+ * snapshots. The quantized vectors and the level 0 links, which hold nearly all of the bytes, are used
+ * straight from the mapped file; the rest is read into memory when the index is opened.
+ *
+ *   FMCPVectorFileHeader
+ *   FMCPVectorSection[SectionCount]
+ *   sections...
+ *
+ * Link lists are a count followed by that many node indices, padded to a fixed size per level:
+ * M0 + 1 int32 at level 0, M + 1 at the levels above. Node n's upper lists start at UpperOffsets[n],
+ * one after another from level 1 up to Levels[n]. Ids and metadata keys and values are indices into the
+ * string table; node n's metadata is the (key, value) pairs MetaPairs[MetaStarts[n], MetaStarts[n + 1]).
+ */
+namespace MCPVectorFormat
+{
+    constexpr uint32 FORMAT_VERSION = 1;
+    constexpr uint32 SECTION_ALIGNMENT = 64;
+    constexpr const TCHAR* FILE_EXTENSION = TEXT(".mcpvec");
+
+    /** Section ids in the section table */
+    enum ESectionId : uint32
+    {
+        Vectors = 1,             // int8[NodeCount * Stride]
+        Scales = 2,              // float[NodeCount]
+        Levels = 3,              // uint8[NodeCount]
+        Flags = 4,               // uint8[NodeCount]
+        Links0 = 5,              // int32[NodeCount * (M0 + 1)]
+        UpperOffsets = 6,        // int32[NodeCount], -1 for nodes only on level 0
+        UpperLinks = 7,          // int32[]
+        Ids = 8,                 // uint32[NodeCount]
+        MetaStarts = 9,          // uint32[NodeCount + 1]
+        MetaPairs = 10,          // uint32[2 * PairCount]
+        StringOffsets = 11,      // uint32[StringCount + 1]
+        StringData = 12          // uint8[], UTF-8
+    };
+
+    /** Node flags */
+    enum ENodeFlags : uint8
+    {
+        Deleted = 1 << 0
+    };
+}
+
+#pragma pack(push, 1)
+
+/** File header, 64 bytes */
+struct FMCPVectorFileHeader
+{
+    /** "MCPVEC" followed by two zero bytes */
+    uint8 Magic[8];
+    uint32 FormatVersion;
+    uint32 HeaderSize;
+    uint32 Dimension;
+    uint32 Stride;
+    uint32 NodeCount;
+    uint32 DeletedCount;
+    uint32 M;
+    uint32 M0;
+    int32 EntryPoint;
+    int32 MaxLevel;
+    uint32 StringCount;
+    uint32 SectionCount;
+    uint8 Reserved[8];
+};
+
+/** Section table entry, 32 bytes */
+struct FMCPVectorSection
+{
+    uint32 Id;
+    uint32 Stride;
+    uint64 Count;
+    uint64 Offset;
+    uint64 Size;
+};
+
+#pragma pack(pop)
+
+static_assert(sizeof(FMCPVectorFileHeader) == 64, "Vector index header layout changed");
+static_assert(sizeof(FMCPVectorSection) == 32, "Vector index section layout changed");
+
+/**
+ * Metadata conditions a search hit must meet: every key must match one of its values
+ */
+struct FMCPVectorFilter
+{
+    /** Key and accepted values; a value ending in '*' matches by prefix */
+    TArray<TPair<FString, TArray<FString>>> Conditions;
+
+    /**
+     * Read a filter object, e.g. {"kind": "asset", "class": ["/Script/Engine.StaticMesh"], "path": "/Game/Props*"}
+     * @param Object - The filter
+     * @param OutError - Why the filter is malformed
+     * @return False if a value is not a string or array of strings
+     */
+    bool Parse(const TSharedPtr<FJsonObject>& Object, FString& OutError);
+
+    bool IsEmpty() const { return Conditions.Num() == 0; }
+};
+
+/**
+ * One search result
+ */
+struct FMCPVectorHit
+{
+    int32 Node = INDEX_NONE;
+
+    /** Cosine similarity */
+    float Score = 0.0f;
+};
+
+/**
+ * How a search ran
+ */
+struct FMCPVectorSearchStats
+{
+    /** Vectors compared */
+    int32 Visited = 0;
+
+    /** True if every candidate was compared instead of walking the graph */
+    bool bExact = false;
+};
+
+/**
+ * Approximate nearest-neighbour index over embeddings (HNSW graph, cosine similarity)
+ *
+ * Vectors are normalized and quantized to int8 with one scale per vector, so a million 384-dimensional
+ * embeddings take about 400 MB, and similarities are integer dot products run with AVX2, SSSE3 or NEON.
+ * Upserting an existing id marks its old node deleted and inserts a new one; deleted nodes keep routing
+ * searches but are never returned, and hold their memory and file space until Compact rebuilds the graph.
+ *
+ * Metadata filters with exact values are resolved through an inverted index: when few nodes match,
+ * they are compared exhaustively, otherwise the graph walk only admits matching nodes into the result.
+ *
+ * An opened file stays mapped until the index is changed, when the mapped parts are copied into memory.
+ * Only touched on the game thread.
+ */
+class UNREALMCP_API FMCPVectorIndex
+{
+public:
+    explicit FMCPVectorIndex(const FString& InName);
+    ~FMCPVectorIndex();
+
+    const FString& GetName() const { return Name; }
+
+    /** @return Vector length, 0 until the first upsert */
+    int32 GetDimension() const { return Dimension; }
+
+    /** @return Number of live entries */
+    int32 Num() const { return NodeCount - DeletedCount; }
+
+    /** @return Nodes in the graph, deleted ones included */
+    int32 GetNodeCount() const { return NodeCount; }
+
+    bool IsMapped() const { return MappedRegion.IsValid(); }
+    bool IsDirty() const { return bDirty; }
+
+    /** @return Bytes held in memory, mapped sections excluded */
+    int64 GetAllocatedSize() const;
+
+    /**
+     * Insert or replace an entry
+     * @param Id - Unique id, e.g. an asset object path or actor name
+     * @param Vector - The embedding; all entries share the length of the first one
+     * @param Metadata - Key/value pairs filters can test
+     * @param OutError - Why the entry was rejected
+     * @return False on a length mismatch or an all-zero vector
+     */
+    bool Upsert(const FString& Id, TArrayView<const float> Vector, const TArray<TPair<FString, FString>>& Metadata, FString& OutError);
+
+    /**
+     * Delete an entry
+     * @param Id - The entry id
+     * @return False if there is no such entry
+     */
+    bool Remove(const FString& Id);
+
+    /**
+     * Drop deleted nodes and the strings only they used, relinking the live nodes into a new graph
+     * @return Number of nodes dropped
+     */
+    int32 Compact();
+
+    /**
+     * Find the entries most similar to a vector
+     * @param Query - The query embedding
+     * @param K - Number of hits wanted
+     * @param Ef - Candidate list size of the graph walk; larger is slower and more accurate
+     * @param Filter - Metadata conditions, or null
+     * @param OutHits - Best hits first
+     * @param OutStats - How the search ran, or null
+     * @return False if the query length does not match the index
+     */
+    bool Search(TArrayView<const float> Query, int32 K, int32 Ef, const FMCPVectorFilter* Filter, TArray<FMCPVectorHit>& OutHits, FMCPVectorSearchStats* OutStats = nullptr);
+
+    /** @return The id of a node */
+    const FString& GetId(int32 Node) const;
+
+    /**
+     * Read the metadata of a node
+     * @param Node - Node from a hit
+     * @param OutMetadata - Key/value pairs
+     */
+    void GetMetadata(int32 Node, TArray<TPair<FString, FString>>& OutMetadata) const;
+
+    /**
+     * Write the index to a file, under a temporary name moved into place when complete
+     * @param Path - Destination file
+     * @param OutError - Why writing failed
+     * @return True on success
+     */
+    bool Save(const FString& Path, FString& OutError);
+
+    /**
+     * Replace the contents with a file, mapping its large sections
+     * @param Path - File written by Save
+     * @param OutError - Why the file could not be used
+     * @return True on success
+     */
+    bool Load(const FString& Path, FString& OutError);
+
+private:
+    /** A node and its similarity to the vector being searched for */
+    struct FCandidate
+    {
+        float Similarity;
+        int32 Node;
+    };
+
+    /** A filter resolved against the string table */
+    struct FCompiledFilter
+    {
+        struct FCondition
+        {
+            int32 Key = INDEX_NONE;
+            TArray<int32> Values;
+            TArray<FString> Prefixes;
+        };
+        TArray<FCondition> Conditions;
+
+        /** True if some condition can match nothing */
+        bool bEmpty = false;
+    };
+
+    void Reset();
+
+    /** Copy mapped sections into memory so they can be changed */
+    void MakeWritable();
+
+    /** Point the section views at the owned arrays */
+    void RefreshViews();
+
+    int32 InternString(const FString& Value);
+
+    const int8* GetVector(int32 Node) const { return Vectors + static_cast<int64>(Node) * Stride; }
+    const int32* GetLinks(int32 Node, int32 Level) const;
+    int32* GetMutableLinks(int32 Node, int32 Level);
+    int32 GetMaxLinks(int32 Level) const { return Level == 0 ? M0 : M; }
+
+    /**
+     * Normalize and quantize a vector
+     * @param Vector - The input, Dimension long
+     * @param Out - Stride bytes, zero padded
+     * @return The scale of the quantized values, 0 for an all-zero vector
+     */
+    float Quantize(TArrayView<const float> Vector, int8* Out) const;
+
+    float Similarity(const int8* Query, float QueryScale, int32 Node) const;
+    float NodeSimilarity(int32 A, int32 B) const;
+
+    bool IsLive(int32 Node) const { return (Flags[Node] & MCPVectorFormat::Deleted) == 0; }
+    bool Matches(int32 Node, const FCompiledFilter& Filter) const;
+    void CompileFilter(const FMCPVectorFilter& Filter, FCompiledFilter& OutFilter) const;
+
+    /**
+     * Best-first walk of one graph level
+     * @param Query - Quantized query
+     * @param QueryScale - Its scale
+     * @param Entries - Nodes to start from
+     * @param Ef - Results kept
+     * @param Level - Graph level
+     * @param Filter - Conditions a node needs to enter the results, or null to admit every node
+     * @param bLiveOnly - Keep deleted nodes out of the results
+     * @param OutResults - Up to Ef nodes, best first
+     * @param InOutVisited - Incremented per node compared
+     */
+    void SearchLevel(const int8* Query, float QueryScale, const TArray<FCandidate>& Entries, int32 Ef, int32 Level,
+        const FCompiledFilter* Filter, bool bLiveOnly, TArray<FCandidate>& OutResults, int32& InOutVisited);
+
+    /**
+     * Keep candidates that are closer to the new node than to any neighbour kept before them
+     * @param Candidates - Best first
+     * @param MaxCount - Neighbours wanted
+     * @param OutNeighbours - The kept nodes
+     */
+    void SelectNeighbours(const TArray<FCandidate>& Candidates, int32 MaxCount, TArray<int32>& OutNeighbours) const;
+
+    /**
+     * Append a node whose quantized vector was already added to OwnedVectors, and link it into the graph
+     * @param IdString - Interned id
+     * @param Scale - Scale of the quantized vector
+     * @param Level - Highest graph level of the node
+     * @param Metadata - Key/value pairs
+     */
+    void AddNode(int32 IdString, float Scale, int32 Level, const TArray<TPair<FString, FString>>& Metadata);
+
+    /** Link a new node into the graph */
+    void Connect(int32 Node);
+
+    /** Add a link from Node to Neighbour, pruning Node's list if it is full */
+    void AddLink(int32 Node, int32 Neighbour, int32 Level);
+
+    FString Name;
+    int32 Dimension = 0;
+    int32 Stride = 0;
+    int32 M = MCPConstants::VECTOR_INDEX_M;
+    int32 M0 = 2 * MCPConstants::VECTOR_INDEX_M;
+    int32 NodeCount = 0;
+    int32 DeletedCount = 0;
+    int32 EntryPoint = INDEX_NONE;
+    int32 MaxLevel = -1;
+
+    /** Quantized vectors and level 0 links; point into the owned arrays or the mapped file */
+    const int8* Vectors = nullptr;
+    const int32* Links0 = nullptr;
+    TArray<int8> OwnedVectors;
+    TArray<int32> OwnedLinks0;
+
+    TArray<float> Scales;
+    TArray<uint8> Levels;
+    TArray<uint8> Flags;
+    TArray<int32> UpperOffsets;
+    TArray<int32> UpperLinks;
+
+    TArray<int32> IdStrings;
+    TArray<uint32> MetaStarts;
+    TArray<uint32> MetaPairs;
+
+    TArray<FString> Strings;
+    TMap<FString, int32> StringIds;
+
+    /** Live node by id string */
+    TMap<int32, int32> NodeByIdString;
+
+    /** Nodes by metadata key and value string, deleted nodes included */
+    TMap<uint64, TArray<int32>> MetaPostings;
+
+    FRandomStream LevelRandom;
+    bool bDirty = false;
+
+    TUniquePtr<IMappedFileHandle> MappedFile;
+    TUniquePtr<IMappedFileRegion> MappedRegion;
+
+    /** Visit marks of the running walk; a node is visited if its mark equals VisitEpoch */
+    TArray<uint32> VisitMarks;
+    uint32 VisitEpoch = 0;
+};
+
+/**
+ * Named vector indexes, each persisted as Saved/MCPVectors/<name>.mcpvec
+ *
+ * Indexes are opened from their file on first use and written back by vector_index save and when the
+ * server stops, if they changed.
+ */
+class UNREALMCP_API FMCPVectorStore
+{
+public:
+    static FMCPVectorStore& Get();
+
+    /**
+     * Get an index, opening its file if it is not loaded
+     * @param Name - Index name
+     * @param bCreate - Create an empty index if there is neither one loaded nor a file
+     * @param OutError - Why the index could not be opened
+     * @return The index, or null
+     */
+    FMCPVectorIndex* Find(const FString& Name, bool bCreate, FString& OutError);
+
+    /**
+     * Write an index to its file
+     * @param Name - Index name
+     * @param OutError - Why writing failed
+     * @return True on success
+     */
+    bool Save(const FString& Name, FString& OutError);
+
+    /**
+     * Unload an index
+     * @param Name - Index name
+     * @param bDeleteFile - Also delete its file
+     * @return False if the index is neither loaded nor on disk
+     */
+    bool Drop(const FString& Name, bool bDeleteFile);
+
+    /** @return Names of loaded indexes and of index files */
+    TArray<FString> GetNames() const;
+
+    /** @return The loaded index, or null */
+    const FMCPVectorIndex* FindLoaded(const FString& Name) const;
+
+    /**
+     * Save changed indexes and unload all of them
+     */
+    void Shutdown();
+
+    /** @return Whether a name is usable as an index file name */
+    static bool IsValidName(const FString& Name);
+
+    /** @return File of an index */
+    static FString GetPath(const FString& Name);
+
+private:
+    FMCPVectorStore() = default;
+
+    // Make non-copyable
+    FMCPVectorStore(const FMCPVectorStore&) = delete;
+    FMCPVectorStore& operator=(const FMCPVectorStore&) = delete;
+
+    TMap<FString, TUniquePtr<FMCPVectorIndex>> Indexes;
+};
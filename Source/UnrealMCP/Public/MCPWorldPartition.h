@@ -0,0 +1,122 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtr.h"
+
+class UClass;
+class UWorld;
+class UWorldPartitionEditorLoaderAdapter;
+struct FMCPActorFilter;
+
+/**
+ * Plain copy of a World Partition actor descriptor; describes an actor whether or not it is loaded
+ */
+struct FMCPActorDescRecord
+{
+    FGuid Guid;
+    FName Name;
+    FString Label;
+
+    /** Native class of the actor */
+    const UClass* NativeClass = nullptr;
+
+    /** Blueprint class path for blueprint actors, empty for native actors */
+    FString BaseClass;
+
+    FString Folder;
+    FBox Bounds = FBox(ForceInit);
+    TArray<FName> DataLayers;
+    bool bLoaded = false;
+};
+
+/**
+ * Options for reading actor descriptors
+ */
+struct FMCPActorDescQuery
+{
+    /** Only descriptors matching the filter are returned, when set; the region is tested against the bounds center */
+    const FMCPActorFilter* Filter = nullptr;
+
+    /** Only descriptors whose bounds intersect this box are returned, when valid */
+    FBox Intersects = FBox(ForceInit);
+
+    /** Only descriptors in at least one of these data layers are returned, when not empty */
+    TArray<FName> DataLayers;
+
+    /** Only unloaded descriptors are returned */
+    bool bUnloadedOnly = false;
+
+    /** Maximum number of records to return; the total is still counted past it */
+    int32 MaxRecords = MAX_int32;
+};
+
+/**
+ * A region of a World Partition map loaded in the editor on behalf of a client
+ */
+struct FMCPLoadedRegion
+{
+    FString Id;
+    FBox Bounds = FBox(ForceInit);
+
+    /** True once the actors in the region are loaded */
+    bool bLoaded = false;
+
+    TWeakObjectPtr<UWorld> World;
+    TWeakObjectPtr<UWorldPartitionEditorLoaderAdapter> Adapter;
+};
+
+/**
+ * Queries over World Partition actor descriptors and tracking of client-loaded regions
+ */
+class UNREALMCP_API FMCPWorldPartition
+{
+public:
+    static FMCPWorldPartition& Get();
+
+    /**
+     * Read actor descriptors from every descriptor container of a world without loading actors
+     * @param World - A World Partition world
+     * @param Query - Which descriptors to return
+     * @param OutRecords - The matching descriptors
+     * @return Total number of matching descriptors, or INDEX_NONE if the world has no World Partition
+     */
+    static int32 CollectActorDescs(UWorld* World, const FMCPActorDescQuery& Query, TArray<FMCPActorDescRecord>& OutRecords);
+
+    /**
+     * Create an editor loader region; its actors are loaded on the next tick unless bWait is set
+     * @param World - A World Partition world
+     * @param Bounds - The region to load
+     * @param bWait - Load before returning instead of on the next tick
+     * @param OutError - Why the region could not be created
+     * @return The region id, or an empty string on failure
+     */
+    FString LoadRegion(UWorld* World, const FBox& Bounds, bool bWait, FString& OutError);
+
+    /**
+     * Unload a region created by LoadRegion and release its loader
+     * @param Id - The region id
+     * @return False if no region has that id
+     */
+    bool UnloadRegion(const FString& Id);
+
+    /** Unload every region created by LoadRegion */
+    void UnloadAllRegions();
+
+    /** @return The regions currently tracked; stale regions of closed worlds are dropped first */
+    TArray<FMCPLoadedRegion> GetRegions();
+
+private:
+    FMCPWorldPartition() = default;
+
+    // Make non-copyable
+    FMCPWorldPartition(const FMCPWorldPartition&) = delete;
+    FMCPWorldPartition& operator=(const FMCPWorldPartition&) = delete;
+
+    /** Load the actors of a pending region */
+    void FinishLoad(const FString& Id);
+
+    /** Regions by id; only touched on the game thread */
+    TMap<FString, FMCPLoadedRegion> Regions;
+
+    int32 NextRegionNumber = 1;
+};